@@ -179,14 +179,14 @@ namespace RealtimeMesh
 					const auto UpdateData = MakeShared<FRealtimeMeshSectionGroupStreamUpdateData>(MoveTemp(StreamCopy), EBufferUsageFlags::Static);
 					UpdateData->CreateBufferAsyncIfPossible(UpdateContext);
 
-					ProxyBuilder->AddSectionGroupTask(Key, [UpdateData = UpdateData](FRHICommandListBase& RHICmdList, FRealtimeMeshSectionGroupProxy& Proxy)
+					ProxyBuilder->AddSectionGroupStreamTask(Key, StreamKey, true, [UpdateData = UpdateData](FRHICommandListBase& RHICmdList, FRealtimeMeshSectionGroupProxy& Proxy)
 					{
 						Proxy.CreateOrUpdateStream(RHICmdList, UpdateData);
 					}, ShouldRecreateProxyOnChange(UpdateContext));
 				}
 				else
 				{
-					ProxyBuilder->AddSectionGroupTask(Key, [StreamKey](FRHICommandListBase& RHICmdList, FRealtimeMeshSectionGroupProxy& Proxy)
+					ProxyBuilder->AddSectionGroupStreamTask(Key, StreamKey, true, [StreamKey](FRHICommandListBase& RHICmdList, FRealtimeMeshSectionGroupProxy& Proxy)
 					{
 						Proxy.RemoveStream(StreamKey);
 					}, ShouldRecreateProxyOnChange(UpdateContext));
@@ -197,6 +197,33 @@ namespace RealtimeMesh
 		UpdateContext.GetState().StreamDirtyTree.Flag(Key, StreamKey);
 	}
 
+	void FRealtimeMeshSectionGroup::UpdateStreamRange(FRealtimeMeshUpdateContext& UpdateContext, const FRealtimeMeshStream& Stream, int32 StartIndex, int32 Count)
+	{
+		const auto StreamKey = Stream.GetStreamKey();
+		check(Streams.Contains(StreamKey));
+		check(StartIndex >= 0 && Count > 0 && StartIndex + Count <= Stream.Num());
+
+		if (SharedResources->WantsStreamOnGPU(StreamKey))
+		{
+			if (auto ProxyBuilder = UpdateContext.GetProxyBuilder())
+			{
+				FRealtimeMeshStream StreamRange(StreamKey, Stream.GetLayout());
+				StreamRange.SetNumUninitialized(Count);
+				StreamRange.SetRange(0, Stream.GetLayout(), Stream.GetData() + StartIndex * Stream.GetStride(), Count);
+
+				const auto UpdateData = MakeShared<FRealtimeMeshSectionGroupStreamUpdateData>(MoveTemp(StreamRange), EBufferUsageFlags::Static, StartIndex, Stream.Num());
+
+				// The proxy keeps its buffers and vertex factory, so it never needs recreating for this
+				ProxyBuilder->AddSectionGroupStreamTask(Key, StreamKey, false, [UpdateData = UpdateData](FRHICommandListBase& RHICmdList, FRealtimeMeshSectionGroupProxy& Proxy)
+				{
+					Proxy.UpdateStreamRange(RHICmdList, UpdateData);
+				}, false);
+			}
+		}
+
+		UpdateContext.GetState().StreamDirtyTree.Flag(Key, StreamKey);
+	}
+
 	void FRealtimeMeshSectionGroup::RemoveStream(FRealtimeMeshUpdateContext& UpdateContext, const FRealtimeMeshStreamKey& StreamKey)
 	{
 		if (Streams.Remove(StreamKey))
@@ -205,7 +232,7 @@ namespace RealtimeMesh
 			{
 				if (auto ProxyBuilder = UpdateContext.GetProxyBuilder())
 				{
-					ProxyBuilder->AddSectionGroupTask(Key, [StreamKey](FRHICommandListBase& RHICmdList, FRealtimeMeshSectionGroupProxy& Proxy)
+					ProxyBuilder->AddSectionGroupStreamTask(Key, StreamKey, true, [StreamKey](FRHICommandListBase& RHICmdList, FRealtimeMeshSectionGroupProxy& Proxy)
 					{
 						Proxy.RemoveStream(StreamKey);
 					}, ShouldRecreateProxyOnChange(UpdateContext));
@@ -2,10 +2,15 @@
 
 
 #include "Mesh/RealtimeMeshAlgo.h"
+#include "Mesh/RealtimeMeshTangentGenerator.h"
+#include "RealtimeMeshComponentModule.h"
 
 #include "Core/RealtimeMeshBuilder.h"
 #include "Core/RealtimeMeshDataStream.h"
 #include "Core/RealtimeMeshDataTypes.h"
+#include "Algo/AllOf.h"
+#include "Async/ParallelFor.h"
+#include "Misc/Crc.h"
 
 using namespace RealtimeMesh;
 
@@ -281,56 +286,73 @@ TOptional<TMap<int32, FRealtimeMeshStreamRange>> RealtimeMeshAlgo::GetStreamRang
 	                                     FRealtimeMeshStreams::DepthOnlyPolyGroupSegments);
 }
 
-
-void RealtimeMeshAlgo::GenerateTangents(RealtimeMesh::FRealtimeMeshStreamSet& StreamSet, bool bComputeSmoothNormals)
+bool RealtimeMeshAlgo::CopyPositionsAndTriangles(const FRealtimeMeshStreamSet& Streams, TArray<FVector3f>& OutPositions, TArray<int32>& OutIndices)
 {
-	if (!StreamSet.Contains(FRealtimeMeshStreams::Triangles) || !StreamSet.Contains(FRealtimeMeshStreams::Position))
+	const FRealtimeMeshStream* PositionStream = Streams.Find(FRealtimeMeshStreams::Position);
+	const FRealtimeMeshStream* TriangleStream = Streams.Find(FRealtimeMeshStreams::Triangles);
+	if (!PositionStream || !TriangleStream || !PositionStream->CanConvertTo<FVector3f>())
 	{
-		return;
+		return false;
 	}
 
-	TRealtimeMeshStreamBuilder<FVector3f> Positions(StreamSet.FindChecked(FRealtimeMeshStreams::Position));
-	TRealtimeMeshStreamBuilder<TIndex3<uint32>> Triangles(StreamSet.FindChecked(FRealtimeMeshStreams::Triangles));
-	TOptional<TRealtimeMeshStridedStreamBuilder<FVector2f, void>> TexCoords;
+	PositionStream->CopyTo(OutPositions);
 
-	if (StreamSet.Contains(FRealtimeMeshStreams::TexCoords))
+	TRealtimeMeshStreamBuilder<const TIndex3<uint32>, void> TrianglesData(*TriangleStream);
+	OutIndices.SetNumUninitialized(TrianglesData.Num() * 3);
+	for (int32 TriIdx = 0; TriIdx < TrianglesData.Num(); TriIdx++)
 	{
-		TexCoords = TRealtimeMeshStridedStreamBuilder<FVector2f, void>(StreamSet.FindChecked(FRealtimeMeshStreams::TexCoords));
+		OutIndices[TriIdx * 3 + 0] = TrianglesData[TriIdx].GetElement(0).GetValue();
+		OutIndices[TriIdx * 3 + 1] = TrianglesData[TriIdx].GetElement(1).GetValue();
+		OutIndices[TriIdx * 3 + 2] = TrianglesData[TriIdx].GetElement(2).GetValue();
 	}
+	return true;
+}
 
-	StreamSet.Remove(FRealtimeMeshStreams::Tangents);
-	TRealtimeMeshStreamBuilder<FRealtimeMeshTangentsNormalPrecision> Tangents(StreamSet.AddStream<FRealtimeMeshTangentsNormalPrecision>(FRealtimeMeshStreams::Tangents));
-	Tangents.SetNumZeroed(Positions.Num());
-	
-	uint32 NumIndices = Triangles.Num() * 3;
-	uint32 NumVertices = Positions.Num();
 
-	// Calculate the duplicate vertices map if we're wanting smooth normals.  Don't find duplicates if we don't want smooth normals
-	// that will cause it to only smooth across faces sharing a common vertex, not across faces with vertices of common position
-	TMultiMap<uint32, uint32> DuplicateVertexMap;
+void RealtimeMeshAlgo::GenerateTangents(TConstArrayView<int32> Indices, TConstArrayView<FVector3f> Positions, TConstArrayView<FVector2f> UVs,
+                                        TArray<FVector3f>& OutNormals, TArray<FVector3f>& OutTangents, TArray<float>& OutBinormalSigns, bool bComputeSmoothNormals)
+{
+	const int32 NumVertices = Positions.Num();
+	OutNormals.SetNumZeroed(NumVertices);
+	OutTangents.SetNumZeroed(NumVertices);
+	OutBinormalSigns.Init(1.0f, NumVertices);
+
+	TArray<int32> CornerOffsets;
+	TArray<int32> Corners;
+	if (!FRealtimeMeshTangentGenerator::BuildAdjacency(Indices, NumVertices, CornerOffsets, Corners))
+	{
+		UE_LOG(LogRealtimeMesh, Warning, TEXT("RealtimeMeshAlgo: Triangles index past the %d vertices, skipping tangent generation"), NumVertices);
+		return;
+	}
+	const FRealtimeMeshTangentGenerator Generator(Indices, CornerOffsets, Corners);
 
 	if (bComputeSmoothNormals)
 	{
 		using namespace Private;
 
+		// Split vertices at the same position share a normal, compute it once on triangles where those vertices are merged.
+		// Positions within Equals tolerance count as the same, found by sweeping the vertices sorted by a weighted sum of their components
 		TArray<FRealtimeMeshVertexSortElement> VertexSorter;
 		VertexSorter.Empty(NumVertices);
-		for (uint32 Index = 0; Index < NumVertices; Index++)
+		for (int32 VertexIdx = 0; VertexIdx < NumVertices; VertexIdx++)
 		{
-			new(VertexSorter)FRealtimeMeshVertexSortElement(Index, Positions[Index]);
+			new(VertexSorter)FRealtimeMeshVertexSortElement(VertexIdx, Positions[VertexIdx]);
 		}
-
-		// Sort the list
 		VertexSorter.Sort(FRuntimeMeshVertexSortingFunction());
 
-		// Map out the duplicates.
-		for (uint32 Index = 0; Index < NumVertices; Index++)
+		TArray<int32> PositionRemap;
+		PositionRemap.Init(INDEX_NONE, NumVertices);
+		for (int32 Index = 0; Index < NumVertices; Index++)
 		{
-			uint32 SrcVertIdx = VertexSorter[Index].Index;
-			float Value = VertexSorter[Index].Value;
+			const int32 SrcVertIdx = VertexSorter[Index].Index;
+			if (PositionRemap[SrcVertIdx] != INDEX_NONE)
+			{
+				continue;
+			}
+			PositionRemap[SrcVertIdx] = SrcVertIdx;
 
-			// Search forward adding pairs both ways
-			for (uint32 SubIndex = Index + 1; SubIndex < NumVertices; SubIndex++)
+			const float Value = VertexSorter[Index].Value;
+			for (int32 SubIndex = Index + 1; SubIndex < NumVertices; SubIndex++)
 			{
 				if (FMath::Abs(VertexSorter[SubIndex].Value - Value) > THRESH_POINTS_ARE_SAME * 4.01f)
 				{
@@ -338,179 +360,630 @@ void RealtimeMeshAlgo::GenerateTangents(RealtimeMesh::FRealtimeMeshStreamSet& St
 					break;
 				}
 
-				uint32 OtherVertIdx = VertexSorter[SubIndex].Index;
-				if (Positions.GetValue(SrcVertIdx).Equals(Positions.GetValue(OtherVertIdx)))
+				const int32 OtherVertIdx = VertexSorter[SubIndex].Index;
+				if (PositionRemap[OtherVertIdx] == INDEX_NONE && Positions[SrcVertIdx].Equals(Positions[OtherVertIdx]))
 				{
-					DuplicateVertexMap.AddUnique(SrcVertIdx, OtherVertIdx);
-					DuplicateVertexMap.AddUnique(OtherVertIdx, SrcVertIdx);
+					PositionRemap[OtherVertIdx] = SrcVertIdx;
 				}
 			}
 		}
+
+		TArray<int32> SmoothIndices;
+		SmoothIndices.SetNumUninitialized(Indices.Num());
+		for (int32 Index = 0; Index < Indices.Num(); Index++)
+		{
+			SmoothIndices[Index] = PositionRemap[Indices[Index]];
+		}
+
+		TArray<int32> SmoothCornerOffsets;
+		TArray<int32> SmoothCorners;
+		FRealtimeMeshTangentGenerator::BuildAdjacency(SmoothIndices, NumVertices, SmoothCornerOffsets, SmoothCorners);
+		FRealtimeMeshTangentGenerator(SmoothIndices, SmoothCornerOffsets, SmoothCorners).ComputeNormals(Positions, OutNormals);
+
+		for (int32 VertexIdx = 0; VertexIdx < NumVertices; VertexIdx++)
+		{
+			OutNormals[VertexIdx] = OutNormals[PositionRemap[VertexIdx]];
+		}
+	}
+	else
+	{
+		Generator.ComputeNormals(Positions, OutNormals);
 	}
 
-	// Number of triangles
-	const uint32 NumTris = NumIndices / 3;
+	Generator.ComputeTangents(Positions, OutNormals, UVs, OutTangents, OutBinormalSigns);
+}
 
-	// Map of vertex to triangles in Triangles array
-	TMultiMap<uint32, uint32> VertToTriMap;
-	// Map of vertex to triangles to consider for normal calculation
-	TMultiMap<uint32, uint32> VertToTriSmoothMap;
+void RealtimeMeshAlgo::GenerateTangents(RealtimeMesh::FRealtimeMeshStreamSet& StreamSet, bool bComputeSmoothNormals)
+{
+	TArray<FVector3f> Positions;
+	TArray<int32> Indices;
+	if (!CopyPositionsAndTriangles(StreamSet, Positions, Indices))
+	{
+		return;
+	}
+
+	TArray<FVector2f> UVs;
+	if (StreamSet.Contains(FRealtimeMeshStreams::TexCoords))
+	{
+		TRealtimeMeshStridedStreamBuilder<FVector2f, void> TexCoords(StreamSet.FindChecked(FRealtimeMeshStreams::TexCoords));
+		UVs.SetNumUninitialized(FMath::Min(TexCoords.Num(), Positions.Num()));
+		for (int32 VertexIdx = 0; VertexIdx < UVs.Num(); VertexIdx++)
+		{
+			UVs[VertexIdx] = TexCoords.GetValue(VertexIdx);
+		}
+	}
+
+	TArray<FVector3f> Normals;
+	TArray<FVector3f> TangentXs;
+	TArray<float> BinormalSigns;
+	GenerateTangents(Indices, Positions, UVs, Normals, TangentXs, BinormalSigns, bComputeSmoothNormals);
 
-	// Normal/tangents for each face
-	TArray<FVector3f> FaceTangentX, FaceTangentY, FaceTangentZ;
-	FaceTangentX.AddUninitialized(NumTris);
-	FaceTangentY.AddUninitialized(NumTris);
-	FaceTangentZ.AddUninitialized(NumTris);
+	StreamSet.Remove(FRealtimeMeshStreams::Tangents);
+	TRealtimeMeshStreamBuilder<FRealtimeMeshTangentsNormalPrecision> Tangents(StreamSet.AddStream<FRealtimeMeshTangentsNormalPrecision>(FRealtimeMeshStreams::Tangents));
+	Tangents.SetNumUninitialized(Positions.Num());
+	ParallelForTemplate(Positions.Num(), [&](int32 VertexIdx)
+	{
+		Tangents.Set(VertexIdx, FRealtimeMeshTangentsNormalPrecision(Normals[VertexIdx], TangentXs[VertexIdx], BinormalSigns[VertexIdx] < 0.0f));
+	}, Positions.Num() < 4096 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+}
 
-	// Iterate over triangles
-	for (uint32 TriIdx = 0; TriIdx < NumTris; TriIdx++)
+namespace RealtimeMeshAlgo::Private
+{
+	// Forsyth, "Linear-Speed Vertex Cache Optimisation"
+	static constexpr int32 ForsythCacheSize = 32;
+	static constexpr int32 ForsythMaxValence = 64;
+	static constexpr float ForsythCacheDecayPower = 1.5f;
+	static constexpr float ForsythLastTriangleScore = 0.75f;
+	static constexpr float ForsythValenceBoostScale = 2.0f;
+	static constexpr float ForsythValenceBoostPower = 0.5f;
+
+	struct FForsythScoreTable
 	{
-		uint32 CornerIndex[3];
-		FVector3f P[3];
+		float CacheScores[ForsythCacheSize];
+		float ValenceScores[ForsythMaxValence + 1];
 
-		for (int32 CornerIdx = 0; CornerIdx < 3; CornerIdx++)
+		FForsythScoreTable()
 		{
-			// Find vert index (clamped within range)
-			uint32 VertIndex = FMath::Min(Triangles.GetElementValue(TriIdx, CornerIdx), NumVertices - 1);
+			for (int32 Position = 0; Position < ForsythCacheSize; Position++)
+			{
+				// The three vertices of the last triangle score the same on purpose, so it doesn't matter which way round they were added
+				CacheScores[Position] = Position < 3
+					? ForsythLastTriangleScore
+					: FMath::Pow(1.0f - float(Position - 3) / (ForsythCacheSize - 3), ForsythCacheDecayPower);
+			}
 
-			CornerIndex[CornerIdx] = VertIndex;
-			P[CornerIdx] = Positions.GetValue(VertIndex);
+			ValenceScores[0] = 0.0f;
+			for (int32 Valence = 1; Valence <= ForsythMaxValence; Valence++)
+			{
+				ValenceScores[Valence] = ForsythValenceBoostScale * FMath::Pow(float(Valence), -ForsythValenceBoostPower);
+			}
+		}
 
-			// Find/add this vert to index buffer
-			TArray<uint32> VertOverlaps;
-			DuplicateVertexMap.MultiFind(VertIndex, VertOverlaps);
+		float GetScore(int32 CachePosition, int32 NumActiveTriangles) const
+		{
+			if (NumActiveTriangles == 0)
+			{
+				return -1.0f;
+			}
+			const float CacheScore = CachePosition >= 0 ? CacheScores[CachePosition] : 0.0f;
+			return CacheScore + ValenceScores[FMath::Min(NumActiveTriangles, ForsythMaxValence)];
+		}
+	};
 
-			// Remember which triangles map to this vert
-			VertToTriMap.AddUnique(VertIndex, TriIdx);
-			VertToTriSmoothMap.AddUnique(VertIndex, TriIdx);
+	/*
+	 * Writes the order to emit the triangles of Indices in, Indices must be in [0, NumVertices)
+	 */
+	static void OptimizeTriangleOrderForsyth(TConstArrayView<int32> Indices, int32 NumVertices, TArrayView<uint32> OutOrder)
+	{
+		static const FForsythScoreTable ScoreTable;
 
-			// Also update map of triangles that 'overlap' this vert (ie don't match UV, but do match smoothing) and should be considered when calculating normal
-			for (int32 OverlapIdx = 0; OverlapIdx < VertOverlaps.Num(); OverlapIdx++)
+		const int32 NumTriangles = Indices.Num() / 3;
+		check(OutOrder.Num() == NumTriangles);
+
+		// Vertex to triangle adjacency in CSR form, the first NumActive entries of each vertex are the triangles not emitted yet
+		TArray<int32> Offsets;
+		Offsets.SetNumZeroed(NumVertices + 1);
+		for (const int32 Index : Indices)
+		{
+			Offsets[Index + 1]++;
+		}
+		for (int32 VertexIdx = 0; VertexIdx < NumVertices; VertexIdx++)
+		{
+			Offsets[VertexIdx + 1] += Offsets[VertexIdx];
+		}
+
+		TArray<int32> NumActive;
+		NumActive.SetNumZeroed(NumVertices);
+		TArray<int32> VertexTriangles;
+		VertexTriangles.SetNumUninitialized(Indices.Num());
+		for (int32 Index = 0; Index < Indices.Num(); Index++)
+		{
+			const int32 VertexIdx = Indices[Index];
+			VertexTriangles[Offsets[VertexIdx] + NumActive[VertexIdx]++] = Index / 3;
+		}
+
+		TArray<int32> CachePositions;
+		CachePositions.Init(INDEX_NONE, NumVertices);
+		TArray<float> VertexScores;
+		VertexScores.SetNumUninitialized(NumVertices);
+		for (int32 VertexIdx = 0; VertexIdx < NumVertices; VertexIdx++)
+		{
+			VertexScores[VertexIdx] = ScoreTable.GetScore(INDEX_NONE, NumActive[VertexIdx]);
+		}
+
+		TArray<float> TriangleScores;
+		TriangleScores.SetNumUninitialized(NumTriangles);
+		for (int32 TriIdx = 0; TriIdx < NumTriangles; TriIdx++)
+		{
+			TriangleScores[TriIdx] = VertexScores[Indices[TriIdx * 3 + 0]] + VertexScores[Indices[TriIdx * 3 + 1]] + VertexScores[Indices[TriIdx * 3 + 2]];
+		}
+
+		TBitArray<> Emitted(false, NumTriangles);
+		int32 Cache[ForsythCacheSize + 3];
+		int32 CacheNum = 0;
+		int32 Cursor = 0;
+		int32 BestTriangle = INDEX_NONE;
+
+		for (int32 OutIdx = 0; OutIdx < NumTriangles; OutIdx++)
+		{
+			if (BestTriangle == INDEX_NONE)
+			{
+				// Dead end, nothing in the cache has triangles left so carry on from the first one not emitted in input order
+				while (Emitted[Cursor])
+				{
+					Cursor++;
+				}
+				BestTriangle = Cursor;
+			}
+
+			OutOrder[OutIdx] = BestTriangle;
+			Emitted[BestTriangle] = true;
+
+			int32 NewCache[ForsythCacheSize + 3];
+			int32 NewCacheNum = 0;
+			for (int32 Corner = 0; Corner < 3; Corner++)
 			{
-				// For each vert we overlap..
-				int32 OverlapVertIdx = VertOverlaps[OverlapIdx];
+				const int32 VertexIdx = Indices[BestTriangle * 3 + Corner];
+
+				int32* ActiveTriangles = &VertexTriangles[Offsets[VertexIdx]];
+				for (int32 Index = 0; Index < NumActive[VertexIdx]; Index++)
+				{
+					if (ActiveTriangles[Index] == BestTriangle)
+					{
+						ActiveTriangles[Index] = ActiveTriangles[--NumActive[VertexIdx]];
+						break;
+					}
+				}
+
+				if (MakeArrayView(NewCache, NewCacheNum).Find(VertexIdx) == INDEX_NONE)
+				{
+					NewCache[NewCacheNum++] = VertexIdx;
+				}
+			}
+
+			const int32 NumTriangleVertices = NewCacheNum;
+			for (int32 Index = 0; Index < CacheNum; Index++)
+			{
+				if (MakeArrayView(NewCache, NumTriangleVertices).Find(Cache[Index]) == INDEX_NONE)
+				{
+					NewCache[NewCacheNum++] = Cache[Index];
+				}
+			}
+
+			// Rescore everything that moved in or fell out of the cache and push the change to its remaining triangles
+			for (int32 Index = 0; Index < NewCacheNum; Index++)
+			{
+				const int32 VertexIdx = NewCache[Index];
+				CachePositions[VertexIdx] = Index < ForsythCacheSize ? Index : INDEX_NONE;
+
+				const float NewScore = ScoreTable.GetScore(CachePositions[VertexIdx], NumActive[VertexIdx]);
+				const float Delta = NewScore - VertexScores[VertexIdx];
+				VertexScores[VertexIdx] = NewScore;
 
-				// Add this triangle to that vert
-				VertToTriSmoothMap.AddUnique(OverlapVertIdx, TriIdx);
+				for (int32 ActiveIdx = 0; ActiveIdx < NumActive[VertexIdx]; ActiveIdx++)
+				{
+					TriangleScores[VertexTriangles[Offsets[VertexIdx] + ActiveIdx]] += Delta;
+				}
+			}
+
+			CacheNum = FMath::Min(NewCacheNum, ForsythCacheSize);
+			FMemory::Memcpy(Cache, NewCache, CacheNum * sizeof(int32));
 
-				// And add all of its triangles to us
-				TArray<uint32> OverlapTris;
-				VertToTriMap.MultiFind(OverlapVertIdx, OverlapTris);
-				for (int32 OverlapTriIdx = 0; OverlapTriIdx < OverlapTris.Num(); OverlapTriIdx++)
+			BestTriangle = INDEX_NONE;
+			float BestScore = -1.0f;
+			for (int32 Index = 0; Index < CacheNum; Index++)
+			{
+				const int32 VertexIdx = Cache[Index];
+				for (int32 ActiveIdx = 0; ActiveIdx < NumActive[VertexIdx]; ActiveIdx++)
 				{
-					VertToTriSmoothMap.AddUnique(VertIndex, OverlapTris[OverlapTriIdx]);
+					const int32 TriIdx = VertexTriangles[Offsets[VertexIdx] + ActiveIdx];
+					if (TriangleScores[TriIdx] > BestScore)
+					{
+						BestScore = TriangleScores[TriIdx];
+						BestTriangle = TriIdx;
+					}
 				}
 			}
 		}
+	}
 
-		// Calculate triangle edge vectors and normal
-		const FVector3f Edge21 = P[1] - P[2];
-		const FVector3f Edge20 = P[0] - P[2];
-		const FVector3f TriNormal = (Edge21 ^ Edge20).GetSafeNormal();
-
-		// If we have UVs, use those to calculate
-		if (TexCoords.IsSet())
-		{
-			const FVector2f T1 = TexCoords->GetValue(CornerIndex[0]);
-			const FVector2f T2 = TexCoords->GetValue(CornerIndex[1]);
-			const FVector2f T3 = TexCoords->GetValue(CornerIndex[2]);
-
-			// 			float X1 = P[1].X - P[0].X;
-			// 			float X2 = P[2].X - P[0].X;
-			// 			float Y1 = P[1].Y - P[0].Y;
-			// 			float Y2 = P[2].Y - P[0].Y;
-			// 			float Z1 = P[1].Z - P[0].Z;
-			// 			float Z2 = P[2].Z - P[0].Z;
-			// 
-			// 			float S1 = U1.X - U0.X;
-			// 			float S2 = U2.X - U0.X;
-			// 			float T1 = U1.Y - U0.Y;
-			// 			float T2 = U2.Y - U0.Y;
-			// 
-			// 			float R = 1.0f / (S1 * T2 - S2 * T1);
-			// 			FaceTangentX[TriIdx] = FVector((T2 * X1 - T1 * X2) * R, (T2 * Y1 - T1 * Y2) * R,
-			// 				(T2 * Z1 - T1 * Z2) * R);
-			// 			FaceTangentY[TriIdx] = FVector((S1 * X2 - S2 * X1) * R, (S1 * Y2 - S2 * Y1) * R,
-			// 				(S1 * Z2 - S2 * Z1) * R);
-
-
-			FMatrix44f ParameterToLocal(
-				FPlane4f(P[1].X - P[0].X, P[1].Y - P[0].Y, P[1].Z - P[0].Z, 0),
-				FPlane4f(P[2].X - P[0].X, P[2].Y - P[0].Y, P[2].Z - P[0].Z, 0),
-				FPlane4f(P[0].X, P[0].Y, P[0].Z, 0),
-				FPlane4f(0, 0, 0, 1)
-			);
-
-			FMatrix44f ParameterToTexture(
-				FPlane4f(T2.X - T1.X, T2.Y - T1.Y, 0, 0),
-				FPlane4f(T3.X - T1.X, T3.Y - T1.Y, 0, 0),
-				FPlane4f(T1.X, T1.Y, 1, 0),
-				FPlane4f(0, 0, 0, 1)
-			);
-
-			// Use InverseSlow to catch singular matrices.  Inverse can miss this sometimes.
-			const FMatrix44f TextureToLocal = ParameterToTexture.Inverse() * ParameterToLocal;
-
-			FaceTangentX[TriIdx] = TextureToLocal.TransformVector(FVector3f(1, 0, 0)).GetSafeNormal();
-			FaceTangentY[TriIdx] = TextureToLocal.TransformVector(FVector3f(0, 1, 0)).GetSafeNormal();
+	template <typename FuncType>
+	static bool VisitIndices(FRealtimeMeshStream& Stream, FuncType&& Func)
+	{
+		const int32 NumIndices = Stream.Num() * Stream.GetNumElements();
+		if (Stream.GetElementType() == GetRealtimeMeshDataElementType<uint16>())
+		{
+			Func(MakeArrayView(reinterpret_cast<uint16*>(Stream.GetData()), NumIndices));
+			return true;
+		}
+		if (Stream.GetElementType() == GetRealtimeMeshDataElementType<int16>())
+		{
+			Func(MakeArrayView(reinterpret_cast<int16*>(Stream.GetData()), NumIndices));
+			return true;
+		}
+		if (Stream.GetElementType() == GetRealtimeMeshDataElementType<uint32>())
+		{
+			Func(MakeArrayView(reinterpret_cast<uint32*>(Stream.GetData()), NumIndices));
+			return true;
+		}
+		if (Stream.GetElementType() == GetRealtimeMeshDataElementType<int32>())
+		{
+			Func(MakeArrayView(reinterpret_cast<int32*>(Stream.GetData()), NumIndices));
+			return true;
+		}
+		return false;
+	}
+
+	static TArray<FRealtimeMeshStream*, TInlineAllocator<4>> GetTriangleStreams(FRealtimeMeshStreamSet& Streams)
+	{
+		TArray<FRealtimeMeshStream*, TInlineAllocator<4>> TriangleStreams;
+		for (const FRealtimeMeshStreamKey* Key : { &FRealtimeMeshStreams::Triangles, &FRealtimeMeshStreams::ReversedTriangles,
+			&FRealtimeMeshStreams::DepthOnlyTriangles, &FRealtimeMeshStreams::ReversedDepthOnlyTriangles })
+		{
+			if (FRealtimeMeshStream* Stream = Streams.Find(*Key))
+			{
+				TriangleStreams.Add(Stream);
+			}
+		}
+		return TriangleStreams;
+	}
+
+	/*
+	 * Finds the vertex streams and the shared vertex count, fails if they disagree on the count or a triangle stream indexes past it
+	 */
+	static bool GatherVertexStreams(FRealtimeMeshStreamSet& Streams, TArray<FRealtimeMeshStream*>& OutVertexStreams, int32& OutNumVertices)
+	{
+		OutNumVertices = INDEX_NONE;
+		bool bConsistent = true;
+		Streams.ForEach([&](FRealtimeMeshStream& Stream)
+		{
+			if (Stream.GetStreamType() == ERealtimeMeshStreamType::Vertex)
+			{
+				bConsistent &= OutNumVertices == INDEX_NONE || OutNumVertices == Stream.Num();
+				OutNumVertices = Stream.Num();
+				OutVertexStreams.Add(&Stream);
+			}
+		});
+
+		if (!bConsistent)
+		{
+			UE_LOG(LogRealtimeMesh, Warning, TEXT("RealtimeMeshAlgo: Vertex streams differ in length, skipping vertex optimization"));
+			return false;
+		}
+		if (OutNumVertices <= 0)
+		{
+			return false;
+		}
+
+		for (FRealtimeMeshStream* TriangleStream : GetTriangleStreams(Streams))
+		{
+			bool bInRange = false;
+			const bool bSupported = VisitIndices(*TriangleStream, [&](auto Indices)
+			{
+				bInRange = Algo::AllOf(Indices, [&](auto Index) { return static_cast<int64>(Index) >= 0 && static_cast<int64>(Index) < OutNumVertices; });
+			});
+
+			if (!bSupported || !bInRange)
+			{
+				UE_LOG(LogRealtimeMesh, Warning, TEXT("RealtimeMeshAlgo: Stream %s has indices outside the vertex streams, skipping vertex optimization"),
+				       *TriangleStream->GetStreamKey().ToString());
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/*
+	 * Rebuilds each vertex stream from the rows listed in NewToOld, in parallel across streams, then remaps the triangle streams
+	 */
+	static void RemapVertices(FRealtimeMeshStreamSet& Streams, TConstArrayView<FRealtimeMeshStream*> VertexStreams, TConstArrayView<uint32> NewToOld,
+	                          TConstArrayView<int32> OldToNew)
+	{
+		ParallelForTemplate(VertexStreams.Num(), [&](int32 StreamIdx)
+		{
+			FRealtimeMeshStream& Stream = *VertexStreams[StreamIdx];
+			const int32 Stride = Stream.GetStride();
+
+			FRealtimeMeshStream NewData(Stream.GetStreamKey(), Stream.GetLayout());
+			NewData.SetNumUninitialized(NewToOld.Num());
+			for (int32 Index = 0; Index < NewToOld.Num(); Index++)
+			{
+				FMemory::Memcpy(NewData.GetData() + Index * Stride, Stream.GetData() + NewToOld[Index] * Stride, Stride);
+			}
+			Stream = MoveTemp(NewData);
+		});
+
+		for (FRealtimeMeshStream* TriangleStream : GetTriangleStreams(Streams))
+		{
+			VisitIndices(*TriangleStream, [&](auto Indices)
+			{
+				using IndexType = typename decltype(Indices)::ElementType;
+				ParallelForTemplate(Indices.Num(), [&](int32 Index)
+				{
+					Indices[Index] = static_cast<IndexType>(OldToNew[Indices[Index]]);
+				}, Indices.Num() < 65536 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+			});
+		}
+	}
+
+	static bool OptimizeTriangleOrder(FRealtimeMeshStreamSet& Streams, const FRealtimeMeshStreamKey& TrianglesKey, const FRealtimeMeshStreamKey& ReversedTrianglesKey,
+	                                  const FRealtimeMeshStreamKey& PolyGroupsKey, const FRealtimeMeshStreamKey& PolyGroupSegmentsKey)
+	{
+		FRealtimeMeshStream* Triangles = Streams.Find(TrianglesKey);
+		if (!Triangles || Triangles->GetNumElements() != 3 || Triangles->Num() == 0)
+		{
+			return false;
+		}
+
+		const int32 NumTriangles = Triangles->Num();
+		TArray<int32> Indices;
+		Indices.SetNumUninitialized(NumTriangles * 3);
+		if (!VisitIndices(*Triangles, [&](auto InIndices)
+		{
+			for (int32 Index = 0; Index < InIndices.Num(); Index++)
+			{
+				Indices[Index] = InIndices[Index];
+			}
+		}))
+		{
+			return false;
+		}
+
+		// Triangles stay inside their polygroup run, so the polygroup streams and section ranges need no update
+		TArray<FRealtimeMeshPolygonGroupRange> Segments;
+		const FRealtimeMeshStream* PolyGroups = Streams.Find(PolyGroupsKey);
+		if (const FRealtimeMeshStream* PolyGroupSegments = Streams.Find(PolyGroupSegmentsKey))
+		{
+			Segments.Append(PolyGroupSegments->GetArrayView<FRealtimeMeshPolygonGroupRange>());
+		}
+		else if (PolyGroups && PolyGroups->Num() == NumTriangles)
+		{
+			GatherSegmentsFromPolygonGroupIndices(*PolyGroups, [&Segments](const FRealtimeMeshPolygonGroupRange& NewSegment)
+			{
+				Segments.Add(NewSegment);
+			});
 		}
 		else
 		{
-			FaceTangentX[TriIdx] = Edge20.GetSafeNormal();
-			FaceTangentY[TriIdx] = (FaceTangentX[TriIdx] ^ TriNormal).GetSafeNormal();
+			Segments.Add(FRealtimeMeshPolygonGroupRange(0, NumTriangles, 0));
+		}
+
+		TArray<uint32> RemapTable;
+		RemapTable.SetNumUninitialized(NumTriangles);
+		for (int32 TriIdx = 0; TriIdx < NumTriangles; TriIdx++)
+		{
+			RemapTable[TriIdx] = TriIdx;
+		}
+
+		ParallelForTemplate(Segments.Num(), [&](int32 SegmentIdx)
+		{
+			const int32 Start = FMath::Clamp(Segments[SegmentIdx].StartIndex, 0, NumTriangles);
+			const int32 Count = FMath::Clamp(Segments[SegmentIdx].Count, 0, NumTriangles - Start);
+			if (Count < 2)
+			{
+				return;
+			}
+
+			// Segments usually cover a compact vertex range, index into it locally so the working set scales with the segment
+			const TConstArrayView<int32> SegmentIndices = MakeArrayView(Indices).Slice(Start * 3, Count * 3);
+			int32 MinVertex = SegmentIndices[0];
+			int32 MaxVertex = SegmentIndices[0];
+			for (const int32 Index : SegmentIndices)
+			{
+				MinVertex = FMath::Min(MinVertex, Index);
+				MaxVertex = FMath::Max(MaxVertex, Index);
+			}
+
+			TArray<int32> LocalIndices;
+			LocalIndices.SetNumUninitialized(SegmentIndices.Num());
+			for (int32 Index = 0; Index < SegmentIndices.Num(); Index++)
+			{
+				LocalIndices[Index] = SegmentIndices[Index] - MinVertex;
+			}
+
+			const TArrayView<uint32> SegmentOrder = MakeArrayView(RemapTable).Slice(Start, Count);
+			OptimizeTriangleOrderForsyth(LocalIndices, MaxVertex - MinVertex + 1, SegmentOrder);
+			for (uint32& TriIdx : SegmentOrder)
+			{
+				TriIdx += Start;
+			}
+		});
+
+		ApplyRemapTableToStream(RemapTable, *Triangles);
+
+		if (FRealtimeMeshStream* ReversedTriangles = Streams.Find(ReversedTrianglesKey))
+		{
+			if (ReversedTriangles->Num() == NumTriangles)
+			{
+				ApplyRemapTableToStream(RemapTable, *ReversedTriangles);
+			}
 		}
+		return true;
+	}
+}
 
-		FaceTangentZ[TriIdx] = TriNormal;
+int32 RealtimeMeshAlgo::WeldVertices(FRealtimeMeshStreamSet& Streams)
+{
+	TArray<FRealtimeMeshStream*> VertexStreams;
+	int32 NumVertices;
+	if (!Private::GatherVertexStreams(Streams, VertexStreams, NumVertices))
+	{
+		return 0;
 	}
 
+	// Hash whole vertices across all streams in parallel, the serial pass below only walks hash chains
+	TArray<uint32> Hashes;
+	Hashes.SetNumUninitialized(NumVertices);
+	ParallelForTemplate(NumVertices, [&](int32 VertexIdx)
+	{
+		uint32 Hash = 0;
+		for (const FRealtimeMeshStream* Stream : VertexStreams)
+		{
+			Hash = FCrc::MemCrc32(Stream->GetDataRawAtVertex(VertexIdx), Stream->GetStride(), Hash);
+		}
+		Hashes[VertexIdx] = Hash;
+	}, NumVertices < 4096 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
 
-	// Arrays to accumulate tangents into
-	TArray<FVector3f> VertexTangentXSum, VertexTangentYSum, VertexTangentZSum;
-	VertexTangentXSum.AddZeroed(NumVertices);
-	VertexTangentYSum.AddZeroed(NumVertices);
-	VertexTangentZSum.AddZeroed(NumVertices);
+	const auto IsSameVertex = [&VertexStreams](int32 A, int32 B)
+	{
+		for (const FRealtimeMeshStream* Stream : VertexStreams)
+		{
+			if (FMemory::Memcmp(Stream->GetDataRawAtVertex(A), Stream->GetDataRawAtVertex(B), Stream->GetStride()) != 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	};
+
+	const int32 NumBuckets = FMath::RoundUpToPowerOfTwo(NumVertices * 2);
+	TArray<int32> BucketHeads;
+	BucketHeads.Init(INDEX_NONE, NumBuckets);
+	TArray<int32> NextInBucket;
+	NextInBucket.SetNumUninitialized(NumVertices);
 
-	// For each vertex..
-	for (uint32 VertxIdx = 0; VertxIdx < NumVertices; VertxIdx++)
+	TArray<int32> OldToNew;
+	OldToNew.SetNumUninitialized(NumVertices);
+	TArray<uint32> NewToOld;
+	NewToOld.Reserve(NumVertices);
+
+	for (int32 VertexIdx = 0; VertexIdx < NumVertices; VertexIdx++)
 	{
-		// Find relevant triangles for normal
-		TArray<uint32> SmoothTris;
-		VertToTriSmoothMap.MultiFind(VertxIdx, SmoothTris);
+		int32& Head = BucketHeads[Hashes[VertexIdx] & (NumBuckets - 1)];
+
+		int32 Match = Head;
+		while (Match != INDEX_NONE && (Hashes[Match] != Hashes[VertexIdx] || !IsSameVertex(Match, VertexIdx)))
+		{
+			Match = NextInBucket[Match];
+		}
 
-		for (int i = 0; i < SmoothTris.Num(); i++)
+		if (Match != INDEX_NONE)
 		{
-			uint32 TriIdx = SmoothTris[i];
-			VertexTangentZSum[VertxIdx] += FaceTangentZ[TriIdx];
+			OldToNew[VertexIdx] = OldToNew[Match];
 		}
+		else
+		{
+			NextInBucket[VertexIdx] = Head;
+			Head = VertexIdx;
+			OldToNew[VertexIdx] = NewToOld.Add(VertexIdx);
+		}
+	}
+
+	const int32 NumRemoved = NumVertices - NewToOld.Num();
+	if (NumRemoved > 0)
+	{
+		Private::RemapVertices(Streams, VertexStreams, NewToOld, OldToNew);
+	}
+	return NumRemoved;
+}
+
+bool RealtimeMeshAlgo::OptimizeTriangleOrder(FRealtimeMeshStreamSet& Streams)
+{
+	const bool bOptimized = Private::OptimizeTriangleOrder(Streams, FRealtimeMeshStreams::Triangles, FRealtimeMeshStreams::ReversedTriangles,
+	                                                       FRealtimeMeshStreams::PolyGroups, FRealtimeMeshStreams::PolyGroupSegments);
+	Private::OptimizeTriangleOrder(Streams, FRealtimeMeshStreams::DepthOnlyTriangles, FRealtimeMeshStreams::ReversedDepthOnlyTriangles,
+	                               FRealtimeMeshStreams::DepthOnlyPolyGroups, FRealtimeMeshStreams::DepthOnlyPolyGroupSegments);
+	return bOptimized;
+}
+
+bool RealtimeMeshAlgo::OptimizeVertexOrder(FRealtimeMeshStreamSet& Streams)
+{
+	TArray<FRealtimeMeshStream*> VertexStreams;
+	int32 NumVertices;
+	if (!Private::GatherVertexStreams(Streams, VertexStreams, NumVertices))
+	{
+		return false;
+	}
+
+	TArray<int32> OldToNew;
+	OldToNew.Init(INDEX_NONE, NumVertices);
+	TArray<uint32> NewToOld;
+	NewToOld.Reserve(NumVertices);
 
-		// Find relevant triangles for tangents
-		TArray<uint32> TangentTris;
-		VertToTriMap.MultiFind(VertxIdx, TangentTris);
+	// Forward triangles first, they are what's drawn most, the other streams mostly reuse the same vertices
+	for (FRealtimeMeshStream* TriangleStream : Private::GetTriangleStreams(Streams))
+	{
+		Private::VisitIndices(*TriangleStream, [&](auto Indices)
+		{
+			for (const auto Index : Indices)
+			{
+				if (OldToNew[Index] == INDEX_NONE)
+				{
+					OldToNew[Index] = NewToOld.Add(Index);
+				}
+			}
+		});
+	}
 
-		for (int i = 0; i < TangentTris.Num(); i++)
+	for (int32 VertexIdx = 0; VertexIdx < NumVertices; VertexIdx++)
+	{
+		if (OldToNew[VertexIdx] == INDEX_NONE)
 		{
-			uint32 TriIdx = TangentTris[i];
-			VertexTangentXSum[VertxIdx] += FaceTangentX[TriIdx];
-			VertexTangentYSum[VertxIdx] += FaceTangentY[TriIdx];
+			OldToNew[VertexIdx] = NewToOld.Add(VertexIdx);
 		}
 	}
 
-	// Finally, normalize tangents and build output arrays	
-	for (uint32 VertxIdx = 0; VertxIdx < NumVertices; VertxIdx++)
+	Private::RemapVertices(Streams, VertexStreams, NewToOld, OldToNew);
+	return true;
+}
+
+bool RealtimeMeshAlgo::OptimizeStreamSet(FRealtimeMeshStreamSet& Streams, bool bWeldVertices)
+{
+	if (bWeldVertices)
 	{
-		FVector3f& TangentX = VertexTangentXSum[VertxIdx];
-		FVector3f& TangentY = VertexTangentYSum[VertxIdx];
-		FVector3f& TangentZ = VertexTangentZSum[VertxIdx];
+		WeldVertices(Streams);
+	}
 
-		TangentX.Normalize();
-		//TangentY.Normalize();
-		TangentZ.Normalize();
+	const bool bOptimizedTriangles = OptimizeTriangleOrder(Streams);
+	const bool bOptimizedVertices = OptimizeVertexOrder(Streams);
+	return bOptimizedTriangles && bOptimizedVertices;
+}
 
-		// Use Gram-Schmidt orthogonalization to make sure X is orthonormal with Z
-		TangentX -= TangentZ * (TangentZ | TangentX);
-		TangentX.Normalize();
-		TangentY.Normalize();
+float RealtimeMeshAlgo::ComputeACMR(TConstArrayView<int32> Indices, int32 CacheSize)
+{
+	const int32 NumTriangles = Indices.Num() / 3;
+	if (NumTriangles == 0)
+	{
+		return 0.0f;
+	}
+
+	int32 MaxIndex = 0;
+	for (const int32 Index : Indices)
+	{
+		MaxIndex = FMath::Max(MaxIndex, Index);
+	}
 
-		Tangents.Set(VertxIdx, FRealtimeMeshTangentsNormalPrecision(TangentZ, TangentY, TangentX));
+	// A vertex is still cached if fewer than CacheSize misses happened since it was last loaded
+	TArray<int32> LoadedAtMiss;
+	LoadedAtMiss.Init(-CacheSize - 1, MaxIndex + 1);
+	int32 NumMisses = 0;
+	for (int32 Index = 0; Index < NumTriangles * 3; Index++)
+	{
+		const int32 VertexIdx = Indices[Index];
+		if (VertexIdx >= 0 && NumMisses - LoadedAtMiss[VertexIdx] > CacheSize)
+		{
+			LoadedAtMiss[VertexIdx] = NumMisses++;
+		}
 	}
+	return float(NumMisses) / NumTriangles;
 }
@@ -5,6 +5,7 @@
 #include "Engine/Engine.h"
 #include "RealtimeMeshComponentModule.h"
 #include "Core/RealtimeMeshDataStream.h"
+#include "Mesh/RealtimeMeshAlgo.h"
 #if RMC_ENGINE_ABOVE_5_2
 #include "Logging/MessageLog.h"
 #endif
@@ -1348,6 +1349,17 @@ URealtimeMeshStreamSet* URealtimeMeshStreamUtils::CopyStreamSetFromComponents(UR
 	return Streams;
 }
 
+URealtimeMeshStreamSet* URealtimeMeshStreamUtils::OptimizeStreamSet(URealtimeMeshStreamSet* Streams, bool bWeldVertices)
+{
+	if (!IsValid(Streams))
+	{
+		return nullptr;
+	}
+
+	RealtimeMeshAlgo::OptimizeStreamSet(Streams->GetStreamSet(), bWeldVertices);
+	return Streams;
+}
+
 const FRealtimeMeshStreamRowPtr& URealtimeMeshStreamUtils::SetIntElement(const FRealtimeMeshStreamRowPtr& Row, int32 Index, int32 ElementIdx, int32 NewValue)
 {
 	if (Row.IsValid() && Row.Stream->IntAccessors.Num() > ElementIdx)
@@ -0,0 +1,252 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#include "Mesh/RealtimeMeshCardRepresentationGenerator.h"
+#include "Mesh/RealtimeMeshAlgo.h"
+#include "Core/RealtimeMeshDataStream.h"
+#include "RealtimeMeshThreadingSubsystem.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+
+namespace RealtimeMesh
+{
+	namespace CardRepresentationGenerator::Private
+	{
+		// Same order as FLumenCardBuildData::AxisAlignedDirectionIndex, -X +X -Y +Y -Z +Z
+		static constexpr int32 NumDirections = 6;
+		static constexpr int32 MaxCardsPerDirection = 16;
+		static constexpr int32 TrianglesPerTask = 4096;
+
+		// Triangles within 60 degrees of a direction are captured by its cards
+		static constexpr float FacingThreshold = 0.5f;
+
+		struct FDirectionLayout
+		{
+			int32 SplitAxis = 0;
+			int32 NumCards = 1;
+			float CardSize = 0.0f;
+		};
+
+		struct FTaskCoverage
+		{
+			float SurfaceArea = 0.0f;
+			float FacingArea[NumDirections] = {};
+			FBox3f CardBounds[NumDirections][MaxCardsPerDirection];
+
+			FTaskCoverage()
+			{
+				for (int32 Direction = 0; Direction < NumDirections; Direction++)
+				{
+					for (int32 Card = 0; Card < MaxCardsPerDirection; Card++)
+					{
+						CardBounds[Direction][Card] = FBox3f(ForceInit);
+					}
+				}
+			}
+		};
+
+		static FVector3f GetDirection(int32 DirectionIndex)
+		{
+			FVector3f Direction = FVector3f::ZeroVector;
+			Direction[DirectionIndex / 2] = (DirectionIndex & 1) ? 1.0f : -1.0f;
+			return Direction;
+		}
+	}
+
+	FRealtimeMeshCardRepresentationGenerator::FRealtimeMeshCardRepresentationGenerator(const FRealtimeMeshCardRepresentationSettings& InSettings)
+		: Settings(InSettings)
+	{
+	}
+
+	bool FRealtimeMeshCardRepresentationGenerator::Build(TConstArrayView<FVector3f> InPositions, TConstArrayView<int32> InIndices, FRealtimeMeshCardRepresentation& OutCardRepresentation) const
+	{
+		using namespace CardRepresentationGenerator::Private;
+
+		const int32 NumTriangles = InIndices.Num() / 3;
+		if (NumTriangles == 0 || InPositions.IsEmpty())
+		{
+			return false;
+		}
+
+		const FBox3f MeshBounds(InPositions.GetData(), InPositions.Num());
+		const FVector3f MeshSize = MeshBounds.GetSize();
+
+		// Split each direction along the longer of its two card axes, so a blade gets a row of cards instead of one thin one
+		const int32 MaxCards = FMath::Clamp(Settings.MaxCardsPerDirection, 1, CardRepresentationGenerator::Private::MaxCardsPerDirection);
+		FDirectionLayout Layouts[NumDirections];
+		for (int32 DirectionIndex = 0; DirectionIndex < NumDirections; DirectionIndex++)
+		{
+			const int32 AxisU = (DirectionIndex / 2 + 1) % 3;
+			const int32 AxisV = (DirectionIndex / 2 + 2) % 3;
+			FDirectionLayout& Layout = Layouts[DirectionIndex];
+			Layout.SplitAxis = MeshSize[AxisU] >= MeshSize[AxisV] ? AxisU : AxisV;
+			const float LongSide = MeshSize[Layout.SplitAxis];
+			const float ShortSide = FMath::Max(MeshSize[Layout.SplitAxis == AxisU ? AxisV : AxisU], UE_KINDA_SMALL_NUMBER);
+			Layout.NumCards = FMath::Clamp(FMath::RoundToInt(LongSide / ShortSide), 1, MaxCards);
+			Layout.CardSize = FMath::Max(LongSide / Layout.NumCards, UE_KINDA_SMALL_NUMBER);
+		}
+
+		const int32 NumTasks = FMath::DivideAndRoundUp(NumTriangles, TrianglesPerTask);
+		TArray<FTaskCoverage> TaskCoverage;
+		TaskCoverage.SetNum(NumTasks);
+
+		ParallelForTemplate(NumTasks, [&](int32 TaskIndex)
+		{
+			FTaskCoverage& Coverage = TaskCoverage[TaskIndex];
+			const int32 EndTriangle = FMath::Min((TaskIndex + 1) * TrianglesPerTask, NumTriangles);
+			for (int32 TriIdx = TaskIndex * TrianglesPerTask; TriIdx < EndTriangle; TriIdx++)
+			{
+				const int32 I0 = InIndices[TriIdx * 3 + 0];
+				const int32 I1 = InIndices[TriIdx * 3 + 1];
+				const int32 I2 = InIndices[TriIdx * 3 + 2];
+				if (!InPositions.IsValidIndex(I0) || !InPositions.IsValidIndex(I1) || !InPositions.IsValidIndex(I2))
+				{
+					continue;
+				}
+
+				const FVector3f& P0 = InPositions[I0];
+				const FVector3f& P1 = InPositions[I1];
+				const FVector3f& P2 = InPositions[I2];
+
+				// Front faces wind clockwise
+				const FVector3f Normal = (P2 - P0) ^ (P1 - P0);
+				const float DoubleArea = Normal.Size();
+				if (DoubleArea <= UE_SMALL_NUMBER)
+				{
+					continue;
+				}
+
+				const float Area = 0.5f * DoubleArea;
+				const FVector3f UnitNormal = Normal / DoubleArea;
+				FBox3f TriangleBounds(ForceInit);
+				TriangleBounds += P0;
+				TriangleBounds += P1;
+				TriangleBounds += P2;
+
+				Coverage.SurfaceArea += Area;
+				for (int32 DirectionIndex = 0; DirectionIndex < NumDirections; DirectionIndex++)
+				{
+					const float AxisNormal = UnitNormal[DirectionIndex / 2];
+					const float Facing = Settings.bTwoSided ? FMath::Abs(AxisNormal) : ((DirectionIndex & 1) ? AxisNormal : -AxisNormal);
+					if (Facing < FacingThreshold)
+					{
+						continue;
+					}
+
+					Coverage.FacingArea[DirectionIndex] += Area * Facing;
+
+					// Large triangles span several cards, each gets the part of the triangle bounds within its slab
+					const FDirectionLayout& Layout = Layouts[DirectionIndex];
+					const int32 Axis = Layout.SplitAxis;
+					const int32 FirstCard = FMath::Clamp(FMath::FloorToInt((TriangleBounds.Min[Axis] - MeshBounds.Min[Axis]) / Layout.CardSize), 0, Layout.NumCards - 1);
+					const int32 LastCard = FMath::Clamp(FMath::FloorToInt((TriangleBounds.Max[Axis] - MeshBounds.Min[Axis]) / Layout.CardSize), 0, Layout.NumCards - 1);
+					for (int32 CardIndex = FirstCard; CardIndex <= LastCard; CardIndex++)
+					{
+						FBox3f SlabBounds = TriangleBounds;
+						SlabBounds.Min[Axis] = FMath::Max(SlabBounds.Min[Axis], MeshBounds.Min[Axis] + CardIndex * Layout.CardSize);
+						SlabBounds.Max[Axis] = FMath::Min(SlabBounds.Max[Axis], MeshBounds.Min[Axis] + (CardIndex + 1) * Layout.CardSize);
+						Coverage.CardBounds[DirectionIndex][CardIndex] += SlabBounds;
+					}
+				}
+			}
+		});
+
+		FTaskCoverage Total;
+		for (const FTaskCoverage& Coverage : TaskCoverage)
+		{
+			Total.SurfaceArea += Coverage.SurfaceArea;
+			for (int32 DirectionIndex = 0; DirectionIndex < NumDirections; DirectionIndex++)
+			{
+				Total.FacingArea[DirectionIndex] += Coverage.FacingArea[DirectionIndex];
+				for (int32 CardIndex = 0; CardIndex < Layouts[DirectionIndex].NumCards; CardIndex++)
+				{
+					Total.CardBounds[DirectionIndex][CardIndex] += Coverage.CardBounds[DirectionIndex][CardIndex];
+				}
+			}
+		}
+
+		if (Total.SurfaceArea <= UE_SMALL_NUMBER)
+		{
+			return false;
+		}
+
+		FCardRepresentationData CardData;
+		CardData.MeshCardsBuildData.Bounds = FBox(MeshBounds);
+#if RMC_ENGINE_ABOVE_5_2
+		CardData.MeshCardsBuildData.bMostlyTwoSided = Settings.bTwoSided;
+#endif
+
+		for (int32 DirectionIndex = 0; DirectionIndex < NumDirections; DirectionIndex++)
+		{
+			if (Total.FacingArea[DirectionIndex] < Settings.MinSurfaceCoverage * Total.SurfaceArea)
+			{
+				continue;
+			}
+
+			for (int32 CardIndex = 0; CardIndex < Layouts[DirectionIndex].NumCards; CardIndex++)
+			{
+				const FBox3f& CardBounds = Total.CardBounds[DirectionIndex][CardIndex];
+				if (!CardBounds.IsValid)
+				{
+					continue;
+				}
+
+				FLumenCardBuildData& Card = CardData.MeshCardsBuildData.CardBuildData.AddDefaulted_GetRef();
+				Card.AxisAlignedDirectionIndex = DirectionIndex;
+				Card.OBB.AxisZ = GetDirection(DirectionIndex);
+				Card.OBB.AxisZ.FindBestAxisVectors(Card.OBB.AxisX, Card.OBB.AxisY);
+				Card.OBB.AxisX = FVector3f::CrossProduct(Card.OBB.AxisZ, Card.OBB.AxisY).GetSafeNormal();
+				Card.OBB.Origin = CardBounds.GetCenter();
+
+				// Padded by a unit like the engine's bounds cards so flat surfaces still get some depth
+				const FVector3f Extent = CardBounds.GetExtent() + FVector3f(1.0f);
+				Card.OBB.Extent = FVector3f(
+					Card.OBB.AxisX.GetAbs() | Extent,
+					Card.OBB.AxisY.GetAbs() | Extent,
+					Card.OBB.AxisZ.GetAbs() | Extent);
+			}
+		}
+
+		if (CardData.MeshCardsBuildData.CardBuildData.IsEmpty())
+		{
+			return false;
+		}
+
+		OutCardRepresentation = FRealtimeMeshCardRepresentation(CardData);
+		return true;
+	}
+
+	bool FRealtimeMeshCardRepresentationGenerator::Build(const FRealtimeMeshStreamSet& Streams, FRealtimeMeshCardRepresentation& OutCardRepresentation) const
+	{
+		TArray<FVector3f> Positions;
+		TArray<int32> Indices;
+		return RealtimeMeshAlgo::CopyPositionsAndTriangles(Streams, Positions, Indices) && Build(Positions, Indices, OutCardRepresentation);
+	}
+
+	TFuture<TOptional<FRealtimeMeshCardRepresentation>> FRealtimeMeshCardRepresentationGenerator::BuildAsync(TArray<FVector3f>&& InPositions, TArray<int32>&& InIndices) const
+	{
+		return URealtimeMeshThreadingSubsystem::Get()->Launch(URealtimeMeshThreadingSubsystem::BackgroundPriority,
+			[Generator = *this, Positions = MoveTemp(InPositions), Indices = MoveTemp(InIndices)]() -> TOptional<FRealtimeMeshCardRepresentation>
+			{
+				FRealtimeMeshCardRepresentation CardRepresentation;
+				if (!Generator.Build(Positions, Indices, CardRepresentation))
+				{
+					return TOptional<FRealtimeMeshCardRepresentation>();
+				}
+				return TOptional<FRealtimeMeshCardRepresentation>(MoveTemp(CardRepresentation));
+			});
+	}
+
+	TFuture<TOptional<FRealtimeMeshCardRepresentation>> FRealtimeMeshCardRepresentationGenerator::BuildAsync(FRealtimeMeshStreamSet&& Streams) const
+	{
+		return URealtimeMeshThreadingSubsystem::Get()->Launch(URealtimeMeshThreadingSubsystem::BackgroundPriority,
+			[Generator = *this, Streams = MoveTemp(Streams)]() -> TOptional<FRealtimeMeshCardRepresentation>
+			{
+				FRealtimeMeshCardRepresentation CardRepresentation;
+				if (!Generator.Build(Streams, CardRepresentation))
+				{
+					return TOptional<FRealtimeMeshCardRepresentation>();
+				}
+				return TOptional<FRealtimeMeshCardRepresentation>(MoveTemp(CardRepresentation));
+			});
+	}
+}
@@ -0,0 +1,471 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#include "Mesh/RealtimeMeshCollisionBVH.h"
+
+namespace RealtimeMesh
+{
+	namespace CollisionBVH::Private
+	{
+		// Past this depth the spatial split is abandoned for a plain count split so degenerate input can't recurse unbounded
+		static constexpr int32 MaxSpatialSplitDepth = 48;
+
+		// Refits never improve the split planes, so once the mesh has been reshaped this many times the tree is rebuilt
+		static constexpr int32 MaxRefitsBeforeRebuild = 256;
+
+		// Closest point on triangle ABC, from Real-Time Collision Detection 5.1.5
+		static FVector3f ClosestPointOnTriangle(const FVector3f& P, const FVector3f& A, const FVector3f& B, const FVector3f& C)
+		{
+			const FVector3f AB = B - A;
+			const FVector3f AC = C - A;
+			const FVector3f AP = P - A;
+			const float D1 = AB | AP;
+			const float D2 = AC | AP;
+			if (D1 <= 0.0f && D2 <= 0.0f)
+			{
+				return A;
+			}
+
+			const FVector3f BP = P - B;
+			const float D3 = AB | BP;
+			const float D4 = AC | BP;
+			if (D3 >= 0.0f && D4 <= D3)
+			{
+				return B;
+			}
+
+			const float VC = D1 * D4 - D3 * D2;
+			if (VC <= 0.0f && D1 >= 0.0f && D3 <= 0.0f)
+			{
+				return A + AB * (D1 / (D1 - D3));
+			}
+
+			const FVector3f CP = P - C;
+			const float D5 = AB | CP;
+			const float D6 = AC | CP;
+			if (D6 >= 0.0f && D5 <= D6)
+			{
+				return C;
+			}
+
+			const float VB = D5 * D2 - D1 * D6;
+			if (VB <= 0.0f && D2 >= 0.0f && D6 <= 0.0f)
+			{
+				return A + AC * (D2 / (D2 - D6));
+			}
+
+			const float VA = D3 * D6 - D5 * D4;
+			if (VA <= 0.0f && (D4 - D3) >= 0.0f && (D5 - D6) >= 0.0f)
+			{
+				return B + (C - B) * ((D4 - D3) / ((D4 - D3) + (D5 - D6)));
+			}
+
+			const float Denominator = 1.0f / (VA + VB + VC);
+			return A + AB * (VB * Denominator) + AC * (VC * Denominator);
+		}
+	}
+
+	void FRealtimeMeshCollisionBVH::Reset()
+	{
+		Nodes.Reset();
+		ParentNodes.Reset();
+		TriangleOrder.Reset();
+		TriangleLeaf.Reset();
+		Positions.Reset();
+		Indices.Reset();
+		VertexTriangleOffsets.Reset();
+		VertexTriangles.Reset();
+		NumRefits = 0;
+	}
+
+	FBox3f FRealtimeMeshCollisionBVH::GetBounds() const
+	{
+		return Nodes.Num() > 0 ? FBox3f(Nodes[0].Min, Nodes[0].Max) : FBox3f(ForceInit);
+	}
+
+	void FRealtimeMeshCollisionBVH::Build(TConstArrayView<FVector3f> InPositions, TConstArrayView<int32> InIndices)
+	{
+		Reset();
+
+		Positions.Append(InPositions);
+		Indices.Append(InIndices.Left(InIndices.Num() - InIndices.Num() % 3));
+
+		const int32 NumVertices = Positions.Num();
+		const int32 NumTris = Indices.Num() / 3;
+		TriangleLeaf.Init(INDEX_NONE, NumTris);
+
+		// Triangles referencing missing vertices are kept in the index copy, so Update can still compare against it, but never enter the tree
+		TArray<FVector3f> Centroids;
+		Centroids.SetNumUninitialized(NumTris);
+		TriangleOrder.Reserve(NumTris);
+		VertexTriangleOffsets.SetNumZeroed(NumVertices + 1);
+		for (int32 Tri = 0; Tri < NumTris; Tri++)
+		{
+			const int32 I0 = Indices[Tri * 3 + 0];
+			const int32 I1 = Indices[Tri * 3 + 1];
+			const int32 I2 = Indices[Tri * 3 + 2];
+			if (!Positions.IsValidIndex(I0) || !Positions.IsValidIndex(I1) || !Positions.IsValidIndex(I2))
+			{
+				continue;
+			}
+
+			Centroids[Tri] = (Positions[I0] + Positions[I1] + Positions[I2]) / 3.0f;
+			TriangleOrder.Add(Tri);
+			VertexTriangleOffsets[I0 + 1]++;
+			VertexTriangleOffsets[I1 + 1]++;
+			VertexTriangleOffsets[I2 + 1]++;
+		}
+
+		for (int32 Vertex = 0; Vertex < NumVertices; Vertex++)
+		{
+			VertexTriangleOffsets[Vertex + 1] += VertexTriangleOffsets[Vertex];
+		}
+
+		VertexTriangles.SetNumUninitialized(VertexTriangleOffsets[NumVertices]);
+		TArray<int32> Cursor(VertexTriangleOffsets.GetData(), NumVertices);
+		for (const int32 Tri : TriangleOrder)
+		{
+			for (int32 Corner = 0; Corner < 3; Corner++)
+			{
+				VertexTriangles[Cursor[Indices[Tri * 3 + Corner]]++] = Tri;
+			}
+		}
+
+		if (TriangleOrder.Num() > 0)
+		{
+			Nodes.Reserve(2 * FMath::DivideAndRoundUp(TriangleOrder.Num(), MaxTrianglesPerLeaf));
+			ParentNodes.Reserve(Nodes.Max());
+			BuildRecursive(INDEX_NONE, 0, TriangleOrder.Num(), 0, Centroids);
+		}
+	}
+
+	int32 FRealtimeMeshCollisionBVH::BuildRecursive(int32 Parent, int32 Begin, int32 End, int32 Depth, TArray<FVector3f>& Centroids)
+	{
+		const int32 NodeIndex = Nodes.AddUninitialized();
+		ParentNodes.Add(Parent);
+
+		const int32 Count = End - Begin;
+		if (Count <= MaxTrianglesPerLeaf)
+		{
+			FNode& Leaf = Nodes[NodeIndex];
+			Leaf.Offset = Begin;
+			Leaf.Count = Count;
+			for (int32 Index = Begin; Index < End; Index++)
+			{
+				TriangleLeaf[TriangleOrder[Index]] = NodeIndex;
+			}
+			ComputeLeafBounds(Leaf);
+			return NodeIndex;
+		}
+
+		// Split at the middle of the centroid bounds on their longest axis
+		FBox3f CentroidBounds(ForceInit);
+		for (int32 Index = Begin; Index < End; Index++)
+		{
+			CentroidBounds += Centroids[TriangleOrder[Index]];
+		}
+		const FVector3f Extent = CentroidBounds.GetSize();
+		const int32 Axis = Extent.X >= Extent.Y ? (Extent.X >= Extent.Z ? 0 : 2) : (Extent.Y >= Extent.Z ? 1 : 2);
+		const float SplitPosition = CentroidBounds.GetCenter()[Axis];
+
+		int32 Mid = Begin;
+		if (Depth < CollisionBVH::Private::MaxSpatialSplitDepth)
+		{
+			for (int32 Index = Begin; Index < End; Index++)
+			{
+				if (Centroids[TriangleOrder[Index]][Axis] < SplitPosition)
+				{
+					Swap(TriangleOrder[Index], TriangleOrder[Mid++]);
+				}
+			}
+		}
+		if (Mid == Begin || Mid == End)
+		{
+			Mid = Begin + Count / 2;
+		}
+
+		Nodes[NodeIndex].Count = 0;
+		const int32 Left = BuildRecursive(NodeIndex, Begin, Mid, Depth + 1, Centroids);
+		const int32 Right = BuildRecursive(NodeIndex, Mid, End, Depth + 1, Centroids);
+
+		FNode& Node = Nodes[NodeIndex];
+		Node.Offset = Right;
+		Node.Min = Nodes[Left].Min.ComponentMin(Nodes[Right].Min);
+		Node.Max = Nodes[Left].Max.ComponentMax(Nodes[Right].Max);
+		return NodeIndex;
+	}
+
+	void FRealtimeMeshCollisionBVH::ComputeLeafBounds(FNode& Node) const
+	{
+		Node.Min = FVector3f(UE_BIG_NUMBER);
+		Node.Max = FVector3f(-UE_BIG_NUMBER);
+		for (int32 Index = Node.Offset; Index < Node.Offset + Node.Count; Index++)
+		{
+			const int32 Tri = TriangleOrder[Index];
+			for (int32 Corner = 0; Corner < 3; Corner++)
+			{
+				const FVector3f& Position = Positions[Indices[Tri * 3 + Corner]];
+				Node.Min = Node.Min.ComponentMin(Position);
+				Node.Max = Node.Max.ComponentMax(Position);
+			}
+		}
+	}
+
+	int32 FRealtimeMeshCollisionBVH::Update(TConstArrayView<FVector3f> InPositions, TConstArrayView<int32> InIndices, FBox3f* OutChangedBounds)
+	{
+		const bool bSameTopology = Nodes.Num() > 0 && InPositions.Num() == Positions.Num() && InIndices.Num() == Indices.Num() &&
+			FMemory::Memcmp(InIndices.GetData(), Indices.GetData(), Indices.Num() * sizeof(int32)) == 0;
+
+		if (!bSameTopology)
+		{
+			Build(InPositions, InIndices);
+			return INDEX_NONE;
+		}
+
+		const int32 NumRefitNodes = Refit(InPositions, OutChangedBounds);
+		if (NumRefits >= CollisionBVH::Private::MaxRefitsBeforeRebuild)
+		{
+			const TArray<FVector3f> CurrentPositions = MoveTemp(Positions);
+			const TArray<int32> CurrentIndices = MoveTemp(Indices);
+			Build(CurrentPositions, CurrentIndices);
+		}
+		return NumRefitNodes;
+	}
+
+	int32 FRealtimeMeshCollisionBVH::Refit(TConstArrayView<FVector3f> InPositions, FBox3f* OutChangedBounds)
+	{
+		// Flag every leaf holding a moved vertex and walk up to the root, stopping at the first ancestor already flagged
+		TBitArray<> DirtyNodes(false, Nodes.Num());
+		int32 NumDirtyLeaves = 0;
+		for (int32 Vertex = 0; Vertex < Positions.Num(); Vertex++)
+		{
+			if (InPositions[Vertex] == Positions[Vertex])
+			{
+				continue;
+			}
+
+			// Moved corners add their old and new position, the others are the same either way
+			if (OutChangedBounds)
+			{
+				*OutChangedBounds += Positions[Vertex];
+				*OutChangedBounds += InPositions[Vertex];
+			}
+
+			Positions[Vertex] = InPositions[Vertex];
+			for (int32 Adjacent = VertexTriangleOffsets[Vertex]; Adjacent < VertexTriangleOffsets[Vertex + 1]; Adjacent++)
+			{
+				const int32 Tri = VertexTriangles[Adjacent];
+				if (OutChangedBounds)
+				{
+					*OutChangedBounds += InPositions[Indices[Tri * 3 + 0]];
+					*OutChangedBounds += InPositions[Indices[Tri * 3 + 1]];
+					*OutChangedBounds += InPositions[Indices[Tri * 3 + 2]];
+				}
+
+				int32 NodeIndex = TriangleLeaf[Tri];
+				NumDirtyLeaves += NodeIndex != INDEX_NONE && !DirtyNodes[NodeIndex];
+				while (NodeIndex != INDEX_NONE && !DirtyNodes[NodeIndex])
+				{
+					DirtyNodes[NodeIndex] = true;
+					NodeIndex = ParentNodes[NodeIndex];
+				}
+			}
+		}
+
+		if (NumDirtyLeaves == 0)
+		{
+			return 0;
+		}
+
+		// Children always sit after their parent, so one backwards pass sees them refit first
+		int32 NumRefitNodes = 0;
+		for (int32 NodeIndex = Nodes.Num() - 1; NodeIndex >= 0; NodeIndex--)
+		{
+			if (!DirtyNodes[NodeIndex])
+			{
+				continue;
+			}
+
+			FNode& Node = Nodes[NodeIndex];
+			if (Node.IsLeaf())
+			{
+				ComputeLeafBounds(Node);
+			}
+			else
+			{
+				const FNode& Left = Nodes[NodeIndex + 1];
+				const FNode& Right = Nodes[Node.Offset];
+				Node.Min = Left.Min.ComponentMin(Right.Min);
+				Node.Max = Left.Max.ComponentMax(Right.Max);
+			}
+			NumRefitNodes++;
+		}
+
+		NumRefits++;
+		return NumRefitNodes;
+	}
+
+	bool FRealtimeMeshCollisionBVH::LineTrace(const FVector3f& Start, const FVector3f& End, FRealtimeMeshCollisionBVHHit& OutHit) const
+	{
+		if (Nodes.IsEmpty())
+		{
+			return false;
+		}
+
+		const FVector3f Direction = End - Start;
+		const FVector3f InvDirection(
+			Direction.X != 0.0f ? 1.0f / Direction.X : UE_BIG_NUMBER,
+			Direction.Y != 0.0f ? 1.0f / Direction.Y : UE_BIG_NUMBER,
+			Direction.Z != 0.0f ? 1.0f / Direction.Z : UE_BIG_NUMBER);
+
+		float BestTime = 1.0f;
+		int32 BestTriangle = INDEX_NONE;
+		FVector3f BestEdge1, BestEdge2;
+
+		TArray<int32, TInlineAllocator<64>> Stack;
+		Stack.Add(0);
+		while (Stack.Num() > 0)
+		{
+			const int32 NodeIndex = Stack.Pop(false);
+			const FNode& Node = Nodes[NodeIndex];
+
+			// Slab test against the node bounds, clipped to the closest hit so far
+			const FVector3f T0 = (Node.Min - Start) * InvDirection;
+			const FVector3f T1 = (Node.Max - Start) * InvDirection;
+			const float TimeEnter = FMath::Max3(FMath::Min(T0.X, T1.X), FMath::Min(T0.Y, T1.Y), FMath::Min(T0.Z, T1.Z));
+			const float TimeExit = FMath::Min3(FMath::Max(T0.X, T1.X), FMath::Max(T0.Y, T1.Y), FMath::Max(T0.Z, T1.Z));
+			if (TimeExit < FMath::Max(TimeEnter, 0.0f) || TimeEnter > BestTime)
+			{
+				continue;
+			}
+
+			if (!Node.IsLeaf())
+			{
+				Stack.Add(Node.Offset);
+				Stack.Add(NodeIndex + 1);
+				continue;
+			}
+
+			for (int32 Index = Node.Offset; Index < Node.Offset + Node.Count; Index++)
+			{
+				const int32 Tri = TriangleOrder[Index];
+				const FVector3f& V0 = Positions[Indices[Tri * 3 + 0]];
+				const FVector3f Edge1 = Positions[Indices[Tri * 3 + 1]] - V0;
+				const FVector3f Edge2 = Positions[Indices[Tri * 3 + 2]] - V0;
+
+				// Moller-Trumbore, accepting either winding
+				const FVector3f P = Direction ^ Edge2;
+				const float Determinant = Edge1 | P;
+				if (FMath::Abs(Determinant) < UE_SMALL_NUMBER)
+				{
+					continue;
+				}
+				const float InvDeterminant = 1.0f / Determinant;
+
+				const FVector3f S = Start - V0;
+				const float U = (S | P) * InvDeterminant;
+				if (U < 0.0f || U > 1.0f)
+				{
+					continue;
+				}
+
+				const FVector3f Q = S ^ Edge1;
+				const float V = (Direction | Q) * InvDeterminant;
+				if (V < 0.0f || U + V > 1.0f)
+				{
+					continue;
+				}
+
+				const float Time = (Edge2 | Q) * InvDeterminant;
+				if (Time >= 0.0f && Time <= BestTime)
+				{
+					BestTime = Time;
+					BestTriangle = Tri;
+					BestEdge1 = Edge1;
+					BestEdge2 = Edge2;
+				}
+			}
+		}
+
+		if (BestTriangle == INDEX_NONE)
+		{
+			return false;
+		}
+
+		const FVector3f FrontNormal = (BestEdge2 ^ BestEdge1).GetSafeNormal();
+		OutHit.Time = BestTime;
+		OutHit.Distance = BestTime * Direction.Size();
+		OutHit.Triangle = BestTriangle;
+		OutHit.Location = Start + Direction * BestTime;
+		OutHit.bBackFace = (FrontNormal | Direction) > 0.0f;
+		// Face the trace start, the hammer only ever cares about the side it strikes
+		OutHit.Normal = OutHit.bBackFace ? -FrontNormal : FrontNormal;
+		return true;
+	}
+
+	bool FRealtimeMeshCollisionBVH::FindClosestPoint(const FVector3f& Point, float MaxDistance, FRealtimeMeshCollisionBVHHit& OutHit) const
+	{
+		if (Nodes.IsEmpty())
+		{
+			return false;
+		}
+
+		float BestDistanceSquared = FMath::Square(MaxDistance);
+		int32 BestTriangle = INDEX_NONE;
+		FVector3f BestPoint;
+
+		TArray<int32, TInlineAllocator<64>> Stack;
+		Stack.Add(0);
+		while (Stack.Num() > 0)
+		{
+			const int32 NodeIndex = Stack.Pop(false);
+			const FNode& Node = Nodes[NodeIndex];
+
+			const FVector3f Outside = (Node.Min - Point).ComponentMax(Point - Node.Max).ComponentMax(FVector3f::ZeroVector);
+			if (Outside.SizeSquared() > BestDistanceSquared)
+			{
+				continue;
+			}
+
+			if (!Node.IsLeaf())
+			{
+				Stack.Add(Node.Offset);
+				Stack.Add(NodeIndex + 1);
+				continue;
+			}
+
+			for (int32 Index = Node.Offset; Index < Node.Offset + Node.Count; Index++)
+			{
+				const int32 Tri = TriangleOrder[Index];
+				const FVector3f Closest = CollisionBVH::Private::ClosestPointOnTriangle(Point,
+					Positions[Indices[Tri * 3 + 0]], Positions[Indices[Tri * 3 + 1]], Positions[Indices[Tri * 3 + 2]]);
+				const float DistanceSquared = FVector3f::DistSquared(Point, Closest);
+				if (DistanceSquared <= BestDistanceSquared)
+				{
+					BestDistanceSquared = DistanceSquared;
+					BestTriangle = Tri;
+					BestPoint = Closest;
+				}
+			}
+		}
+
+		if (BestTriangle == INDEX_NONE)
+		{
+			return false;
+		}
+
+		const FVector3f& V0 = Positions[Indices[BestTriangle * 3 + 0]];
+		OutHit.Time = 0.0f;
+		OutHit.Distance = FMath::Sqrt(BestDistanceSquared);
+		OutHit.Triangle = BestTriangle;
+		OutHit.Location = BestPoint;
+		OutHit.Normal = ((Positions[Indices[BestTriangle * 3 + 2]] - V0) ^ (Positions[Indices[BestTriangle * 3 + 1]] - V0)).GetSafeNormal();
+		OutHit.bBackFace = false;
+		return true;
+	}
+
+	SIZE_T FRealtimeMeshCollisionBVH::GetAllocatedSize() const
+	{
+		return Nodes.GetAllocatedSize() + ParentNodes.GetAllocatedSize() + TriangleOrder.GetAllocatedSize() + TriangleLeaf.GetAllocatedSize() +
+			Positions.GetAllocatedSize() + Indices.GetAllocatedSize() + VertexTriangleOffsets.GetAllocatedSize() + VertexTriangles.GetAllocatedSize();
+	}
+}
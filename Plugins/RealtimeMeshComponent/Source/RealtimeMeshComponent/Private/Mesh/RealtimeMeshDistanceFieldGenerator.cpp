@@ -0,0 +1,351 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#include "Mesh/RealtimeMeshDistanceFieldGenerator.h"
+#include "Mesh/RealtimeMeshDistanceField.h"
+#include "Mesh/RealtimeMeshAlgo.h"
+#include "Core/RealtimeMeshBuilder.h"
+#include "Core/RealtimeMeshDataStream.h"
+#include "Async/ParallelFor.h"
+
+namespace RealtimeMesh
+{
+	namespace DistanceFieldGenerator::Private
+	{
+		static constexpr int32 BrickVoxelCount = DistanceField::BrickSize * DistanceField::BrickSize * DistanceField::BrickSize;
+	}
+
+	FRealtimeMeshDistanceFieldGenerator::FRealtimeMeshDistanceFieldGenerator(const FRealtimeMeshDistanceFieldSettings& InSettings)
+		: Settings(InSettings)
+		, LocalSpaceMeshBounds(ForceInit)
+		, LocalToVolumeScale(1.0f)
+		, InsideTraceLength(0.0f)
+		, NumBricksComputed(0)
+	{
+	}
+
+	void FRealtimeMeshDistanceFieldGenerator::Reset()
+	{
+		BVH.Reset();
+		LocalSpaceMeshBounds = FBox3f(ForceInit);
+		for (FMip& Mip : Mips)
+		{
+			Mip = FMip();
+		}
+		NumBricksComputed = 0;
+	}
+
+	int32 FRealtimeMeshDistanceFieldGenerator::GetNumBricks() const
+	{
+		int32 NumBricks = 0;
+		for (const FMip& Mip : Mips)
+		{
+			NumBricks += Mip.NumBricks();
+		}
+		return NumBricks;
+	}
+
+	bool FRealtimeMeshDistanceFieldGenerator::Build(TConstArrayView<FVector3f> InPositions, TConstArrayView<int32> InIndices, FRealtimeMeshDistanceField& OutDistanceField)
+	{
+		NumBricksComputed = 0;
+		BVH.Build(InPositions, InIndices);
+		if (BVH.IsEmpty())
+		{
+			Reset();
+			return false;
+		}
+
+		SetupVolume();
+		for (FMip& Mip : Mips)
+		{
+			ComputeBricks(Mip, nullptr);
+		}
+		WriteDistanceField(OutDistanceField);
+		return true;
+	}
+
+	bool FRealtimeMeshDistanceFieldGenerator::Build(const FRealtimeMeshStreamSet& Streams, FRealtimeMeshDistanceField& OutDistanceField)
+	{
+		TArray<FVector3f> Positions;
+		TArray<int32> Indices;
+		return RealtimeMeshAlgo::CopyPositionsAndTriangles(Streams, Positions, Indices) && Build(Positions, Indices, OutDistanceField);
+	}
+
+	bool FRealtimeMeshDistanceFieldGenerator::Update(TConstArrayView<FVector3f> InPositions, TConstArrayView<int32> InIndices, FRealtimeMeshDistanceField& OutDistanceField)
+	{
+		if (BVH.IsEmpty())
+		{
+			return Build(InPositions, InIndices, OutDistanceField);
+		}
+
+		FBox3f ChangedBounds(ForceInit);
+		const int32 NumRefitNodes = BVH.Update(InPositions, InIndices, &ChangedBounds);
+		if (NumRefitNodes == INDEX_NONE || !LocalSpaceMeshBounds.IsInsideOrOn(BVH.GetBounds()))
+		{
+			return Build(InPositions, InIndices, OutDistanceField);
+		}
+
+		NumBricksComputed = 0;
+		if (ChangedBounds.IsValid)
+		{
+			for (FMip& Mip : Mips)
+			{
+				ComputeBricks(Mip, &ChangedBounds);
+			}
+		}
+		WriteDistanceField(OutDistanceField);
+		return true;
+	}
+
+	bool FRealtimeMeshDistanceFieldGenerator::Update(const FRealtimeMeshStreamSet& Streams, FRealtimeMeshDistanceField& OutDistanceField)
+	{
+		TArray<FVector3f> Positions;
+		TArray<int32> Indices;
+		return RealtimeMeshAlgo::CopyPositionsAndTriangles(Streams, Positions, Indices) && Update(Positions, Indices, OutDistanceField);
+	}
+
+	void FRealtimeMeshDistanceFieldGenerator::SetupVolume()
+	{
+		// Same volume layout as the engine's mesh distance field build, so the renderer samples it the same way
+		const FBox3f MeshBounds = BVH.GetBounds();
+		const FVector3f MeshExtent = FVector3f::Max(MeshBounds.GetExtent() * (1.0f + Settings.BoundsSlack), FVector3f(1.0f));
+		LocalSpaceMeshBounds = FBox3f(MeshBounds.GetCenter() - MeshExtent, MeshBounds.GetCenter() + MeshExtent);
+
+		// Volume space is normalized by the largest extent to stay within [-1, 1]
+		LocalToVolumeScale = 1.0f / LocalSpaceMeshBounds.GetExtent().GetMax();
+		InsideTraceLength = LocalSpaceMeshBounds.GetSize().Size() * 2.0f;
+
+		const FVector3f DesiredDimensions = LocalSpaceMeshBounds.GetSize() * (Settings.VoxelDensity / DistanceField::UniqueDataBrickSize);
+		const FIntVector Mip0IndirectionDimensions(
+			FMath::Clamp(FMath::RoundToInt(DesiredDimensions.X), 1, (int32)DistanceField::MaxIndirectionDimension),
+			FMath::Clamp(FMath::RoundToInt(DesiredDimensions.Y), 1, (int32)DistanceField::MaxIndirectionDimension),
+			FMath::Clamp(FMath::RoundToInt(DesiredDimensions.Z), 1, (int32)DistanceField::MaxIndirectionDimension));
+
+		for (int32 MipIndex = 0; MipIndex < DistanceField::NumMips; MipIndex++)
+		{
+			FMip& Mip = Mips[MipIndex];
+			Mip.IndirectionDimensions = FIntVector(
+				FMath::DivideAndRoundUp(Mip0IndirectionDimensions.X, 1 << MipIndex),
+				FMath::DivideAndRoundUp(Mip0IndirectionDimensions.Y, 1 << MipIndex),
+				FMath::DivideAndRoundUp(Mip0IndirectionDimensions.Z, 1 << MipIndex));
+
+			// One voxel border for gradient reconstruction with bilinear filtering
+			const FIntVector VoxelDimensions = Mip.IndirectionDimensions * DistanceField::UniqueDataBrickSize;
+			const FVector3f TexelObjectSpaceSize = LocalSpaceMeshBounds.GetSize() / FVector3f(VoxelDimensions - FIntVector(2 * DistanceField::MeshDistanceFieldObjectBorder));
+			Mip.VolumeBounds = LocalSpaceMeshBounds.ExpandBy(TexelObjectSpaceSize);
+			Mip.IndirectionVoxelSize = Mip.VolumeBounds.GetSize() / FVector3f(Mip.IndirectionDimensions);
+
+			// The stored magnitude covers a fixed number of voxels either side of the surface
+			const FVector3f VolumeSpaceVoxelSize = Mip.IndirectionVoxelSize * LocalToVolumeScale / (float)DistanceField::UniqueDataBrickSize;
+			const float MaxDistanceForEncoding = VolumeSpaceVoxelSize.Size() * DistanceField::BandSizeInVoxels;
+			Mip.LocalSpaceTraceDistance = MaxDistanceForEncoding / LocalToVolumeScale;
+			Mip.DistanceFieldToVolumeScaleBias = FVector2f(2.0f * MaxDistanceForEncoding, -MaxDistanceForEncoding);
+
+			// [-VolumeSpaceExtent, VolumeSpaceExtent] maps to the virtual UVs inside the border
+			const FVector3f VirtualUVMin = FVector3f((float)DistanceField::MeshDistanceFieldObjectBorder) / FVector3f(VoxelDimensions);
+			const FVector3f VirtualUVSize = FVector3f(VoxelDimensions - FIntVector(2 * DistanceField::MeshDistanceFieldObjectBorder)) / FVector3f(VoxelDimensions);
+			const FVector3f VolumeSpaceExtent = LocalSpaceMeshBounds.GetExtent() * LocalToVolumeScale;
+			Mip.VolumeToVirtualUVScale = VirtualUVSize / (2.0f * VolumeSpaceExtent);
+			Mip.VolumeToVirtualUVAdd = VolumeSpaceExtent * Mip.VolumeToVirtualUVScale + VirtualUVMin;
+
+			Mip.BrickVoxels.SetNumUninitialized(Mip.NumBricks() * DistanceFieldGenerator::Private::BrickVoxelCount);
+			Mip.ValidBricks.SetNumZeroed(Mip.NumBricks());
+		}
+	}
+
+	void FRealtimeMeshDistanceFieldGenerator::ComputeBricks(FMip& Mip, const FBox3f* ChangedBounds)
+	{
+		TArray<int32> BricksToCompute;
+		if (ChangedBounds)
+		{
+			// Voxels further than the band from every moved triangle keep their clamped value
+			const FBox3f AffectedBounds = ChangedBounds->ExpandBy(Mip.LocalSpaceTraceDistance);
+			// Neighbouring bricks share their border voxels, so one extra brick on the low side
+			const FIntVector MinBrick(
+				FMath::Max(FMath::FloorToInt((AffectedBounds.Min.X - Mip.VolumeBounds.Min.X) / Mip.IndirectionVoxelSize.X) - 1, 0),
+				FMath::Max(FMath::FloorToInt((AffectedBounds.Min.Y - Mip.VolumeBounds.Min.Y) / Mip.IndirectionVoxelSize.Y) - 1, 0),
+				FMath::Max(FMath::FloorToInt((AffectedBounds.Min.Z - Mip.VolumeBounds.Min.Z) / Mip.IndirectionVoxelSize.Z) - 1, 0));
+			const FIntVector MaxBrick(
+				FMath::Min(FMath::FloorToInt((AffectedBounds.Max.X - Mip.VolumeBounds.Min.X) / Mip.IndirectionVoxelSize.X), Mip.IndirectionDimensions.X - 1),
+				FMath::Min(FMath::FloorToInt((AffectedBounds.Max.Y - Mip.VolumeBounds.Min.Y) / Mip.IndirectionVoxelSize.Y), Mip.IndirectionDimensions.Y - 1),
+				FMath::Min(FMath::FloorToInt((AffectedBounds.Max.Z - Mip.VolumeBounds.Min.Z) / Mip.IndirectionVoxelSize.Z), Mip.IndirectionDimensions.Z - 1));
+
+			for (int32 Z = MinBrick.Z; Z <= MaxBrick.Z; Z++)
+			{
+				for (int32 Y = MinBrick.Y; Y <= MaxBrick.Y; Y++)
+				{
+					for (int32 X = MinBrick.X; X <= MaxBrick.X; X++)
+					{
+						BricksToCompute.Add((Z * Mip.IndirectionDimensions.Y + Y) * Mip.IndirectionDimensions.X + X);
+					}
+				}
+			}
+		}
+		else
+		{
+			BricksToCompute.SetNumUninitialized(Mip.NumBricks());
+			for (int32 BrickIndex = 0; BrickIndex < BricksToCompute.Num(); BrickIndex++)
+			{
+				BricksToCompute[BrickIndex] = BrickIndex;
+			}
+		}
+
+		ParallelForTemplate(BricksToCompute.Num(), [this, &Mip, &BricksToCompute](int32 Index)
+		{
+			const int32 BrickIndex = BricksToCompute[Index];
+			Mip.ValidBricks[BrickIndex] = ComputeBrick(Mip, BrickIndex, &Mip.BrickVoxels[BrickIndex * DistanceFieldGenerator::Private::BrickVoxelCount]);
+		});
+
+		NumBricksComputed += BricksToCompute.Num();
+	}
+
+	bool FRealtimeMeshDistanceFieldGenerator::ComputeBrick(const FMip& Mip, int32 BrickIndex, uint8* OutVoxels) const
+	{
+		const FIntVector BrickCoordinate(
+			BrickIndex % Mip.IndirectionDimensions.X,
+			(BrickIndex / Mip.IndirectionDimensions.X) % Mip.IndirectionDimensions.Y,
+			BrickIndex / (Mip.IndirectionDimensions.X * Mip.IndirectionDimensions.Y));
+		const FVector3f VoxelSize = Mip.IndirectionVoxelSize / (float)DistanceField::UniqueDataBrickSize;
+		const FVector3f BrickMin = Mip.VolumeBounds.Min + FVector3f(BrickCoordinate) * Mip.IndirectionVoxelSize;
+
+		// Bricks with no surface inside the band are never stored, skip them without touching the voxels
+		const FVector3f BrickHalfSize = Mip.IndirectionVoxelSize * 0.5f;
+		FRealtimeMeshCollisionBVHHit Hit;
+		if (!BVH.FindClosestPoint(BrickMin + BrickHalfSize, BrickHalfSize.Size() + Mip.LocalSpaceTraceDistance, Hit))
+		{
+			return false;
+		}
+
+		uint8 BrickMinDistance = MAX_uint8;
+		uint8 BrickMaxDistance = MIN_uint8;
+		for (int32 ZIndex = 0; ZIndex < DistanceField::BrickSize; ZIndex++)
+		{
+			for (int32 YIndex = 0; YIndex < DistanceField::BrickSize; YIndex++)
+			{
+				for (int32 XIndex = 0; XIndex < DistanceField::BrickSize; XIndex++)
+				{
+					const FVector3f VoxelPosition = BrickMin + FVector3f((float)XIndex, (float)YIndex, (float)ZIndex) * VoxelSize;
+
+					float Distance = Mip.LocalSpaceTraceDistance;
+					if (BVH.FindClosestPoint(VoxelPosition, Mip.LocalSpaceTraceDistance, Hit))
+					{
+						Distance = Hit.Distance;
+					}
+					if (!Settings.bTwoSided && IsInside(VoxelPosition))
+					{
+						Distance = -Distance;
+					}
+
+					const float VolumeSpaceDistance = Distance * LocalToVolumeScale;
+					const float RescaledDistance = (VolumeSpaceDistance - Mip.DistanceFieldToVolumeScaleBias.Y) / Mip.DistanceFieldToVolumeScaleBias.X;
+					const uint8 QuantizedDistance = (uint8)FMath::Clamp<int32>(FMath::FloorToInt(RescaledDistance * 255.0f + 0.5f), 0, 255);
+
+					OutVoxels[(ZIndex * DistanceField::BrickSize + YIndex) * DistanceField::BrickSize + XIndex] = QuantizedDistance;
+					BrickMinDistance = FMath::Min(BrickMinDistance, QuantizedDistance);
+					BrickMaxDistance = FMath::Max(BrickMaxDistance, QuantizedDistance);
+				}
+			}
+		}
+
+		// Only bricks the surface passes through are worth storing
+		return BrickMinDistance < MAX_uint8 && BrickMaxDistance > MIN_uint8;
+	}
+
+	bool FRealtimeMeshDistanceFieldGenerator::IsInside(const FVector3f& Point) const
+	{
+		// Majority vote of axis rays, a ray leaving through a back face started inside. Tolerates small holes and
+		// the odd ray grazing an edge.
+		static const FVector3f Directions[] = {
+			FVector3f(1, 0, 0), FVector3f(-1, 0, 0), FVector3f(0, 1, 0), FVector3f(0, -1, 0), FVector3f(0, 0, 1), FVector3f(0, 0, -1)
+		};
+		constexpr int32 NumDirections = UE_ARRAY_COUNT(Directions);
+
+		int32 InsideVotes = 0;
+		int32 OutsideVotes = 0;
+		for (const FVector3f& Direction : Directions)
+		{
+			FRealtimeMeshCollisionBVHHit Hit;
+			if (BVH.LineTrace(Point, Point + Direction * InsideTraceLength, Hit) && Hit.bBackFace)
+			{
+				InsideVotes++;
+			}
+			else
+			{
+				OutsideVotes++;
+			}
+
+			if (InsideVotes > NumDirections / 2 || OutsideVotes >= NumDirections / 2)
+			{
+				break;
+			}
+		}
+		return InsideVotes > NumDirections / 2;
+	}
+
+	void FRealtimeMeshDistanceFieldGenerator::WriteDistanceField(FRealtimeMeshDistanceField& OutDistanceField) const
+	{
+		using namespace DistanceFieldGenerator::Private;
+
+		FDistanceFieldVolumeData VolumeData;
+		TArray<uint8> StreamableMipData;
+
+		// Each mip is its indirection table followed by the stored bricks, the coarsest one is always loaded
+		for (int32 MipIndex = 0; MipIndex < DistanceField::NumMips; MipIndex++)
+		{
+			const FMip& Mip = Mips[MipIndex];
+
+			TArray<uint32> IndirectionTable;
+			IndirectionTable.Init(DistanceField::InvalidBrickIndex, Mip.NumBricks());
+			int32 NumValidBricks = 0;
+			for (int32 BrickIndex = 0; BrickIndex < Mip.NumBricks(); BrickIndex++)
+			{
+				if (Mip.ValidBricks[BrickIndex])
+				{
+					IndirectionTable[BrickIndex] = NumValidBricks++;
+				}
+			}
+
+			TArray<uint8> MipData;
+			MipData.Reserve(IndirectionTable.Num() * IndirectionTable.GetTypeSize() + NumValidBricks * BrickVoxelCount);
+			MipData.Append(reinterpret_cast<const uint8*>(IndirectionTable.GetData()), IndirectionTable.Num() * IndirectionTable.GetTypeSize());
+			for (int32 BrickIndex = 0; BrickIndex < Mip.NumBricks(); BrickIndex++)
+			{
+				if (Mip.ValidBricks[BrickIndex])
+				{
+					MipData.Append(&Mip.BrickVoxels[BrickIndex * BrickVoxelCount], BrickVoxelCount);
+				}
+			}
+
+			FSparseDistanceFieldMip& OutMip = VolumeData.Mips[MipIndex];
+			OutMip.IndirectionDimensions = Mip.IndirectionDimensions;
+			OutMip.NumDistanceFieldBricks = NumValidBricks;
+			OutMip.VolumeToVirtualUVScale = Mip.VolumeToVirtualUVScale;
+			OutMip.VolumeToVirtualUVAdd = Mip.VolumeToVirtualUVAdd;
+			OutMip.DistanceFieldToVolumeScaleBias = Mip.DistanceFieldToVolumeScaleBias;
+
+			if (MipIndex == DistanceField::NumMips - 1)
+			{
+				VolumeData.AlwaysLoadedMip = MoveTemp(MipData);
+			}
+			else
+			{
+				OutMip.BulkOffset = StreamableMipData.Num();
+				OutMip.BulkSize = MipData.Num();
+				StreamableMipData.Append(MipData);
+			}
+		}
+
+#if RMC_ENGINE_ABOVE_5_4
+		VolumeData.LocalSpaceMeshBounds = LocalSpaceMeshBounds;
+#else
+		VolumeData.LocalSpaceMeshBounds = FBox(LocalSpaceMeshBounds);
+#endif
+		VolumeData.bMostlyTwoSided = Settings.bTwoSided;
+
+		VolumeData.StreamableMips.Lock(LOCK_READ_WRITE);
+		void* StreamableMipsMemory = VolumeData.StreamableMips.Realloc(StreamableMipData.Num());
+		FMemory::Memcpy(StreamableMipsMemory, StreamableMipData.GetData(), StreamableMipData.Num());
+		VolumeData.StreamableMips.Unlock();
+
+		OutDistanceField = FRealtimeMeshDistanceField(VolumeData);
+	}
+}
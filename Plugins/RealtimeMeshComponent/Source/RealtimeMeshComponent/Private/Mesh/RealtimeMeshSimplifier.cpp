@@ -0,0 +1,435 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#include "Mesh/RealtimeMeshSimplifier.h"
+#include "Mesh/RealtimeMeshAlgo.h"
+#include "Core/RealtimeMeshBuilder.h"
+
+namespace RealtimeMesh
+{
+	namespace Simplifier::Private
+	{
+		static uint64 MakeEdgeKey(int32 A, int32 B)
+		{
+			return A < B ? (uint64(A) << 32) | uint32(B) : (uint64(B) << 32) | uint32(A);
+		}
+
+		static FVector3f GetTriangleNormal(const FVector3f& P0, const FVector3f& P1, const FVector3f& P2)
+		{
+			// Front faces wind clockwise
+			return (P2 - P0) ^ (P1 - P0);
+		}
+	}
+
+	void FRealtimeMeshSimplifier::FQuadric::AddPlane(const FVector3f& Normal, float Distance, float InWeight)
+	{
+		const double NX = Normal.X, NY = Normal.Y, NZ = Normal.Z, D = Distance, W = InWeight;
+		A00 += W * NX * NX; A01 += W * NX * NY; A02 += W * NX * NZ;
+		A11 += W * NY * NY; A12 += W * NY * NZ; A22 += W * NZ * NZ;
+		B0 += W * NX * D; B1 += W * NY * D; B2 += W * NZ * D;
+		C += W * D * D;
+		Weight += W;
+	}
+
+	void FRealtimeMeshSimplifier::FQuadric::Add(const FQuadric& Other)
+	{
+		A00 += Other.A00; A01 += Other.A01; A02 += Other.A02;
+		A11 += Other.A11; A12 += Other.A12; A22 += Other.A22;
+		B0 += Other.B0; B1 += Other.B1; B2 += Other.B2;
+		C += Other.C;
+		Weight += Other.Weight;
+	}
+
+	double FRealtimeMeshSimplifier::FQuadric::Evaluate(const FVector3f& Point) const
+	{
+		const double X = Point.X, Y = Point.Y, Z = Point.Z;
+		return A00 * X * X + 2.0 * A01 * X * Y + 2.0 * A02 * X * Z
+			+ A11 * Y * Y + 2.0 * A12 * Y * Z + A22 * Z * Z
+			+ 2.0 * (B0 * X + B1 * Y + B2 * Z) + C;
+	}
+
+	FRealtimeMeshSimplifier::FRealtimeMeshSimplifier(const FRealtimeMeshStreamSet& InSource)
+		: Source(InSource)
+		, NumSourceTriangles(0)
+		, PolyGroups(nullptr)
+		, Error(0.0f)
+	{
+		if (!RealtimeMeshAlgo::CopyPositionsAndTriangles(Source, Positions, Indices))
+		{
+			Positions.Empty();
+			Indices.Empty();
+			return;
+		}
+
+		// Drop triangles referencing missing vertices rather than reading out of bounds later
+		NumSourceTriangles = Indices.Num() / 3;
+		SourceTriangles.SetNumUninitialized(NumSourceTriangles);
+		int32 NumValid = 0;
+		for (int32 TriIdx = 0; TriIdx < NumSourceTriangles; TriIdx++)
+		{
+			const int32 V0 = Indices[TriIdx * 3 + 0], V1 = Indices[TriIdx * 3 + 1], V2 = Indices[TriIdx * 3 + 2];
+			if (Positions.IsValidIndex(V0) && Positions.IsValidIndex(V1) && Positions.IsValidIndex(V2))
+			{
+				Indices[NumValid * 3 + 0] = V0;
+				Indices[NumValid * 3 + 1] = V1;
+				Indices[NumValid * 3 + 2] = V2;
+				SourceTriangles[NumValid++] = TriIdx;
+			}
+		}
+		Indices.SetNum(NumValid * 3);
+		SourceTriangles.SetNum(NumValid);
+
+		const FRealtimeMeshStream* PolyGroupStream = Source.Find(FRealtimeMeshStreams::PolyGroups);
+		if (PolyGroupStream && PolyGroupStream->Num() >= NumSourceTriangles)
+		{
+			PolyGroups = PolyGroupStream;
+		}
+
+		Quadrics.SetNum(Positions.Num());
+		for (int32 TriIdx = 0; TriIdx < GetNumTriangles(); TriIdx++)
+		{
+			const int32* Tri = &Indices[TriIdx * 3];
+			const FVector3f Normal = Simplifier::Private::GetTriangleNormal(Positions[Tri[0]], Positions[Tri[1]], Positions[Tri[2]]);
+			const float DoubleArea = Normal.Length();
+			if (DoubleArea <= UE_SMALL_NUMBER)
+			{
+				continue;
+			}
+
+			// Area weighted so a fine region does not outvote the large faces it borders
+			const FVector3f UnitNormal = Normal / DoubleArea;
+			const float Distance = -(UnitNormal | Positions[Tri[0]]);
+			for (int32 Corner = 0; Corner < 3; Corner++)
+			{
+				Quadrics[Tri[Corner]].AddPlane(UnitNormal, Distance, DoubleArea * 0.5f);
+			}
+		}
+
+		LockBoundaryVertices();
+	}
+
+	void FRealtimeMeshSimplifier::LockBoundaryVertices()
+	{
+		using namespace Simplifier::Private;
+
+		LockedVertices.Init(false, Positions.Num());
+
+		// Edges used by a single triangle are open borders or seams, seams are split in index space so both sides show up here
+		TMap<uint64, int32> EdgeCounts;
+		EdgeCounts.Reserve(Indices.Num());
+		for (int32 TriIdx = 0; TriIdx < GetNumTriangles(); TriIdx++)
+		{
+			const int32* Tri = &Indices[TriIdx * 3];
+			for (int32 Corner = 0; Corner < 3; Corner++)
+			{
+				EdgeCounts.FindOrAdd(MakeEdgeKey(Tri[Corner], Tri[(Corner + 1) % 3]))++;
+			}
+		}
+		for (const TPair<uint64, int32>& Edge : EdgeCounts)
+		{
+			if (Edge.Value != 2)
+			{
+				LockedVertices[int32(Edge.Key >> 32)] = true;
+				LockedVertices[int32(Edge.Key & 0xFFFFFFFF)] = true;
+			}
+		}
+
+		// Vertices shared between polygroups hold the boundary between their sections in place
+		if (PolyGroups)
+		{
+			BuildAdjacency();
+			for (int32 VertIdx = 0; VertIdx < Positions.Num(); VertIdx++)
+			{
+				const int32 Begin = VertexTriangleOffsets[VertIdx];
+				const int32 End = VertexTriangleOffsets[VertIdx + 1];
+				for (int32 Index = Begin + 1; Index < End && !LockedVertices[VertIdx]; Index++)
+				{
+					if (!HaveSamePolyGroup(VertexTriangles[Begin], VertexTriangles[Index]))
+					{
+						LockedVertices[VertIdx] = true;
+					}
+				}
+			}
+		}
+	}
+
+	bool FRealtimeMeshSimplifier::HaveSamePolyGroup(int32 TriangleA, int32 TriangleB) const
+	{
+		return !PolyGroups || FMemory::Memcmp(
+			PolyGroups->GetDataRawAtVertex(SourceTriangles[TriangleA]),
+			PolyGroups->GetDataRawAtVertex(SourceTriangles[TriangleB]),
+			PolyGroups->GetStride()) == 0;
+	}
+
+	void FRealtimeMeshSimplifier::BuildAdjacency()
+	{
+		VertexTriangleOffsets.SetNumZeroed(Positions.Num() + 1);
+		for (const int32 VertIdx : Indices)
+		{
+			VertexTriangleOffsets[VertIdx + 1]++;
+		}
+		for (int32 VertIdx = 0; VertIdx < Positions.Num(); VertIdx++)
+		{
+			VertexTriangleOffsets[VertIdx + 1] += VertexTriangleOffsets[VertIdx];
+		}
+
+		TArray<int32> Cursors(VertexTriangleOffsets.GetData(), Positions.Num());
+		VertexTriangles.SetNumUninitialized(Indices.Num());
+		for (int32 Index = 0; Index < Indices.Num(); Index++)
+		{
+			VertexTriangles[Cursors[Indices[Index]]++] = Index / 3;
+		}
+	}
+
+	float FRealtimeMeshSimplifier::GetCollapseCost(int32 From, int32 To) const
+	{
+		FQuadric Quadric = Quadrics[From];
+		Quadric.Add(Quadrics[To]);
+		if (Quadric.Weight <= 0.0)
+		{
+			return 0.0f;
+		}
+		// Area weighted mean squared distance to the planes of the merged triangles, as a distance
+		return static_cast<float>(FMath::Sqrt(FMath::Max(0.0, Quadric.Evaluate(Positions[To])) / Quadric.Weight));
+	}
+
+	bool FRealtimeMeshSimplifier::IsCollapseAllowed(int32 From, int32 To) const
+	{
+		using namespace Simplifier::Private;
+
+		// Link condition, From and To may share only the two vertices opposite their edge or the collapse pinches the surface
+		TArray<int32, TInlineAllocator<32>> FromNeighbors;
+		for (int32 Index = VertexTriangleOffsets[From]; Index < VertexTriangleOffsets[From + 1]; Index++)
+		{
+			const int32* Tri = &Indices[VertexTriangles[Index] * 3];
+			for (int32 Corner = 0; Corner < 3; Corner++)
+			{
+				if (Tri[Corner] != From && Tri[Corner] != To)
+				{
+					FromNeighbors.AddUnique(Tri[Corner]);
+				}
+			}
+		}
+
+		TArray<int32, TInlineAllocator<32>> SharedNeighbors;
+		for (int32 Index = VertexTriangleOffsets[To]; Index < VertexTriangleOffsets[To + 1]; Index++)
+		{
+			const int32* Tri = &Indices[VertexTriangles[Index] * 3];
+			for (int32 Corner = 0; Corner < 3; Corner++)
+			{
+				if (FromNeighbors.Contains(Tri[Corner]))
+				{
+					SharedNeighbors.AddUnique(Tri[Corner]);
+				}
+			}
+		}
+		if (SharedNeighbors.Num() > 2)
+		{
+			return false;
+		}
+
+		// Every triangle that survives the collapse has to keep facing the same way
+		const FVector3f& Target = Positions[To];
+		for (int32 Index = VertexTriangleOffsets[From]; Index < VertexTriangleOffsets[From + 1]; Index++)
+		{
+			const int32* Tri = &Indices[VertexTriangles[Index] * 3];
+			if (Tri[0] == To || Tri[1] == To || Tri[2] == To)
+			{
+				continue;
+			}
+
+			FVector3f Corners[3] = { Positions[Tri[0]], Positions[Tri[1]], Positions[Tri[2]] };
+			const FVector3f OldNormal = GetTriangleNormal(Corners[0], Corners[1], Corners[2]);
+			for (int32 Corner = 0; Corner < 3; Corner++)
+			{
+				if (Tri[Corner] == From)
+				{
+					Corners[Corner] = Target;
+				}
+			}
+			const FVector3f NewNormal = GetTriangleNormal(Corners[0], Corners[1], Corners[2]);
+			if ((OldNormal | NewNormal) <= 0.0f)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	int32 FRealtimeMeshSimplifier::Simplify(int32 TargetTriangles, float MaxError)
+	{
+		TargetTriangles = FMath::Max(TargetTriangles, 0);
+
+		TArray<FCollapse> Collapses;
+		TBitArray<> TouchedVertices;
+		TArray<int32> Remap;
+
+		// Each pass collapses an independent set of edges, those whose neighborhoods no earlier collapse in the pass touched
+		while (GetNumTriangles() > TargetTriangles)
+		{
+			BuildAdjacency();
+
+			Collapses.Reset();
+			for (int32 TriIdx = 0; TriIdx < GetNumTriangles(); TriIdx++)
+			{
+				const int32* Tri = &Indices[TriIdx * 3];
+				for (int32 Corner = 0; Corner < 3; Corner++)
+				{
+					const int32 A = Tri[Corner];
+					const int32 B = Tri[(Corner + 1) % 3];
+					// Each interior edge is seen from both of its triangles, emit one direction from each
+					const int32 From = LockedVertices[A] ? B : A;
+					const int32 To = From == A ? B : A;
+					if (!LockedVertices[From])
+					{
+						const float Cost = GetCollapseCost(From, To);
+						if (Cost <= MaxError)
+						{
+							Collapses.Add({ From, To, Cost });
+						}
+					}
+				}
+			}
+			if (Collapses.IsEmpty())
+			{
+				break;
+			}
+			Collapses.Sort([](const FCollapse& A, const FCollapse& B) { return A.Cost < B.Cost; });
+
+			TouchedVertices.Init(false, Positions.Num());
+			Remap.SetNumUninitialized(Positions.Num());
+			for (int32 VertIdx = 0; VertIdx < Positions.Num(); VertIdx++)
+			{
+				Remap[VertIdx] = VertIdx;
+			}
+
+			int32 RemainingTriangles = GetNumTriangles();
+			int32 NumCollapsed = 0;
+			for (const FCollapse& Collapse : Collapses)
+			{
+				if (RemainingTriangles <= TargetTriangles)
+				{
+					break;
+				}
+				if (TouchedVertices[Collapse.From] || TouchedVertices[Collapse.To] || !IsCollapseAllowed(Collapse.From, Collapse.To))
+				{
+					continue;
+				}
+
+				for (int32 Index = VertexTriangleOffsets[Collapse.From]; Index < VertexTriangleOffsets[Collapse.From + 1]; Index++)
+				{
+					const int32* Tri = &Indices[VertexTriangles[Index] * 3];
+					if (Tri[0] == Collapse.To || Tri[1] == Collapse.To || Tri[2] == Collapse.To)
+					{
+						RemainingTriangles--;
+					}
+					TouchedVertices[Tri[0]] = true;
+					TouchedVertices[Tri[1]] = true;
+					TouchedVertices[Tri[2]] = true;
+				}
+
+				Remap[Collapse.From] = Collapse.To;
+				Quadrics[Collapse.To].Add(Quadrics[Collapse.From]);
+				Error = FMath::Max(Error, Collapse.Cost);
+				NumCollapsed++;
+			}
+			if (NumCollapsed == 0)
+			{
+				break;
+			}
+
+			// Remap in place keeping triangle order, so polygroup ranges stay contiguous
+			int32 NumKept = 0;
+			for (int32 TriIdx = 0; TriIdx < GetNumTriangles(); TriIdx++)
+			{
+				const int32 V0 = Remap[Indices[TriIdx * 3 + 0]];
+				const int32 V1 = Remap[Indices[TriIdx * 3 + 1]];
+				const int32 V2 = Remap[Indices[TriIdx * 3 + 2]];
+				if (V0 != V1 && V1 != V2 && V2 != V0)
+				{
+					Indices[NumKept * 3 + 0] = V0;
+					Indices[NumKept * 3 + 1] = V1;
+					Indices[NumKept * 3 + 2] = V2;
+					SourceTriangles[NumKept++] = SourceTriangles[TriIdx];
+				}
+			}
+			Indices.SetNum(NumKept * 3);
+			SourceTriangles.SetNum(NumKept);
+		}
+
+		return GetNumTriangles();
+	}
+
+	void FRealtimeMeshSimplifier::GetResult(FRealtimeMeshStreamSet& OutStreams) const
+	{
+		OutStreams.Empty();
+		if (!IsValid())
+		{
+			return;
+		}
+
+		TArray<int32> VertexRemap;
+		VertexRemap.Init(INDEX_NONE, Positions.Num());
+		TArray<int32> UsedVertices;
+		UsedVertices.Reserve(Positions.Num());
+		for (const int32 VertIdx : Indices)
+		{
+			if (VertexRemap[VertIdx] == INDEX_NONE)
+			{
+				VertexRemap[VertIdx] = UsedVertices.Add(VertIdx);
+			}
+		}
+
+		Source.ForEach([&](const FRealtimeMeshStream& Stream)
+		{
+			if (Stream.GetStreamType() == ERealtimeMeshStreamType::Vertex)
+			{
+				// Streams that do not line up with the positions can't be remapped
+				if (Stream.Num() != Positions.Num())
+				{
+					return;
+				}
+
+				FRealtimeMeshStream& NewStream = OutStreams.AddStream(Stream.GetStreamKey(), Stream.GetLayout());
+				NewStream.SetNumUninitialized(UsedVertices.Num());
+				const int32 Stride = Stream.GetStride();
+				for (int32 NewIdx = 0; NewIdx < UsedVertices.Num(); NewIdx++)
+				{
+					FMemory::Memcpy(NewStream.GetDataRawAtVertex(NewIdx), Stream.GetDataRawAtVertex(UsedVertices[NewIdx]), Stride);
+				}
+			}
+			else if (Stream.GetStreamKey() == FRealtimeMeshStreams::Triangles)
+			{
+				FRealtimeMeshStream& NewStream = OutStreams.AddStream(Stream.GetStreamKey(), Stream.GetLayout());
+				TRealtimeMeshStreamBuilder<TIndex3<uint32>, void> Triangles(NewStream);
+				Triangles.SetNumUninitialized(GetNumTriangles());
+				for (int32 TriIdx = 0; TriIdx < GetNumTriangles(); TriIdx++)
+				{
+					Triangles.Set(TriIdx, TIndex3<uint32>(
+						VertexRemap[Indices[TriIdx * 3 + 0]],
+						VertexRemap[Indices[TriIdx * 3 + 1]],
+						VertexRemap[Indices[TriIdx * 3 + 2]]));
+				}
+			}
+			else if (Stream.GetStreamKey() == FRealtimeMeshStreams::PolyGroups && PolyGroups)
+			{
+				FRealtimeMeshStream& NewStream = OutStreams.AddStream(Stream.GetStreamKey(), Stream.GetLayout());
+				NewStream.SetNumUninitialized(GetNumTriangles());
+				const int32 Stride = Stream.GetStride();
+				for (int32 TriIdx = 0; TriIdx < GetNumTriangles(); TriIdx++)
+				{
+					FMemory::Memcpy(NewStream.GetDataRawAtVertex(TriIdx), Stream.GetDataRawAtVertex(SourceTriangles[TriIdx]), Stride);
+				}
+			}
+		});
+
+		// Segments are derived from the polygroups, the depth only and reversed index buffers are left for the caller to rebuild
+		if (const FRealtimeMeshStream* SourceSegments = Source.Find(FRealtimeMeshStreams::PolyGroupSegments))
+		{
+			if (const FRealtimeMeshStream* NewPolyGroups = OutStreams.Find(FRealtimeMeshStreams::PolyGroups))
+			{
+				FRealtimeMeshStream& NewSegments = OutStreams.AddStream(SourceSegments->GetStreamKey(), SourceSegments->GetLayout());
+				RealtimeMeshAlgo::GatherSegmentsFromPolygonGroupIndices(*NewPolyGroups, NewSegments);
+			}
+		}
+	}
+}
@@ -0,0 +1,180 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#include "Mesh/RealtimeMeshTangentGenerator.h"
+#include "Async/ParallelFor.h"
+
+namespace RealtimeMesh
+{
+	namespace TangentGenerator::Private
+	{
+		static constexpr int32 ParallelBatchSize = 1024;
+
+		FORCEINLINE static FVector3f ProjectToPlane(const FVector3f& Vector, const FVector3f& Normal)
+		{
+			return (Vector - Normal * (Normal | Vector)).GetSafeNormal();
+		}
+
+		template <typename FuncType>
+		static void ForEachVertex(int32 NumVertices, TConstArrayView<int32> Vertices, const FuncType& Func)
+		{
+			const int32 Num = Vertices.Num() > 0 ? Vertices.Num() : NumVertices;
+			const int32 NumBatches = FMath::DivideAndRoundUp(Num, ParallelBatchSize);
+			ParallelForTemplate(NumBatches, [&](int32 BatchIndex)
+			{
+				const int32 End = FMath::Min(Num, (BatchIndex + 1) * ParallelBatchSize);
+				for (int32 Index = BatchIndex * ParallelBatchSize; Index < End; Index++)
+				{
+					Func(Vertices.Num() > 0 ? Vertices[Index] : Index);
+				}
+			}, NumBatches < 2 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+		}
+	}
+
+	bool FRealtimeMeshTangentGenerator::BuildAdjacency(TConstArrayView<int32> Indices, int32 NumVertices, TArray<int32>& OutCornerOffsets, TArray<int32>& OutCorners)
+	{
+		OutCornerOffsets.Reset();
+		OutCorners.Reset();
+
+		const int32 NumCorners = Indices.Num() - Indices.Num() % 3;
+		OutCornerOffsets.SetNumZeroed(NumVertices + 1);
+		for (int32 Corner = 0; Corner < NumCorners; Corner++)
+		{
+			if (Indices[Corner] < 0 || Indices[Corner] >= NumVertices)
+			{
+				OutCornerOffsets.Reset();
+				return false;
+			}
+			OutCornerOffsets[Indices[Corner] + 1]++;
+		}
+		for (int32 VertexIdx = 0; VertexIdx < NumVertices; VertexIdx++)
+		{
+			OutCornerOffsets[VertexIdx + 1] += OutCornerOffsets[VertexIdx];
+		}
+
+		TArray<int32> Cursor(OutCornerOffsets.GetData(), NumVertices);
+		OutCorners.SetNumUninitialized(NumCorners);
+		for (int32 Corner = 0; Corner < NumCorners; Corner++)
+		{
+			OutCorners[Cursor[Indices[Corner]]++] = Corner;
+		}
+		return true;
+	}
+
+	FRealtimeMeshTangentGenerator::FRealtimeMeshTangentGenerator(TConstArrayView<int32> InIndices, TConstArrayView<int32> InCornerOffsets, TConstArrayView<int32> InCorners)
+		: Indices(InIndices)
+		, CornerOffsets(InCornerOffsets)
+		, Corners(InCorners)
+	{
+	}
+
+	void FRealtimeMeshTangentGenerator::ComputeNormals(TConstArrayView<FVector3f> Positions, TArrayView<FVector3f> OutNormals, TConstArrayView<int32> Vertices) const
+	{
+		using namespace TangentGenerator::Private;
+		check(Positions.Num() >= NumVertices() && OutNormals.Num() >= NumVertices());
+
+		ForEachVertex(NumVertices(), Vertices, [&](int32 VertexIdx)
+		{
+			FVector3f Normal = FVector3f::ZeroVector;
+			for (int32 CornerIdx = CornerOffsets[VertexIdx]; CornerIdx < CornerOffsets[VertexIdx + 1]; CornerIdx++)
+			{
+				const int32 Corner = Corners[CornerIdx];
+				const int32 TriangleStart = Corner - Corner % 3;
+				const FVector3f& P0 = Positions[Indices[TriangleStart + 0]];
+				const FVector3f& P1 = Positions[Indices[TriangleStart + 1]];
+				const FVector3f& P2 = Positions[Indices[TriangleStart + 2]];
+
+				// Front faces wind clockwise
+				const FVector3f FaceNormal = ((P2 - P0) ^ (P1 - P0)).GetSafeNormal();
+
+				const FVector3f& Position = Positions[VertexIdx];
+				const FVector3f ToPrev = (Positions[Indices[TriangleStart + (Corner + 2) % 3]] - Position).GetSafeNormal();
+				const FVector3f ToNext = (Positions[Indices[TriangleStart + (Corner + 1) % 3]] - Position).GetSafeNormal();
+				Normal += FaceNormal * FMath::Acos(FMath::Clamp(ToPrev | ToNext, -1.0f, 1.0f));
+			}
+
+			if (!Normal.IsNearlyZero())
+			{
+				OutNormals[VertexIdx] = Normal.GetUnsafeNormal();
+			}
+		});
+	}
+
+	void FRealtimeMeshTangentGenerator::ComputeTangents(TConstArrayView<FVector3f> Positions, TConstArrayView<FVector3f> Normals, TConstArrayView<FVector2f> UVs,
+	                                                    TArrayView<FVector3f> OutTangents, TArrayView<float> OutBinormalSigns, TConstArrayView<int32> Vertices) const
+	{
+		using namespace TangentGenerator::Private;
+		check(Positions.Num() >= NumVertices() && Normals.Num() >= NumVertices() && OutTangents.Num() >= NumVertices());
+		check(OutBinormalSigns.Num() == 0 || OutBinormalSigns.Num() >= NumVertices());
+		const bool bHasUVs = UVs.Num() >= NumVertices();
+
+		ForEachVertex(NumVertices(), Vertices, [&](int32 VertexIdx)
+		{
+			const FVector3f& Normal = Normals[VertexIdx];
+			const FVector3f& Position = Positions[VertexIdx];
+
+			// Indexed by whether the UVs of the triangle preserve orientation
+			FVector3f TangentSums[2] = { FVector3f::ZeroVector, FVector3f::ZeroVector };
+			float AngleSums[2] = { 0.0f, 0.0f };
+
+			for (int32 CornerIdx = CornerOffsets[VertexIdx]; CornerIdx < CornerOffsets[VertexIdx + 1]; CornerIdx++)
+			{
+				const int32 Corner = Corners[CornerIdx];
+				const int32 TriangleStart = Corner - Corner % 3;
+				const int32 I0 = Indices[TriangleStart + 0];
+				const int32 I1 = Indices[TriangleStart + 1];
+				const int32 I2 = Indices[TriangleStart + 2];
+				const FVector3f D1 = Positions[I1] - Positions[I0];
+				const FVector3f D2 = Positions[I2] - Positions[I0];
+
+				FVector3f FaceTangent;
+				bool bOrientationPreserving = true;
+				if (bHasUVs)
+				{
+					const FVector2f T21 = UVs[I1] - UVs[I0];
+					const FVector2f T31 = UVs[I2] - UVs[I0];
+					const float SignedAreaTimesTwo = T21.X * T31.Y - T21.Y * T31.X;
+
+					// Triangles without UV area can go with any tangent, like MikkTSpace they don't contribute
+					if (FMath::Abs(SignedAreaTimesTwo) <= UE_SMALL_NUMBER)
+					{
+						continue;
+					}
+					bOrientationPreserving = SignedAreaTimesTwo > 0.0f;
+					FaceTangent = (D1 * T31.Y - D2 * T21.Y) * (bOrientationPreserving ? 1.0f : -1.0f);
+				}
+				else
+				{
+					FaceTangent = -D2;
+				}
+
+				FaceTangent = ProjectToPlane(FaceTangent, Normal);
+				if (FaceTangent.IsZero())
+				{
+					continue;
+				}
+
+				const FVector3f ToPrev = ProjectToPlane(Positions[Indices[TriangleStart + (Corner + 2) % 3]] - Position, Normal);
+				const FVector3f ToNext = ProjectToPlane(Positions[Indices[TriangleStart + (Corner + 1) % 3]] - Position, Normal);
+				const float Angle = FMath::Acos(FMath::Clamp(ToPrev | ToNext, -1.0f, 1.0f));
+
+				TangentSums[bOrientationPreserving] += FaceTangent * Angle;
+				AngleSums[bOrientationPreserving] += Angle;
+			}
+
+			const int32 Side = AngleSums[1] >= AngleSums[0] ? 1 : 0;
+			FVector3f Tangent = TangentSums[Side].GetSafeNormal();
+			if (Tangent.IsZero())
+			{
+				// Nothing to derive a direction from, any tangent orthogonal to the normal will do
+				FVector3f Binormal;
+				Normal.FindBestAxisVectors(Tangent, Binormal);
+			}
+
+			OutTangents[VertexIdx] = Tangent;
+			if (OutBinormalSigns.Num() > 0)
+			{
+				OutBinormalSigns[VertexIdx] = Side ? 1.0f : -1.0f;
+			}
+		});
+	}
+}
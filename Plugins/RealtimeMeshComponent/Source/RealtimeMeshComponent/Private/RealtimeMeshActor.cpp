@@ -190,11 +190,16 @@ void ARealtimeMeshActor::UnregisterWithGenerationManager()
 }
 
 
+bool ARealtimeMeshActor::IsGeneratedMeshRebuildPending() const
+{
+	return bDeferGeneration && !bFrozen &&
+		bGeneratedMeshRebuildPending &&
+		IsValid(RealtimeMeshComponent);
+}
+
 void ARealtimeMeshActor::ExecuteRebuildGeneratedMeshIfPending()
 {
-	if (!bDeferGeneration || bFrozen ||
-		!bGeneratedMeshRebuildPending ||
-		!IsValid(RealtimeMeshComponent))
+	if (!IsGeneratedMeshRebuildPending())
 	{
 		return;
 	}
@@ -5,6 +5,7 @@
 #include "Interfaces/IPluginManager.h"
 #include "ShaderCore.h"
 #include "RealtimeMeshCore.h"
+#include "RealtimeMeshGuard.h"
 
 
 // Register the custom version with core
@@ -32,6 +33,7 @@ void FRealtimeMeshComponentPlugin::StartupModule()
 
 void FRealtimeMeshComponentPlugin::ShutdownModule()
 {
+	RealtimeMesh::FRealtimeMeshEpoch::Collect();
 }
 
 DEFINE_LOG_CATEGORY(LogRealtimeMesh);
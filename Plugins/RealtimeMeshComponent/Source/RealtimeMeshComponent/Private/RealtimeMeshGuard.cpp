@@ -10,6 +10,81 @@ namespace RealtimeMesh
 	namespace Threading::Private
 	{		
 		static thread_local TMap<FRealtimeMeshGuard*, FRealtimeMeshGuardThreadState> ActiveThreadLocks;
+
+		// One per thread that has ever read, padded so readers never share a cache line
+		struct alignas(PLATFORM_CACHE_LINE_SIZE) FRealtimeMeshEpochSlot
+		{
+			// Epoch announced by the owning thread while it's in a read, zero otherwise
+			std::atomic<uint64> Epoch { 0 };
+			FRealtimeMeshEpochSlot* Next = nullptr;
+			// Guarded by FRealtimeMeshEpochState::SlotsLock
+			bool bInUse = false;
+		};
+
+		struct FRealtimeMeshEpochRetired
+		{
+			void* Data;
+			void (*Deleter)(void*);
+			uint64 Epoch;
+		};
+
+		struct FRealtimeMeshEpochState
+		{
+			std::atomic<uint64> GlobalEpoch { 1 };
+
+			// Slots are never freed so writers can walk the list without a lock, threads hand theirs back on exit
+			std::atomic<FRealtimeMeshEpochSlot*> Slots { nullptr };
+			FCriticalSection SlotsLock;
+
+			TArray<FRealtimeMeshEpochRetired> Retired;
+			FCriticalSection RetiredLock;
+		};
+
+		static FRealtimeMeshEpochState& GetEpochState()
+		{
+			static FRealtimeMeshEpochState State;
+			return State;
+		}
+
+		struct FRealtimeMeshEpochThreadState
+		{
+			FRealtimeMeshEpochSlot* Slot = nullptr;
+			int32 ReadDepth = 0;
+
+			~FRealtimeMeshEpochThreadState()
+			{
+				if (Slot)
+				{
+					FRealtimeMeshEpochState& State = GetEpochState();
+					FScopeLock Lock(&State.SlotsLock);
+					Slot->Epoch.store(0, std::memory_order_release);
+					Slot->bInUse = false;
+				}
+			}
+		};
+
+		static thread_local FRealtimeMeshEpochThreadState EpochThreadState;
+
+		static FRealtimeMeshEpochSlot* AcquireEpochSlot()
+		{
+			FRealtimeMeshEpochState& State = GetEpochState();
+			FScopeLock Lock(&State.SlotsLock);
+
+			for (FRealtimeMeshEpochSlot* Slot = State.Slots.load(std::memory_order_relaxed); Slot; Slot = Slot->Next)
+			{
+				if (!Slot->bInUse)
+				{
+					Slot->bInUse = true;
+					return Slot;
+				}
+			}
+
+			FRealtimeMeshEpochSlot* Slot = new FRealtimeMeshEpochSlot();
+			Slot->bInUse = true;
+			Slot->Next = State.Slots.load(std::memory_order_relaxed);
+			State.Slots.store(Slot, std::memory_order_release);
+			return Slot;
+		}
 	}
 	
 	void FRealtimeMeshGuard::ReadLock()
@@ -106,6 +181,97 @@ namespace RealtimeMesh
 	}
 
 
+	void FRealtimeMeshEpoch::EnterRead()
+	{
+		Threading::Private::FRealtimeMeshEpochThreadState& ThreadState = Threading::Private::EpochThreadState;
+		if (ThreadState.ReadDepth++ == 0)
+		{
+			if (!ThreadState.Slot)
+			{
+				ThreadState.Slot = Threading::Private::AcquireEpochSlot();
+			}
+
+			// The fence orders the announcement before any published pointer is loaded. A writer either sees this
+			// slot when it scans, or unpublished its data before we load it
+			const uint64 Epoch = Threading::Private::GetEpochState().GlobalEpoch.load(std::memory_order_acquire);
+			ThreadState.Slot->Epoch.store(Epoch, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+		}
+	}
+
+	void FRealtimeMeshEpoch::ExitRead()
+	{
+		Threading::Private::FRealtimeMeshEpochThreadState& ThreadState = Threading::Private::EpochThreadState;
+		checkf(ThreadState.ReadDepth > 0, TEXT("ExitRead called when the thread isn't reading."));
+		if (--ThreadState.ReadDepth == 0)
+		{
+			ThreadState.Slot->Epoch.store(0, std::memory_order_release);
+		}
+	}
+
+	bool FRealtimeMeshEpoch::IsInRead()
+	{
+		return Threading::Private::EpochThreadState.ReadDepth > 0;
+	}
+
+	void FRealtimeMeshEpoch::Retire(void* Data, void (*Deleter)(void*))
+	{
+		check(Data && Deleter);
+		Threading::Private::FRealtimeMeshEpochState& State = Threading::Private::GetEpochState();
+		{
+			FScopeLock Lock(&State.RetiredLock);
+			// Reads that begin after the bump can't have seen Data, only ones announcing this epoch or older can
+			const uint64 Epoch = State.GlobalEpoch.fetch_add(1, std::memory_order_seq_cst);
+			State.Retired.Add({ Data, Deleter, Epoch });
+		}
+		Collect();
+	}
+
+	int32 FRealtimeMeshEpoch::Collect()
+	{
+		Threading::Private::FRealtimeMeshEpochState& State = Threading::Private::GetEpochState();
+		TArray<Threading::Private::FRealtimeMeshEpochRetired, TInlineAllocator<16>> Expired;
+		int32 NumWaiting;
+		{
+			FScopeLock Lock(&State.RetiredLock);
+			if (State.Retired.IsEmpty())
+			{
+				return 0;
+			}
+
+			// Pairs with the fence in EnterRead
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			uint64 OldestRead = TNumericLimits<uint64>::Max();
+			for (Threading::Private::FRealtimeMeshEpochSlot* Slot = State.Slots.load(std::memory_order_acquire); Slot; Slot = Slot->Next)
+			{
+				const uint64 Epoch = Slot->Epoch.load(std::memory_order_relaxed);
+				if (Epoch != 0)
+				{
+					OldestRead = FMath::Min(OldestRead, Epoch);
+				}
+			}
+
+			for (int32 Index = State.Retired.Num() - 1; Index >= 0; Index--)
+			{
+				if (State.Retired[Index].Epoch < OldestRead)
+				{
+					Expired.Add(State.Retired[Index]);
+					State.Retired.RemoveAtSwap(Index);
+				}
+			}
+			NumWaiting = State.Retired.Num();
+		}
+
+		// Deleters may retire more data, so they run outside the lock
+		for (const Threading::Private::FRealtimeMeshEpochRetired& Entry : Expired)
+		{
+			Entry.Deleter(Entry.Data);
+		}
+		return NumWaiting;
+	}
+
+
 	FRealtimeMeshScopeGuardRead::FRealtimeMeshScopeGuardRead(FRealtimeMeshGuard& InGuard, bool bLockImmediately)
 		: Guard(InGuard)
 		  , bIsLocked(false)
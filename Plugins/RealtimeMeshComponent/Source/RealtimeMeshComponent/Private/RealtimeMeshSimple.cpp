@@ -9,11 +9,13 @@
 #include "RenderProxy/RealtimeMeshSectionGroupProxy.h"
 #include "RenderProxy/RealtimeMeshVertexFactory.h"
 #include "Async/Async.h"
+#include "Algo/AnyOf.h"
 #include "Core/RealtimeMeshFuture.h"
 #include "Data/RealtimeMeshUpdateBuilder.h"
 #include "Mesh/RealtimeMeshAlgo.h"
 #include "Mesh/RealtimeMeshBlueprintMeshBuilder.h"
 #include "RenderProxy/RealtimeMeshProxy.h"
+#include "RealtimeMeshThreadingSubsystem.h"
 #if RMC_ENGINE_ABOVE_5_2
 #include "Logging/MessageLog.h"
 #endif
@@ -26,6 +28,20 @@ namespace RealtimeMesh
 	namespace Simple::Private
 	{
 		static thread_local bool bShouldDeferPolyGroupUpdates = false;		
+
+		struct FLODGenerationSource
+		{
+			FName GroupName;
+			FRealtimeMeshSectionGroupConfig Config;
+			TMap<FName, FRealtimeMeshSectionConfig> SectionConfigs;
+			FRealtimeMeshStreamSet Streams;
+		};
+
+		// Half the width of the 1920 pixel screen FRealtimeMeshLODGenerationSettings::MaxPixelError is measured on
+		static constexpr float LODErrorScreenHalfWidth = 960.0f;
+
+		// A LOD has to drop at least this share of what the ratio asked for, or the chain stops
+		static constexpr float MinLODReduction = 0.5f;
 	}	
 	
 	FRealtimeMeshSectionSimple::FRealtimeMeshSectionSimple(const FRealtimeMeshSharedResourcesRef& InSharedResources, const FRealtimeMeshSectionKey& InKey)
@@ -161,16 +177,56 @@ namespace RealtimeMesh
 		ProcessFunc(Streams);
 	}
 
+	void FRealtimeMeshSectionGroupSimple::ProcessMeshDataSnapshot(TFunctionRef<void(const FRealtimeMeshStreamSet&)> ProcessFunc) const
+	{
+		{
+			FRealtimeMeshScopeEpochRead EpochRead;
+			if (const FRealtimeMeshStreamSet* Snapshot = PublishedStreams.Read())
+			{
+				ProcessFunc(*Snapshot);
+				return;
+			}
+		}
+
+		// Nothing published yet, publish the current streams so FinalizeUpdate keeps them up to date from now on
+		FRealtimeMeshScopeGuardRead ScopeGuard(SharedResources->GetGuard());
+		TUniquePtr<FRealtimeMeshStreamSet> Snapshot = MakeUnique<FRealtimeMeshStreamSet>(Streams);
+		PublishedStreams.PublishIfEmpty(Snapshot);
+		ProcessFunc(Streams);
+	}
+
 	void FRealtimeMeshSectionGroupSimple::EditMeshData(FRealtimeMeshUpdateContext& UpdateContext, TFunctionRef<TSet<FRealtimeMeshStreamKey>(FRealtimeMeshStreamSet&)> EditFunc)
 	{
+		// What the GPU buffers were last created from, recorded dirty ranges are only written in place while this still holds
+		TMap<FRealtimeMeshStreamKey, TPair<int32, FRealtimeMeshBufferLayout>> UploadedStreams;
+		Streams.ForEach([&](const FRealtimeMeshStream& Stream)
+		{
+			UploadedStreams.Add(Stream.GetStreamKey(), MakeTuple(Stream.Num(), Stream.GetLayout()));
+		});
+		Streams.ClearDirtyRanges();
+		
 		auto UpdatedStreams = EditFunc(Streams);
 
 		for (const auto& UpdatedStream : UpdatedStreams)
 		{
 			if (const auto* Stream = Streams.Find(UpdatedStream))
 			{
-				FRealtimeMeshStream StreamCopy(*Stream);				
-				FRealtimeMeshSectionGroup::CreateOrUpdateStream(UpdateContext, MoveTemp(StreamCopy));
+				const FInt32Range* DirtyRange = Streams.FindDirtyRange(UpdatedStream);
+				const auto* Uploaded = UploadedStreams.Find(UpdatedStream);
+				if (DirtyRange && Uploaded && Uploaded->Key == Stream->Num() && Uploaded->Value == Stream->GetLayout())
+				{
+					const int32 StartIndex = FMath::Max(DirtyRange->GetLowerBoundValue(), 0);
+					const int32 EndIndex = FMath::Min(DirtyRange->GetUpperBoundValue(), Stream->Num());
+					if (StartIndex < EndIndex)
+					{
+						FRealtimeMeshSectionGroup::UpdateStreamRange(UpdateContext, *Stream, StartIndex, EndIndex - StartIndex);
+					}
+				}
+				else
+				{
+					FRealtimeMeshStream StreamCopy(*Stream);				
+					FRealtimeMeshSectionGroup::CreateOrUpdateStream(UpdateContext, MoveTemp(StreamCopy));
+				}
 			}
 			else
 			{				
@@ -270,7 +326,7 @@ namespace RealtimeMesh
 					const auto UpdateData = MakeShared<FRealtimeMeshSectionGroupStreamUpdateData>(MoveTemp(Copy), EBufferUsageFlags::Static);
 					UpdateData->CreateBufferAsyncIfPossible(UpdateContext);
 
-					ProxyBuilder->AddSectionGroupTask(Key, [UpdateData](FRHICommandListBase& RHICmdList, FRealtimeMeshSectionGroupProxy& Proxy)
+					ProxyBuilder->AddSectionGroupStreamTask(Key, Stream.GetStreamKey(), true, [UpdateData](FRHICommandListBase& RHICmdList, FRealtimeMeshSectionGroupProxy& Proxy)
 					{
 						Proxy.CreateOrUpdateStream(RHICmdList, UpdateData);
 					}, ShouldRecreateProxyOnChange(UpdateContext));
@@ -284,6 +340,7 @@ namespace RealtimeMesh
 	void FRealtimeMeshSectionGroupSimple::Reset(FRealtimeMeshUpdateContext& UpdateContext)
 	{
 		Streams.Empty();
+		PublishedStreams.Reset();
 		FRealtimeMeshSectionGroup::Reset(UpdateContext);
 	}
 
@@ -296,6 +353,11 @@ namespace RealtimeMesh
 			Ar << Streams;
 		}
 
+		if (Ar.IsLoading())
+		{
+			PublishedStreams.Reset();
+		}
+
 		return bResult;
 	}
 
@@ -317,6 +379,66 @@ namespace RealtimeMesh
 		return bHasMeshData;
 	}
 
+	bool FRealtimeMeshSectionGroupSimple::UpdateCollisionBVH(const FRealtimeMeshLockContext& LockContext, FRealtimeMeshCollisionBVH& BVH) const
+	{
+		const FRealtimeMeshStream* PositionStream = Streams.Find(FRealtimeMeshStreams::Position);
+		const FRealtimeMeshStream* TriangleStream = Streams.Find(FRealtimeMeshStreams::Triangles);
+		if (!PositionStream || !TriangleStream || !PositionStream->CanConvertTo<FVector3f>())
+		{
+			return false;
+		}
+
+		TArray<int32> Indices;
+		TRealtimeMeshStreamBuilder<const TIndex3<uint32>, void> TrianglesData(*TriangleStream);
+		for (const FRealtimeMeshSectionRef& Section : Sections)
+		{
+			const auto SimpleSection = StaticCastSharedRef<FRealtimeMeshSectionSimple>(Section);
+			if (SimpleSection->HasCollision(LockContext))
+			{
+				const FRealtimeMeshStreamRange StreamRange = SimpleSection->GetStreamRange(LockContext);
+				const int32 FirstTriangle = StreamRange.GetMinIndex() / REALTIME_MESH_NUM_INDICES_PER_PRIMITIVE;
+				const int32 LastTriangle = FMath::Min(FirstTriangle + StreamRange.NumPrimitives(REALTIME_MESH_NUM_INDICES_PER_PRIMITIVE), TrianglesData.Num());
+				Indices.Reserve(Indices.Num() + FMath::Max(LastTriangle - FirstTriangle, 0) * REALTIME_MESH_NUM_INDICES_PER_PRIMITIVE);
+				for (int32 TriIdx = FirstTriangle; TriIdx < LastTriangle; TriIdx++)
+				{
+					Indices.Add(TrianglesData[TriIdx].GetElement(0).GetValue());
+					Indices.Add(TrianglesData[TriIdx].GetElement(1).GetValue());
+					Indices.Add(TrianglesData[TriIdx].GetElement(2).GetValue());
+				}
+			}
+		}
+
+		if (Indices.IsEmpty())
+		{
+			return false;
+		}
+
+		// Read the positions in place when they're already full precision, the tree diffs against its own copy
+		if (PositionStream->GetLayout() == GetRealtimeMeshBufferLayout<FVector3f>())
+		{
+			BVH.Update(TConstArrayView<FVector3f>(PositionStream->GetData<FVector3f>(), PositionStream->Num()), Indices);
+		}
+		else
+		{
+			TArray<FVector3f> Positions;
+			PositionStream->CopyTo(Positions);
+			BVH.Update(Positions, Indices);
+		}
+		return true;
+	}
+
+	void FRealtimeMeshSectionGroupSimple::FinalizeUpdate(FRealtimeMeshUpdateContext& UpdateContext)
+	{
+		FRealtimeMeshSectionGroup::FinalizeUpdate(UpdateContext);
+
+		// Readers keep the previous snapshot until this one is published, so they never see a half applied update.
+		// Published snapshots are immutable and streams aren't shared between sets, so the clean streams are copied too
+		if (PublishedStreams.IsPublished() && UpdateContext.GetState().StreamDirtyTree.HasDirtyStreams(Key))
+		{
+			PublishedStreams.Publish(MakeUnique<FRealtimeMeshStreamSet>(Streams));
+		}
+	}
+
 	void FRealtimeMeshSectionGroupSimple::UpdatePolyGroupSections(FRealtimeMeshUpdateContext& UpdateContext, bool bUpdateDepthOnly)
 	{
 		if (ShouldCreateSingularSection())
@@ -475,6 +597,190 @@ namespace RealtimeMesh
 		return UpdateSectionGroup(SectionGroupKey, MoveTemp(Copy));
 	}
 
+	TFuture<ERealtimeMeshProxyUpdateStatus> FRealtimeMeshSimple::GenerateLODs(const FRealtimeMeshLODGenerationSettings& Settings)
+	{
+		using namespace Simple::Private;
+
+		TArray<FLODGenerationSource> Sources;
+		float BoundsRadius = 0.0f;
+		float LOD0ScreenSize = 0.0f;
+		{
+			const FRealtimeMeshAccessContext AccessContext(this->AsShared());
+			const auto LOD0 = GetLODAs<FRealtimeMeshLODSimple>(AccessContext, 0);
+			const TOptional<FBoxSphereBounds3f> LocalBounds = GetLocalBounds(AccessContext);
+			if (!LOD0.IsValid() || !LocalBounds.IsSet())
+			{
+				return MakeFulfilledPromise<ERealtimeMeshProxyUpdateStatus>(ERealtimeMeshProxyUpdateStatus::NoUpdate).GetFuture();
+			}
+
+			BoundsRadius = LocalBounds->SphereRadius;
+			LOD0ScreenSize = LOD0->GetConfig(AccessContext).ScreenSize;
+
+			for (const FRealtimeMeshSectionGroupKey& SectionGroupKey : LOD0->GetSectionGroupKeys(AccessContext))
+			{
+				const auto SectionGroup = LOD0->GetSectionGroupAs<FRealtimeMeshSectionGroupSimple>(AccessContext, SectionGroupKey);
+				FLODGenerationSource& Source = Sources.AddDefaulted_GetRef();
+				Source.GroupName = SectionGroupKey.Name();
+				Source.Config = SectionGroup->GetConfig(AccessContext);
+				for (const FRealtimeMeshSectionKey& SectionKey : SectionGroup->GetSectionKeys(AccessContext))
+				{
+					Source.SectionConfigs.Add(SectionKey.Name(), SectionGroup->GetSection(AccessContext, SectionKey)->GetConfig(AccessContext));
+				}
+				SectionGroup->ProcessMeshData(AccessContext, [&Source](const FRealtimeMeshStreamSet& Streams)
+				{
+					Source.Streams.CopyFrom(Streams);
+				});
+			}
+		}
+
+		TSharedRef<TPromise<ERealtimeMeshProxyUpdateStatus>> Promise = MakeShared<TPromise<ERealtimeMeshProxyUpdateStatus>>();
+		TFuture<ERealtimeMeshProxyUpdateStatus> Result = Promise->GetFuture();
+
+		URealtimeMeshThreadingSubsystem::Get()->Launch(URealtimeMeshThreadingSubsystem::BackgroundPriority,
+			[WeakThis = TWeakPtr<FRealtimeMesh>(this->AsShared()), Sources = MoveTemp(Sources), Settings, BoundsRadius, LOD0ScreenSize, Promise]() mutable
+		{
+			const int32 MaxLODs = FMath::Clamp(Settings.NumLODs, 0, REALTIME_MESH_MAX_LOD_INDEX);
+			const float TriangleRatio = FMath::Clamp(Settings.TriangleRatio, 0.01f, 0.95f);
+
+			TArray<TUniquePtr<FRealtimeMeshSimplifier>> Simplifiers;
+			for (const FLODGenerationSource& Source : Sources)
+			{
+				Simplifiers.Add(MakeUnique<FRealtimeMeshSimplifier>(Source.Streams));
+			}
+
+			// Each LOD continues from the previous one, so the quadrics accumulate down the chain
+			TArray<float> ScreenSizes;
+			TArray<TArray<FRealtimeMeshStreamSet>> LODStreams;
+			float MaxScreenSize = LOD0ScreenSize > 0.0f ? LOD0ScreenSize : 1.0f;
+			for (int32 LODIndex = 1; LODIndex <= MaxLODs; LODIndex++)
+			{
+				int32 NumTrianglesBefore = 0;
+				int32 NumTrianglesAfter = 0;
+				float LODError = 0.0f;
+				for (const TUniquePtr<FRealtimeMeshSimplifier>& Simplifier : Simplifiers)
+				{
+					if (Simplifier->IsValid())
+					{
+						const int32 NumTriangles = Simplifier->GetNumTriangles();
+						NumTrianglesBefore += NumTriangles;
+						NumTrianglesAfter += Simplifier->Simplify(FMath::Max(1, FMath::FloorToInt32(NumTriangles * TriangleRatio)));
+						LODError = FMath::Max(LODError, Simplifier->GetError());
+					}
+				}
+
+				if (NumTrianglesBefore == 0 || NumTrianglesBefore - NumTrianglesAfter < (NumTrianglesBefore * (1.0f - TriangleRatio)) * MinLODReduction)
+				{
+					break;
+				}
+
+				// Projected error is LODError * ScreenSize * HalfWidth / BoundsRadius pixels, switch in where that reaches the limit
+				const float ErrorScreenSize = LODError > 0.0f
+					? Settings.MaxPixelError * BoundsRadius / (LODErrorScreenHalfWidth * LODError)
+					: MaxScreenSize;
+				const float ScreenSize = FMath::Min(ErrorScreenSize, MaxScreenSize * 0.99f);
+				MaxScreenSize = ScreenSize;
+				ScreenSizes.Add(ScreenSize);
+
+				TArray<FRealtimeMeshStreamSet>& GroupStreams = LODStreams.AddDefaulted_GetRef();
+				for (const TUniquePtr<FRealtimeMeshSimplifier>& Simplifier : Simplifiers)
+				{
+					Simplifier->GetResult(GroupStreams.AddDefaulted_GetRef());
+				}
+			}
+
+			const TSharedPtr<FRealtimeMesh> PinnedThis = WeakThis.Pin();
+			if (!PinnedThis)
+			{
+				Promise->SetValue(ERealtimeMeshProxyUpdateStatus::NoProxy);
+				return;
+			}
+
+			FRealtimeMeshUpdateBuilder UpdateBuilder;
+
+			UpdateBuilder.AddMeshTask<FRealtimeMeshSimple>([ScreenSizes](FRealtimeMeshUpdateContext& UpdateContext, FRealtimeMeshSimple& Mesh)
+			{
+				while (Mesh.GetNumLODs(UpdateContext) > ScreenSizes.Num() + 1)
+				{
+					Mesh.RemoveTrailingLOD(UpdateContext);
+				}
+				for (int32 Index = 0; Index < ScreenSizes.Num(); Index++)
+				{
+					const FRealtimeMeshLODKey LODKey(Index + 1);
+					if (const FRealtimeMeshLODPtr LOD = Mesh.GetLOD(UpdateContext, LODKey))
+					{
+						FRealtimeMeshLODConfig Config = LOD->GetConfig(UpdateContext);
+						Config.ScreenSize = ScreenSizes[Index];
+						LOD->UpdateConfig(UpdateContext, Config);
+					}
+					else
+					{
+						Mesh.AddLOD(UpdateContext, FRealtimeMeshLODConfig(ScreenSizes[Index]));
+					}
+				}
+			});
+
+			for (int32 Index = 0; Index < LODStreams.Num(); Index++)
+			{
+				const FRealtimeMeshLODKey LODKey(Index + 1);
+
+				TMap<FRealtimeMeshSectionGroupKey, FRealtimeMeshSectionGroupConfig> GroupConfigs;
+				for (int32 SourceIndex = 0; SourceIndex < Sources.Num(); SourceIndex++)
+				{
+					if (Simplifiers[SourceIndex]->IsValid())
+					{
+						GroupConfigs.Add(FRealtimeMeshSectionGroupKey::Create(LODKey, Sources[SourceIndex].GroupName), Sources[SourceIndex].Config);
+					}
+				}
+
+				UpdateBuilder.AddLODTask<FRealtimeMeshLODSimple>(LODKey, [GroupConfigs](FRealtimeMeshUpdateContext& UpdateContext, FRealtimeMeshLODSimple& LOD)
+				{
+					for (const FRealtimeMeshSectionGroupKey& SectionGroupKey : LOD.GetSectionGroupKeys(UpdateContext))
+					{
+						if (!GroupConfigs.Contains(SectionGroupKey))
+						{
+							LOD.RemoveSectionGroup(UpdateContext, SectionGroupKey);
+						}
+					}
+					for (const TPair<FRealtimeMeshSectionGroupKey, FRealtimeMeshSectionGroupConfig>& Group : GroupConfigs)
+					{
+						LOD.CreateOrUpdateSectionGroup(UpdateContext, Group.Key, Group.Value);
+					}
+				});
+
+				for (int32 SourceIndex = 0; SourceIndex < Sources.Num(); SourceIndex++)
+				{
+					if (!Simplifiers[SourceIndex]->IsValid())
+					{
+						continue;
+					}
+
+					UpdateBuilder.AddSectionGroupTask<FRealtimeMeshSectionGroupSimple>(FRealtimeMeshSectionGroupKey::Create(LODKey, Sources[SourceIndex].GroupName),
+						[MeshData = MoveTemp(LODStreams[Index][SourceIndex]), SectionConfigs = Sources[SourceIndex].SectionConfigs]
+						(FRealtimeMeshUpdateContext& UpdateContext, FRealtimeMeshSectionGroupSimple& SectionGroup) mutable
+					{
+						SectionGroup.SetShouldAutoCreateSectionsForPolyGroups(UpdateContext, true);
+						SectionGroup.SetAllStreams(UpdateContext, MoveTemp(MeshData));
+
+						for (const FRealtimeMeshSectionKey& SectionKey : SectionGroup.GetSectionKeys(UpdateContext))
+						{
+							if (const FRealtimeMeshSectionConfig* SectionConfig = SectionConfigs.Find(SectionKey.Name()))
+							{
+								SectionGroup.GetSection(UpdateContext, SectionKey)->UpdateConfig(UpdateContext, *SectionConfig);
+							}
+						}
+					});
+				}
+			}
+
+			UpdateBuilder.Commit(PinnedThis.ToSharedRef()).Next([Promise](ERealtimeMeshProxyUpdateStatus Status)
+			{
+				Promise->SetValue(Status);
+			});
+		});
+
+		return Result;
+	}
+
 	FRealtimeMeshCollisionConfiguration FRealtimeMeshSimple::GetCollisionConfig() const
 	{
 		FRealtimeMeshScopeGuardRead ScopeGuard(SharedResources->GetGuard());
@@ -582,6 +888,12 @@ namespace RealtimeMesh
 	{
 		// Copy any custom complex geometry
 		OutComplexGeometry = ComplexGeometry;
+
+		// Section collision lives in the deformable BVHs instead
+		if (bUseDeformableCollision)
+		{
+			return OutComplexGeometry.NumMeshes() > 0;
+		}
 		
 		// TODO: Allow other LOD to be used for collision?
 		if (LODs.IsValidIndex(0))
@@ -591,6 +903,123 @@ namespace RealtimeMesh
 		return false;
 	}
 
+	bool FRealtimeMeshSimple::IsUsingDeformableCollision() const
+	{
+		FRealtimeMeshScopeGuardRead ScopeGuard(SharedResources->GetGuard());
+		return bUseDeformableCollision;
+	}
+
+	TFuture<ERealtimeMeshCollisionUpdateResult> FRealtimeMeshSimple::SetUseDeformableCollision(bool bNewUseDeformableCollision)
+	{
+		FRealtimeMeshScopeGuardWrite ScopeGuard(SharedResources->GetGuard());
+		if (bUseDeformableCollision == bNewUseDeformableCollision)
+		{
+			return MakeFulfilledPromise<ERealtimeMeshCollisionUpdateResult>(ERealtimeMeshCollisionUpdateResult::Ignored).GetFuture();
+		}
+
+		bUseDeformableCollision = bNewUseDeformableCollision;
+		DeformableCollision.Empty();
+
+		if (bUseDeformableCollision)
+		{
+			FRealtimeMeshAccessContext AccessContext(this->AsShared());
+			if (const auto LOD = GetLOD(AccessContext, FRealtimeMeshLODKey(0)))
+			{
+				for (const FRealtimeMeshSectionGroupKey& SectionGroupKey : LOD->GetSectionGroupKeys(AccessContext))
+				{
+					UpdateDeformableCollision(AccessContext, SectionGroupKey);
+				}
+			}
+		}
+
+		// Recook so the physics body drops, or regains, the section geometry
+		return MarkCollisionDirty();
+	}
+
+	bool FRealtimeMeshSimple::LineTraceDeformableCollision(const FVector3f& Start, const FVector3f& End, FRealtimeMeshCollisionBVHHit& OutHit,
+		FRealtimeMeshSectionGroupKey* OutSectionGroupKey) const
+	{
+		FRealtimeMeshScopeGuardRead ScopeGuard(SharedResources->GetGuard());
+
+		bool bHit = false;
+		for (const auto& Entry : DeformableCollision)
+		{
+			FRealtimeMeshCollisionBVHHit Hit;
+			if (Entry.Value->LineTrace(Start, End, Hit) && (!bHit || Hit.Time < OutHit.Time))
+			{
+				OutHit = Hit;
+				bHit = true;
+				if (OutSectionGroupKey)
+				{
+					*OutSectionGroupKey = Entry.Key;
+				}
+			}
+		}
+		return bHit;
+	}
+
+	bool FRealtimeMeshSimple::ProcessMeshSnapshot(const FRealtimeMeshSectionGroupKey& SectionGroupKey, TFunctionRef<void(const FRealtimeMeshStreamSet&)> ProcessFunc) const
+	{
+		{
+			FRealtimeMeshScopeEpochRead EpochRead;
+			if (const FPublishedSectionGroups* SectionGroups = PublishedSectionGroups.Read())
+			{
+				// The published map holds a reference to the group, it can't be destroyed while we're in this read
+				const TSharedRef<const FRealtimeMeshSectionGroupSimple>* SectionGroup = SectionGroups->Find(SectionGroupKey);
+				if (SectionGroup)
+				{
+					(*SectionGroup)->ProcessMeshDataSnapshot(ProcessFunc);
+				}
+				return SectionGroup != nullptr;
+			}
+		}
+
+		// Nothing published yet, publish the section groups so FinalizeUpdate keeps them up to date from now on
+		FRealtimeMeshAccessContext AccessContext(this->AsShared());
+		TUniquePtr<FPublishedSectionGroups> SectionGroups = GatherSectionGroups(AccessContext);
+		PublishedSectionGroups.PublishIfEmpty(SectionGroups);
+
+		if (const auto SectionGroup = GetSectionGroupAs<const FRealtimeMeshSectionGroupSimple>(AccessContext, SectionGroupKey))
+		{
+			SectionGroup->ProcessMeshDataSnapshot(ProcessFunc);
+			return true;
+		}
+		return false;
+	}
+
+	TUniquePtr<FRealtimeMeshSimple::FPublishedSectionGroups> FRealtimeMeshSimple::GatherSectionGroups(const FRealtimeMeshLockContext& LockContext) const
+	{
+		TUniquePtr<FPublishedSectionGroups> SectionGroups = MakeUnique<FPublishedSectionGroups>();
+		ProcessLODs(LockContext, [&](const FRealtimeMeshLOD& LOD)
+		{
+			LOD.ProcessSectionGroupsAs<FRealtimeMeshSectionGroupSimple>(LockContext, [&](const FRealtimeMeshSectionGroupSimple& SectionGroup)
+			{
+				SectionGroups->Add(SectionGroup.GetKey(LockContext), StaticCastSharedRef<const FRealtimeMeshSectionGroupSimple>(SectionGroup.AsShared()));
+			});
+		});
+		return SectionGroups;
+	}
+
+	void FRealtimeMeshSimple::UpdateDeformableCollision(const FRealtimeMeshLockContext& LockContext, const FRealtimeMeshSectionGroupKey& SectionGroupKey)
+	{
+		// TODO: Allow other LOD to be used for collision?
+		if (SectionGroupKey.LOD() == FRealtimeMeshLODKey(0))
+		{
+			if (const auto SectionGroup = GetSectionGroupAs<FRealtimeMeshSectionGroupSimple>(LockContext, SectionGroupKey))
+			{
+				const TSharedRef<FRealtimeMeshCollisionBVH>* Existing = DeformableCollision.Find(SectionGroupKey);
+				const TSharedRef<FRealtimeMeshCollisionBVH> BVH = Existing ? *Existing : MakeShared<FRealtimeMeshCollisionBVH>();
+				if (SectionGroup->UpdateCollisionBVH(LockContext, *BVH))
+				{
+					DeformableCollision.Add(SectionGroupKey, BVH);
+					return;
+				}
+			}
+		}
+
+		DeformableCollision.Remove(SectionGroupKey);
+	}
+
 	void FRealtimeMeshSimple::InitializeProxy(FRealtimeMeshUpdateContext& UpdateContext) const
 	{
 		FRealtimeMesh::InitializeProxy(UpdateContext);
@@ -612,11 +1041,64 @@ namespace RealtimeMesh
 		}
 	}
 
+	bool FRealtimeMeshSimple::IsCoalescingProxyUpdates() const
+	{
+		FRealtimeMeshScopeGuardRead ScopeGuard(SharedResources->GetGuard());
+		return bCoalesceProxyUpdates;
+	}
+
+	void FRealtimeMeshSimple::SetCoalesceProxyUpdates(bool bNewCoalesceProxyUpdates)
+	{
+		{
+			FRealtimeMeshScopeGuardWrite ScopeGuard(SharedResources->GetGuard());
+			bCoalesceProxyUpdates = bNewCoalesceProxyUpdates;
+		}
+
+		// Later commits go straight to the proxy, so what's held has to go out ahead of them
+		if (!bNewCoalesceProxyUpdates)
+		{
+			FlushProxyUpdates();
+		}
+	}
+
+	void FRealtimeMeshSimple::FlushProxyUpdates() const
+	{
+		TUniquePtr<FRealtimeMeshProxyUpdateCoalescer> ProxyUpdates;
+		{
+			FRealtimeMeshScopeGuardWrite ScopeGuard(SharedResources->GetGuard());
+			ProxyUpdates = MoveTemp(PendingProxyUpdates);
+		}
+
+		// Sent outside the lock, superseded futures complete here and their continuations may update the mesh again
+		if (ProxyUpdates.IsValid())
+		{
+			ProxyUpdates->Send();
+		}
+	}
+
+	TOptional<TFuture<ERealtimeMeshProxyUpdateStatus>> FRealtimeMeshSimple::DeferProxyUpdates(const FRealtimeMeshProxyRef& Proxy, FRealtimeMeshProxyUpdateBuilder& Builder) const
+	{
+		FRealtimeMeshScopeGuardWrite ScopeGuard(SharedResources->GetGuard());
+		if (!bCoalesceProxyUpdates)
+		{
+			return NullOpt;
+		}
+
+		if (!PendingProxyUpdates.IsValid())
+		{
+			PendingProxyUpdates = MakeUnique<FRealtimeMeshProxyUpdateCoalescer>();
+			MarkForEndOfFrameUpdate();
+		}
+		return PendingProxyUpdates->Record(this->AsShared(), Proxy, Builder);
+	}
+
 	void FRealtimeMeshSimple::Reset(FRealtimeMeshUpdateContext& UpdateContext, bool bRemoveRenderProxy)
 	{
 		FRealtimeMeshScopeGuardWrite ScopeGuard(SharedResources->GetGuard());
 		CollisionConfig = FRealtimeMeshCollisionConfiguration();
 		SimpleGeometry = FRealtimeMeshSimpleGeometry();
+		DeformableCollision.Empty();
+		bUseDeformableCollision = false;
 		
 		FRealtimeMesh::Reset(UpdateContext, bRemoveRenderProxy);
 
@@ -628,9 +1110,71 @@ namespace RealtimeMesh
 	{
 		FRealtimeMesh::FinalizeUpdate(UpdateContext);
 		
-		if (UpdateContext.GetState<FRealtimeMeshSimpleUpdateState>().CollisionGroupDirtySet.HasAnyDirty())
+		const FRealtimeMeshSimpleCollisionGroupDirtySet& CollisionGroupDirtySet = UpdateContext.GetState<FRealtimeMeshSimpleUpdateState>().CollisionGroupDirtySet;
+		if (CollisionGroupDirtySet.HasAnyDirty())
 		{
-			MarkCollisionDirtyNoCallback();
+			if (bUseDeformableCollision)
+			{
+				// Refit only the groups that changed, the cooked physics body doesn't contain them
+				for (const FRealtimeMeshSectionGroupKey& SectionGroupKey : CollisionGroupDirtySet.GetDirtySectionGroups())
+				{
+					UpdateDeformableCollision(UpdateContext, SectionGroupKey);
+				}
+			}
+			else
+			{
+				MarkCollisionDirtyNoCallback();
+			}
+		}
+
+		if (bUseDeformableCollision)
+		{
+			// Vertices moved by in-place stream edits don't dirty the section collision, refit those trees here too
+			const FRealtimeMeshStructuredStreamDirtyTree& StreamDirtyTree = UpdateContext.GetState().StreamDirtyTree;
+			TArray<FRealtimeMeshSectionGroupKey> MovedSectionGroups;
+			for (const auto& Entry : DeformableCollision)
+			{
+				if (!CollisionGroupDirtySet.IsDirty(Entry.Key) && StreamDirtyTree.HasDirtyStreams(Entry.Key) &&
+					StreamDirtyTree.GetDirtyStreams(Entry.Key).Contains(FRealtimeMeshStreams::Position))
+				{
+					MovedSectionGroups.Add(Entry.Key);
+				}
+			}
+			for (const FRealtimeMeshSectionGroupKey& SectionGroupKey : MovedSectionGroups)
+			{
+				UpdateDeformableCollision(UpdateContext, SectionGroupKey);
+			}
+		}
+
+		// Drop trees for section groups removed in this update
+		for (auto It = DeformableCollision.CreateIterator(); It; ++It)
+		{
+			if (!GetSectionGroup(UpdateContext, It.Key()).IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		if (PublishedSectionGroups.IsPublished())
+		{
+			TUniquePtr<FPublishedSectionGroups> SectionGroups = GatherSectionGroups(UpdateContext);
+
+			bool bSectionGroupsChanged;
+			{
+				FRealtimeMeshScopeEpochRead EpochRead;
+				const FPublishedSectionGroups* Published = PublishedSectionGroups.Read();
+				bSectionGroupsChanged = !Published || Published->Num() != SectionGroups->Num() ||
+					Algo::AnyOf(*SectionGroups, [Published](const auto& Entry)
+					{
+						const TSharedRef<const FRealtimeMeshSectionGroupSimple>* Existing = Published->Find(Entry.Key);
+						return !Existing || *Existing != Entry.Value;
+					});
+			}
+
+			if (bSectionGroupsChanged)
+			{
+				PublishedSectionGroups.Publish(MoveTemp(SectionGroups));
+			}
 		}
 	}
 
@@ -741,6 +1285,8 @@ namespace RealtimeMesh
 
 	void FRealtimeMeshSimple::ProcessEndOfFrameUpdates()
 	{
+		FlushProxyUpdates();
+
 		TSharedPtr<TPromise<ERealtimeMeshCollisionUpdateResult>> CollisionPromise;
 		{
 			FRealtimeMeshScopeGuardWrite ScopeGuard(SharedResources);
@@ -850,6 +1396,12 @@ TFuture<ERealtimeMeshProxyUpdateStatus> URealtimeMeshSimple::UpdateSectionGroup(
 	return GetMeshAs<FRealtimeMeshSimple>()->UpdateSectionGroup(SectionGroupKey, MeshData);
 }
 
+// ReSharper disable once CppMemberFunctionMayBeConst
+TFuture<ERealtimeMeshProxyUpdateStatus> URealtimeMeshSimple::GenerateLODs(const FRealtimeMeshLODGenerationSettings& Settings)
+{
+	return GetMeshAs<FRealtimeMeshSimple>()->GenerateLODs(Settings);
+}
+
 // ReSharper disable once CppMemberFunctionMayBeConst
 TFuture<ERealtimeMeshProxyUpdateStatus> URealtimeMeshSimple::CreateSection(const FRealtimeMeshSectionKey& SectionKey,
 	const FRealtimeMeshSectionConfig& Config, const FRealtimeMeshStreamRange& StreamRange, bool bShouldCreateCollision)
@@ -965,6 +1517,11 @@ void URealtimeMeshSimple::ProcessMesh(const FRealtimeMeshSectionGroupKey& Sectio
 	Accessor.Execute(GetMeshData());
 }
 
+bool URealtimeMeshSimple::ProcessMeshSnapshot(const FRealtimeMeshSectionGroupKey& SectionGroupKey, const TFunctionRef<void(const FRealtimeMeshStreamSet&)>& ProcessFunc) const
+{
+	return GetMeshData()->ProcessMeshSnapshot(SectionGroupKey, ProcessFunc);
+}
+
 // ReSharper disable once CppMemberFunctionMayBeConst
 TFuture<ERealtimeMeshProxyUpdateStatus> URealtimeMeshSimple::EditMeshInPlace(const FRealtimeMeshSectionGroupKey& SectionGroupKey, const TFunctionRef<TSet<FRealtimeMeshStreamKey>(FRealtimeMeshStreamSet&)>& EditFunc)
 {
@@ -1052,6 +1609,18 @@ void URealtimeMeshSimple::UpdateSectionGroup(const FRealtimeMeshSectionGroupKey&
 	}
 }
 
+void URealtimeMeshSimple::GenerateLODs(int32 NumLODs, float TriangleRatio, float MaxPixelError, const FRealtimeMeshSimpleCompletionCallback& CompletionCallback)
+{
+	FRealtimeMeshLODGenerationSettings Settings;
+	Settings.NumLODs = NumLODs;
+	Settings.TriangleRatio = TriangleRatio;
+	Settings.MaxPixelError = MaxPixelError;
+	GenerateLODs(Settings).Next([CompletionCallback](ERealtimeMeshProxyUpdateStatus Status)
+	{
+		(void)CompletionCallback.ExecuteIfBound(Status);
+	});
+}
+
 void URealtimeMeshSimple::CreateSection(const FRealtimeMeshSectionKey& SectionKey, const FRealtimeMeshSectionConfig& Config, const FRealtimeMeshStreamRange& StreamRange,
 	bool bShouldCreateCollision, const FRealtimeMeshSimpleCompletionCallback& CompletionCallback)
 {
@@ -1334,6 +1903,47 @@ void URealtimeMeshSimple::SetSimpleGeometry(const FRealtimeMeshSimpleGeometry& I
 		});
 }
 
+bool URealtimeMeshSimple::IsUsingDeformableCollision() const
+{
+	return GetMeshAs<FRealtimeMeshSimple>()->IsUsingDeformableCollision();
+}
+
+bool URealtimeMeshSimple::IsCoalescingProxyUpdates() const
+{
+	return GetMeshAs<FRealtimeMeshSimple>()->IsCoalescingProxyUpdates();
+}
+
+// ReSharper disable once CppMemberFunctionMayBeConst
+void URealtimeMeshSimple::SetCoalesceProxyUpdates(bool bNewCoalesceProxyUpdates)
+{
+	GetMeshAs<FRealtimeMeshSimple>()->SetCoalesceProxyUpdates(bNewCoalesceProxyUpdates);
+}
+
+void URealtimeMeshSimple::FlushProxyUpdates() const
+{
+	GetMeshAs<FRealtimeMeshSimple>()->FlushProxyUpdates();
+}
+
+// ReSharper disable once CppMemberFunctionMayBeConst
+TFuture<ERealtimeMeshCollisionUpdateResult> URealtimeMeshSimple::SetUseDeformableCollision(bool bNewUseDeformableCollision)
+{
+	return GetMeshAs<FRealtimeMeshSimple>()->SetUseDeformableCollision(bNewUseDeformableCollision);
+}
+
+void URealtimeMeshSimple::SetUseDeformableCollision(bool bNewUseDeformableCollision, const FRealtimeMeshSimpleCollisionCompletionCallback& CompletionCallback)
+{
+	SetUseDeformableCollision(bNewUseDeformableCollision)
+		.Next([CompletionCallback](ERealtimeMeshCollisionUpdateResult Status)
+		{
+			(void)CompletionCallback.ExecuteIfBound(Status);
+		});
+}
+
+bool URealtimeMeshSimple::LineTraceDeformableCollision(const FVector3f& Start, const FVector3f& End, RealtimeMesh::FRealtimeMeshCollisionBVHHit& OutHit) const
+{
+	return GetMeshAs<FRealtimeMeshSimple>()->LineTraceDeformableCollision(Start, End, OutHit);
+}
+
 void URealtimeMeshSimple::Reset(bool bCreateNewMeshData)
 {
 	Super::Reset(bCreateNewMeshData);
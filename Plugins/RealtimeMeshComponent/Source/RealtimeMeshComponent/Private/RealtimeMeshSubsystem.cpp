@@ -2,11 +2,23 @@
 
 #include "RealtimeMeshSubsystem.h"
 #include "RealtimeMeshActor.h"
+#include "RealtimeMeshGuard.h"
+#include "RenderProxy/RealtimeMeshProxyCommandBatch.h"
 #include "RealtimeMeshSceneViewExtension.h"
 #include "SceneViewExtension.h"
 #include "Engine/Engine.h"
 #include "Engine/Level.h"
 #include "Misc/LazySingleton.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("RealtimeMeshGeneration - Pending"), STAT_RealtimeMeshGeneration_Pending, STATGROUP_RealtimeMesh);
+DECLARE_DWORD_COUNTER_STAT(TEXT("RealtimeMeshGeneration - Generated"), STAT_RealtimeMeshGeneration_Generated, STATGROUP_RealtimeMesh);
+DECLARE_CYCLE_STAT(TEXT("RealtimeMeshGeneration - Tick"), STAT_RealtimeMeshGeneration_Tick, STATGROUP_RealtimeMesh);
+
+static TAutoConsoleVariable<float> CVarRealtimeMeshGenerationFrameBudgetMs(
+	TEXT("RealtimeMesh.Generation.FrameBudgetMs"),
+	4.0f,
+	TEXT("Milliseconds per frame URealtimeMeshSubsystem spends running deferred ARealtimeMeshActor generations, the rest carry over to the next frame. 0 runs all of them"));
 
 
 URealtimeMeshSubsystem::URealtimeMeshSubsystem()
@@ -45,16 +57,87 @@ bool URealtimeMeshSubsystem::IsTickableInEditor() const
 
 void URealtimeMeshSubsystem::Tick(float DeltaTime)
 {
+	SCOPE_CYCLE_COUNTER(STAT_RealtimeMeshGeneration_Tick);
 	Super::Tick(DeltaTime);
 
-	// Rebuild all valid generated actors, if necessary
-	for (TWeakObjectPtr<ARealtimeMeshActor>& Actor : ActiveGeneratedActors)
+	BuildGenerationQueue();
+
+	const double BudgetSeconds = CVarRealtimeMeshGenerationFrameBudgetMs.GetValueOnGameThread() / 1000.0;
+	const double StartTime = FPlatformTime::Seconds();
+	double Now = StartTime;
+	int32 NumGenerated = 0;
+	int32 QueueIndex = 0;
+
+	{
+		// Every mesh generated this tick reaches its proxy in a single batch
+		RealtimeMesh::FRealtimeMeshUpdateTransaction Transaction;
+
+		// Always make progress, even when a single generation is over the budget. Actors destroyed
+		// since the queue was built are dropped without counting as a generation.
+		while (QueueIndex < GenerationQueue.Num() && (NumGenerated == 0 || BudgetSeconds <= 0.0 || Now - StartTime < BudgetSeconds))
+		{
+			const TWeakObjectPtr<ARealtimeMeshActor>& Actor = GenerationQueue[QueueIndex++].Actor;
+			if (Actor.IsValid())
+			{
+				Actor->ExecuteRebuildGeneratedMeshIfPending();
+				NumGenerated++;
+			}
+			PendingSince.Remove(Actor);
+			Now = FPlatformTime::Seconds();
+		}
+	}
+
+	// Whatever didn't fit is still pending and gets queued again next Tick
+	double OldestPendingSince = Now;
+	for (int32 Index = QueueIndex; Index < GenerationQueue.Num(); Index++)
+	{
+		if (const double* Since = PendingSince.Find(GenerationQueue[Index].Actor))
+		{
+			OldestPendingSince = FMath::Min(OldestPendingSince, *Since);
+		}
+	}
+
+	GenerationStats.NumPending = GenerationQueue.Num() - QueueIndex;
+	GenerationStats.NumGeneratedLastTick = NumGenerated;
+	GenerationStats.GenerationTimeLastTickMs = static_cast<float>((Now - StartTime) * 1000.0);
+	GenerationStats.OldestPendingSeconds = static_cast<float>(Now - OldestPendingSince);
+	GenerationStats.TicksBehind = GenerationStats.NumPending > 0 ? GenerationStats.TicksBehind + 1 : 0;
+
+	SET_DWORD_STAT(STAT_RealtimeMeshGeneration_Pending, GenerationStats.NumPending);
+	SET_DWORD_STAT(STAT_RealtimeMeshGeneration_Generated, NumGenerated);
+}
+
+void URealtimeMeshSubsystem::BuildGenerationQueue()
+{
+	GenerationQueue.Reset();
+
+	const UWorld* World = GetWorld();
+	const TArray<FVector>& ViewLocations = World->ViewLocationsRenderedLastFrame;
+	const double Now = FPlatformTime::Seconds();
+
+	for (const TWeakObjectPtr<ARealtimeMeshActor>& Actor : ActiveGeneratedActors)
 	{
-		if (Actor.IsValid() && IsValid(Actor->GetLevel()))
+		if (!Actor.IsValid() || !IsValid(Actor->GetLevel()) || !Actor->IsGeneratedMeshRebuildPending())
 		{
-			Actor->ExecuteRebuildGeneratedMeshIfPending();
+			PendingSince.Remove(Actor);
+			continue;
 		}
+
+		// Without a rendered view yet every actor is equally close
+		double DistanceSquared = ViewLocations.Num() > 0 ? TNumericLimits<double>::Max() : 0.0;
+		for (const FVector& ViewLocation : ViewLocations)
+		{
+			DistanceSquared = FMath::Min(DistanceSquared, FVector::DistSquared(ViewLocation, Actor->GetActorLocation()));
+		}
+
+		GenerationQueue.Add({ Actor, Actor->GenerationPriority, DistanceSquared });
+		PendingSince.FindOrAdd(Actor, Now);
 	}
+
+	GenerationQueue.Sort([](const FPendingGeneration& A, const FPendingGeneration& B)
+	{
+		return A.Priority != B.Priority ? A.Priority > B.Priority : A.DistanceSquared < B.DistanceSquared;
+	});
 }
 
 TStatId URealtimeMeshSubsystem::GetStatId() const
@@ -77,6 +160,7 @@ void URealtimeMeshSubsystem::UnregisterGeneratedMeshActor(ARealtimeMeshActor* Ac
 	if (GetWorld() && bInitialized)
 	{
 		ActiveGeneratedActors.Remove(Actor);
+		PendingSince.Remove(Actor);
 	}
 }
 
@@ -106,13 +190,19 @@ void RealtimeMesh::FRealtimeMeshEndOfFrameUpdateManager::OnPreSendAllEndOfFrameU
 	auto MeshesCopy = MoveTemp(MeshesToUpdate);
 	SyncRoot.Unlock();
 
-	for (const auto& MeshWeak : MeshesCopy)
 	{
-		if (auto Mesh = MeshWeak.Pin())
+		RealtimeMesh::FRealtimeMeshUpdateTransaction Transaction;
+		for (const auto& MeshWeak : MeshesCopy)
 		{
-			Mesh->ProcessEndOfFrameUpdates();
+			if (auto Mesh = MeshWeak.Pin())
+			{
+				Mesh->ProcessEndOfFrameUpdates();
+			}
 		}
 	}
+
+	// Snapshots retired while a lock-free read was still in them are otherwise only freed by the next retire
+	RealtimeMesh::FRealtimeMeshEpoch::Collect();
 }
 
 RealtimeMesh::FRealtimeMeshEndOfFrameUpdateManager::~FRealtimeMeshEndOfFrameUpdateManager()
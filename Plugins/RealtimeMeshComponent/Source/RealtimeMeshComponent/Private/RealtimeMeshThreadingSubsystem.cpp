@@ -3,6 +3,32 @@
 
 #include "RealtimeMeshThreadingSubsystem.h"
 #include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "RealtimeMeshComponentModule.h"
+
+static TAutoConsoleVariable<int32> CVarRealtimeMeshThreadPoolNumThreads(
+	TEXT("RealtimeMesh.ThreadPool.NumThreads"),
+	0,
+	TEXT("Number of RealtimeMesh worker threads, 0 uses half the physical cores"),
+	ECVF_ReadOnly);
+
+static TAutoConsoleVariable<int32> CVarRealtimeMeshThreadPoolMaxThreads(
+	TEXT("RealtimeMesh.ThreadPool.MaxThreads"),
+	8,
+	TEXT("Upper limit for the automatically chosen number of RealtimeMesh worker threads"),
+	ECVF_ReadOnly);
+
+static TAutoConsoleVariable<int32> CVarRealtimeMeshThreadPoolStackSizeKB(
+	TEXT("RealtimeMesh.ThreadPool.StackSizeKB"),
+	512,
+	TEXT("Stack size of the RealtimeMesh worker threads in KB, at least 128. LOD simplification and the distance field and card builds run on them"),
+	ECVF_ReadOnly);
+
+static TAutoConsoleVariable<int32> CVarRealtimeMeshThreadPoolPriority(
+	TEXT("RealtimeMesh.ThreadPool.ThreadPriority"),
+	static_cast<int32>(TPri_Normal),
+	TEXT("EThreadPriority of the RealtimeMesh worker threads. 0 Normal, 1 AboveNormal, 2 BelowNormal, 4 Lowest, 5 SlightlyBelowNormal, anything else falls back to Normal"),
+	ECVF_ReadOnly);
 
 void URealtimeMeshThreadingSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
@@ -23,8 +49,33 @@ FQueuedThreadPool& URealtimeMeshThreadingSubsystem::GetThreadPool()
 {
 	if (!ThreadPool.IsValid())
 	{
+		int32 NumThreads = CVarRealtimeMeshThreadPoolNumThreads.GetValueOnAnyThread();
+		if (NumThreads <= 0)
+		{
+			// Leave the other half to the task graph and the render thread
+			NumThreads = FMath::Clamp(FPlatformMisc::NumberOfCores() / 2, 1, FMath::Max(CVarRealtimeMeshThreadPoolMaxThreads.GetValueOnAnyThread(), 1));
+		}
+		const uint32 StackSize = FMath::Max(CVarRealtimeMeshThreadPoolStackSizeKB.GetValueOnAnyThread(), 128) * 1024;
+
+		// Highest and TimeCritical would starve the game and render threads, they are treated like invalid values
+		const int32 Priority = CVarRealtimeMeshThreadPoolPriority.GetValueOnAnyThread();
+		EThreadPriority ThreadPriority = TPri_Normal;
+		switch (Priority)
+		{
+		case TPri_Normal:
+		case TPri_AboveNormal:
+		case TPri_BelowNormal:
+		case TPri_Lowest:
+		case TPri_SlightlyBelowNormal:
+			ThreadPriority = static_cast<EThreadPriority>(Priority);
+			break;
+		default:
+			UE_LOG(LogRealtimeMesh, Warning, TEXT("RealtimeMesh.ThreadPool.ThreadPriority %d is not supported, using Normal"), Priority);
+			break;
+		}
+
 		ThreadPool = TUniquePtr<FQueuedThreadPool>(FQueuedThreadPool::Allocate());
-		ThreadPool->Create(4,  64 * 1024, TPri_Normal, TEXT("RealtimeMeshThreadPool"));
+		ThreadPool->Create(NumThreads, StackSize, ThreadPriority, TEXT("RealtimeMeshThreadPool"));
 	}
 	
 	return *ThreadPool;
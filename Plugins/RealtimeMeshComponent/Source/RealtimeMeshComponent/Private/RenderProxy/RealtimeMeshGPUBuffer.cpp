@@ -7,6 +7,12 @@ namespace RealtimeMesh
 {
 	void FRealtimeMeshSectionGroupStreamUpdateData::CreateBufferAsyncIfPossible(FRealtimeMeshUpdateContext& UpdateContext)
 	{
+		// Range updates write into the buffer the proxy already has
+		if (IsRangeUpdate())
+		{
+			return;
+		}
+		
 		if (false && GRHISupportsAsyncTextureCreation)
 		{
 			auto& RHICmdList = UpdateContext.GetRHICmdList();
@@ -40,7 +46,7 @@ namespace RealtimeMesh
 
 	void FRealtimeMeshSectionGroupStreamUpdateData::FinalizeInitialization(FRHICommandListBase& RHICmdList)
 	{
-		if (!Buffer.IsValid())
+		if (!Buffer.IsValid() && !IsRangeUpdate())
 		{
 			check(Stream.GetResourceDataSize());
 				
@@ -70,4 +76,36 @@ namespace RealtimeMesh
 #endif
 		}
 	}
+
+	bool FRealtimeMeshGPUBuffer::UpdateRange(FRHICommandListBase& RHICmdList, const FRealtimeMeshSectionGroupStreamUpdateDataRef& UpdateData)
+	{
+		check(UpdateData->IsRangeUpdate());
+
+		FRHIBuffer* RHIBuffer = GetRHIBuffer();
+		const uint32 Stride = UpdateData->GetStride();
+		if (!RHIBuffer || !(BufferLayout == UpdateData->GetBufferLayout()) ||
+			RHIBuffer->GetSize() != static_cast<uint32>(UpdateData->GetTotalNumElements()) * Stride ||
+			UpdateData->GetDestinationIndex() < 0 || UpdateData->GetDestinationIndex() + UpdateData->GetNumElements() > UpdateData->GetTotalNumElements())
+		{
+			return false;
+		}
+
+		const uint32 Offset = UpdateData->GetDestinationIndex() * Stride;
+		const uint32 Size = UpdateData->GetNumElements() * Stride;
+		if (Size == 0)
+		{
+			return true;
+		}
+
+#if RMC_ENGINE_ABOVE_5_3
+		void* Destination = RHICmdList.LockBuffer(RHIBuffer, Offset, Size, RLM_WriteOnly);
+		FMemory::Memcpy(Destination, UpdateData->GetResource()->GetResourceData(), Size);
+		RHICmdList.UnlockBuffer(RHIBuffer);
+#else
+		void* Destination = RHILockBuffer(RHIBuffer, Offset, Size, RLM_WriteOnly);
+		FMemory::Memcpy(Destination, UpdateData->GetResource()->GetResourceData(), Size);
+		RHIUnlockBuffer(RHIBuffer);
+#endif
+		return true;
+	}
 }
@@ -29,8 +29,7 @@ namespace RealtimeMesh
 
 			if (!ThisShared->bFinalized)
 			{
-				ThisShared->FinalPromise->EmplaceValue(ThisShared->Result);
-				ThisShared->bFinalized = true;
+				ThisShared->Finalize();
 			}
 		});
 	}
@@ -41,20 +40,62 @@ namespace RealtimeMesh
 
 		if (bRenderThreadReady && !bFinalized)
 		{
-			FinalPromise->EmplaceValue(Result);
-			bFinalized = true;
+			Finalize();
 		}
 	}
 
+	void FRealtimeMeshCommandBatchIntermediateFuture::Finalize()
+	{
+		FinalPromise->EmplaceValue(Result);
+		for (TPromise<ERealtimeMeshProxyUpdateStatus>& Promise : MergedPromises)
+		{
+			Promise.EmplaceValue(Result);
+		}
+		MergedPromises.Empty();
+		bFinalized = true;
+	}
+
 
 
 
 	
 	
+	void FRealtimeMeshProxyUpdateBuilder::AddTask(FTask&& Task)
+	{
+		if (Task.bReplacesStream)
+		{
+			check(Task.Stream.IsSet());
+			for (FTask& Existing : Tasks)
+			{
+				if (Existing.Function && Existing.Stream == Task.Stream)
+				{
+					Existing.Function = TaskFunctionType();
+					NumReplacedTasks++;
+				}
+			}
+		}
+		Tasks.Add(MoveTemp(Task));
+	}
+
+	void FRealtimeMeshProxyUpdateBuilder::Append(FRealtimeMeshProxyUpdateBuilder&& Other)
+	{
+		bRequiresProxyRecreate |= Other.bRequiresProxyRecreate;
+		for (FTask& Task : Other.Tasks)
+		{
+			if (Task.Function)
+			{
+				AddTask(MoveTemp(Task));
+			}
+		}
+		Other.Tasks.Empty();
+		Other.NumReplacedTasks = 0;
+		Other.bRequiresProxyRecreate = false;
+	}
+
 	void FRealtimeMeshProxyUpdateBuilder::AddMeshTask(TUniqueFunction<void(FRHICommandListBase&, FRealtimeMeshProxy&)>&& Function, bool bInRequiresProxyRecreate)
 	{
 		bRequiresProxyRecreate |= bInRequiresProxyRecreate;
-		Tasks.Add(MoveTemp(Function));
+		AddTask(FTask { MoveTemp(Function) });
 	}
 
 	void FRealtimeMeshProxyUpdateBuilder::AddLODTask(const FRealtimeMeshLODKey& LODKey, TUniqueFunction<void(FRHICommandListBase&, FRealtimeMeshLODProxy&)>&& Function, bool bInRequiresProxyRecreate)
@@ -83,6 +124,19 @@ namespace RealtimeMesh
 		}, bInRequiresProxyRecreate);
 	}
 
+	void FRealtimeMeshProxyUpdateBuilder::AddSectionGroupStreamTask(const FRealtimeMeshSectionGroupKey& SectionGroupKey, const FRealtimeMeshStreamKey& StreamKey,
+		bool bReplacesStream, TUniqueFunction<void(FRHICommandListBase&, FRealtimeMeshSectionGroupProxy&)>&& Function, bool bInRequiresProxyRecreate)
+	{
+		AddSectionGroupTask(SectionGroupKey, MoveTemp(Function), bInRequiresProxyRecreate);
+
+		// Tag it after the fact so it goes through the same lookups as every other section group task
+		FTask Task = MoveTemp(Tasks.Last());
+		Tasks.Pop();
+		Task.Stream = MakeTuple(SectionGroupKey, StreamKey);
+		Task.bReplacesStream = bReplacesStream;
+		AddTask(MoveTemp(Task));
+	}
+
 	void FRealtimeMeshProxyUpdateBuilder::AddSectionTask(const FRealtimeMeshSectionKey& SectionKey, TUniqueFunction<void(FRHICommandListBase&, FRealtimeMeshSectionProxy&)>&& Function, bool bInRequiresProxyRecreate)
 	{
 		AddSectionGroupTask(SectionKey.SectionGroup(), [SectionKey, Func = MoveTemp(Function)](FRHICommandListBase& RHICmdList, const FRealtimeMeshSectionGroupProxy& SectionGroup)
@@ -114,12 +168,45 @@ namespace RealtimeMesh
 		{
 			return MakeFulfilledPromise<ERealtimeMeshProxyUpdateStatus>(ERealtimeMeshProxyUpdateStatus::NoProxy).GetFuture();
 		}
+
+		// Meshes that coalesce their proxy updates hold on to them until the end of the frame
+		if (TOptional<TFuture<ERealtimeMeshProxyUpdateStatus>> DeferredUpdate = Mesh->DeferProxyUpdates(Proxy.ToSharedRef(), *this))
+		{
+			return MoveTemp(DeferredUpdate.GetValue());
+		}
+
+		if (FRealtimeMeshUpdateTransaction* Transaction = FRealtimeMeshUpdateTransaction::GetActive())
+		{
+			return Transaction->Record(Mesh, Proxy.ToSharedRef(), *this);
+		}
 		
 		auto ThreadState = MakeShared<FRealtimeMeshCommandBatchIntermediateFuture>();
 
-		Proxy->EnqueueCommandBatch(MoveTemp(Tasks), ThreadState);
+		TArray<TaskFunctionType> TasksToSend;
+		TasksToSend.Reserve(NumTasks());
+		for (FTask& Task : Tasks)
+		{
+			if (Task.Function)
+			{
+				TasksToSend.Add(MoveTemp(Task.Function));
+			}
+		}
 
-		DoOnGameThread([ThreadState, MeshWeak = Mesh.ToWeakPtr(), bRecreateProxies = static_cast<bool>(bRequiresProxyRecreate)]()
+		Send(Proxy.ToSharedRef(), Mesh.ToWeakPtr(), MoveTemp(TasksToSend), bRequiresProxyRecreate, ThreadState);
+
+		Tasks.Empty();
+		NumReplacedTasks = 0;
+		bRequiresProxyRecreate = false;
+
+		return ThreadState->FinalPromise->GetFuture();
+	}
+
+	void FRealtimeMeshProxyUpdateBuilder::Send(const FRealtimeMeshProxyRef& Proxy, const TWeakPtr<const FRealtimeMesh>& MeshWeak, TArray<TaskFunctionType>&& InTasks,
+		bool bRecreateProxies, const TSharedRef<FRealtimeMeshCommandBatchIntermediateFuture>& ThreadState)
+	{
+		Proxy->EnqueueCommandBatch(MoveTemp(InTasks), ThreadState);
+
+		DoOnGameThread([ThreadState, MeshWeak, bRecreateProxies]()
 		{
 			if (bRecreateProxies)
 			{
@@ -134,10 +221,194 @@ namespace RealtimeMesh
 
 			ThreadState->FinalizeGameThread();
 		});
+	}
 
-		Tasks.Empty();
-		bRequiresProxyRecreate = false;
 
-		return ThreadState->FinalPromise->GetFuture();
+	namespace ProxyCommandBatch::Private
+	{
+		static thread_local FRealtimeMeshUpdateTransaction* ActiveTransaction = nullptr;
+	}
+
+	FRealtimeMeshUpdateTransaction::FRealtimeMeshUpdateTransaction()
+		: Outer(ProxyCommandBatch::Private::ActiveTransaction)
+		, NumCommits(0)
+	{
+		if (!Outer)
+		{
+			ProxyCommandBatch::Private::ActiveTransaction = this;
+		}
+	}
+
+	FRealtimeMeshUpdateTransaction::~FRealtimeMeshUpdateTransaction()
+	{
+		if (!Outer)
+		{
+			// Stop recording first, so anything committed while sending goes straight to its proxy
+			ProxyCommandBatch::Private::ActiveTransaction = nullptr;
+			Commit();
+		}
+	}
+
+	FRealtimeMeshUpdateTransaction* FRealtimeMeshUpdateTransaction::GetActive()
+	{
+		return ProxyCommandBatch::Private::ActiveTransaction;
+	}
+
+	TFuture<ERealtimeMeshProxyUpdateStatus> FRealtimeMeshUpdateTransaction::Record(const TSharedRef<const FRealtimeMesh>& Mesh, const FRealtimeMeshProxyRef& Proxy,
+		FRealtimeMeshProxyUpdateBuilder& Builder)
+	{
+		NumCommits++;
+
+		FMeshBatch* Batch;
+		if (const int32* BatchIndex = BatchIndices.Find(&Proxy.Get()))
+		{
+			Batch = Batches[*BatchIndex].Get();
+		}
+		else
+		{
+			BatchIndices.Add(&Proxy.Get(), Batches.Num());
+			Batch = Batches.Add_GetRef(MakeUnique<FMeshBatch>(Proxy, Mesh)).Get();
+		}
+
+		const bool bIsFirstCommit = Batch->Builder.Tasks.IsEmpty();
+		Batch->Builder.Append(MoveTemp(Builder));
+
+		return bIsFirstCommit
+			? Batch->ThreadState->FinalPromise->GetFuture()
+			: Batch->ThreadState->MergedPromises.Emplace_GetRef().GetFuture();
+	}
+
+	void FRealtimeMeshUpdateTransaction::Commit()
+	{
+		if (Outer)
+		{
+			return;
+		}
+
+		TArray<TUniquePtr<FMeshBatch>> BatchesToSend = MoveTemp(Batches);
+		Batches.Reset();
+		BatchIndices.Reset();
+
+		for (const TUniquePtr<FMeshBatch>& Batch : BatchesToSend)
+		{
+			TArray<FRealtimeMeshProxyUpdateBuilder::TaskFunctionType> TasksToSend;
+			TasksToSend.Reserve(Batch->Builder.NumTasks());
+			for (FRealtimeMeshProxyUpdateBuilder::FTask& Task : Batch->Builder.Tasks)
+			{
+				if (Task.Function)
+				{
+					TasksToSend.Add(MoveTemp(Task.Function));
+				}
+			}
+
+			FRealtimeMeshProxyUpdateBuilder::Send(Batch->Proxy, Batch->Mesh, MoveTemp(TasksToSend), Batch->Builder.bRequiresProxyRecreate, Batch->ThreadState);
+		}
+	}
+
+
+
+	FRealtimeMeshProxyUpdateCoalescer::~FRealtimeMeshProxyUpdateCoalescer()
+	{
+		// Never sent, the mesh went away first
+		for (FCommit& Commit : Commits)
+		{
+			Commit.Promise.EmplaceValue(ERealtimeMeshProxyUpdateStatus::NoProxy);
+		}
+	}
+
+	TFuture<ERealtimeMeshProxyUpdateStatus> FRealtimeMeshProxyUpdateCoalescer::Record(const TSharedRef<const FRealtimeMesh>& InMesh, const FRealtimeMeshProxyRef& InProxy,
+		FRealtimeMeshProxyUpdateBuilder& InBuilder)
+	{
+		// The proxy was recreated, what's pending belongs to the old one
+		if (Proxy.IsValid() && Proxy != InProxy)
+		{
+			Send();
+		}
+		Proxy = InProxy;
+		Mesh = InMesh;
+
+		FCommit& Commit = Commits.AddDefaulted_GetRef();
+		Commit.FirstTask = Builder.Tasks.Num();
+		Builder.Append(MoveTemp(InBuilder));
+		Commit.NumTasks = Builder.Tasks.Num() - Commit.FirstTask;
+
+		return Commit.Promise.GetFuture();
+	}
+
+	bool FRealtimeMeshProxyUpdateCoalescer::IsSuperseded(const FCommit& Commit) const
+	{
+		bool bWroteStreams = false;
+		for (int32 Index = Commit.FirstTask; Index < Commit.FirstTask + Commit.NumTasks; Index++)
+		{
+			const FRealtimeMeshProxyUpdateBuilder::FTask& Task = Builder.Tasks[Index];
+			if (Task.Stream.IsSet())
+			{
+				if (Task.Function)
+				{
+					return false;
+				}
+				bWroteStreams = true;
+			}
+		}
+		return bWroteStreams;
+	}
+
+	int32 FRealtimeMeshProxyUpdateCoalescer::NumSupersededCommits() const
+	{
+		int32 NumSuperseded = 0;
+		for (const FCommit& Commit : Commits)
+		{
+			NumSuperseded += IsSuperseded(Commit) ? 1 : 0;
+		}
+		return NumSuperseded;
+	}
+
+	void FRealtimeMeshProxyUpdateCoalescer::Send()
+	{
+		if (Commits.IsEmpty())
+		{
+			return;
+		}
+
+		auto ThreadState = MakeShared<FRealtimeMeshCommandBatchIntermediateFuture>();
+		TArray<TPromise<ERealtimeMeshProxyUpdateStatus>> SupersededPromises;
+		for (FCommit& Commit : Commits)
+		{
+			if (IsSuperseded(Commit))
+			{
+				SupersededPromises.Add(MoveTemp(Commit.Promise));
+			}
+			else
+			{
+				ThreadState->MergedPromises.Add(MoveTemp(Commit.Promise));
+			}
+		}
+		Commits.Empty();
+
+		TArray<FRealtimeMeshProxyUpdateBuilder::TaskFunctionType> TasksToSend;
+		TasksToSend.Reserve(Builder.NumTasks());
+		for (FRealtimeMeshProxyUpdateBuilder::FTask& Task : Builder.Tasks)
+		{
+			if (Task.Function)
+			{
+				TasksToSend.Add(MoveTemp(Task.Function));
+			}
+		}
+
+		const bool bRequiresProxyRecreate = Builder.bRequiresProxyRecreate;
+		Builder.Tasks.Empty();
+		Builder.NumReplacedTasks = 0;
+		Builder.bRequiresProxyRecreate = false;
+
+		const FRealtimeMeshProxyRef ProxyToUpdate = Proxy.ToSharedRef();
+		Proxy.Reset();
+
+		FRealtimeMeshProxyUpdateBuilder::Send(ProxyToUpdate, Mesh, MoveTemp(TasksToSend), bRequiresProxyRecreate, ThreadState);
+
+		// Completed last, their continuations may well commit to the mesh again
+		for (TPromise<ERealtimeMeshProxyUpdateStatus>& Promise : SupersededPromises)
+		{
+			Promise.EmplaceValue(ERealtimeMeshProxyUpdateStatus::Superseded);
+		}
 	}
 }
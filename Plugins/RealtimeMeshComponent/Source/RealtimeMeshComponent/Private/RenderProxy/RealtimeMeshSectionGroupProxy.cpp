@@ -21,6 +21,7 @@ namespace RealtimeMesh
 		, Key(InKey)
 		, VertexFactory(SharedResources->CreateVertexFactory())
 		, bVertexFactoryDirty(false)
+		, bRayTracingGeometryDirty(false)
 	{
 	}
 
@@ -101,6 +102,8 @@ namespace RealtimeMesh
 	{
 		TRACE_CPUPROFILER_EVENT_SCOPE(FRealtimeMeshSectionGroupProxy::CreateOrUpdateStream);
 
+		check(!InStream->IsRangeUpdate());
+
 		// If we didn't create the buffers async, create them now
 		InStream->FinalizeInitialization(RHICmdList);
 
@@ -127,6 +130,27 @@ namespace RealtimeMesh
 		bVertexFactoryDirty = true;
 	}
 
+	void FRealtimeMeshSectionGroupProxy::UpdateStreamRange(FRHICommandListBase& RHICmdList, const FRealtimeMeshSectionGroupStreamUpdateDataRef& InStream)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(FRealtimeMeshSectionGroupProxy::UpdateStreamRange);
+
+		check(InStream->IsRangeUpdate());
+
+		// The game thread only sends range updates for streams whose size and layout didn't change since the last full upload
+		const TSharedPtr<FRealtimeMeshGPUBuffer>* FoundBuffer = Streams.Find(InStream->GetStreamKey());
+		if (!ensureMsgf(FoundBuffer && (*FoundBuffer)->UpdateRange(RHICmdList, InStream),
+			TEXT("RealtimeMesh: Range update for stream %s doesn't match its GPU buffer"), *InStream->GetStreamKey().ToString()))
+		{
+			return;
+		}
+
+		// Same buffers and views, so the vertex factory stays valid
+		if (InStream->GetStreamKey() == FRealtimeMeshStreams::Position || InStream->GetStreamKey() == FRealtimeMeshStreams::Triangles)
+		{
+			bRayTracingGeometryDirty = true;
+		}
+	}
+
 	void FRealtimeMeshSectionGroupProxy::RemoveStream(const FRealtimeMeshStreamKey& StreamKey)
 	{
 		TRACE_CPUPROFILER_EVENT_SCOPE(FRealtimeMeshSectionGroupProxy::RemoveStream);
@@ -241,9 +265,10 @@ namespace RealtimeMesh
 			DrawMask.SetFlag(Config.DrawType == ERealtimeMeshSectionDrawType::Static ? ERealtimeMeshDrawMask::DrawStatic : ERealtimeMeshDrawMask::DrawDynamic);
 		}
 
-		if (bNeedsFactoryInitialization)
+		if (bNeedsFactoryInitialization || bRayTracingGeometryDirty)
 		{
 			UpdateRayTracingInfo(RHICmdList);
+			bRayTracingGeometryDirty = false;
 		}
 	}
 
@@ -20,6 +20,7 @@ class URealtimeMesh;
 namespace RealtimeMesh
 {
 	struct FRealtimeMeshUpdateContext;
+	struct FRealtimeMeshProxyUpdateBuilder;
 	struct IRealtimeMeshNaniteResources;
 
 
@@ -188,6 +189,12 @@ namespace RealtimeMesh
 		virtual void InitializeProxy(FRealtimeMeshUpdateContext& UpdateContext) const;
 
 		virtual void ProcessEndOfFrameUpdates() { }
+
+		/*
+		 * @brief Lets the mesh hold on to the proxy updates of a commit instead of them being sent right away
+		 * @return The commit's future if the mesh took the updates
+		 */
+		virtual TOptional<TFuture<ERealtimeMeshProxyUpdateStatus>> DeferProxyUpdates(const FRealtimeMeshProxyRef& Proxy, FRealtimeMeshProxyUpdateBuilder& Builder) const { return NullOpt; }
 		
 		virtual void FinalizeUpdate(FRealtimeMeshUpdateContext& UpdateContext);
 
@@ -27,6 +27,7 @@ namespace RealtimeMesh
 		virtual ~FRealtimeMeshSectionGroup() = default;
 
 		const FRealtimeMeshSectionGroupKey& GetKey(const FRealtimeMeshLockContext& LockContext) const { return Key; }
+		FRealtimeMeshSectionGroupConfig GetConfig(const FRealtimeMeshLockContext& LockContext) const { return Config; }
 		FRealtimeMeshStreamRange GetInUseRange(const FRealtimeMeshLockContext& LockContext) const;
 		TOptional<FBoxSphereBounds3f> GetLocalBounds(const FRealtimeMeshLockContext& LockContext) const;
 		bool HasSections(const FRealtimeMeshLockContext& LockContext) const;
@@ -67,6 +68,14 @@ namespace RealtimeMesh
 		virtual void UpdateConfig(FRealtimeMeshUpdateContext& UpdateContext, TFunction<void(FRealtimeMeshSectionGroupConfig&)> EditFunc);
 
 		virtual void CreateOrUpdateStream(FRealtimeMeshUpdateContext& UpdateContext, FRealtimeMeshStream&& Stream);
+
+		/**
+		 * @brief Uploads elements [StartIndex, StartIndex + Count) of a stream into its existing GPU buffer instead of replacing the buffer.
+		 * Only valid while the stream has the size and layout it was last sent to CreateOrUpdateStream with.
+		 * @param UpdateContext Update context used for this operation
+		 * @param Stream The full stream, only the range is copied out of it
+		 */
+		virtual void UpdateStreamRange(FRealtimeMeshUpdateContext& UpdateContext, const FRealtimeMeshStream& Stream, int32 StartIndex, int32 Count);
 		virtual void RemoveStream(FRealtimeMeshUpdateContext& UpdateContext, const FRealtimeMeshStreamKey& StreamKey);
 
 		virtual void SetAllStreams(FRealtimeMeshUpdateContext& UpdateContext, FRealtimeMeshStreamSet&& InStreams);
@@ -1141,6 +1141,40 @@ namespace RealtimeMesh
 			return TOptional<TRealtimeMeshStreamBuilderBase<AccessLayout, DataLayout, bAllowSubstreamAccess>>();
 		}
 
+		// Writes Source, or Source gathered through Gather, to the rows from StartIndex on with a single converting copy
+		template <typename ElementType>
+		static void SetStreamRange(FRealtimeMeshStream& Stream, SizeType StartIndex, TConstArrayView<ElementType> Source, TConstArrayView<int32> Gather)
+		{
+			const FRealtimeMeshBufferLayout SourceLayout = GetRealtimeMeshBufferLayout<ElementType>();
+			if (Gather.IsEmpty())
+			{
+				Stream.SetRange(StartIndex, SourceLayout, reinterpret_cast<const uint8*>(Source.GetData()), Source.Num());
+				return;
+			}
+
+			const ElementType* SourceData = Source.GetData();
+			const int32* GatherData = Gather.GetData();
+			const int32 NumToGather = Gather.Num();
+			if (Stream.IsOfType(SourceLayout))
+			{
+				// Same type, gather straight into the stream
+				ElementType* DestinationData = Stream.GetDataAtVertex<ElementType>(StartIndex);
+				for (int32 Index = 0; Index < NumToGather; Index++)
+				{
+					DestinationData[Index] = SourceData[GatherData[Index]];
+				}
+				return;
+			}
+
+			TArray<ElementType> Gathered;
+			Gathered.SetNumUninitialized(NumToGather);
+			for (int32 Index = 0; Index < NumToGather; Index++)
+			{
+				Gathered[Index] = SourceData[GatherData[Index]];
+			}
+			Stream.SetRange(StartIndex, SourceLayout, reinterpret_cast<const uint8*>(Gathered.GetData()), NumToGather);
+		}
+
 	public:
 
 		TRealtimeMeshBuilderLocal(FRealtimeMeshStreamSet& InExistingStreams)
@@ -1474,6 +1508,66 @@ namespace RealtimeMesh
 			return VertexBuilder(*this, VertIdx);
 		}
 
+		/*
+		 * @brief Appends vertices from separate attribute arrays with one converting copy per stream, instead of a bounds checked write
+		 * per attribute per vertex. Attributes that aren't supplied keep the stream defaults, normals and tangents fill the tangent stream
+		 * the same way SetNormal and SetTangent do
+		 * @param InGather Optional, appended vertex N takes entry InGather[N] of every supplied array. Without it every supplied array
+		 * must be the length of InPositions
+		 * @return Index of the first appended vertex
+		 */
+		SizeType AppendVertices(TConstArrayView<FVector3f> InPositions, TConstArrayView<FVector3f> InNormals = TConstArrayView<FVector3f>(),
+			TConstArrayView<FVector3f> InTangents = TConstArrayView<FVector3f>(), TConstArrayView<FVector2f> InTexCoords = TConstArrayView<FVector2f>(),
+			TConstArrayView<FColor> InColors = TConstArrayView<FColor>(), TConstArrayView<int32> InGather = TConstArrayView<int32>())
+		{
+			const bool bGather = !InGather.IsEmpty();
+			const int32 NumToAdd = bGather ? InGather.Num() : InPositions.Num();
+			checkf(bGather || ((InNormals.IsEmpty() || InNormals.Num() == NumToAdd) && (InTangents.IsEmpty() || InTangents.Num() == NumToAdd)
+				&& (InTexCoords.IsEmpty() || InTexCoords.Num() == NumToAdd) && (InColors.IsEmpty() || InColors.Num() == NumToAdd)),
+				TEXT("Vertex attribute arrays must match the number of positions"));
+			checkf((InNormals.IsEmpty() && InTangents.IsEmpty()) || HasTangents(), TEXT("Vertex tangents not enabled"));
+			checkf(InTexCoords.IsEmpty() || HasTexCoords(), TEXT("Vertex texcoords not enabled"));
+			checkf(InColors.IsEmpty() || HasVertexColors(), TEXT("Vertex colors not enabled"));
+
+			const SizeType StartIndex = Vertices.Num();
+			if (NumToAdd == 0)
+			{
+				return StartIndex;
+			}
+
+			// Growing the positions grows every stream in the vertex link pool, filled with its default row
+			Vertices.SetNumUninitialized(StartIndex + NumToAdd);
+			SetStreamRange(Vertices.GetStream(), StartIndex, InPositions, InGather);
+
+			if (!InNormals.IsEmpty() || !InTangents.IsEmpty())
+			{
+				const FVector3f* Normals = InNormals.GetData();
+				const FVector3f* TangentXs = InTangents.GetData();
+				TArray<TangentAccessType> TangentRows;
+				TangentRows.SetNumUninitialized(NumToAdd);
+				for (int32 Index = 0; Index < NumToAdd; Index++)
+				{
+					const int32 SourceIndex = bGather ? InGather[Index] : Index;
+					TangentRows[Index] = TangentAccessType(Normals ? Normals[SourceIndex] : FVector3f::ZAxisVector, TangentXs ? TangentXs[SourceIndex] : FVector3f::XAxisVector);
+				}
+				SetStreamRange<TangentAccessType>(Tangents->GetStream(), StartIndex, TangentRows, TConstArrayView<int32>());
+			}
+
+			if (!InTexCoords.IsEmpty())
+			{
+				// Fills channel 0, further channels keep their defaults
+				SetStreamRange(TexCoords->GetStream(), StartIndex, InTexCoords, InGather);
+			}
+
+			if (!InColors.IsEmpty())
+			{
+				SetStreamRange(Colors->GetStream(), StartIndex, InColors, InGather);
+			}
+
+			return StartIndex;
+		}
+
+
 
 		void SetPosition(int32 VertIdx, const FVector3f& InPosition)
 		{
@@ -1602,6 +1696,33 @@ namespace RealtimeMesh
 			return Result;
 		}
 
+		/*
+		 * @brief Appends triangles from a flat index list, three indices per triangle, converted to the index type in one copy
+		 * @param InPolyGroupIndex Polygroup of every appended triangle, INDEX_NONE leaves the polygroup stream default
+		 * @return Index of the first appended triangle
+		 */
+		SizeType AppendTriangles(TConstArrayView<int32> InIndices, int32 InPolyGroupIndex = INDEX_NONE)
+		{
+			checkf(InIndices.Num() % 3 == 0, TEXT("Index count must be a multiple of three"));
+			checkf(InPolyGroupIndex == INDEX_NONE || HasPolyGroups(), TEXT("Triangle material indices not enabled"));
+
+			const int32 NumToAdd = InIndices.Num() / 3;
+			const SizeType StartIndex = Triangles.Num();
+			if (NumToAdd == 0)
+			{
+				return StartIndex;
+			}
+
+			Triangles.SetNumUninitialized(StartIndex + NumToAdd);
+			Triangles.GetStream().SetRange(StartIndex, GetRealtimeMeshBufferLayout<TIndex3<int32>>(), reinterpret_cast<const uint8*>(InIndices.GetData()), NumToAdd);
+
+			if (InPolyGroupIndex != INDEX_NONE)
+			{
+				TrianglePolyGroups->GetStream().FillRange(StartIndex, NumToAdd, static_cast<uint32>(InPolyGroupIndex));
+			}
+			return StartIndex;
+		}
+
 		void SetTriangle(SizeType Index, const TIndex3<uint32>& NewTriangle)
 		{
 			Triangles.Set(Index, NewTriangle);
@@ -2,6 +2,7 @@
 
 
 #include "RealtimeMeshDataConversion.h"
+#include "RealtimeMeshVectorizedConversion.h"
 
 
 namespace RealtimeMesh
@@ -65,7 +66,7 @@ namespace RealtimeMesh
 
 	// float
 	RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL(float, float);
-	RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL(float, FFloat16);
+	RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL_CONTIGUOUS(float, FFloat16, FRealtimeMeshVectorizedConversion::ConvertFloatToHalf);
 
 	// FFloat16
 	RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL(FFloat16, float);
@@ -77,7 +78,7 @@ namespace RealtimeMesh
 	RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL(FVector2DHalf, FVector2d);
 
 	// FVector2f
-	RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL(FVector2f, FVector2DHalf);
+	RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL_CONTIGUOUS(FVector2f, FVector2DHalf, FRealtimeMeshVectorizedConversion::ConvertVector2fToHalf);
 	RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL(FVector2f, FVector2f);
 	RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL(FVector2f, FVector2d);
 
@@ -89,6 +90,7 @@ namespace RealtimeMesh
 	// FVector3f
 	RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL(FVector3f, FVector3f);
 	RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL(FVector3f, FVector3d);
+	RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL_CONTIGUOUS(FVector3f, FPackedNormal, FRealtimeMeshVectorizedConversion::ConvertVector3fToPackedNormal);
 
 	// FVector3d
 	RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL(FVector3d, FVector3f);
@@ -97,8 +99,8 @@ namespace RealtimeMesh
 	// FVector4f
 	RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL(FVector4f, FVector4f);
 	RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL(FVector4f, FVector4d);
-	RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL(FVector4f, FPackedNormal);
-	RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL(FVector4f, FPackedRGBA16N);
+	RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL_CONTIGUOUS(FVector4f, FPackedNormal, FRealtimeMeshVectorizedConversion::ConvertVector4fToPackedNormal);
+	RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL_CONTIGUOUS(FVector4f, FPackedRGBA16N, FRealtimeMeshVectorizedConversion::ConvertVector4fToPackedRGBA16N);
 
 	// FVector4d
 	RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL(FVector4d, FVector4f);
@@ -110,6 +110,18 @@ namespace RealtimeMesh
 #define RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL(FromElementType, ToElementType) \
 	RMC_DEFINE_ELEMENT_TYPE_CONVERTER(FromElementType, ToElementType, { Destination = ToElementType(Source); });
 
+// Same as the trivial converter, but whole arrays go through ContiguousConverter(const From*, To*, uint32 Count) instead of the per element loop
+#define RMC_DEFINE_ELEMENT_TYPE_CONVERTER_TRIVIAL_CONTIGUOUS(FromElementType, ToElementType, ContiguousConverter) \
+	FRealtimeMeshTypeConverterRegistration<FromElementType, ToElementType> GRegister##FromElementType##To##ToElementType(FRealtimeMeshElementConverters( \
+			[](const void* SourceElement, void* DestinationElement) { \
+				*static_cast<ToElementType*>(DestinationElement) = ToElementType(*static_cast<const FromElementType*>(SourceElement)); \
+			}, \
+			[](const void* SourceArr, void* DestinationArr, uint32 Count) { \
+				ContiguousConverter(static_cast<const FromElementType*>(SourceArr), static_cast<ToElementType*>(DestinationArr), Count); \
+			} \
+		) \
+	);
+
 
 	template<typename SourceType, typename DestinationType>
 	FORCEINLINE_DEBUGGABLE DestinationType ConvertRealtimeMeshType(const SourceType& Source)
@@ -1224,6 +1224,8 @@ namespace RealtimeMesh
 	private:
 		TMap<FRealtimeMeshStreamKey, TUniquePtr<FRealtimeMeshStream>> Streams;
 		TMap<FName, TUniquePtr<FRealtimeMeshStreamLinkage>> StreamLinkages;
+		// Element ranges written since the last ClearDirtyRanges, streams without an entry count as fully dirty
+		TMap<FRealtimeMeshStreamKey, FInt32Range> DirtyRanges;
 
 		void CleanUpLinkages()
 		{
@@ -1266,6 +1268,15 @@ namespace RealtimeMesh
 				}
 			}
 
+			DirtyRanges.Empty(Other.DirtyRanges.Num());
+			for (auto RangeIt = Other.DirtyRanges.CreateConstIterator(); RangeIt; ++RangeIt)
+			{
+				if (Streams.Contains(RangeIt->Key))
+				{
+					DirtyRanges.Add(RangeIt->Key, RangeIt->Value);
+				}
+			}
+
 			if (bIncludeLinkages)
 			{
 				StreamLinkages.Empty(Other.StreamLinkages.Num());
@@ -1286,7 +1297,7 @@ namespace RealtimeMesh
 		}
 
 		int32 Num() const { return Streams.Num(); }
-		void Empty() { Streams.Empty(); StreamLinkages.Empty(); }
+		void Empty() { Streams.Empty(); StreamLinkages.Empty(); DirtyRanges.Empty(); }
 		bool IsEmpty() const { return Streams.IsEmpty(); }
 
 		int32 Remove(const FRealtimeMeshStreamKey& StreamKey)
@@ -1296,7 +1307,8 @@ namespace RealtimeMesh
 			{
 				(*Stream)->UnLink();
 				CleanUpLinkages();
-			}			
+			}
+			DirtyRanges.Remove(StreamKey);
 			return Streams.Remove(StreamKey);
 		}
 
@@ -1305,6 +1317,7 @@ namespace RealtimeMesh
 			int32 RemovedCount = 0;
 			for (const FRealtimeMeshStreamKey& StreamKey : StreamKeys)
 			{
+				DirtyRanges.Remove(StreamKey);
 				RemovedCount += Streams.Remove(StreamKey);
 			}
 			if  (RemovedCount)
@@ -1338,6 +1351,7 @@ namespace RealtimeMesh
 			{
 				if (!bKeepData)
 				{
+					DirtyRanges.Remove(StreamKey);
 					(*Result)->Empty();
 				}
 				if (!(*Result)->ConvertTo(NewLayout))
@@ -1347,6 +1361,7 @@ namespace RealtimeMesh
 				return *Result->Get();
 			}
 			
+			DirtyRanges.Remove(StreamKey);
 			auto& Entry = Streams.FindOrAdd(StreamKey);
 			Entry = MakeUnique<FRealtimeMeshStream>(StreamKey, NewLayout);
 			return *Entry.Get();
@@ -1395,6 +1410,7 @@ namespace RealtimeMesh
 		FRealtimeMeshStream& AddStream(ERealtimeMeshStreamType StreamType, FName StreamName, const FRealtimeMeshBufferLayout& InLayout)
 		{
 			const FRealtimeMeshStreamKey StreamKey(StreamType, StreamName);
+			DirtyRanges.Remove(StreamKey);
 			auto& Entry = Streams.FindOrAdd(StreamKey);
 			Entry = MakeUnique<FRealtimeMeshStream>(StreamKey, InLayout);
 			return *Entry.Get();
@@ -1402,6 +1418,7 @@ namespace RealtimeMesh
 		
 		FRealtimeMeshStream& AddStream(const FRealtimeMeshStreamKey& StreamKey, const FRealtimeMeshBufferLayout& InLayout)
 		{
+			DirtyRanges.Remove(StreamKey);
 			auto& Entry = Streams.FindOrAdd(StreamKey);
 			Entry = MakeUnique<FRealtimeMeshStream>(StreamKey, InLayout);
 			return *Entry.Get();
@@ -1411,6 +1428,7 @@ namespace RealtimeMesh
 		FRealtimeMeshStream& AddStream(ERealtimeMeshStreamType StreamType, FName StreamName)
 		{
 			const FRealtimeMeshStreamKey StreamKey(StreamType, StreamName);
+			DirtyRanges.Remove(StreamKey);
 			auto& Entry = Streams.FindOrAdd(StreamKey);
 			Entry = MakeUnique<FRealtimeMeshStream>(StreamKey, GetRealtimeMeshBufferLayout<StreamLayout>());
 			return *Entry.Get();
@@ -1419,6 +1437,7 @@ namespace RealtimeMesh
 		template <typename StreamLayout>
 		FRealtimeMeshStream& AddStream(const FRealtimeMeshStreamKey& StreamKey)
 		{
+			DirtyRanges.Remove(StreamKey);
 			auto& Entry = Streams.FindOrAdd(StreamKey);
 			Entry = MakeUnique<FRealtimeMeshStream>(StreamKey, GetRealtimeMeshBufferLayout<StreamLayout>());
 			return *Entry.Get();
@@ -1426,6 +1445,7 @@ namespace RealtimeMesh
 
 		FRealtimeMeshStream& AddStream(const FRealtimeMeshStream& Stream)
 		{
+			DirtyRanges.Remove(Stream.GetStreamKey());
 			auto& Entry = Streams.FindOrAdd(Stream.GetStreamKey());
 			Entry = MakeUnique<FRealtimeMeshStream>(Stream);
 			return *Entry.Get();
@@ -1433,6 +1453,7 @@ namespace RealtimeMesh
 
 		FRealtimeMeshStream& AddStream(FRealtimeMeshStream&& Stream)
 		{
+			DirtyRanges.Remove(Stream.GetStreamKey());
 			auto& Entry = Streams.FindOrAdd(Stream.GetStreamKey());
 			Entry = MakeUnique<FRealtimeMeshStream>(MoveTemp(Stream));
 			return *Entry.Get();
@@ -1481,6 +1502,33 @@ namespace RealtimeMesh
 			AddStreamToLinkPool(LinkPool, StreamKey, FRealtimeMeshStreamDefaultRowValue());
 		}
 
+		/*
+		 * @brief Record that elements [StartIndex, StartIndex + Count) of a stream were written. Edits through
+		 * URealtimeMeshSimple::EditMeshInPlace upload only the recorded range of a stream when its size and layout are
+		 * unchanged, instead of the whole stream. Ranges recorded for the same stream merge into one that covers both.
+		 */
+		void MarkRangeDirty(const FRealtimeMeshStreamKey& StreamKey, int32 StartIndex, int32 Count)
+		{
+			if (Count <= 0)
+			{
+				return;
+			}
+			
+			const FInt32Range NewRange(StartIndex, StartIndex + Count);
+			if (FInt32Range* Existing = DirtyRanges.Find(StreamKey))
+			{
+				*Existing = FInt32Range::Hull(*Existing, NewRange);
+			}
+			else
+			{
+				DirtyRanges.Add(StreamKey, NewRange);
+			}
+		}
+
+		// Null if no range was recorded for the stream, in which case it's treated as fully dirty
+		const FInt32Range* FindDirtyRange(const FRealtimeMeshStreamKey& StreamKey) const { return DirtyRanges.Find(StreamKey); }
+		void ClearDirtyRanges() { DirtyRanges.Empty(); }
+
 		void RemoveStreamFromLinkPool(FName LinkPool, const FRealtimeMeshStreamKey& StreamKey)
 		{
 			const auto* Stream = Streams.Find(StreamKey);
@@ -71,6 +71,8 @@ enum class ERealtimeMeshProxyUpdateStatus : uint8
 	NoProxy,
 	NoUpdate,
 	Updated,
+	// A later update of the same mesh replaced this one's stream data before it was uploaded
+	Superseded,
 };
 
 enum class ERealtimeMeshBatchCreationFlags : uint8
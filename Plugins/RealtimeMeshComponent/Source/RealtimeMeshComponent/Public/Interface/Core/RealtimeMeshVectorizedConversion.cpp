@@ -0,0 +1,429 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+
+#include "RealtimeMeshVectorizedConversion.h"
+#include "Templates/Identity.h"
+
+#define RMC_CONVERSION_SSE (PLATFORM_ENABLE_VECTORINTRINSICS && !PLATFORM_ENABLE_VECTORINTRINSICS_NEON && PLATFORM_CPU_X86_FAMILY)
+#define RMC_CONVERSION_AVX2 RMC_CONVERSION_SSE
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON && (defined(__aarch64__) || defined(_M_ARM64))
+#define RMC_CONVERSION_NEON 1
+#else
+#define RMC_CONVERSION_NEON 0
+#endif
+
+#if RMC_CONVERSION_AVX2
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// MSVC emits any intrinsic regardless of the target architecture
+#define RMC_AVX2_TARGET
+#else
+#define RMC_AVX2_TARGET __attribute__((target("avx2,f16c")))
+#endif
+#endif
+
+#if RMC_CONVERSION_NEON
+#include <arm_neon.h>
+#endif
+
+
+namespace RealtimeMesh
+{
+	namespace VectorizedConversion::Private
+	{
+		template<typename FromType, typename ToType>
+		using TConversionKernel = uint32(*)(const FromType*, ToType*, uint32);
+
+		/*
+		 * Runs the kernel for the requested path over as much of the array as it takes, each kernel returns how many
+		 * elements it converted. The remainder goes through the engine conversion one element at a time.
+		 */
+		template<typename FromType, typename ToType>
+		FORCEINLINE void Convert(const FromType* Source, ToType* Destination, uint32 Count, ERealtimeMeshConversionPath Path,
+		                         TIdentity_T<TConversionKernel<FromType, ToType>> AVX2Kernel, TIdentity_T<TConversionKernel<FromType, ToType>> VectorKernel)
+		{
+			Path = FMath::Min(Path, FRealtimeMeshVectorizedConversion::GetSupportedPath());
+
+			uint32 NumConverted = 0;
+			if (Path == ERealtimeMeshConversionPath::AVX2 && AVX2Kernel)
+			{
+				NumConverted = AVX2Kernel(Source, Destination, Count);
+			}
+			else if (Path >= ERealtimeMeshConversionPath::Vector && VectorKernel)
+			{
+				NumConverted = VectorKernel(Source, Destination, Count);
+			}
+
+			for (uint32 Index = NumConverted; Index < Count; Index++)
+			{
+				Destination[Index] = ToType(Source[Index]);
+			}
+		}
+
+		// Highest element count below Count that can be read four floats at a time, the last FVector3f has no fourth float after it
+		FORCEINLINE uint32 GetNumVector3fGroups(uint32 Count, uint32 GroupSize)
+		{
+			return Count > 0 ? ((Count - 1) / GroupSize) * GroupSize : 0;
+		}
+
+#if RMC_CONVERSION_SSE
+		namespace SSE
+		{
+			// Float to half with round to nearest even, matching FFloat16. SSE2 only, after Fabian Giesen's float_to_half_fast3_rtne
+			FORCEINLINE __m128i FloatToHalf(__m128 Value)
+			{
+				const __m128i SignMask = _mm_set1_epi32(0x80000000);
+				// Every float at or above this rounds to infinity
+				const __m128i HalfMax = _mm_set1_epi32((127 + 16) << 23);
+				// Smallest float that gives a normalized half
+				const __m128i MinNormal = _mm_set1_epi32((127 - 14) << 23);
+				const __m128i SubnormalMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+				// Rebias the exponent and add the mantissa rounding
+				const __m128i NormalBias = _mm_set1_epi32(0xfff - ((127 - 15) << 23));
+
+				const __m128 Sign = _mm_and_ps(_mm_castsi128_ps(SignMask), Value);
+				const __m128 Abs = _mm_xor_ps(Value, Sign);
+				const __m128i AbsBits = _mm_castps_si128(Abs);
+
+				const __m128i IsNaN = _mm_castps_si128(_mm_cmpunord_ps(Abs, Abs));
+				const __m128i IsRegular = _mm_cmpgt_epi32(HalfMax, AbsBits);
+				const __m128i InfOrNaN = _mm_or_si128(_mm_and_si128(IsNaN, _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7c00));
+				const __m128i IsSubnormal = _mm_cmpgt_epi32(MinNormal, AbsBits);
+
+				// Adding the magic value lets the float unit round the subnormal mantissa
+				const __m128i Subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(Abs, _mm_castsi128_ps(SubnormalMagic))), SubnormalMagic);
+
+				// Bias ties towards rounding up when the half mantissa would be odd
+				const __m128i MantissaOdd = _mm_srai_epi32(_mm_slli_epi32(AbsBits, 31 - 13), 31);
+				const __m128i Normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(AbsBits, NormalBias), MantissaOdd), 13);
+
+				const __m128i Finite = _mm_or_si128(_mm_and_si128(Subnormal, IsSubnormal), _mm_andnot_si128(IsSubnormal, Normal));
+				const __m128i Joined = _mm_or_si128(_mm_and_si128(Finite, IsRegular), _mm_andnot_si128(IsRegular, InfOrNaN));
+
+				// Negative results land in int16 range so the signed saturating pack keeps their bits
+				return _mm_or_si128(Joined, _mm_srai_epi32(_mm_castps_si128(Sign), 16));
+			}
+
+			/*
+			 * FMath::RoundToInt on SSE is cvt(2x + 0.5) >> 1, done the same way here so ties and the float rounding of the
+			 * scaled value match. The clamp only keeps the conversion in range, the saturating packs clamp to the exact type range.
+			 */
+			FORCEINLINE __m128i QuantizeRound(__m128 Value, __m128 Scale)
+			{
+				const __m128 Doubled = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(Value, Scale), _mm_set1_ps(2.0f)), _mm_set1_ps(0.5f));
+				const __m128 Clamped = _mm_min_ps(_mm_max_ps(Doubled, _mm_set1_ps(-131072.0f)), _mm_set1_ps(131072.0f));
+				return _mm_srai_epi32(_mm_cvtps_epi32(Clamped), 1);
+			}
+
+			FORCEINLINE __m128 LoadVector3f(const FVector3f& Vector)
+			{
+				// Reads the X of the next vector into W, then overwrites it with the 1 FPackedNormal stores for three component vectors
+				const __m128 XYZMask = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+				return _mm_or_ps(_mm_and_ps(_mm_loadu_ps(&Vector.X), XYZMask), _mm_set_ps(1.0f, 0.0f, 0.0f, 0.0f));
+			}
+
+			uint32 ConvertFloatToHalf(const float* Source, FFloat16* Destination, uint32 Count)
+			{
+				const uint32 NumVectorized = Count & ~7u;
+				for (uint32 Index = 0; Index < NumVectorized; Index += 8)
+				{
+					const __m128i Low = FloatToHalf(_mm_loadu_ps(Source + Index));
+					const __m128i High = FloatToHalf(_mm_loadu_ps(Source + Index + 4));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(Destination + Index), _mm_packs_epi32(Low, High));
+				}
+				return NumVectorized;
+			}
+
+			uint32 ConvertVector3fToPackedNormal(const FVector3f* Source, FPackedNormal* Destination, uint32 Count)
+			{
+				const __m128 Scale = _mm_set1_ps(MAX_int8);
+				const uint32 NumVectorized = GetNumVector3fGroups(Count, 4);
+				for (uint32 Index = 0; Index < NumVectorized; Index += 4)
+				{
+					const __m128i A = QuantizeRound(LoadVector3f(Source[Index + 0]), Scale);
+					const __m128i B = QuantizeRound(LoadVector3f(Source[Index + 1]), Scale);
+					const __m128i C = QuantizeRound(LoadVector3f(Source[Index + 2]), Scale);
+					const __m128i D = QuantizeRound(LoadVector3f(Source[Index + 3]), Scale);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(Destination + Index), _mm_packs_epi16(_mm_packs_epi32(A, B), _mm_packs_epi32(C, D)));
+				}
+				return NumVectorized;
+			}
+
+			uint32 ConvertVector4fToPackedNormal(const FVector4f* Source, FPackedNormal* Destination, uint32 Count)
+			{
+				const __m128 Scale = _mm_set1_ps(MAX_int8);
+				const uint32 NumVectorized = Count & ~3u;
+				for (uint32 Index = 0; Index < NumVectorized; Index += 4)
+				{
+					const __m128i A = QuantizeRound(_mm_loadu_ps(&Source[Index + 0].X), Scale);
+					const __m128i B = QuantizeRound(_mm_loadu_ps(&Source[Index + 1].X), Scale);
+					const __m128i C = QuantizeRound(_mm_loadu_ps(&Source[Index + 2].X), Scale);
+					const __m128i D = QuantizeRound(_mm_loadu_ps(&Source[Index + 3].X), Scale);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(Destination + Index), _mm_packs_epi16(_mm_packs_epi32(A, B), _mm_packs_epi32(C, D)));
+				}
+				return NumVectorized;
+			}
+
+			uint32 ConvertVector4fToPackedRGBA16N(const FVector4f* Source, FPackedRGBA16N* Destination, uint32 Count)
+			{
+				const __m128 Scale = _mm_set1_ps(MAX_int16);
+				const uint32 NumVectorized = Count & ~1u;
+				for (uint32 Index = 0; Index < NumVectorized; Index += 2)
+				{
+					const __m128i A = QuantizeRound(_mm_loadu_ps(&Source[Index + 0].X), Scale);
+					const __m128i B = QuantizeRound(_mm_loadu_ps(&Source[Index + 1].X), Scale);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(Destination + Index), _mm_packs_epi32(A, B));
+				}
+				return NumVectorized;
+			}
+		}
+#endif
+
+#if RMC_CONVERSION_AVX2
+		namespace AVX2
+		{
+			bool IsSupported()
+			{
+#if defined(_MSC_VER) && !defined(__clang__)
+				int32 Info[4];
+				__cpuid(Info, 0);
+				if (Info[0] < 7)
+				{
+					return false;
+				}
+
+				// AVX and F16C, and the OS has to save the upper halves of the ymm registers
+				__cpuid(Info, 1);
+				const int32 OSXSaveAVXF16C = (1 << 27) | (1 << 28) | (1 << 29);
+				if ((Info[2] & OSXSaveAVXF16C) != OSXSaveAVXF16C || (_xgetbv(0) & 0x6) != 0x6)
+				{
+					return false;
+				}
+
+				__cpuidex(Info, 7, 0);
+				return (Info[1] & (1 << 5)) != 0;
+#else
+				__builtin_cpu_init();
+				return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c");
+#endif
+			}
+
+			RMC_AVX2_TARGET FORCEINLINE __m256i QuantizeRound(__m256 Value, __m256 Scale)
+			{
+				const __m256 Doubled = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(Value, Scale), _mm256_set1_ps(2.0f)), _mm256_set1_ps(0.5f));
+				const __m256 Clamped = _mm256_min_ps(_mm256_max_ps(Doubled, _mm256_set1_ps(-131072.0f)), _mm256_set1_ps(131072.0f));
+				return _mm256_srai_epi32(_mm256_cvtps_epi32(Clamped), 1);
+			}
+
+			RMC_AVX2_TARGET uint32 ConvertFloatToHalf(const float* Source, FFloat16* Destination, uint32 Count)
+			{
+				const uint32 NumVectorized = Count & ~15u;
+				for (uint32 Index = 0; Index < NumVectorized; Index += 16)
+				{
+					const __m128i Low = _mm256_cvtps_ph(_mm256_loadu_ps(Source + Index), _MM_FROUND_TO_NEAREST_INT);
+					const __m128i High = _mm256_cvtps_ph(_mm256_loadu_ps(Source + Index + 8), _MM_FROUND_TO_NEAREST_INT);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(Destination + Index), Low);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(Destination + Index + 8), High);
+				}
+				return NumVectorized;
+			}
+
+			RMC_AVX2_TARGET uint32 ConvertVector4fToPackedNormal(const FVector4f* Source, FPackedNormal* Destination, uint32 Count)
+			{
+				const __m256 Scale = _mm256_set1_ps(MAX_int8);
+				// The packs work within each 128 bit lane, leaving even elements in the low lane and odd ones in the high lane
+				const __m256i Interleave = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+				const uint32 NumVectorized = Count & ~7u;
+				for (uint32 Index = 0; Index < NumVectorized; Index += 8)
+				{
+					const __m256i A = QuantizeRound(_mm256_loadu_ps(&Source[Index + 0].X), Scale);
+					const __m256i B = QuantizeRound(_mm256_loadu_ps(&Source[Index + 2].X), Scale);
+					const __m256i C = QuantizeRound(_mm256_loadu_ps(&Source[Index + 4].X), Scale);
+					const __m256i D = QuantizeRound(_mm256_loadu_ps(&Source[Index + 6].X), Scale);
+					const __m256i Packed = _mm256_packs_epi16(_mm256_packs_epi32(A, B), _mm256_packs_epi32(C, D));
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(Destination + Index), _mm256_permutevar8x32_epi32(Packed, Interleave));
+				}
+				return NumVectorized;
+			}
+
+			RMC_AVX2_TARGET uint32 ConvertVector4fToPackedRGBA16N(const FVector4f* Source, FPackedRGBA16N* Destination, uint32 Count)
+			{
+				const __m256 Scale = _mm256_set1_ps(MAX_int16);
+				const uint32 NumVectorized = Count & ~3u;
+				for (uint32 Index = 0; Index < NumVectorized; Index += 4)
+				{
+					const __m256i A = QuantizeRound(_mm256_loadu_ps(&Source[Index + 0].X), Scale);
+					const __m256i B = QuantizeRound(_mm256_loadu_ps(&Source[Index + 2].X), Scale);
+					const __m256i Packed = _mm256_packs_epi32(A, B);
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(Destination + Index), _mm256_permute4x64_epi64(Packed, _MM_SHUFFLE(3, 1, 2, 0)));
+				}
+				return NumVectorized;
+			}
+		}
+#endif
+
+#if RMC_CONVERSION_NEON
+		namespace NEON
+		{
+			// FMath::RoundToInt is floor(x + 0.5) off x86, the floor conversion saturates and the narrowing clamps to the type range
+			FORCEINLINE int32x4_t QuantizeRound(float32x4_t Value, float32x4_t Scale)
+			{
+				return vcvtmq_s32_f32(vaddq_f32(vmulq_f32(Value, Scale), vdupq_n_f32(0.5f)));
+			}
+
+			FORCEINLINE int8x8_t PackNormals(int32x4_t A, int32x4_t B)
+			{
+				return vqmovn_s16(vcombine_s16(vqmovn_s32(A), vqmovn_s32(B)));
+			}
+
+			FORCEINLINE float32x4_t LoadVector3f(const FVector3f& Vector)
+			{
+				// Reads the X of the next vector into W, then overwrites it with the 1 FPackedNormal stores for three component vectors
+				return vsetq_lane_f32(1.0f, vld1q_f32(&Vector.X), 3);
+			}
+
+			uint32 ConvertFloatToHalf(const float* Source, FFloat16* Destination, uint32 Count)
+			{
+				uint16* DestinationBits = reinterpret_cast<uint16*>(Destination);
+				const uint32 NumVectorized = Count & ~7u;
+				for (uint32 Index = 0; Index < NumVectorized; Index += 8)
+				{
+					const float16x4_t Low = vcvt_f16_f32(vld1q_f32(Source + Index));
+					const float16x4_t High = vcvt_f16_f32(vld1q_f32(Source + Index + 4));
+					vst1q_u16(DestinationBits + Index, vcombine_u16(vreinterpret_u16_f16(Low), vreinterpret_u16_f16(High)));
+				}
+				return NumVectorized;
+			}
+
+			uint32 ConvertVector3fToPackedNormal(const FVector3f* Source, FPackedNormal* Destination, uint32 Count)
+			{
+				const float32x4_t Scale = vdupq_n_f32(MAX_int8);
+				const uint32 NumVectorized = GetNumVector3fGroups(Count, 4);
+				for (uint32 Index = 0; Index < NumVectorized; Index += 4)
+				{
+					const int8x8_t AB = PackNormals(QuantizeRound(LoadVector3f(Source[Index + 0]), Scale), QuantizeRound(LoadVector3f(Source[Index + 1]), Scale));
+					const int8x8_t CD = PackNormals(QuantizeRound(LoadVector3f(Source[Index + 2]), Scale), QuantizeRound(LoadVector3f(Source[Index + 3]), Scale));
+					vst1q_s8(reinterpret_cast<int8*>(Destination + Index), vcombine_s8(AB, CD));
+				}
+				return NumVectorized;
+			}
+
+			uint32 ConvertVector4fToPackedNormal(const FVector4f* Source, FPackedNormal* Destination, uint32 Count)
+			{
+				const float32x4_t Scale = vdupq_n_f32(MAX_int8);
+				const uint32 NumVectorized = Count & ~3u;
+				for (uint32 Index = 0; Index < NumVectorized; Index += 4)
+				{
+					const int8x8_t AB = PackNormals(QuantizeRound(vld1q_f32(&Source[Index + 0].X), Scale), QuantizeRound(vld1q_f32(&Source[Index + 1].X), Scale));
+					const int8x8_t CD = PackNormals(QuantizeRound(vld1q_f32(&Source[Index + 2].X), Scale), QuantizeRound(vld1q_f32(&Source[Index + 3].X), Scale));
+					vst1q_s8(reinterpret_cast<int8*>(Destination + Index), vcombine_s8(AB, CD));
+				}
+				return NumVectorized;
+			}
+
+			uint32 ConvertVector4fToPackedRGBA16N(const FVector4f* Source, FPackedRGBA16N* Destination, uint32 Count)
+			{
+				const float32x4_t Scale = vdupq_n_f32(MAX_int16);
+				const uint32 NumVectorized = Count & ~1u;
+				for (uint32 Index = 0; Index < NumVectorized; Index += 2)
+				{
+					const int16x4_t A = vqmovn_s32(QuantizeRound(vld1q_f32(&Source[Index + 0].X), Scale));
+					const int16x4_t B = vqmovn_s32(QuantizeRound(vld1q_f32(&Source[Index + 1].X), Scale));
+					vst1q_s16(reinterpret_cast<int16*>(Destination + Index), vcombine_s16(A, B));
+				}
+				return NumVectorized;
+			}
+		}
+#endif
+
+#if RMC_CONVERSION_SSE
+		namespace Vector = SSE;
+#elif RMC_CONVERSION_NEON
+		namespace Vector = NEON;
+#endif
+
+		ERealtimeMeshConversionPath DetectSupportedPath()
+		{
+#if RMC_CONVERSION_AVX2
+			if (AVX2::IsSupported())
+			{
+				return ERealtimeMeshConversionPath::AVX2;
+			}
+#endif
+#if RMC_CONVERSION_SSE || RMC_CONVERSION_NEON
+			return ERealtimeMeshConversionPath::Vector;
+#else
+			return ERealtimeMeshConversionPath::Scalar;
+#endif
+		}
+	}
+
+	using namespace VectorizedConversion::Private;
+
+#if RMC_CONVERSION_AVX2
+#define RMC_AVX2_KERNEL(Name) &AVX2::Name
+#else
+#define RMC_AVX2_KERNEL(Name) nullptr
+#endif
+
+#if RMC_CONVERSION_SSE || RMC_CONVERSION_NEON
+#define RMC_VECTOR_KERNEL(Name) &Vector::Name
+#else
+#define RMC_VECTOR_KERNEL(Name) nullptr
+#endif
+
+	ERealtimeMeshConversionPath FRealtimeMeshVectorizedConversion::GetSupportedPath()
+	{
+		static const ERealtimeMeshConversionPath SupportedPath = DetectSupportedPath();
+		return SupportedPath;
+	}
+
+	const TCHAR* FRealtimeMeshVectorizedConversion::GetPathName(ERealtimeMeshConversionPath Path)
+	{
+		switch (Path)
+		{
+		case ERealtimeMeshConversionPath::Scalar:
+			return TEXT("Scalar");
+		case ERealtimeMeshConversionPath::Vector:
+			return RMC_CONVERSION_NEON ? TEXT("NEON") : TEXT("SSE2");
+		case ERealtimeMeshConversionPath::AVX2:
+			return TEXT("AVX2");
+		}
+		return TEXT("Unknown");
+	}
+
+	void FRealtimeMeshVectorizedConversion::ConvertFloatToHalf(const float* Source, FFloat16* Destination, uint32 Count, ERealtimeMeshConversionPath Path)
+	{
+		static_assert(sizeof(FFloat16) == sizeof(uint16));
+		Convert(Source, Destination, Count, Path, RMC_AVX2_KERNEL(ConvertFloatToHalf), RMC_VECTOR_KERNEL(ConvertFloatToHalf));
+	}
+
+	void FRealtimeMeshVectorizedConversion::ConvertVector2fToHalf(const FVector2f* Source, FVector2DHalf* Destination, uint32 Count, ERealtimeMeshConversionPath Path)
+	{
+		// FVector2DHalf converts each component through FFloat16
+		static_assert(sizeof(FVector2f) == sizeof(float) * 2 && sizeof(FVector2DHalf) == sizeof(FFloat16) * 2);
+		ConvertFloatToHalf(&Source->X, &Destination->X, Count * 2, Path);
+	}
+
+	void FRealtimeMeshVectorizedConversion::ConvertVector3fToPackedNormal(const FVector3f* Source, FPackedNormal* Destination, uint32 Count, ERealtimeMeshConversionPath Path)
+	{
+		static_assert(sizeof(FPackedNormal) == sizeof(int8) * 4);
+		// Three component vectors gain nothing from eight lanes, AVX2 runs the four lane kernel
+		Convert(Source, Destination, Count, Path, RMC_VECTOR_KERNEL(ConvertVector3fToPackedNormal), RMC_VECTOR_KERNEL(ConvertVector3fToPackedNormal));
+	}
+
+	void FRealtimeMeshVectorizedConversion::ConvertVector4fToPackedNormal(const FVector4f* Source, FPackedNormal* Destination, uint32 Count, ERealtimeMeshConversionPath Path)
+	{
+		Convert(Source, Destination, Count, Path, RMC_AVX2_KERNEL(ConvertVector4fToPackedNormal), RMC_VECTOR_KERNEL(ConvertVector4fToPackedNormal));
+	}
+
+	void FRealtimeMeshVectorizedConversion::ConvertVector4fToPackedRGBA16N(const FVector4f* Source, FPackedRGBA16N* Destination, uint32 Count, ERealtimeMeshConversionPath Path)
+	{
+		static_assert(sizeof(FPackedRGBA16N) == sizeof(int16) * 4);
+		Convert(Source, Destination, Count, Path, RMC_AVX2_KERNEL(ConvertVector4fToPackedRGBA16N), RMC_VECTOR_KERNEL(ConvertVector4fToPackedRGBA16N));
+	}
+
+#undef RMC_AVX2_KERNEL
+#undef RMC_VECTOR_KERNEL
+}
@@ -0,0 +1,36 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#pragma once
+
+#include "RealtimeMeshDataTypes.h"
+
+namespace RealtimeMesh
+{
+	enum class ERealtimeMeshConversionPath : uint8
+	{
+		// One element at a time through the engine types
+		Scalar,
+		// Four lanes, SSE2 on x86 and NEON on arm64
+		Vector,
+		// Eight lanes, AVX2 and F16C, x86 only
+		AVX2,
+	};
+
+	/**
+	 * Vectorized contiguous converters for the type pairs that dominate stream conversion before upload.
+	 * These back the contiguous array converters registered for those pairs, the widest path the CPU supports
+	 * is picked once at runtime. Every path produces the same bits as the per element engine conversion.
+	 */
+	struct REALTIMEMESHCOMPONENT_INTERFACE_API FRealtimeMeshVectorizedConversion
+	{
+		static ERealtimeMeshConversionPath GetSupportedPath();
+		static const TCHAR* GetPathName(ERealtimeMeshConversionPath Path);
+
+		// Paths wider than GetSupportedPath fall back to the widest supported one
+		static void ConvertFloatToHalf(const float* Source, FFloat16* Destination, uint32 Count, ERealtimeMeshConversionPath Path = GetSupportedPath());
+		static void ConvertVector2fToHalf(const FVector2f* Source, FVector2DHalf* Destination, uint32 Count, ERealtimeMeshConversionPath Path = GetSupportedPath());
+		static void ConvertVector3fToPackedNormal(const FVector3f* Source, FPackedNormal* Destination, uint32 Count, ERealtimeMeshConversionPath Path = GetSupportedPath());
+		static void ConvertVector4fToPackedNormal(const FVector4f* Source, FPackedNormal* Destination, uint32 Count, ERealtimeMeshConversionPath Path = GetSupportedPath());
+		static void ConvertVector4fToPackedRGBA16N(const FVector4f* Source, FPackedRGBA16N* Destination, uint32 Count, ERealtimeMeshConversionPath Path = GetSupportedPath());
+	};
+}
@@ -483,6 +483,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category="RealtimeMesh|MeshData")
 	static URealtimeMeshStreamSet* CopyStreamSetFromComponents(URealtimeMeshStreamSet* Streams, const FRealtimeMeshStreamSetFromComponents& Components);
 
+	// Welds duplicate vertices and reorders triangles and vertices for the GPU vertex cache, run it on finished streams before updating a section group with them
+	UFUNCTION(BlueprintCallable, Category="RealtimeMesh|MeshData")
+	static URealtimeMeshStreamSet* OptimizeStreamSet(URealtimeMeshStreamSet* Streams, bool bWeldVertices = true);
+
 	UFUNCTION(BlueprintCallable, Category="RealtimeMesh|MeshData")
 	static const FRealtimeMeshStreamRowPtr& SetIntElement(const FRealtimeMeshStreamRowPtr& Row, int32 Index, int32 ElementIdx, int32 NewValue);
 	UFUNCTION(BlueprintCallable, Category="RealtimeMesh|MeshData")
@@ -0,0 +1,55 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Mesh/RealtimeMeshCardRepresentation.h"
+
+namespace RealtimeMesh
+{
+	struct FRealtimeMeshStreamSet;
+
+	struct REALTIMEMESHCOMPONENT_API FRealtimeMeshCardRepresentationSettings
+	{
+		// Directions whose facing surface is below this fraction of the total surface area get no card
+		float MinSurfaceCoverage = 0.02f;
+
+		// Upper limit of cards per direction, elongated meshes are split along their long side so each card stays roughly square
+		int32 MaxCardsPerDirection = 4;
+
+		// Open geometry, back faces count towards the opposite direction and the cards are flagged as mostly two sided
+		bool bTwoSided = false;
+	};
+
+	/**
+	 * Generates the Lumen card representation FRealtimeMeshCardRepresentation carries for meshes built at runtime.
+	 * Cards are axis aligned like the engine's: for each of the six directions the triangles facing it are gathered and
+	 * the card is fit to their bounds instead of the whole mesh, directions with little facing surface are skipped.
+	 * A build is a single parallel pass over the triangles, cheap enough to repeat after every deformation.
+	 */
+	class REALTIMEMESHCOMPONENT_API FRealtimeMeshCardRepresentationGenerator
+	{
+	public:
+		FRealtimeMeshCardRepresentationGenerator(const FRealtimeMeshCardRepresentationSettings& InSettings = FRealtimeMeshCardRepresentationSettings());
+
+		const FRealtimeMeshCardRepresentationSettings& GetSettings() const { return Settings; }
+
+		/*
+		 * @brief Generate the cards of a mesh
+		 * @param InIndices Triangle list, three indices per triangle
+		 * @return False if the mesh has no surface to place cards on
+		 */
+		bool Build(TConstArrayView<FVector3f> InPositions, TConstArrayView<int32> InIndices, FRealtimeMeshCardRepresentation& OutCardRepresentation) const;
+		bool Build(const FRealtimeMeshStreamSet& Streams, FRealtimeMeshCardRepresentation& OutCardRepresentation) const;
+
+		/*
+		 * @brief Run Build on the RealtimeMesh thread pool, the result is unset if the mesh has no surface
+		 */
+		TFuture<TOptional<FRealtimeMeshCardRepresentation>> BuildAsync(TArray<FVector3f>&& InPositions, TArray<int32>&& InIndices) const;
+		TFuture<TOptional<FRealtimeMeshCardRepresentation>> BuildAsync(FRealtimeMeshStreamSet&& Streams) const;
+
+	private:
+		FRealtimeMeshCardRepresentationSettings Settings;
+	};
+}
@@ -0,0 +1,98 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace RealtimeMesh
+{
+	struct REALTIMEMESHCOMPONENT_API FRealtimeMeshCollisionBVHHit
+	{
+		// Fraction along the traced segment
+		float Time = 1.0f;
+		float Distance = 0.0f;
+		int32 Triangle = INDEX_NONE;
+		FVector3f Location = FVector3f::ZeroVector;
+		FVector3f Normal = FVector3f::ZeroVector;
+		// The trace hit the triangle from behind, front faces wind clockwise like the rest of the engine
+		bool bBackFace = false;
+	};
+
+	/**
+	 * CPU bounding volume hierarchy over a triangle mesh, used as query-only collision for meshes that deform every frame.
+	 * When only vertex positions change the tree is refit, recomputing the bounds of the leaves touching moved vertices
+	 * and their ancestors, instead of being rebuilt or handing a new trimesh to Chaos to cook.
+	 * All positions are in mesh local space.
+	 */
+	class REALTIMEMESHCOMPONENT_API FRealtimeMeshCollisionBVH
+	{
+	public:
+		static constexpr int32 MaxTrianglesPerLeaf = 4;
+
+		void Reset();
+		bool IsEmpty() const { return Nodes.IsEmpty(); }
+		int32 NumTriangles() const { return Indices.Num() / 3; }
+		int32 NumNodes() const { return Nodes.Num(); }
+		FBox3f GetBounds() const;
+
+		/*
+		 * @brief Build the tree from scratch
+		 * @param InPositions Vertex positions
+		 * @param InIndices Triangle list, three indices per triangle
+		 */
+		void Build(TConstArrayView<FVector3f> InPositions, TConstArrayView<int32> InIndices);
+
+		/*
+		 * @brief Refit the tree when the topology is unchanged, rebuild it otherwise
+		 * @param OutChangedBounds Optional, receives the bounds of the moved triangles before and after the move
+		 * @return Number of nodes whose bounds were recomputed, or INDEX_NONE if the topology changed and the tree was rebuilt
+		 */
+		int32 Update(TConstArrayView<FVector3f> InPositions, TConstArrayView<int32> InIndices, FBox3f* OutChangedBounds = nullptr);
+
+		/*
+		 * @brief Find the closest triangle crossed by the segment Start to End, triangles are hit from both sides
+		 * and the hit normal faces the trace start
+		 */
+		bool LineTrace(const FVector3f& Start, const FVector3f& End, FRealtimeMeshCollisionBVHHit& OutHit) const;
+
+		/*
+		 * @brief Find the closest point on the mesh within MaxDistance of Point, the hit normal is the front face normal
+		 */
+		bool FindClosestPoint(const FVector3f& Point, float MaxDistance, FRealtimeMeshCollisionBVHHit& OutHit) const;
+
+		SIZE_T GetAllocatedSize() const;
+
+	private:
+		struct FNode
+		{
+			FVector3f Min;
+			FVector3f Max;
+			// Leaf: first entry in TriangleOrder. Inner: index of the second child, the first child directly follows its parent
+			int32 Offset;
+			// Zero for inner nodes
+			int32 Count;
+
+			bool IsLeaf() const { return Count > 0; }
+		};
+
+		int32 BuildRecursive(int32 Parent, int32 Begin, int32 End, int32 Depth, TArray<FVector3f>& Centroids);
+		void ComputeLeafBounds(FNode& Node) const;
+		int32 Refit(TConstArrayView<FVector3f> InPositions, FBox3f* OutChangedBounds);
+
+		TArray<FNode> Nodes;
+		TArray<int32> ParentNodes;
+		// Triangles in leaf order
+		TArray<int32> TriangleOrder;
+		TArray<int32> TriangleLeaf;
+
+		TArray<FVector3f> Positions;
+		TArray<int32> Indices;
+
+		// Vertex to triangle adjacency in CSR form
+		TArray<int32> VertexTriangleOffsets;
+		TArray<int32> VertexTriangles;
+
+		// Refits since the last build, the tree loosens as the mesh drifts from the shape it was split for
+		int32 NumRefits = 0;
+	};
+}
@@ -0,0 +1,93 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DistanceFieldAtlas.h"
+#include "Mesh/RealtimeMeshCollisionBVH.h"
+
+struct FRealtimeMeshDistanceField;
+
+namespace RealtimeMesh
+{
+	struct FRealtimeMeshStreamSet;
+
+	struct REALTIMEMESHCOMPONENT_API FRealtimeMeshDistanceFieldSettings
+	{
+		// Mip0 voxels per local space unit, static meshes default to 0.2
+		float VoxelDensity = 0.2f;
+
+		// Extra room around the mesh bounds as a fraction of their extent, lets Update keep the volume while the mesh grows
+		float BoundsSlack = 0.0f;
+
+		// Open geometry, distances are unsigned and the field is flagged as mostly two sided
+		bool bTwoSided = false;
+	};
+
+	/**
+	 * Builds the sparse distance field volume that FRealtimeMeshDistanceField carries, in the same brick layout the
+	 * engine produces for static meshes, on the CPU from runtime mesh data. Bricks are computed in parallel against a
+	 * BVH of the mesh. The generator keeps the bricks of the last build so Update only recomputes the ones within the
+	 * encoding band of triangles that moved.
+	 * Not thread safe, run one Build or Update at a time.
+	 */
+	class REALTIMEMESHCOMPONENT_API FRealtimeMeshDistanceFieldGenerator
+	{
+	public:
+		FRealtimeMeshDistanceFieldGenerator(const FRealtimeMeshDistanceFieldSettings& InSettings = FRealtimeMeshDistanceFieldSettings());
+
+		const FRealtimeMeshDistanceFieldSettings& GetSettings() const { return Settings; }
+		void Reset();
+
+		/*
+		 * @brief Compute every brick from scratch
+		 * @param InIndices Triangle list, three indices per triangle
+		 * @return False if there were no triangles to build from
+		 */
+		bool Build(TConstArrayView<FVector3f> InPositions, TConstArrayView<int32> InIndices, FRealtimeMeshDistanceField& OutDistanceField);
+		bool Build(const FRealtimeMeshStreamSet& Streams, FRealtimeMeshDistanceField& OutDistanceField);
+
+		/*
+		 * @brief Recompute only the bricks around moved triangles. Falls back to Build when the triangles changed
+		 * or the mesh outgrew the volume of the last build
+		 */
+		bool Update(TConstArrayView<FVector3f> InPositions, TConstArrayView<int32> InIndices, FRealtimeMeshDistanceField& OutDistanceField);
+		bool Update(const FRealtimeMeshStreamSet& Streams, FRealtimeMeshDistanceField& OutDistanceField);
+
+		// Bricks recomputed by the last Build or Update across all mips
+		int32 GetNumBricksComputed() const { return NumBricksComputed; }
+		int32 GetNumBricks() const;
+
+	private:
+		struct FMip
+		{
+			FIntVector IndirectionDimensions = FIntVector::ZeroValue;
+			FBox3f VolumeBounds = FBox3f(ForceInit);
+			FVector3f IndirectionVoxelSize = FVector3f::ZeroVector;
+			float LocalSpaceTraceDistance = 0.0f;
+			FVector2f DistanceFieldToVolumeScaleBias = FVector2f::ZeroVector;
+			FVector3f VolumeToVirtualUVScale = FVector3f::ZeroVector;
+			FVector3f VolumeToVirtualUVAdd = FVector3f::ZeroVector;
+
+			// Quantized voxels of every brick, stored or not, so unchanged bricks are reused by Update
+			TArray<uint8> BrickVoxels;
+			TArray<uint8> ValidBricks;
+
+			int32 NumBricks() const { return IndirectionDimensions.X * IndirectionDimensions.Y * IndirectionDimensions.Z; }
+		};
+
+		void SetupVolume();
+		void ComputeBricks(FMip& Mip, const FBox3f* ChangedBounds);
+		bool ComputeBrick(const FMip& Mip, int32 BrickIndex, uint8* OutVoxels) const;
+		bool IsInside(const FVector3f& Point) const;
+		void WriteDistanceField(FRealtimeMeshDistanceField& OutDistanceField) const;
+
+		FRealtimeMeshDistanceFieldSettings Settings;
+		FRealtimeMeshCollisionBVH BVH;
+		FBox3f LocalSpaceMeshBounds;
+		float LocalToVolumeScale;
+		float InsideTraceLength;
+		TStaticArray<FMip, DistanceField::NumMips> Mips;
+		int32 NumBricksComputed;
+	};
+}
@@ -0,0 +1,104 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace RealtimeMesh
+{
+	struct FRealtimeMeshStream;
+	struct FRealtimeMeshStreamSet;
+
+	struct REALTIMEMESHCOMPONENT_API FRealtimeMeshLODGenerationSettings
+	{
+		// LODs generated after LOD0
+		int32 NumLODs = 3;
+
+		// Triangle count of each LOD relative to the one before it
+		float TriangleRatio = 0.5f;
+
+		// Error in pixels, on a 1920 pixel wide screen, a LOD is allowed to show at the screen size it is switched in at
+		float MaxPixelError = 1.0f;
+	};
+
+	/**
+	 * Quadric error metric simplifier for the triangles of a stream set. Edges are collapsed onto one of their vertices,
+	 * so no vertex is ever moved or created and every vertex stream of the source stays valid for the result.
+	 * Vertices on open borders, on UV or normal seams, which are borders in index space, and between polygroups never
+	 * move, which keeps the silhouette, the seams and the polygroup ranges intact.
+	 * Simplify can be called repeatedly with decreasing targets to produce a LOD chain from a single set of quadrics.
+	 */
+	class REALTIMEMESHCOMPONENT_API FRealtimeMeshSimplifier
+	{
+	public:
+		// The source must outlive the simplifier, GetResult copies its vertex streams
+		explicit FRealtimeMeshSimplifier(const FRealtimeMeshStreamSet& InSource);
+
+		bool IsValid() const { return Positions.Num() > 0 && Indices.Num() > 0; }
+		int32 GetNumSourceTriangles() const { return NumSourceTriangles; }
+		int32 GetNumTriangles() const { return Indices.Num() / 3; }
+
+		// Largest deviation from the source surface introduced so far, in mesh local units
+		float GetError() const { return Error; }
+
+		/*
+		 * @brief Collapse edges until at most TargetTriangles remain, no collapse is cheap enough or the next one would
+		 * exceed MaxError
+		 * @return Triangles remaining
+		 */
+		int32 Simplify(int32 TargetTriangles, float MaxError = TNumericLimits<float>::Max());
+
+		/*
+		 * @brief Write the current triangles as a stream set. Vertex streams are compacted to the vertices still in use,
+		 * polygroups follow their triangles and polygroup segments are regenerated. Depth only and reversed index streams
+		 * are not carried over
+		 */
+		void GetResult(FRealtimeMeshStreamSet& OutStreams) const;
+
+	private:
+		struct FQuadric
+		{
+			double A00 = 0.0, A01 = 0.0, A02 = 0.0, A11 = 0.0, A12 = 0.0, A22 = 0.0;
+			double B0 = 0.0, B1 = 0.0, B2 = 0.0;
+			double C = 0.0;
+			double Weight = 0.0;
+
+			void AddPlane(const FVector3f& Normal, float Distance, float InWeight);
+			void Add(const FQuadric& Other);
+			double Evaluate(const FVector3f& Point) const;
+		};
+
+		struct FCollapse
+		{
+			int32 From;
+			int32 To;
+			float Cost;
+		};
+
+		void BuildAdjacency();
+		void LockBoundaryVertices();
+		float GetCollapseCost(int32 From, int32 To) const;
+		bool IsCollapseAllowed(int32 From, int32 To) const;
+		bool HaveSamePolyGroup(int32 TriangleA, int32 TriangleB) const;
+
+		const FRealtimeMeshStreamSet& Source;
+		int32 NumSourceTriangles;
+
+		TArray<FVector3f> Positions;
+		// Current triangle list, three indices per triangle
+		TArray<int32> Indices;
+		// Source triangle of each current triangle, polygroups are looked up through it
+		TArray<int32> SourceTriangles;
+		// Source polygroups, compared bytewise so any index type works
+		const FRealtimeMeshStream* PolyGroups;
+
+		TArray<FQuadric> Quadrics;
+		TBitArray<> LockedVertices;
+
+		// Vertex to current triangle adjacency in CSR form, rebuilt every pass
+		TArray<int32> VertexTriangleOffsets;
+		TArray<int32> VertexTriangles;
+
+		float Error;
+	};
+}
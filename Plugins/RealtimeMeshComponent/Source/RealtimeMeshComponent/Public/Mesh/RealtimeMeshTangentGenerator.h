@@ -0,0 +1,51 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace RealtimeMesh
+{
+	/**
+	 * Tangent space generation equivalent to MikkTSpace for meshes whose vertices are unique, running in parallel over flat
+	 * vertex to corner adjacency. For each vertex the UV tangents of its triangles are projected into the plane of the vertex
+	 * normal and weighted by the corner angle in that plane. Triangles with mirrored UVs are summed apart and the side with
+	 * the larger angle wins, as a vertex can only carry one binormal sign. MikkTSpace merges vertices with the same position,
+	 * normal and UV first, run RealtimeMeshAlgo::WeldVertices on meshes that have such duplicates to get the same result.
+	 * The generator only views the arrays it is given, they must outlive it. Recomputing after vertices move costs a single
+	 * pass over the vertices, optionally restricted to the ones that changed.
+	 */
+	class REALTIMEMESHCOMPONENT_API FRealtimeMeshTangentGenerator
+	{
+	public:
+		/*
+		 * @brief Builds the vertex to corner adjacency in CSR form, corners are positions in the triangle list so Corner / 3 is the triangle
+		 * @return False if an index is outside [0, NumVertices)
+		 */
+		static bool BuildAdjacency(TConstArrayView<int32> Indices, int32 NumVertices, TArray<int32>& OutCornerOffsets, TArray<int32>& OutCorners);
+
+		FRealtimeMeshTangentGenerator(TConstArrayView<int32> InIndices, TConstArrayView<int32> InCornerOffsets, TConstArrayView<int32> InCorners);
+
+		int32 NumVertices() const { return FMath::Max(CornerOffsets.Num() - 1, 0); }
+
+		/*
+		 * @brief Angle weighted vertex normals, vertices without triangles keep their value
+		 * @param Vertices Optional subset of vertices to update, all of them if empty
+		 */
+		void ComputeNormals(TConstArrayView<FVector3f> Positions, TArrayView<FVector3f> OutNormals, TConstArrayView<int32> Vertices = TConstArrayView<int32>()) const;
+
+		/*
+		 * @brief Tangents orthogonal to the vertex normals, pointing along increasing U
+		 * @param UVs Optional, without UVs the tangents follow an edge of each triangle
+		 * @param OutBinormalSigns Optional, receives -1 where the UVs are mirrored and 1 elsewhere
+		 * @param Vertices Optional subset of vertices to update, all of them if empty
+		 */
+		void ComputeTangents(TConstArrayView<FVector3f> Positions, TConstArrayView<FVector3f> Normals, TConstArrayView<FVector2f> UVs, TArrayView<FVector3f> OutTangents,
+		                     TArrayView<float> OutBinormalSigns = TArrayView<float>(), TConstArrayView<int32> Vertices = TConstArrayView<int32>()) const;
+
+	private:
+		TConstArrayView<int32> Indices;
+		TConstArrayView<int32> CornerOffsets;
+		TConstArrayView<int32> Corners;
+	};
+}
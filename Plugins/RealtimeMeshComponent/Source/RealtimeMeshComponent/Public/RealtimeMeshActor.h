@@ -54,6 +54,13 @@ public:
 	UPROPERTY(Category = "RealtimeMeshActor|Advanced", EditAnywhere, BlueprintReadWrite)
 	bool bResetOnRebuild = true;
 
+	/**
+	 * Deferred generations run within a per-frame budget, higher priorities go first and
+	 * equal priorities go closest to the camera first.
+	 */
+	UPROPERTY(Category = "RealtimeMeshActor|Advanced", EditAnywhere, BlueprintReadWrite)
+	int32 GenerationPriority = 0;
+
 public:
 	ARealtimeMeshActor();
 	virtual ~ARealtimeMeshActor() override;
@@ -80,6 +87,9 @@ public:
 	 */
 	virtual void ExecuteRebuildGeneratedMeshIfPending();
 
+	/** True if ExecuteRebuildGeneratedMeshIfPending would fire the OnGenerateMesh event */
+	virtual bool IsGeneratedMeshRebuildPending() const;
+
 public:
 	//~ Begin UObject/AActor Interface
 	virtual void BeginPlay() override;
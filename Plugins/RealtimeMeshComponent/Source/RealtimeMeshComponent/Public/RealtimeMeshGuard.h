@@ -3,6 +3,7 @@
 #pragma once
 
 #include "RealtimeMeshCore.h"
+#include <atomic>
 
 namespace RealtimeMesh
 {
@@ -236,4 +237,123 @@ namespace RealtimeMesh
 
 		FRealtimeMeshGuard& Guard;
 	};
+
+
+	/**
+	 * Epoch based reclamation for data that is read without taking a FRealtimeMeshGuard.
+	 *
+	 * A reader announces the current epoch in a slot owned by its thread for the duration of the read. That is a store and
+	 * a fence on a cache line no other reader touches, not a read-modify-write on shared state like FRWLock::ReadLock.
+	 * Writers publish a new version of the data, retire the old one tagged with the epoch it was unpublished in, and it is
+	 * freed once no thread is still in a read that began before then.
+	 *
+	 * Reads nest and writers never wait on them, but nothing retired after a read began is freed until it ends.
+	 */
+	class REALTIMEMESHCOMPONENT_API FRealtimeMeshEpoch
+	{
+	public:
+		static void EnterRead();
+		static void ExitRead();
+		static bool IsInRead();
+
+		/*
+		 * @brief Call Deleter on Data once every read that could still see it has ended. Data must already be unpublished.
+		 */
+		static void Retire(void* Data, void (*Deleter)(void*));
+
+		/*
+		 * @brief Free the retired data whose grace period has passed
+		 * @return Number of retired objects still waiting on a read
+		 */
+		static int32 Collect();
+	};
+
+
+	struct FRealtimeMeshScopeEpochRead
+	{
+	public:
+		RMC_NODISCARD_CTOR FRealtimeMeshScopeEpochRead()
+		{
+			FRealtimeMeshEpoch::EnterRead();
+		}
+
+		~FRealtimeMeshScopeEpochRead()
+		{
+			FRealtimeMeshEpoch::ExitRead();
+		}
+
+	private:
+		UE_NONCOPYABLE(FRealtimeMeshScopeEpochRead);
+	};
+
+
+	/**
+	 * Immutable versions of some data, published by writers and read inside a FRealtimeMeshScopeEpochRead.
+	 * Writers are expected to be serialized by the owner, usually by holding its FRealtimeMeshGuard for write.
+	 */
+	template <typename DataType>
+	class TRealtimeMeshPublished
+	{
+	public:
+		TRealtimeMeshPublished()
+			: Current(nullptr)
+		{ }
+
+		~TRealtimeMeshPublished()
+		{
+			Reset();
+		}
+
+		UE_NONCOPYABLE(TRealtimeMeshPublished);
+
+		/*
+		 * @brief Latest published version or nullptr, only valid until the enclosing epoch read ends
+		 */
+		const DataType* Read() const
+		{
+			checkSlow(FRealtimeMeshEpoch::IsInRead());
+			return Current.load(std::memory_order_seq_cst);
+		}
+
+		bool IsPublished() const { return Current.load(std::memory_order_relaxed) != nullptr; }
+
+		/*
+		 * @brief Replace the published version, the previous one is freed after the grace period
+		 */
+		void Publish(TUniquePtr<DataType>&& NewData)
+		{
+			RetireData(Current.exchange(NewData.Release()));
+		}
+
+		/*
+		 * @brief Publish only when nothing is published yet, lets readers holding the guard for read fill it in
+		 * @return False if another version was published first, NewData is left untouched
+		 */
+		bool PublishIfEmpty(TUniquePtr<DataType>& NewData)
+		{
+			DataType* Expected = nullptr;
+			if (Current.compare_exchange_strong(Expected, NewData.Get()))
+			{
+				NewData.Release();
+				return true;
+			}
+			return false;
+		}
+
+		void Reset()
+		{
+			RetireData(Current.exchange(nullptr));
+		}
+
+	private:
+		static void RetireData(DataType* Data)
+		{
+			if (Data)
+			{
+				FRealtimeMeshEpoch::Retire(Data, [](void* Ptr) { delete static_cast<DataType*>(Ptr); });
+			}
+		}
+
+		std::atomic<DataType*> Current;
+	};
 }
@@ -12,6 +12,8 @@
 #include "Core/RealtimeMeshDataStream.h"
 #include "Mesh/RealtimeMeshDistanceField.h"
 #include "Mesh/RealtimeMeshCardRepresentation.h"
+#include "Mesh/RealtimeMeshCollisionBVH.h"
+#include "Mesh/RealtimeMeshSimplifier.h"
 #include "RealtimeMeshSimple.generated.h"
 
 
@@ -93,6 +95,9 @@ namespace RealtimeMesh
 		// Store the actual mesh data on CPU side, this is so we can support fire-and-forget
 		FRealtimeMeshStreamSet Streams;
 
+		// Copy of Streams for lock-free readers, only kept once something has read it and republished on every update after
+		mutable TRealtimeMeshPublished<FRealtimeMeshStreamSet> PublishedStreams;
+
 		// Handler for setting up section config based on found poly groups
 		FRealtimeMeshPolyGroupConfigHandler ConfigHandler;
 
@@ -130,6 +135,16 @@ namespace RealtimeMesh
 		 * @param ProcessFunc Function to process the mesh data, you have threadsafe access while in this function.
 		 */
 		void ProcessMeshData(const FRealtimeMeshLockContext& LockContext, TFunctionRef<void(const FRealtimeMeshStreamSet&)> ProcessFunc) const;
+
+		/*
+		 * @brief Get readonly access to a snapshot of the stream data without taking the mesh lock, for readers that run
+		 * alongside edits. The snapshot is the state as of the last committed update. The first read takes the lock once
+		 * to publish it, from then on every update publishes a new one and the old one is freed once no reader is left in it.
+		 * Publishing copies every stream of the group, not just the edited ones, so once this was called a small in place
+		 * edit costs a full copy of the mesh data. Only use it for readers that can't wait on the mesh lock.
+		 * @param ProcessFunc Function to process the mesh data, the data is only valid while in this function.
+		 */
+		void ProcessMeshDataSnapshot(TFunctionRef<void(const FRealtimeMeshStreamSet&)> ProcessFunc) const;
 		
 		void EditMeshData(FRealtimeMeshUpdateContext& UpdateContext, TFunctionRef<TSet<FRealtimeMeshStreamKey>(FRealtimeMeshStreamSet&)> EditFunc);
 		
@@ -177,7 +192,14 @@ namespace RealtimeMesh
 		 * @brief Generate the collision mesh data for this section group, used to setup PhysX/Chaos collision
 		 */
 		virtual bool GenerateComplexCollision(const FRealtimeMeshLockContext& LockContext, FRealtimeMeshCollisionMesh& CollisionMesh) const;
-		
+
+		/*
+		 * @brief Refit or rebuild the deformable collision tree from the sections that have collision enabled
+		 * @return False if no section of this group has collision
+		 */
+		virtual bool UpdateCollisionBVH(const FRealtimeMeshLockContext& LockContext, FRealtimeMeshCollisionBVH& BVH) const;
+
+		virtual void FinalizeUpdate(FRealtimeMeshUpdateContext& UpdateContext) override;
 		
 	protected:
 
@@ -225,6 +247,11 @@ namespace RealtimeMesh
 		{
 			return !DirtyCollisionSectionGroups.IsEmpty();
 		}
+
+		const TSet<FRealtimeMeshSectionGroupKey>& GetDirtySectionGroups() const
+		{
+			return DirtyCollisionSectionGroups;
+		}
 	};
 	
 	struct FRealtimeMeshSimpleUpdateState : FRealtimeMeshUpdateState
@@ -289,10 +316,24 @@ namespace RealtimeMesh
 
 		// Lumen card representation for this mesh
 		TUniquePtr<FRealtimeMeshCardRepresentation> CardRepresentation;
+
+		// Query-only collision for LOD0 section groups, refit in place as the mesh deforms instead of recooking the trimesh
+		TMap<FRealtimeMeshSectionGroupKey, TSharedRef<FRealtimeMeshCollisionBVH>> DeformableCollision;
+		bool bUseDeformableCollision;
+
+		// Section groups for lock-free lookups by ProcessMeshSnapshot, republished when groups are added or removed once published
+		using FPublishedSectionGroups = TMap<FRealtimeMeshSectionGroupKey, TSharedRef<const FRealtimeMeshSectionGroupSimple>>;
+		mutable TRealtimeMeshPublished<FPublishedSectionGroups> PublishedSectionGroups;
+
+		// Proxy updates held until the end of the frame while coalescing, created on the first deferred commit
+		mutable TUniquePtr<FRealtimeMeshProxyUpdateCoalescer> PendingProxyUpdates;
+		bool bCoalesceProxyUpdates;
 		
 	public:
 		FRealtimeMeshSimple(const FRealtimeMeshSharedResourcesRef& InSharedResources)
 			: FRealtimeMesh(InSharedResources)
+			, bUseDeformableCollision(false)
+			, bCoalesceProxyUpdates(false)
 		{
 		
 		}
@@ -311,6 +352,14 @@ namespace RealtimeMesh
 		TFuture<ERealtimeMeshProxyUpdateStatus> UpdateSectionGroup(const FRealtimeMeshSectionGroupKey& SectionGroupKey, FRealtimeMeshStreamSet&& MeshData);
 		TFuture<ERealtimeMeshProxyUpdateStatus> UpdateSectionGroup(const FRealtimeMeshSectionGroupKey& SectionGroupKey, const FRealtimeMeshStreamSet& MeshData);
 
+		/*
+		 * @brief Replace every LOD after LOD0 with simplified copies of the LOD0 section groups, simplified on the thread pool.
+		 * Section groups keep their names and configs, sections are recreated from the polygroups and keep the configs of the
+		 * LOD0 sections with the same name. Each LOD gets the screen size at which its error stays under MaxPixelError.
+		 * Generation stops early once a LOD no longer removes a meaningful share of the triangles.
+		 */
+		TFuture<ERealtimeMeshProxyUpdateStatus> GenerateLODs(const FRealtimeMeshLODGenerationSettings& Settings = FRealtimeMeshLODGenerationSettings());
+
 
 		FRealtimeMeshCollisionConfiguration GetCollisionConfig() const;
 		TFuture<ERealtimeMeshCollisionUpdateResult> SetCollisionConfig(const FRealtimeMeshCollisionConfiguration& InCollisionConfig);
@@ -334,6 +383,43 @@ namespace RealtimeMesh
 		
 		virtual bool GenerateComplexCollision(const FRealtimeMeshLockContext& LockContext, FRealtimeMeshComplexGeometry& ComplexGeometry) const;
 
+		/*
+		 * @brief In deformable mode section collision is kept in CPU BVHs that are refit on every mesh update and only answer
+		 * LineTraceDeformableCollision. Physics only gets the simple geometry and any custom complex geometry, so meshes that
+		 * are reshaped every frame never wait on a Chaos cook. This is a runtime setting and is not serialized.
+		 */
+		bool IsUsingDeformableCollision() const;
+		TFuture<ERealtimeMeshCollisionUpdateResult> SetUseDeformableCollision(bool bNewUseDeformableCollision);
+
+		/*
+		 * @brief Trace a segment in mesh local space against the deformable collision
+		 * @param OutSectionGroupKey Optional, receives the section group that was hit
+		 */
+		bool LineTraceDeformableCollision(const FVector3f& Start, const FVector3f& End, FRealtimeMeshCollisionBVHHit& OutHit, FRealtimeMeshSectionGroupKey* OutSectionGroupKey = nullptr) const;
+
+		/*
+		 * @brief Read a section group's streams without taking the mesh lock, see FRealtimeMeshSectionGroupSimple::ProcessMeshDataSnapshot.
+		 * The first call makes every later update of the group copy all of its streams
+		 * @return False if the section group didn't exist as of the last committed update
+		 */
+		bool ProcessMeshSnapshot(const FRealtimeMeshSectionGroupKey& SectionGroupKey, TFunctionRef<void(const FRealtimeMeshStreamSet&)> ProcessFunc) const;
+
+		/*
+		 * @brief While coalescing, proxy updates are held until the end of the frame and sent as one batch, so when the same
+		 * section group is updated several times in a frame only its last data is uploaded. The futures of updates whose
+		 * stream data was replaced complete as Superseded. Mesh data is still updated immediately.
+		 * This is a runtime setting and is not serialized.
+		 */
+		bool IsCoalescingProxyUpdates() const;
+		void SetCoalesceProxyUpdates(bool bNewCoalesceProxyUpdates);
+
+		/*
+		 * @brief Send the proxy updates held for the end of the frame now
+		 */
+		void FlushProxyUpdates() const;
+
+		virtual TOptional<TFuture<ERealtimeMeshProxyUpdateStatus>> DeferProxyUpdates(const FRealtimeMeshProxyRef& Proxy, FRealtimeMeshProxyUpdateBuilder& Builder) const override;
+
 		virtual void InitializeProxy(FRealtimeMeshUpdateContext& UpdateContext) const override;
 		
 		using FRealtimeMesh::Reset;
@@ -346,6 +432,10 @@ namespace RealtimeMesh
 		void MarkCollisionDirtyNoCallback() const;
 		TFuture<ERealtimeMeshCollisionUpdateResult> MarkCollisionDirty() const;
 
+		void UpdateDeformableCollision(const FRealtimeMeshLockContext& LockContext, const FRealtimeMeshSectionGroupKey& SectionGroupKey);
+
+		TUniquePtr<FPublishedSectionGroups> GatherSectionGroups(const FRealtimeMeshLockContext& LockContext) const;
+
 		virtual void ProcessEndOfFrameUpdates() override;
 
 		friend class URealtimeMeshSimple;
@@ -375,6 +465,8 @@ public:
 	
 	TFuture<ERealtimeMeshProxyUpdateStatus> UpdateSectionGroup(const FRealtimeMeshSectionGroupKey& SectionGroupKey, FRealtimeMeshStreamSet&& MeshData);
 	TFuture<ERealtimeMeshProxyUpdateStatus> UpdateSectionGroup(const FRealtimeMeshSectionGroupKey& SectionGroupKey, const FRealtimeMeshStreamSet& MeshData);	
+
+	TFuture<ERealtimeMeshProxyUpdateStatus> GenerateLODs(const FRealtimeMeshLODGenerationSettings& Settings = FRealtimeMeshLODGenerationSettings());
 	
 	TFuture<ERealtimeMeshProxyUpdateStatus> CreateSection(const FRealtimeMeshSectionKey& SectionKey, const FRealtimeMeshSectionConfig& Config,
 															const FRealtimeMeshStreamRange& StreamRange, bool bShouldCreateCollision = false);
@@ -387,6 +479,8 @@ public:
 	TSharedPtr<FRealtimeMeshSectionGroupSimple> GetSectionGroup(const FRealtimeMeshSectionGroupKey& SectionGroupKey) const;
 	
 	void ProcessMesh(const FRealtimeMeshSectionGroupKey& SectionGroupKey, const TFunctionRef<void(const FRealtimeMeshStreamSet&)>& ProcessFunc) const;
+	// Lock free read of the last committed streams, from then on every update of the group copies all its streams, see FRealtimeMeshSimple::ProcessMeshSnapshot
+	bool ProcessMeshSnapshot(const FRealtimeMeshSectionGroupKey& SectionGroupKey, const TFunctionRef<void(const FRealtimeMeshStreamSet&)>& ProcessFunc) const;
 	TFuture<ERealtimeMeshProxyUpdateStatus> EditMeshInPlace(const FRealtimeMeshSectionGroupKey& SectionGroupKey, const TFunctionRef<TSet<FRealtimeMeshStreamKey>(FRealtimeMeshStreamSet&)>& EditFunc);
 
 
@@ -408,6 +502,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Components|RealtimeMesh", DisplayName="UpdateSectionGroup", meta=(AutoCreateRefTerm="OnComplete"))
 	void UpdateSectionGroup(const FRealtimeMeshSectionGroupKey& SectionGroupKey, URealtimeMeshStreamSet* MeshData, const FRealtimeMeshSimpleCompletionCallback& OnComplete);
 
+	UFUNCTION(BlueprintCallable, Category = "Components|RealtimeMesh", DisplayName="GenerateLODs", meta=(AutoCreateRefTerm="OnComplete"))
+	void GenerateLODs(int32 NumLODs, float TriangleRatio, float MaxPixelError, const FRealtimeMeshSimpleCompletionCallback& OnComplete);
+
 	UFUNCTION(BlueprintCallable, Category = "Components|RealtimeMesh", DisplayName="CreateSection", meta = (AutoCreateRefTerm = "Config, StreamRange, OnComplete"))
 	void CreateSection(const FRealtimeMeshSectionKey& SectionKey, const FRealtimeMeshSectionConfig& Config,
 								 const FRealtimeMeshStreamRange& StreamRange, bool bShouldCreateCollision, const FRealtimeMeshSimpleCompletionCallback& OnComplete);
@@ -482,6 +579,25 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Components|RealtimeMesh", DisplayName="SetCollisionConfig", meta = (AutoCreateRefTerm = "OnComplete"))
 	void SetCollisionConfig(const FRealtimeMeshCollisionConfiguration& InCollisionConfig, const FRealtimeMeshSimpleCollisionCompletionCallback& OnComplete);
 	
+	UFUNCTION(BlueprintCallable, Category = "Components|RealtimeMesh")
+	bool IsUsingDeformableCollision() const;
+
+	TFuture<ERealtimeMeshCollisionUpdateResult> SetUseDeformableCollision(bool bNewUseDeformableCollision);
+
+	UFUNCTION(BlueprintCallable, Category = "Components|RealtimeMesh", DisplayName="SetUseDeformableCollision", meta = (AutoCreateRefTerm = "OnComplete"))
+	void SetUseDeformableCollision(bool bNewUseDeformableCollision, const FRealtimeMeshSimpleCollisionCompletionCallback& OnComplete);
+
+	bool LineTraceDeformableCollision(const FVector3f& Start, const FVector3f& End, RealtimeMesh::FRealtimeMeshCollisionBVHHit& OutHit) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Components|RealtimeMesh")
+	bool IsCoalescingProxyUpdates() const;
+
+	UFUNCTION(BlueprintCallable, Category = "Components|RealtimeMesh")
+	void SetCoalesceProxyUpdates(bool bNewCoalesceProxyUpdates);
+
+	UFUNCTION(BlueprintCallable, Category = "Components|RealtimeMesh")
+	void FlushProxyUpdates() const;
+	
 	UFUNCTION(BlueprintCallable, Category = "Components|RealtimeMesh")
 	FRealtimeMeshSimpleGeometry GetSimpleGeometry() const;
 
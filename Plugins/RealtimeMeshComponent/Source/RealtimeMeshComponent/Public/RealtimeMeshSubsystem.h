@@ -10,6 +10,18 @@
 class UWorld;
 class ARealtimeMeshActor;
 
+struct FRealtimeMeshGenerationStats
+{
+	// Generations still queued after the last tick
+	int32 NumPending = 0;
+	int32 NumGeneratedLastTick = 0;
+	float GenerationTimeLastTickMs = 0.0f;
+	// How long the longest waiting of the still queued generations has been waiting
+	float OldestPendingSeconds = 0.0f;
+	// Consecutive ticks that ended with generations left over
+	int32 TicksBehind = 0;
+};
+
 /**
  * URealtimeMeshEditorSubsystem manages recomputation of "generated" mesh actors, eg
  * to provide procedural mesh generation in-Editor. Generally such procedural mesh generation
@@ -18,8 +30,9 @@ class ARealtimeMeshActor;
  * 
  * ARealtimeMeshActors register themselves with this Subsystem, and
  * allow the Subsystem to tell them when they should regenerate themselves (if necessary).
- * The current behavior is to run all pending generations on a Tick, however in future
- * this regeneration will be more carefully managed via throttling / timeslicing / etc.
+ * Pending generations are queued by ARealtimeMeshActor::GenerationPriority, then by distance to
+ * the closest view, and each Tick runs as many as fit in RealtimeMesh.Generation.FrameBudgetMs.
+ * At least one runs per Tick, the rest carry over to the next one.
  * 
  */
 UCLASS()
@@ -46,9 +59,24 @@ public:
 
 	static URealtimeMeshSubsystem* GetInstance(UWorld* World);
 
+	const FRealtimeMeshGenerationStats& GetGenerationStats() const { return GenerationStats; }
+
 private:
+	struct FPendingGeneration
+	{
+		TWeakObjectPtr<ARealtimeMeshActor> Actor;
+		int32 Priority;
+		double DistanceSquared;
+	};
+
+	void BuildGenerationQueue();
 	
 	TSet<TWeakObjectPtr<ARealtimeMeshActor>> ActiveGeneratedActors;
+	// Pending generations in the order they run, rebuilt every Tick as the views move
+	TArray<FPendingGeneration> GenerationQueue;
+	// When each queued actor was first seen pending, for the lag stats
+	TMap<TWeakObjectPtr<ARealtimeMeshActor>, double> PendingSince;
+	FRealtimeMeshGenerationStats GenerationStats;
 	TSharedPtr<class FRealtimeMeshSceneViewExtension> SceneViewExtension;
 	bool bInitialized;
 };
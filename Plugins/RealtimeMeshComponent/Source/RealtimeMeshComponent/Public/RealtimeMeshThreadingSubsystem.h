@@ -5,10 +5,13 @@
 #include "CoreMinimal.h"
 #include "Subsystems/EngineSubsystem.h"
 #include "Misc/QueuedThreadPool.h"
+#include "Async/Async.h"
 #include "RealtimeMeshThreadingSubsystem.generated.h"
 
 /**
- * 
+ * Owns the thread pool RealtimeMesh runs its async work on. The pool is sized from the RealtimeMesh.ThreadPool.*
+ * console variables when it's first used, by default to half the physical cores.
+ * Queued work is picked by priority, so interactive rebuilds run ahead of background work that is still queued.
  */
 UCLASS()
 class REALTIMEMESHCOMPONENT_API URealtimeMeshThreadingSubsystem : public UEngineSubsystem
@@ -17,10 +20,21 @@ class REALTIMEMESHCOMPONENT_API URealtimeMeshThreadingSubsystem : public UEngine
 private:
 	TUniquePtr<FQueuedThreadPool> ThreadPool;
 public:
+	// Work someone is waiting on, eg the rebuild after a user edit
+	static constexpr EQueuedWorkPriority InteractivePriority = EQueuedWorkPriority::High;
+	// Work nobody is waiting on, eg LOD and scene representation builds
+	static constexpr EQueuedWorkPriority BackgroundPriority = EQueuedWorkPriority::Low;
+
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
 	virtual void Deinitialize() override;
 
 	static URealtimeMeshThreadingSubsystem* Get();
 
 	FQueuedThreadPool& GetThreadPool();
+
+	template<typename CallableType>
+	auto Launch(EQueuedWorkPriority Priority, CallableType&& Callable) -> TFuture<decltype(Forward<CallableType>(Callable)())>
+	{
+		return AsyncPool(GetThreadPool(), Forward<CallableType>(Callable), nullptr, Priority);
+	}
 };
@@ -25,11 +25,28 @@ namespace RealtimeMesh
 		FRealtimeMeshStream Stream;
 		EBufferUsageFlags UsageFlags;
 		FBufferRHIRef Buffer;
+		// For range updates, where Stream starts in the existing buffer and how many elements that buffer holds
+		int32 DestinationIndex;
+		int32 TotalNumElements;
 
 	public:
 		FRealtimeMeshSectionGroupStreamUpdateData(FRealtimeMeshStream&& InStream, EBufferUsageFlags InUsageFlags)
 			: Stream(MoveTemp(InStream))
 			, UsageFlags(InUsageFlags)
+			, DestinationIndex(0)
+			, TotalNumElements(INDEX_NONE)
+		{
+		}
+
+		/*
+		 * @brief Range update, InStream only holds the elements written into the existing GPU buffer starting at InDestinationIndex.
+		 * No new buffer is created, the existing one has to hold InTotalNumElements elements of the same layout.
+		 */
+		FRealtimeMeshSectionGroupStreamUpdateData(FRealtimeMeshStream&& InStream, EBufferUsageFlags InUsageFlags, int32 InDestinationIndex, int32 InTotalNumElements)
+			: Stream(MoveTemp(InStream))
+			, UsageFlags(InUsageFlags)
+			, DestinationIndex(InDestinationIndex)
+			, TotalNumElements(InTotalNumElements)
 		{
 		}
 
@@ -37,9 +54,14 @@ namespace RealtimeMesh
 		FRealtimeMeshBufferLayout GetBufferLayout() const { return Stream.GetLayout(); }
 		FRealtimeMeshStreamKey GetStreamKey() const { return Stream.GetStreamKey(); }
 		int32 GetNumElements() const { return Stream.Num(); }
+		int32 GetStride() const { return Stream.GetStride(); }
 		EBufferUsageFlags GetUsageFlags() const { return UsageFlags; }
 		FBufferRHIRef& GetBuffer() { return Buffer; }
 
+		bool IsRangeUpdate() const { return TotalNumElements != INDEX_NONE; }
+		int32 GetDestinationIndex() const { return DestinationIndex; }
+		int32 GetTotalNumElements() const { return IsRangeUpdate()? TotalNumElements : Stream.Num(); }
+
 		void CreateBufferAsyncIfPossible(FRealtimeMeshUpdateContext& UpdateContext);
 
 		void FinalizeInitialization(FRHICommandListBase& RHICmdList);
@@ -90,6 +112,13 @@ namespace RealtimeMesh
 		virtual void InitializeResources(FRHICommandListBase& RHICmdList, const FRealtimeMeshSectionGroupStreamUpdateDataRef& UpdateData) = 0;
 		virtual void ReleaseUnderlyingResource() = 0;
 		virtual bool IsResourceInitialized() const = 0;
+		virtual FRHIBuffer* GetRHIBuffer() const = 0;
+
+		/*
+		 * @brief Writes a range update into the existing buffer, the buffer and its views are kept
+		 * @return False if the buffer doesn't match the layout and size the update was made for
+		 */
+		bool UpdateRange(FRHICommandListBase& RHICmdList, const FRealtimeMeshSectionGroupStreamUpdateDataRef& UpdateData);
 
 		FORCEINLINE const FRealtimeMeshBufferLayout& GetBufferLayout() const { return BufferLayout; }
 		FORCEINLINE EPixelFormat GetElementFormat() const { return ElementDetails.GetPixelFormat(); }
@@ -163,6 +192,8 @@ namespace RealtimeMesh
 
 		virtual bool IsResourceInitialized() const override { return IsInitialized(); }
 
+		virtual FRHIBuffer* GetRHIBuffer() const override { return VertexBufferRHI; }
+
 		/** Gets the format of the vertex */
 		FORCEINLINE EVertexElementType GetVertexType() const { return ElementDetails.GetVertexType(); }
 
@@ -272,6 +303,8 @@ namespace RealtimeMesh
 		virtual void ReleaseUnderlyingResource() override { ReleaseResource(); }
 
 		virtual bool IsResourceInitialized() const override { return IsInitialized(); }
+
+		virtual FRHIBuffer* GetRHIBuffer() const override { return IndexBufferRHI; }
 		
 #if RMC_ENGINE_ABOVE_5_3
 		virtual void InitRHI(FRHICommandListBase& RHICmdList) override
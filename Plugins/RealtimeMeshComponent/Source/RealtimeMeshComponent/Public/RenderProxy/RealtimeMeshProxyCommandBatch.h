@@ -16,9 +16,15 @@ namespace RealtimeMesh
 		uint8 bGameThreadReady : 1;
 		uint8 bFinalized : 1;
 
+		// Further commits folded into this batch by a FRealtimeMeshUpdateTransaction, they complete along with FinalPromise
+		TArray<TPromise<ERealtimeMeshProxyUpdateStatus>> MergedPromises;
+
 		FRealtimeMeshCommandBatchIntermediateFuture();
 		void FinalizeRenderThread(ERealtimeMeshProxyUpdateStatus Status);
 		void FinalizeGameThread();
+
+	private:
+		void Finalize();
 	};
 
 	struct REALTIMEMESHCOMPONENT_API FRealtimeMeshProxyUpdateBuilder
@@ -26,12 +32,22 @@ namespace RealtimeMesh
 	public:
 		using TaskFunctionType = TUniqueFunction<void(FRHICommandListBase&, FRealtimeMeshProxy&)>;
 	private:
-		TArray<TaskFunctionType> Tasks;
+		struct FTask
+		{
+			// Unset once a later task replaced all of what this one wrote
+			TaskFunctionType Function;
+			// Set for tasks that write a single stream of a section group
+			TOptional<TPair<FRealtimeMeshSectionGroupKey, FRealtimeMeshStreamKey>> Stream;
+			bool bReplacesStream = false;
+		};
+		TArray<FTask> Tasks;
+		int32 NumReplacedTasks;
 		uint32 bRequiresProxyRecreate : 1;
 		uint32 bIsIgnoringCommands : 1;
 	public:
 		FRealtimeMeshProxyUpdateBuilder(bool bShouldIgnoreCommands = false)
-			: bRequiresProxyRecreate(false)
+			: NumReplacedTasks(0)
+			, bRequiresProxyRecreate(false)
 			, bIsIgnoringCommands(bShouldIgnoreCommands)
 		{ }
 		UE_NONCOPYABLE(FRealtimeMeshProxyUpdateBuilder);
@@ -39,8 +55,20 @@ namespace RealtimeMesh
 		FORCEINLINE bool IsValid() const { return !bIsIgnoringCommands; }
 		FORCEINLINE operator bool() const { return IsValid(); }
 
+		/*
+		 * @brief Send the tasks to the mesh's render proxy, or record them into the active FRealtimeMeshUpdateTransaction if there is one
+		 */
 		TFuture<ERealtimeMeshProxyUpdateStatus> Commit(const TSharedRef<const FRealtimeMesh>& Mesh);
 
+		// Tasks that will run, not counting ones that were replaced
+		int32 NumTasks() const { return Tasks.Num() - NumReplacedTasks; }
+		int32 GetNumReplacedTasks() const { return NumReplacedTasks; }
+
+		/*
+		 * @brief Move the tasks of another builder to the end of this one, replacing stream writes across both
+		 */
+		void Append(FRealtimeMeshProxyUpdateBuilder&& Other);
+
 		void MarkForProxyRecreate() { bRequiresProxyRecreate = true; }
 		void ClearProxyRecreate() { bRequiresProxyRecreate = false; }
 
@@ -79,6 +107,14 @@ namespace RealtimeMesh
 			}, bInRequiresProxyRecreate);
 		}
 
+		/*
+		 * @brief Add a task that writes a single stream of a section group
+		 * @param bReplacesStream The task replaces everything about the stream on the GPU, like a full upload or a removal,
+		 * so earlier tasks writing the same stream are dropped. Partial writes must pass false.
+		 */
+		void AddSectionGroupStreamTask(const FRealtimeMeshSectionGroupKey& SectionGroupKey, const FRealtimeMeshStreamKey& StreamKey, bool bReplacesStream,
+		                               TUniqueFunction<void(FRHICommandListBase&, FRealtimeMeshSectionGroupProxy&)>&& Function, bool bInRequiresProxyRecreate = true);
+
 		void AddSectionTask(const FRealtimeMeshSectionKey& SectionKey, TUniqueFunction<void(FRHICommandListBase&, FRealtimeMeshSectionProxy&)>&& Function, bool bInRequiresProxyRecreate = true);
 
 		template <typename SectionProxyType>
@@ -89,5 +125,110 @@ namespace RealtimeMesh
 				Func(RHICmdList, static_cast<SectionProxyType&>(Section));
 			}, bInRequiresProxyRecreate);
 		}
+
+	private:
+		void AddTask(FTask&& Task);
+		static void Send(const FRealtimeMeshProxyRef& Proxy, const TWeakPtr<const FRealtimeMesh>& MeshWeak, TArray<TaskFunctionType>&& InTasks,
+		                 bool bRecreateProxies, const TSharedRef<FRealtimeMeshCommandBatchIntermediateFuture>& ThreadState);
+
+		friend class FRealtimeMeshUpdateTransaction;
+		friend class FRealtimeMeshProxyUpdateCoalescer;
+	};
+
+	/**
+	 * Records the proxy updates of every mesh committed on this thread while it's in scope and sends them when it ends,
+	 * one command batch per mesh proxy however many edits were made to it, with stream uploads that a later one replaced
+	 * dropped. Mesh data is still updated immediately, only the proxy side waits. The futures of the recorded commits all
+	 * complete once their mesh's batch has been applied, so don't wait on them inside the transaction.
+	 * Nested transactions join the outermost one.
+	 */
+	class REALTIMEMESHCOMPONENT_API FRealtimeMeshUpdateTransaction
+	{
+	public:
+		RMC_NODISCARD_CTOR FRealtimeMeshUpdateTransaction();
+		~FRealtimeMeshUpdateTransaction();
+		UE_NONCOPYABLE(FRealtimeMeshUpdateTransaction);
+
+		/*
+		 * @brief Send everything recorded so far, the transaction keeps recording afterward. Does nothing when nested.
+		 */
+		void Commit();
+
+		bool IsNested() const { return Outer != nullptr; }
+		int32 NumRecordedCommits() const { return NumCommits; }
+		int32 NumPendingMeshes() const { return Batches.Num(); }
+
+		static FRealtimeMeshUpdateTransaction* GetActive();
+
+	private:
+		struct FMeshBatch
+		{
+			FRealtimeMeshProxyRef Proxy;
+			TWeakPtr<const FRealtimeMesh> Mesh;
+			FRealtimeMeshProxyUpdateBuilder Builder;
+			TSharedRef<FRealtimeMeshCommandBatchIntermediateFuture> ThreadState;
+
+			FMeshBatch(const FRealtimeMeshProxyRef& InProxy, const TSharedRef<const FRealtimeMesh>& InMesh)
+				: Proxy(InProxy)
+				, Mesh(InMesh)
+				, ThreadState(MakeShared<FRealtimeMeshCommandBatchIntermediateFuture>())
+			{ }
+		};
+
+		TFuture<ERealtimeMeshProxyUpdateStatus> Record(const TSharedRef<const FRealtimeMesh>& Mesh, const FRealtimeMeshProxyRef& Proxy, FRealtimeMeshProxyUpdateBuilder& Builder);
+
+		// Kept in the order meshes were first committed
+		TArray<TUniquePtr<FMeshBatch>> Batches;
+		TMap<const FRealtimeMeshProxy*, int32> BatchIndices;
+		FRealtimeMeshUpdateTransaction* Outer;
+		int32 NumCommits;
+
+		friend struct FRealtimeMeshProxyUpdateBuilder;
+	};
+
+	/**
+	 * Holds the proxy updates of a single mesh until Send, typically at the end of the frame, and sends them as one
+	 * command batch. Stream uploads that a later commit replaced are dropped, so a mesh updated several times in a frame
+	 * only uploads its last data. A commit whose stream writes were all replaced completes as Superseded, any of its
+	 * other tasks, like section updates, still run. Everything else completes once the batch has been applied.
+	 * Not thread safe, the owning mesh serializes access with its guard.
+	 */
+	class REALTIMEMESHCOMPONENT_API FRealtimeMeshProxyUpdateCoalescer
+	{
+	public:
+		FRealtimeMeshProxyUpdateCoalescer() = default;
+		~FRealtimeMeshProxyUpdateCoalescer();
+		UE_NONCOPYABLE(FRealtimeMeshProxyUpdateCoalescer);
+
+		/*
+		 * @brief Take the tasks of a commit. A commit for a different proxy than the pending ones sends those first.
+		 */
+		TFuture<ERealtimeMeshProxyUpdateStatus> Record(const TSharedRef<const FRealtimeMesh>& Mesh, const FRealtimeMeshProxyRef& InProxy, FRealtimeMeshProxyUpdateBuilder& InBuilder);
+
+		/*
+		 * @brief Send everything recorded so far and complete the superseded commits
+		 */
+		void Send();
+
+		bool HasPendingUpdates() const { return !Commits.IsEmpty(); }
+		int32 NumPendingCommits() const { return Commits.Num(); }
+		int32 NumSupersededCommits() const;
+		int32 NumPendingTasks() const { return Builder.NumTasks(); }
+
+	private:
+		struct FCommit
+		{
+			TPromise<ERealtimeMeshProxyUpdateStatus> Promise;
+			// Range of the commit's tasks in Builder
+			int32 FirstTask;
+			int32 NumTasks;
+		};
+
+		bool IsSuperseded(const FCommit& Commit) const;
+
+		FRealtimeMeshProxyPtr Proxy;
+		TWeakPtr<const FRealtimeMesh> Mesh;
+		FRealtimeMeshProxyUpdateBuilder Builder;
+		TArray<FCommit> Commits;
 	};
 }
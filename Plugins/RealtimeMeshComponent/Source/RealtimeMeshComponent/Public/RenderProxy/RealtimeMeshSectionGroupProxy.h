@@ -77,6 +77,8 @@ namespace RealtimeMesh
 
 		FRealtimeMeshDrawMask DrawMask;
 		bool bVertexFactoryDirty;
+		// Positions or indices were written in place, the buffers stay the same but the ray tracing geometry is stale
+		bool bRayTracingGeometryDirty;
 
 	public:
 		FRealtimeMeshSectionGroupProxy(const FRealtimeMeshSharedResourcesRef& InSharedResources, const FRealtimeMeshSectionGroupKey& InKey);
@@ -105,6 +107,7 @@ namespace RealtimeMesh
 		virtual void RemoveSection(const FRealtimeMeshSectionKey& SectionKey);
 
 		virtual void CreateOrUpdateStream(FRHICommandListBase& RHICmdList, const FRealtimeMeshSectionGroupStreamUpdateDataRef& InStream);
+		virtual void UpdateStreamRange(FRHICommandListBase& RHICmdList, const FRealtimeMeshSectionGroupStreamUpdateDataRef& InStream);
 		virtual void RemoveStream(const FRealtimeMeshStreamKey& StreamKey);
 
 		virtual bool InitializeMeshBatch(FMeshBatch& MeshBatch, FRealtimeMeshResourceReferenceList& Resources, bool bIsLocalToWorldDeterminantNegative, bool bWantsDepthOnly) const;
@@ -0,0 +1,142 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#include "Core/RealtimeMeshBuilder.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(RealtimeMeshBuilderBulkAppendTests, "RealtimeMeshComponent.RealtimeMeshBuilderBulkAppend", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+using namespace RealtimeMesh;
+
+namespace RealtimeMeshBuilderBulkAppendTests
+{
+	using FBuilder = TRealtimeMeshBuilderLocal<uint16, FPackedNormal, FVector2DHalf, 1, uint16>;
+
+	struct FSourceMesh
+	{
+		TArray<FVector3f> Positions;
+		TArray<FVector3f> Normals;
+		TArray<FVector3f> Tangents;
+		TArray<FVector2f> TexCoords;
+		TArray<FColor> Colors;
+		TArray<int32> Indices;
+	};
+
+	FSourceMesh MakeSourceMesh(int32 NumVertices)
+	{
+		FRandomStream Random(NumVertices);
+		FSourceMesh Mesh;
+		for (int32 Index = 0; Index < NumVertices; Index++)
+		{
+			Mesh.Positions.Add(FVector3f(Random.VRand()) * 100.0f);
+			Mesh.Normals.Add(FVector3f(Random.VRand()));
+			Mesh.Tangents.Add(FVector3f(Random.VRand()));
+			Mesh.TexCoords.Add(FVector2f(Random.FRand(), Random.FRand()));
+			Mesh.Colors.Add(FColor(Random.RandRange(0, 255), Random.RandRange(0, 255), Random.RandRange(0, 255)));
+		}
+		for (int32 Index = 0; Index < NumVertices * 3; Index++)
+		{
+			Mesh.Indices.Add(Random.RandRange(0, NumVertices - 1));
+		}
+		return Mesh;
+	}
+
+	void EnableAll(FBuilder& Builder)
+	{
+		Builder.EnableTangents();
+		Builder.EnableTexCoords();
+		Builder.EnableColors();
+		Builder.EnablePolyGroups();
+	}
+
+	// The per vertex write chain the bulk append replaces
+	void BuildPerVertex(FRealtimeMeshStreamSet& Streams, const FSourceMesh& Mesh, TConstArrayView<int32> Gather)
+	{
+		FBuilder Builder(Streams);
+		EnableAll(Builder);
+
+		const int32 NumVertices = Gather.IsEmpty() ? Mesh.Positions.Num() : Gather.Num();
+		for (int32 Index = 0; Index < NumVertices; Index++)
+		{
+			const int32 SourceIndex = Gather.IsEmpty() ? Index : Gather[Index];
+			Builder.AddVertex(Mesh.Positions[SourceIndex])
+				.SetNormal(Mesh.Normals[SourceIndex])
+				.SetTexCoord(Mesh.TexCoords[SourceIndex])
+				.SetTangent(Mesh.Tangents[SourceIndex])
+				.SetColor(Mesh.Colors[SourceIndex]);
+		}
+		for (int32 Index = 0; Index < Mesh.Indices.Num(); Index += 3)
+		{
+			Builder.AddTriangle(Mesh.Indices[Index], Mesh.Indices[Index + 1], Mesh.Indices[Index + 2], 2);
+		}
+	}
+
+	bool StreamsEqual(const FRealtimeMeshStreamSet& A, const FRealtimeMeshStreamSet& B, const FRealtimeMeshStreamKey& Key)
+	{
+		const FRealtimeMeshStream* StreamA = A.Find(Key);
+		const FRealtimeMeshStream* StreamB = B.Find(Key);
+		return StreamA && StreamB && StreamA->GetLayout() == StreamB->GetLayout() && StreamA->Num() == StreamB->Num()
+			&& FMemory::Memcmp(StreamA->GetData(), StreamB->GetData(), StreamA->Num() * StreamA->GetStride()) == 0;
+	}
+}
+
+bool RealtimeMeshBuilderBulkAppendTests::RunTest(const FString& Parameters)
+{
+	using namespace RealtimeMeshBuilderBulkAppendTests;
+
+	const FSourceMesh Mesh = MakeSourceMesh(37);
+	const FRealtimeMeshStreamKey StreamKeys[] = { FRealtimeMeshStreams::Position, FRealtimeMeshStreams::Tangents, FRealtimeMeshStreams::TexCoords,
+		FRealtimeMeshStreams::Color, FRealtimeMeshStreams::Triangles, FRealtimeMeshStreams::PolyGroups };
+
+	{ // Straight copy matches the per vertex chain bit for bit
+		FRealtimeMeshStreamSet Expected;
+		BuildPerVertex(Expected, Mesh, TConstArrayView<int32>());
+
+		FRealtimeMeshStreamSet Bulk;
+		FBuilder Builder(Bulk);
+		EnableAll(Builder);
+		TestEqual(TEXT("FirstVertex"), Builder.AppendVertices(Mesh.Positions, Mesh.Normals, Mesh.Tangents, Mesh.TexCoords, Mesh.Colors), 0);
+		TestEqual(TEXT("FirstTriangle"), Builder.AppendTriangles(Mesh.Indices, 2), 0);
+
+		for (const FRealtimeMeshStreamKey& Key : StreamKeys)
+		{
+			TestTrue(FString::Printf(TEXT("Copy %s"), *Key.ToString()), StreamsEqual(Expected, Bulk, Key));
+		}
+	}
+
+	{ // Gathered copy, with repeats, matches the chain reading through the same index list
+		TArray<int32> Gather;
+		for (int32 Index = 0; Index < 50; Index++)
+		{
+			Gather.Add((Index * 7) % Mesh.Positions.Num());
+		}
+
+		FRealtimeMeshStreamSet Expected;
+		BuildPerVertex(Expected, Mesh, Gather);
+
+		FRealtimeMeshStreamSet Bulk;
+		FBuilder Builder(Bulk);
+		EnableAll(Builder);
+		Builder.AppendVertices(Mesh.Positions, Mesh.Normals, Mesh.Tangents, Mesh.TexCoords, Mesh.Colors, Gather);
+		Builder.AppendTriangles(Mesh.Indices, 2);
+
+		for (const FRealtimeMeshStreamKey& Key : StreamKeys)
+		{
+			TestTrue(FString::Printf(TEXT("Gather %s"), *Key.ToString()), StreamsEqual(Expected, Bulk, Key));
+		}
+	}
+
+	{ // Appends after existing data, attributes left out keep the stream defaults
+		FRealtimeMeshStreamSet Streams;
+		FBuilder Builder(Streams);
+		EnableAll(Builder);
+		Builder.AddVertex(FVector3f::ZeroVector).SetColor(FColor::Red);
+		TestEqual(TEXT("AppendAfterExisting"), Builder.AppendVertices(MakeArrayView(Mesh.Positions.GetData(), 4)), 1);
+		TestEqual(TEXT("AllStreamsGrew"), Streams.FindChecked(FRealtimeMeshStreams::Color).Num(), 5);
+		TestTrue(TEXT("DefaultColor"), Builder.GetColor(3) == FColor::White);
+		TestTrue(TEXT("DefaultNormal"), Builder.GetNormal(3).Equals(FVector3f::ZAxisVector, 0.01f));
+		TestTrue(TEXT("PositionCopied"), Builder.GetPosition(4) == Mesh.Positions[3]);
+		TestEqual(TEXT("EmptyAppend"), Builder.AppendVertices(TConstArrayView<FVector3f>()), 5);
+	}
+
+	return true;
+}
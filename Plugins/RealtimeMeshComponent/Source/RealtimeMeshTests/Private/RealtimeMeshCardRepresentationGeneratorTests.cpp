@@ -0,0 +1,78 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#include "Mesh/RealtimeMeshCardRepresentationGenerator.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(RealtimeMeshCardRepresentationGeneratorTests, "RealtimeMeshComponent.RealtimeMeshCardRepresentationGenerator", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+using namespace RealtimeMesh;
+
+namespace RealtimeMeshCardRepresentationGeneratorTests
+{
+	// Closed box, faces wound clockwise seen from outside
+	void AppendBox(const FVector3f& Min, const FVector3f& Max, TArray<FVector3f>& Positions, TArray<int32>& Indices)
+	{
+		const int32 Base = Positions.Num();
+		for (int32 Corner = 0; Corner < 8; Corner++)
+		{
+			Positions.Add(FVector3f((Corner & 1) ? Max.X : Min.X, (Corner & 2) ? Max.Y : Min.Y, (Corner & 4) ? Max.Z : Min.Z));
+		}
+
+		const int32 Faces[6][4] = { { 0, 2, 3, 1 }, { 4, 5, 7, 6 }, { 0, 1, 5, 4 }, { 2, 6, 7, 3 }, { 0, 4, 6, 2 }, { 1, 3, 7, 5 } };
+		for (const int32 (&Face)[4] : Faces)
+		{
+			Indices.Append({ Base + Face[0], Base + Face[2], Base + Face[1], Base + Face[0], Base + Face[3], Base + Face[2] });
+		}
+	}
+
+	TArray<FLumenCardBuildData> GetCards(const FRealtimeMeshCardRepresentation& CardRepresentation)
+	{
+		return CardRepresentation.CreateRenderingData().MeshCardsBuildData.CardBuildData;
+	}
+}
+
+bool RealtimeMeshCardRepresentationGeneratorTests::RunTest(const FString& Parameters)
+{
+	using namespace RealtimeMeshCardRepresentationGeneratorTests;
+
+	FRealtimeMeshCardRepresentationGenerator Generator;
+	FRealtimeMeshCardRepresentation CardRepresentation;
+	TestFalse(TEXT("EmptyMeshBuildsNothing"), Generator.Build(TConstArrayView<FVector3f>(), TConstArrayView<int32>(), CardRepresentation));
+
+	// A cube gets one card per side
+	TArray<FVector3f> Positions;
+	TArray<int32> Indices;
+	AppendBox(FVector3f(0.0f, 0.0f, 0.0f), FVector3f(10.0f, 10.0f, 10.0f), Positions, Indices);
+	TestTrue(TEXT("BuildCube"), Generator.Build(Positions, Indices, CardRepresentation));
+	TestTrue(TEXT("CubeIsValid"), CardRepresentation.IsValid());
+	TArray<FLumenCardBuildData> Cards = GetCards(CardRepresentation);
+	TestEqual(TEXT("CubeHasSixCards"), Cards.Num(), 6);
+	for (const FLumenCardBuildData& Card : Cards)
+	{
+		FVector3f ExpectedAxis = FVector3f::ZeroVector;
+		ExpectedAxis[Card.AxisAlignedDirectionIndex / 2] = (Card.AxisAlignedDirectionIndex & 1) ? 1.0f : -1.0f;
+		TestTrue(TEXT("CardFacesItsDirection"), Card.OBB.AxisZ.Equals(ExpectedAxis));
+		TestTrue(TEXT("CardFitsItsSide"), Card.OBB.Origin.Equals(FVector3f(5.0f, 5.0f, 5.0f) + ExpectedAxis * 5.0f));
+	}
+
+	// A bar ten times longer than wide is split along its length on the four long sides
+	Positions.Reset();
+	Indices.Reset();
+	AppendBox(FVector3f(0.0f, 0.0f, 0.0f), FVector3f(100.0f, 10.0f, 10.0f), Positions, Indices);
+	TestTrue(TEXT("BuildBar"), Generator.Build(Positions, Indices, CardRepresentation));
+	TestEqual(TEXT("BarSplitsLongSides"), GetCards(CardRepresentation).Num(), 2 + 4 * Generator.GetSettings().MaxCardsPerDirection);
+
+	// A single sided quad facing +Z only needs the +Z card, a two sided one is seen from below as well
+	Positions = { FVector3f(0.0f, 0.0f, 0.0f), FVector3f(10.0f, 0.0f, 0.0f), FVector3f(0.0f, 10.0f, 0.0f), FVector3f(10.0f, 10.0f, 0.0f) };
+	Indices = { 0, 2, 1, 2, 3, 1 };
+	TestTrue(TEXT("BuildQuad"), Generator.Build(Positions, Indices, CardRepresentation));
+	Cards = GetCards(CardRepresentation);
+	TestTrue(TEXT("QuadHasOneCard"), Cards.Num() == 1 && Cards[0].AxisAlignedDirectionIndex == 5);
+
+	FRealtimeMeshCardRepresentationSettings TwoSidedSettings;
+	TwoSidedSettings.bTwoSided = true;
+	TestTrue(TEXT("BuildTwoSidedQuad"), FRealtimeMeshCardRepresentationGenerator(TwoSidedSettings).Build(Positions, Indices, CardRepresentation));
+	TestEqual(TEXT("TwoSidedQuadHasTwoCards"), GetCards(CardRepresentation).Num(), 2);
+
+	return true;
+}
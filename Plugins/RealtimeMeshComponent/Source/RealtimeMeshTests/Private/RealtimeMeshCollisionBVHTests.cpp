@@ -0,0 +1,82 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#include "Mesh/RealtimeMeshCollisionBVH.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(RealtimeMeshCollisionBVHTests, "RealtimeMeshComponent.RealtimeMeshCollisionBVH", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+using namespace RealtimeMesh;
+
+bool RealtimeMeshCollisionBVHTests::RunTest(const FString& Parameters)
+{
+	// Flat 32x32 quad grid at Z = 0, one unit per quad
+	constexpr int32 GridSize = 33;
+	TArray<FVector3f> Positions;
+	TArray<int32> Indices;
+	for (int32 Y = 0; Y < GridSize; Y++)
+	{
+		for (int32 X = 0; X < GridSize; X++)
+		{
+			Positions.Add(FVector3f(X, Y, 0.0f));
+		}
+	}
+	for (int32 Y = 0; Y + 1 < GridSize; Y++)
+	{
+		for (int32 X = 0; X + 1 < GridSize; X++)
+		{
+			const int32 I0 = Y * GridSize + X;
+			Indices.Append({ I0, I0 + GridSize, I0 + 1, I0 + 1, I0 + GridSize, I0 + GridSize + 1 });
+		}
+	}
+
+	FRealtimeMeshCollisionBVH BVH;
+	BVH.Build(Positions, Indices);
+	TestEqual(TEXT("AllTrianglesIndexed"), BVH.NumTriangles(), Indices.Num() / 3);
+
+	FRealtimeMeshCollisionBVHHit Hit;
+	TestTrue(TEXT("HitsFlatGrid"), BVH.LineTrace(FVector3f(10.25f, 10.25f, 10.0f), FVector3f(10.25f, 10.25f, -10.0f), Hit));
+	TestTrue(TEXT("HitsAtGridHeight"), FMath::IsNearlyEqual(Hit.Location.Z, 0.0f, KINDA_SMALL_NUMBER));
+	TestTrue(TEXT("NormalFacesTraceStart"), Hit.Normal.Z > 0.99f);
+	TestFalse(TEXT("MissesOutsideGrid"), BVH.LineTrace(FVector3f(-5.0f, -5.0f, 10.0f), FVector3f(-5.0f, -5.0f, -10.0f), Hit));
+
+	// Raise one vertex, only the leaves around it and their ancestors should be refit
+	const int32 Raised = 10 * GridSize + 10;
+	Positions[Raised].Z = 4.0f;
+	const int32 NumRefitNodes = BVH.Update(Positions, Indices);
+	TestTrue(TEXT("PositionChangeRefits"), NumRefitNodes > 0 && NumRefitNodes < BVH.NumNodes() / 4);
+	TestTrue(TEXT("HitsRaisedVertex"), BVH.LineTrace(FVector3f(10.05f, 10.05f, 10.0f), FVector3f(10.05f, 10.05f, -10.0f), Hit));
+	TestTrue(TEXT("RefitMovesHit"), Hit.Location.Z > 3.5f);
+	TestEqual(TEXT("UnchangedPositionsRefitNothing"), BVH.Update(Positions, Indices), 0);
+
+	// Refit tree must answer exactly like a brute force trace
+	FRandomStream Random(1234);
+	for (int32 Y = 0; Y < GridSize; Y++)
+	{
+		for (int32 X = 0; X < GridSize; X++)
+		{
+			Positions[Y * GridSize + X].Z = Random.FRandRange(-2.0f, 2.0f);
+		}
+	}
+	BVH.Update(Positions, Indices);
+
+	FRealtimeMeshCollisionBVH Reference;
+	Reference.Build(Positions, Indices);
+	bool bMatchesRebuild = true;
+	for (int32 Ray = 0; Ray < 256; Ray++)
+	{
+		const FVector3f Start(Random.FRandRange(0.0f, GridSize - 1.0f), Random.FRandRange(0.0f, GridSize - 1.0f), 10.0f);
+		const FVector3f End = Start + FVector3f(Random.FRandRange(-3.0f, 3.0f), Random.FRandRange(-3.0f, 3.0f), -20.0f);
+		FRealtimeMeshCollisionBVHHit RefitHit, RebuiltHit;
+		const bool bRefitHit = BVH.LineTrace(Start, End, RefitHit);
+		const bool bRebuiltHit = Reference.LineTrace(Start, End, RebuiltHit);
+		bMatchesRebuild &= bRefitHit == bRebuiltHit && (!bRefitHit || FMath::IsNearlyEqual(RefitHit.Time, RebuiltHit.Time, KINDA_SMALL_NUMBER));
+	}
+	TestTrue(TEXT("RefitMatchesRebuild"), bMatchesRebuild);
+
+	// Different triangles can't be refit
+	Indices.SetNum(Indices.Num() - 6);
+	TestEqual(TEXT("TopologyChangeRebuilds"), BVH.Update(Positions, Indices), (int32)INDEX_NONE);
+	TestEqual(TEXT("RebuildDropsTriangles"), BVH.NumTriangles(), Indices.Num() / 3);
+
+	return true;
+}
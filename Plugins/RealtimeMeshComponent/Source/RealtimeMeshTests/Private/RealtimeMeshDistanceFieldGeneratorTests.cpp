@@ -0,0 +1,65 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#include "Mesh/RealtimeMeshDistanceFieldGenerator.h"
+#include "Mesh/RealtimeMeshDistanceField.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(RealtimeMeshDistanceFieldGeneratorTests, "RealtimeMeshComponent.RealtimeMeshDistanceFieldGenerator", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+using namespace RealtimeMesh;
+
+namespace RealtimeMeshDistanceFieldGeneratorTests
+{
+	// Closed box, faces wound clockwise seen from outside
+	void AppendBox(const FVector3f& Min, const FVector3f& Max, TArray<FVector3f>& Positions, TArray<int32>& Indices)
+	{
+		const int32 Base = Positions.Num();
+		for (int32 Corner = 0; Corner < 8; Corner++)
+		{
+			Positions.Add(FVector3f((Corner & 1) ? Max.X : Min.X, (Corner & 2) ? Max.Y : Min.Y, (Corner & 4) ? Max.Z : Min.Z));
+		}
+
+		const int32 Faces[6][4] = { { 0, 2, 3, 1 }, { 4, 5, 7, 6 }, { 0, 1, 5, 4 }, { 2, 6, 7, 3 }, { 0, 4, 6, 2 }, { 1, 3, 7, 5 } };
+		for (const int32 (&Face)[4] : Faces)
+		{
+			Indices.Append({ Base + Face[0], Base + Face[2], Base + Face[1], Base + Face[0], Base + Face[3], Base + Face[2] });
+		}
+	}
+}
+
+bool RealtimeMeshDistanceFieldGeneratorTests::RunTest(const FString& Parameters)
+{
+	// Two boxes far enough apart that moving one leaves the bricks around the other alone
+	TArray<FVector3f> Positions;
+	TArray<int32> Indices;
+	RealtimeMeshDistanceFieldGeneratorTests::AppendBox(FVector3f(0.0f, 0.0f, 0.0f), FVector3f(10.0f, 10.0f, 10.0f), Positions, Indices);
+	RealtimeMeshDistanceFieldGeneratorTests::AppendBox(FVector3f(90.0f, 0.0f, 0.0f), FVector3f(100.0f, 10.0f, 10.0f), Positions, Indices);
+
+	FRealtimeMeshDistanceFieldSettings Settings;
+	Settings.VoxelDensity = 1.0f;
+	Settings.BoundsSlack = 0.1f;
+	FRealtimeMeshDistanceFieldGenerator Generator(Settings);
+
+	FRealtimeMeshDistanceField DistanceField;
+	TestFalse(TEXT("EmptyMeshBuildsNothing"), Generator.Build(TConstArrayView<FVector3f>(), TConstArrayView<int32>(), DistanceField));
+
+	TestTrue(TEXT("Build"), Generator.Build(Positions, Indices, DistanceField));
+	TestTrue(TEXT("BuildIsValid"), DistanceField.IsValid());
+	TestTrue(TEXT("BuildComputesEveryBrick"), Generator.GetNumBricksComputed() == Generator.GetNumBricks() && Generator.GetNumBricks() > 0);
+
+	TestTrue(TEXT("UnchangedUpdate"), Generator.Update(Positions, Indices, DistanceField));
+	TestEqual(TEXT("UnchangedUpdateComputesNothing"), Generator.GetNumBricksComputed(), 0);
+
+	// Dent the far box
+	Positions[8 + 7] -= FVector3f(1.0f, 1.0f, 1.0f);
+	TestTrue(TEXT("PartialUpdate"), Generator.Update(Positions, Indices, DistanceField));
+	TestTrue(TEXT("PartialUpdateIsValid"), DistanceField.IsValid());
+	TestTrue(TEXT("PartialUpdateComputesSomeBricks"), Generator.GetNumBricksComputed() > 0 && Generator.GetNumBricksComputed() < Generator.GetNumBricks() / 2);
+
+	// New triangles need a full build
+	RealtimeMeshDistanceFieldGeneratorTests::AppendBox(FVector3f(40.0f, 0.0f, 0.0f), FVector3f(50.0f, 10.0f, 10.0f), Positions, Indices);
+	TestTrue(TEXT("TopologyUpdate"), Generator.Update(Positions, Indices, DistanceField));
+	TestEqual(TEXT("TopologyChangeRebuilds"), Generator.GetNumBricksComputed(), Generator.GetNumBricks());
+
+	return true;
+}
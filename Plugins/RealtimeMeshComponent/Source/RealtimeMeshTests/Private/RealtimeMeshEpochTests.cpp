@@ -0,0 +1,198 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#include "RealtimeMeshGuard.h"
+#include "Async/Async.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(RealtimeMeshEpochTests, "RealtimeMeshComponent.RealtimeMeshEpoch", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(RealtimeMeshEpochContentionBenchmark, "RealtimeMeshComponent.RealtimeMeshEpochContentionBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+using namespace RealtimeMesh;
+
+namespace RealtimeMeshEpochTests
+{
+	struct FTrackedData
+	{
+		static int32 NumAlive;
+		int32 Value;
+
+		explicit FTrackedData(int32 InValue) : Value(InValue) { NumAlive++; }
+		~FTrackedData() { NumAlive--; }
+	};
+	int32 FTrackedData::NumAlive = 0;
+
+	// Stand in for a section group's streams, consistent when every element holds the same version
+	constexpr int32 NumElements = 4096;
+
+	TArray<int32> MakeVersion(int32 Version)
+	{
+		TArray<int32> Data;
+		Data.Init(Version, NumElements);
+		return Data;
+	}
+
+	bool IsConsistent(const TArray<int32>& Data)
+	{
+		return Data.Num() == NumElements && Data[0] == Data.Last() && Data[0] == Data[NumElements / 2];
+	}
+
+	struct FContentionResult
+	{
+		int64 NumReads = 0;
+		int64 NumTornReads = 0;
+		int32 NumWrites = 0;
+		double Seconds = 0.0;
+	};
+
+	/*
+	 * Runs NumReaders threads reading as fast as they can while the calling thread writes, for Duration seconds
+	 */
+	template<typename ReadFuncType, typename WriteFuncType>
+	FContentionResult RunContention(int32 NumReaders, double Duration, ReadFuncType&& ReadFunc, WriteFuncType&& WriteFunc)
+	{
+		std::atomic<bool> bStop { false };
+		TArray<TFuture<TPair<int64, int64>>> Readers;
+		for (int32 Index = 0; Index < NumReaders; Index++)
+		{
+			Readers.Add(Async(EAsyncExecution::Thread, [&bStop, &ReadFunc]()
+			{
+				int64 NumReads = 0;
+				int64 NumTornReads = 0;
+				while (!bStop.load(std::memory_order_relaxed))
+				{
+					NumTornReads += ReadFunc() ? 0 : 1;
+					NumReads++;
+				}
+				return MakeTuple(NumReads, NumTornReads);
+			}));
+		}
+
+		FContentionResult Result;
+		const double StartTime = FPlatformTime::Seconds();
+		while (FPlatformTime::Seconds() - StartTime < Duration)
+		{
+			WriteFunc(++Result.NumWrites);
+			FPlatformProcess::Yield();
+		}
+		bStop.store(true);
+
+		for (TFuture<TPair<int64, int64>>& Reader : Readers)
+		{
+			const TPair<int64, int64> Counts = Reader.Get();
+			Result.NumReads += Counts.Key;
+			Result.NumTornReads += Counts.Value;
+		}
+		Result.Seconds = FPlatformTime::Seconds() - StartTime;
+		return Result;
+	}
+}
+
+bool RealtimeMeshEpochTests::RunTest(const FString& Parameters)
+{
+	using namespace RealtimeMeshEpochTests;
+	FRealtimeMeshEpoch::Collect();
+	const int32 InitialAlive = FTrackedData::NumAlive;
+
+	{
+		TRealtimeMeshPublished<FTrackedData> Published;
+		Published.Publish(MakeUnique<FTrackedData>(1));
+
+		{
+			FRealtimeMeshScopeEpochRead EpochRead;
+			const FTrackedData* Snapshot = Published.Read();
+			TestTrue(TEXT("ReadPublished"), Snapshot && Snapshot->Value == 1);
+
+			// A version retired while we're reading it must outlive the read
+			Published.Publish(MakeUnique<FTrackedData>(2));
+			FRealtimeMeshEpoch::Collect();
+			TestEqual(TEXT("RetiredHeldByRead"), FTrackedData::NumAlive - InitialAlive, 2);
+			TestEqual(TEXT("SnapshotUnchanged"), Snapshot->Value, 1);
+
+			{
+				FRealtimeMeshScopeEpochRead NestedRead;
+				TestEqual(TEXT("NestedReadSeesLatest"), Published.Read()->Value, 2);
+			}
+			TestTrue(TEXT("StillReadingAfterNested"), FRealtimeMeshEpoch::IsInRead());
+		}
+		TestFalse(TEXT("ReadEnded"), FRealtimeMeshEpoch::IsInRead());
+
+		FRealtimeMeshEpoch::Collect();
+		TestEqual(TEXT("RetiredFreedAfterRead"), FTrackedData::NumAlive - InitialAlive, 1);
+
+		TUniquePtr<FTrackedData> Late = MakeUnique<FTrackedData>(3);
+		TestFalse(TEXT("PublishIfEmptyKeepsExisting"), Published.PublishIfEmpty(Late));
+		TestTrue(TEXT("PublishIfEmptyLeavesData"), Late.IsValid());
+
+		Published.Reset();
+		TestTrue(TEXT("PublishIfEmptyFillsReset"), Published.PublishIfEmpty(Late));
+		TestFalse(TEXT("PublishIfEmptyTakesData"), Late.IsValid());
+	}
+
+	FRealtimeMeshEpoch::Collect();
+	TestEqual(TEXT("AllFreed"), FTrackedData::NumAlive, InitialAlive);
+
+	// Readers on other threads only ever see whole versions while one is being replaced
+	TRealtimeMeshPublished<TArray<int32>> Published;
+	Published.Publish(MakeUnique<TArray<int32>>(MakeVersion(0)));
+	const FContentionResult Result = RunContention(4, 0.1, [&Published]()
+	{
+		FRealtimeMeshScopeEpochRead EpochRead;
+		return IsConsistent(*Published.Read());
+	},
+	[&Published](int32 Version)
+	{
+		Published.Publish(MakeUnique<TArray<int32>>(MakeVersion(Version)));
+	});
+	TestEqual(TEXT("NoTornSnapshots"), Result.NumTornReads, int64(0));
+	TestTrue(TEXT("WriterProgressed"), Result.NumWrites > 1);
+
+	return true;
+}
+
+bool RealtimeMeshEpochContentionBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace RealtimeMeshEpochTests;
+	const int32 NumReaders = FMath::Clamp(FPlatformMisc::NumberOfCoresIncludingHyperthreads() - 1, 2, 15);
+	constexpr double Duration = 1.0;
+
+	FRealtimeMeshGuard Guard;
+	TArray<int32> Data = MakeVersion(0);
+	const FContentionResult LockResult = RunContention(NumReaders, Duration, [&Guard, &Data]()
+	{
+		FRealtimeMeshScopeGuardRead ReadGuard(Guard);
+		return IsConsistent(Data);
+	},
+	[&Guard, &Data](int32 Version)
+	{
+		FRealtimeMeshScopeGuardWrite WriteGuard(Guard);
+		for (int32& Element : Data)
+		{
+			Element = Version;
+		}
+	});
+
+	TRealtimeMeshPublished<TArray<int32>> Published;
+	Published.Publish(MakeUnique<TArray<int32>>(MakeVersion(0)));
+	const FContentionResult EpochResult = RunContention(NumReaders, Duration, [&Published]()
+	{
+		FRealtimeMeshScopeEpochRead EpochRead;
+		return IsConsistent(*Published.Read());
+	},
+	[&Published](int32 Version)
+	{
+		Published.Publish(MakeUnique<TArray<int32>>(MakeVersion(Version)));
+	});
+
+	TestEqual(TEXT("LockTornReads"), LockResult.NumTornReads, int64(0));
+	TestEqual(TEXT("EpochTornReads"), EpochResult.NumTornReads, int64(0));
+
+	auto Report = [this, NumReaders](const TCHAR* Name, const FContentionResult& Result)
+	{
+		AddInfo(FString::Printf(TEXT("%s: %d readers, %.2fM reads/s, %.0f writes/s"), Name, NumReaders,
+			Result.NumReads / Result.Seconds / 1000000.0, Result.NumWrites / Result.Seconds));
+	};
+	Report(TEXT("FRealtimeMeshGuard"), LockResult);
+	Report(TEXT("FRealtimeMeshEpoch"), EpochResult);
+
+	return true;
+}
@@ -0,0 +1,60 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#include "RenderProxy/RealtimeMeshProxyCommandBatch.h"
+#include "Core/RealtimeMeshBuilder.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(RealtimeMeshProxyUpdateBuilderTests, "RealtimeMeshComponent.RealtimeMeshProxyUpdateBuilder", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+using namespace RealtimeMesh;
+
+bool RealtimeMeshProxyUpdateBuilderTests::RunTest(const FString& Parameters)
+{
+	const FRealtimeMeshSectionGroupKey GroupA = FRealtimeMeshSectionGroupKey::Create(0, FName("A"));
+	const FRealtimeMeshSectionGroupKey GroupB = FRealtimeMeshSectionGroupKey::Create(0, FName("B"));
+	auto NoOp = [](FRHICommandListBase&, FRealtimeMeshSectionGroupProxy&) { };
+
+	FRealtimeMeshProxyUpdateBuilder Builder;
+	Builder.AddSectionGroupStreamTask(GroupA, FRealtimeMeshStreams::Position, true, NoOp);
+	Builder.AddSectionGroupStreamTask(GroupA, FRealtimeMeshStreams::Position, false, NoOp, false);
+	Builder.AddSectionGroupStreamTask(GroupA, FRealtimeMeshStreams::Color, true, NoOp);
+	Builder.AddSectionGroupStreamTask(GroupB, FRealtimeMeshStreams::Position, true, NoOp);
+	Builder.AddSectionGroupTask(GroupA, NoOp);
+	TestEqual(TEXT("DistinctStreamsKept"), Builder.NumTasks(), 5);
+
+	// A full upload replaces the earlier full and partial writes of the same stream, and nothing else
+	Builder.AddSectionGroupStreamTask(GroupA, FRealtimeMeshStreams::Position, true, NoOp);
+	TestEqual(TEXT("ReplacedWrites"), Builder.GetNumReplacedTasks(), 2);
+	TestEqual(TEXT("TasksAfterReplace"), Builder.NumTasks(), 4);
+
+	// Partial writes after it stay, they apply on top of it
+	Builder.AddSectionGroupStreamTask(GroupA, FRealtimeMeshStreams::Position, false, NoOp, false);
+	TestEqual(TEXT("PartialWriteKept"), Builder.NumTasks(), 5);
+
+	// Replacing works across appended builders, like two updates of the same section group recorded by a transaction
+	FRealtimeMeshProxyUpdateBuilder Later;
+	Later.AddSectionGroupStreamTask(GroupA, FRealtimeMeshStreams::Position, true, NoOp);
+	Later.AddSectionGroupStreamTask(GroupA, FRealtimeMeshStreams::Color, true, NoOp);
+	Builder.Append(MoveTemp(Later));
+	TestEqual(TEXT("AppendReplaced"), Builder.GetNumReplacedTasks(), 5);
+	TestEqual(TEXT("TasksAfterAppend"), Builder.NumTasks(), 4);
+	TestEqual(TEXT("AppendEmptiesSource"), Later.NumTasks(), 0);
+
+	// Nested transactions join the outermost one
+	TestNull(TEXT("NoActiveTransaction"), FRealtimeMeshUpdateTransaction::GetActive());
+	{
+		FRealtimeMeshUpdateTransaction Transaction;
+		TestTrue(TEXT("ActiveTransaction"), FRealtimeMeshUpdateTransaction::GetActive() == &Transaction);
+		TestFalse(TEXT("OuterNotNested"), Transaction.IsNested());
+		{
+			FRealtimeMeshUpdateTransaction Nested;
+			TestTrue(TEXT("InnerNested"), Nested.IsNested());
+			TestTrue(TEXT("NestedJoinsOuter"), FRealtimeMeshUpdateTransaction::GetActive() == &Transaction);
+		}
+		TestTrue(TEXT("OuterStillActive"), FRealtimeMeshUpdateTransaction::GetActive() == &Transaction);
+		TestEqual(TEXT("NothingRecorded"), Transaction.NumPendingMeshes(), 0);
+	}
+	TestNull(TEXT("TransactionEnded"), FRealtimeMeshUpdateTransaction::GetActive());
+
+	return true;
+}
@@ -0,0 +1,79 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#include "RealtimeMeshSimple.h"
+#include "Core/RealtimeMeshBuilder.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(RealtimeMeshProxyUpdateCoalescingTests, "RealtimeMeshComponent.RealtimeMeshProxyUpdateCoalescing", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+using namespace RealtimeMesh;
+
+namespace RealtimeMeshProxyUpdateCoalescingTests
+{
+	FRealtimeMeshStreamSet MakeTriangle(float Size)
+	{
+		FRealtimeMeshStreamSet Streams;
+		TRealtimeMeshBuilderLocal<uint16, FPackedNormal, FVector2DHalf, 1> Builder(Streams);
+		Builder.EnableTangents();
+		Builder.EnableTexCoords();
+		Builder.EnablePolyGroups();
+
+		const int32 V0 = Builder.AddVertex(FVector3f(0.0f, 0.0f, 0.0f)).SetNormalAndTangent(FVector3f::UpVector, FVector3f::ForwardVector).SetTexCoord(FVector2f(0.0f, 0.0f));
+		const int32 V1 = Builder.AddVertex(FVector3f(0.0f, Size, 0.0f)).SetNormalAndTangent(FVector3f::UpVector, FVector3f::ForwardVector).SetTexCoord(FVector2f(1.0f, 0.0f));
+		const int32 V2 = Builder.AddVertex(FVector3f(Size, 0.0f, 0.0f)).SetNormalAndTangent(FVector3f::UpVector, FVector3f::ForwardVector).SetTexCoord(FVector2f(0.0f, 1.0f));
+		Builder.AddTriangle(V0, V1, V2, 0);
+		return Streams;
+	}
+}
+
+bool RealtimeMeshProxyUpdateCoalescingTests::RunTest(const FString& Parameters)
+{
+	using namespace RealtimeMeshProxyUpdateCoalescingTests;
+
+	// Without a proxy there is nothing to coalesce
+	if (!FApp::CanEverRender())
+	{
+		return true;
+	}
+
+	URealtimeMeshSimple* RealtimeMesh = NewObject<URealtimeMeshSimple>();
+	const TSharedRef<FRealtimeMeshSimple> Mesh = RealtimeMesh->GetMeshData();
+	const FRealtimeMeshSectionGroupKey GroupKey = FRealtimeMeshSectionGroupKey::Create(0, FName("Coalesced"));
+
+	RealtimeMesh->CreateSectionGroup(GroupKey, MakeTriangle(100.0f));
+	TestTrue(TEXT("ProxyCreated"), Mesh->GetRenderProxy(true).IsValid());
+
+	RealtimeMesh->SetCoalesceProxyUpdates(true);
+	TestTrue(TEXT("Coalescing"), RealtimeMesh->IsCoalescingProxyUpdates());
+
+	TFuture<ERealtimeMeshProxyUpdateStatus> First = RealtimeMesh->UpdateSectionGroup(GroupKey, MakeTriangle(200.0f));
+	TFuture<ERealtimeMeshProxyUpdateStatus> Second = RealtimeMesh->UpdateSectionGroup(GroupKey, MakeTriangle(300.0f));
+	TestFalse(TEXT("HeldUntilFlush"), First.IsReady());
+
+	// Mesh data is never held back, only the proxy side is
+	FBox3f Bounds(ForceInit);
+	RealtimeMesh->ProcessMesh(GroupKey, [&Bounds](const FRealtimeMeshStreamSet& Streams)
+	{
+		const FRealtimeMeshStream* Positions = Streams.Find(FRealtimeMeshStreams::Position);
+		for (const FVector3f& Position : Positions->GetArrayView<FVector3f>())
+		{
+			Bounds += Position;
+		}
+	});
+	TestEqual(TEXT("LatestMeshData"), Bounds.Max.X, 300.0f);
+
+	// The second update replaced every stream the first one wrote
+	RealtimeMesh->FlushProxyUpdates();
+	TestTrue(TEXT("SupersededReady"), First.IsReady());
+	TestTrue(TEXT("Superseded"), First.IsReady() && First.Get() == ERealtimeMeshProxyUpdateStatus::Superseded);
+	TestFalse(TEXT("LastNotSuperseded"), Second.IsReady() && Second.Get() == ERealtimeMeshProxyUpdateStatus::Superseded);
+
+	// Turning it off sends what's held so later updates can't overtake it
+	TFuture<ERealtimeMeshProxyUpdateStatus> Third = RealtimeMesh->UpdateSectionGroup(GroupKey, MakeTriangle(400.0f));
+	TFuture<ERealtimeMeshProxyUpdateStatus> Fourth = RealtimeMesh->UpdateSectionGroup(GroupKey, MakeTriangle(500.0f));
+	RealtimeMesh->SetCoalesceProxyUpdates(false);
+	TestFalse(TEXT("CoalescingOff"), RealtimeMesh->IsCoalescingProxyUpdates());
+	TestTrue(TEXT("FlushedOnDisable"), Third.IsReady() && Third.Get() == ERealtimeMeshProxyUpdateStatus::Superseded);
+
+	return true;
+}
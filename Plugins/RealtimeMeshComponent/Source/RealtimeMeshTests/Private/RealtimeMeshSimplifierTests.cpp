@@ -0,0 +1,121 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#include "Mesh/RealtimeMeshSimplifier.h"
+#include "Core/RealtimeMeshBuilder.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(RealtimeMeshSimplifierTests, "RealtimeMeshComponent.RealtimeMeshSimplifier", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+using namespace RealtimeMesh;
+
+namespace RealtimeMeshSimplifierTests
+{
+	static constexpr int32 GridSize = 16;
+
+	// Grid of unit quads facing +Z, the left half is polygroup 0 and the right half polygroup 1
+	void BuildGrid(FRealtimeMeshStreamSet& Streams, float DomeHeight)
+	{
+		TRealtimeMeshStreamBuilder<FVector3f> Positions(Streams.AddStream<FVector3f>(FRealtimeMeshStreams::Position));
+		TRealtimeMeshStreamBuilder<FVector2f> TexCoords(Streams.AddStream<FVector2f>(FRealtimeMeshStreams::TexCoords));
+		TRealtimeMeshStreamBuilder<TIndex3<uint32>> Triangles(Streams.AddStream<TIndex3<uint32>>(FRealtimeMeshStreams::Triangles));
+		TRealtimeMeshStreamBuilder<uint16> PolyGroups(Streams.AddStream<uint16>(FRealtimeMeshStreams::PolyGroups));
+
+		const float Center = GridSize * 0.5f;
+		for (int32 Y = 0; Y <= GridSize; Y++)
+		{
+			for (int32 X = 0; X <= GridSize; X++)
+			{
+				const float Distance = FVector2f(X - Center, Y - Center).Size() / Center;
+				Positions.Add(FVector3f(X, Y, DomeHeight * (1.0f - Distance * Distance)));
+				TexCoords.Add(FVector2f(X, Y) / GridSize);
+			}
+		}
+
+		for (int32 Y = 0; Y < GridSize; Y++)
+		{
+			for (int32 X = 0; X < GridSize; X++)
+			{
+				const uint32 V00 = Y * (GridSize + 1) + X;
+				const uint32 V10 = V00 + 1;
+				const uint32 V01 = V00 + GridSize + 1;
+				const uint32 V11 = V01 + 1;
+				Triangles.Add(TIndex3<uint32>(V00, V01, V10));
+				Triangles.Add(TIndex3<uint32>(V10, V01, V11));
+				PolyGroups.Add(X < GridSize / 2 ? 0 : 1);
+				PolyGroups.Add(X < GridSize / 2 ? 0 : 1);
+			}
+		}
+	}
+}
+
+bool RealtimeMeshSimplifierTests::RunTest(const FString& Parameters)
+{
+	using namespace RealtimeMeshSimplifierTests;
+
+	FRealtimeMeshStreamSet EmptyStreams;
+	TestFalse(TEXT("EmptyMeshIsInvalid"), FRealtimeMeshSimplifier(EmptyStreams).IsValid());
+
+	// A flat grid collapses to far fewer triangles without any error
+	FRealtimeMeshStreamSet FlatStreams;
+	BuildGrid(FlatStreams, 0.0f);
+	FRealtimeMeshSimplifier FlatSimplifier(FlatStreams);
+	TestTrue(TEXT("FlatIsValid"), FlatSimplifier.IsValid());
+	TestEqual(TEXT("FlatSourceTriangles"), FlatSimplifier.GetNumSourceTriangles(), GridSize * GridSize * 2);
+	const int32 NumFlatTriangles = FlatSimplifier.Simplify(GridSize * GridSize / 4);
+	TestTrue(TEXT("FlatReduced"), NumFlatTriangles < GridSize * GridSize);
+	TestTrue(TEXT("FlatHasNoError"), FlatSimplifier.GetError() < KINDA_SMALL_NUMBER);
+
+	FRealtimeMeshStreamSet Result;
+	FlatSimplifier.GetResult(Result);
+	TRealtimeMeshStreamBuilder<const FVector3f> ResultPositions(Result.FindChecked(FRealtimeMeshStreams::Position));
+	TRealtimeMeshStreamBuilder<const TIndex3<uint32>> ResultTriangles(Result.FindChecked(FRealtimeMeshStreams::Triangles));
+	TRealtimeMeshStreamBuilder<const uint16> ResultPolyGroups(Result.FindChecked(FRealtimeMeshStreams::PolyGroups));
+	TestEqual(TEXT("ResultTriangles"), ResultTriangles.Num(), NumFlatTriangles);
+	TestEqual(TEXT("ResultPolyGroups"), ResultPolyGroups.Num(), NumFlatTriangles);
+	TestEqual(TEXT("ResultTexCoordsFollowPositions"), Result.FindChecked(FRealtimeMeshStreams::TexCoords).Num(), ResultPositions.Num());
+	TestTrue(TEXT("ResultDropsVertices"), ResultPositions.Num() < (GridSize + 1) * (GridSize + 1));
+
+	// The outline and the line between the polygroups keep every vertex
+	int32 NumBorderVertices = 0;
+	int32 NumPolyGroupVertices = 0;
+	for (int32 Index = 0; Index < ResultPositions.Num(); Index++)
+	{
+		const FVector3f Position = ResultPositions[Index];
+		if (Position.X == 0.0f || Position.Y == 0.0f || Position.X == GridSize || Position.Y == GridSize)
+		{
+			NumBorderVertices++;
+		}
+		else if (Position.X == GridSize / 2)
+		{
+			NumPolyGroupVertices++;
+		}
+	}
+	TestEqual(TEXT("BorderKept"), NumBorderVertices, GridSize * 4);
+	TestEqual(TEXT("PolyGroupBoundaryKept"), NumPolyGroupVertices, GridSize - 1);
+
+	// Triangles stay on their side of the polygroup boundary
+	bool bPolyGroupsMatch = true;
+	for (int32 TriIdx = 0; TriIdx < ResultTriangles.Num(); TriIdx++)
+	{
+		const TIndex3<uint32> Triangle = ResultTriangles[TriIdx];
+		const FVector3f P0 = ResultPositions[Triangle.V0];
+		const FVector3f P1 = ResultPositions[Triangle.V1];
+		const FVector3f P2 = ResultPositions[Triangle.V2];
+		const uint16 PolyGroup = ResultPolyGroups[TriIdx];
+		bPolyGroupsMatch &= ((P0.X + P1.X + P2.X) / 3.0f < GridSize / 2) == (PolyGroup == 0);
+	}
+	TestTrue(TEXT("PolyGroupsFollowTriangles"), bPolyGroupsMatch);
+
+	// A dome has no free collapses, the error limit holds it and the error grows as it is reduced
+	FRealtimeMeshStreamSet DomeStreams;
+	BuildGrid(DomeStreams, 4.0f);
+	FRealtimeMeshSimplifier DomeSimplifier(DomeStreams);
+	TestEqual(TEXT("DomeHeldByErrorLimit"), DomeSimplifier.Simplify(1, 0.0f), GridSize * GridSize * 2);
+	TestTrue(TEXT("DomeReduced"), DomeSimplifier.Simplify(GridSize * GridSize) < GridSize * GridSize * 2);
+	const float HalfError = DomeSimplifier.GetError();
+	TestTrue(TEXT("DomeHasError"), HalfError > 0.0f);
+	DomeSimplifier.Simplify(GridSize * GridSize / 4);
+	TestTrue(TEXT("DomeErrorGrows"), DomeSimplifier.GetError() >= HalfError);
+
+	return true;
+}
@@ -0,0 +1,50 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#include "Core/RealtimeMeshBuilder.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(RealtimeMeshStreamDirtyRangeTests, "RealtimeMeshComponent.RealtimeMeshStreamDirtyRange", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+using namespace RealtimeMesh;
+
+bool RealtimeMeshStreamDirtyRangeTests::RunTest(const FString& Parameters)
+{
+	FRealtimeMeshStreamSet Streams;
+	Streams.AddStream<FVector3f>(FRealtimeMeshStreams::Position).SetNumZeroed(64);
+	Streams.AddStream<FColor>(FRealtimeMeshStreams::Color).SetNumZeroed(64);
+
+	TestNull(TEXT("NothingRecorded"), Streams.FindDirtyRange(FRealtimeMeshStreams::Color));
+
+	// Ranges of the same stream merge, other streams are unaffected
+	Streams.MarkRangeDirty(FRealtimeMeshStreams::Color, 10, 4);
+	Streams.MarkRangeDirty(FRealtimeMeshStreams::Color, 30, 2);
+	Streams.MarkRangeDirty(FRealtimeMeshStreams::Color, 12, 0);
+	if (const FInt32Range* Range = Streams.FindDirtyRange(FRealtimeMeshStreams::Color))
+	{
+		TestEqual(TEXT("MergedStart"), Range->GetLowerBoundValue(), 10);
+		TestEqual(TEXT("MergedEnd"), Range->GetUpperBoundValue(), 32);
+	}
+	else
+	{
+		AddError(TEXT("Color range was not recorded"));
+	}
+	TestNull(TEXT("OtherStreamClean"), Streams.FindDirtyRange(FRealtimeMeshStreams::Position));
+
+	// Copies keep the ranges of the streams they take
+	Streams.MarkRangeDirty(FRealtimeMeshStreams::Position, 0, 1);
+	FRealtimeMeshStreamSet Copy(Streams, false, { FRealtimeMeshStreams::Color });
+	TestNotNull(TEXT("CopyKeepsRange"), Copy.FindDirtyRange(FRealtimeMeshStreams::Color));
+	TestNull(TEXT("CopyDropsSkippedStream"), Copy.FindDirtyRange(FRealtimeMeshStreams::Position));
+
+	// A replaced stream is dirty as a whole, the old range no longer describes it
+	Streams.AddStream<FColor>(FRealtimeMeshStreams::Color).SetNumZeroed(64);
+	TestNull(TEXT("ReplacedStreamForgetsRange"), Streams.FindDirtyRange(FRealtimeMeshStreams::Color));
+
+	Streams.Remove(FRealtimeMeshStreams::Position);
+	TestNull(TEXT("RemovedStreamForgetsRange"), Streams.FindDirtyRange(FRealtimeMeshStreams::Position));
+
+	Copy.ClearDirtyRanges();
+	TestNull(TEXT("Cleared"), Copy.FindDirtyRange(FRealtimeMeshStreams::Color));
+
+	return true;
+}
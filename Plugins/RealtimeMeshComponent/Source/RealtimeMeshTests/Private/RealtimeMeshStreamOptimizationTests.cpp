@@ -0,0 +1,181 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#include "Mesh/RealtimeMeshAlgo.h"
+#include "Core/RealtimeMeshBuilder.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(RealtimeMeshStreamOptimizationTests, "RealtimeMeshComponent.RealtimeMeshStreamOptimization", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(RealtimeMeshStreamOptimizationBenchmark, "RealtimeMeshComponent.RealtimeMeshStreamOptimizationBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+using namespace RealtimeMesh;
+
+namespace RealtimeMeshStreamOptimizationTests
+{
+	// Grid of unit quads where every quad has its own four vertices, like a builder that emits faces independently.
+	// Triangles are shuffled inside each half, the left half is polygroup 0 and the right half polygroup 1
+	void BuildQuadSoup(FRealtimeMeshStreamSet& Streams, int32 GridSize)
+	{
+		TRealtimeMeshStreamBuilder<FVector3f> Positions(Streams.AddStream<FVector3f>(FRealtimeMeshStreams::Position));
+		TRealtimeMeshStreamBuilder<FVector2f> TexCoords(Streams.AddStream<FVector2f>(FRealtimeMeshStreams::TexCoords));
+		TRealtimeMeshStreamBuilder<TIndex3<uint32>> Triangles(Streams.AddStream<TIndex3<uint32>>(FRealtimeMeshStreams::Triangles));
+		TRealtimeMeshStreamBuilder<uint16> PolyGroups(Streams.AddStream<uint16>(FRealtimeMeshStreams::PolyGroups));
+
+		TArray<TIndex3<uint32>> GroupTriangles[2];
+		for (int32 Y = 0; Y < GridSize; Y++)
+		{
+			for (int32 X = 0; X < GridSize; X++)
+			{
+				const uint32 V00 = Positions.Num();
+				for (const FIntPoint& Corner : { FIntPoint(0, 0), FIntPoint(1, 0), FIntPoint(0, 1), FIntPoint(1, 1) })
+				{
+					Positions.Add(FVector3f(X + Corner.X, Y + Corner.Y, 0.0f));
+					TexCoords.Add(FVector2f(X + Corner.X, Y + Corner.Y) / GridSize);
+				}
+
+				const int32 Group = X < GridSize / 2 ? 0 : 1;
+				GroupTriangles[Group].Add(TIndex3<uint32>(V00, V00 + 2, V00 + 1));
+				GroupTriangles[Group].Add(TIndex3<uint32>(V00 + 1, V00 + 2, V00 + 3));
+			}
+		}
+
+		FRandomStream Random(1234);
+		for (int32 Group = 0; Group < 2; Group++)
+		{
+			for (int32 Index = GroupTriangles[Group].Num() - 1; Index > 0; Index--)
+			{
+				GroupTriangles[Group].Swap(Index, Random.RandRange(0, Index));
+			}
+			for (const TIndex3<uint32>& Triangle : GroupTriangles[Group])
+			{
+				Triangles.Add(Triangle);
+				PolyGroups.Add(Group);
+			}
+		}
+	}
+
+	TArray<int32> GetIndices(const FRealtimeMeshStreamSet& Streams)
+	{
+		TArray<FVector3f> Positions;
+		TArray<int32> Indices;
+		RealtimeMeshAlgo::CopyPositionsAndTriangles(Streams, Positions, Indices);
+		return Indices;
+	}
+
+	// Per triangle key from its corner positions and polygroup, rotated to start at the lowest corner so winding is kept
+	TArray<int64> GetTriangleKeys(const FRealtimeMeshStreamSet& Streams, int32 GridSize)
+	{
+		TArray<FVector3f> Positions;
+		TArray<int32> Indices;
+		RealtimeMeshAlgo::CopyPositionsAndTriangles(Streams, Positions, Indices);
+		const TConstArrayView<const uint16> PolyGroups = Streams.FindChecked(FRealtimeMeshStreams::PolyGroups).GetArrayView<uint16>();
+
+		const int64 NumGridVertices = (GridSize + 1) * (GridSize + 1);
+		TArray<int64> Keys;
+		for (int32 TriIdx = 0; TriIdx < Indices.Num() / 3; TriIdx++)
+		{
+			int64 Corners[3];
+			for (int32 Corner = 0; Corner < 3; Corner++)
+			{
+				const FVector3f& Position = Positions[Indices[TriIdx * 3 + Corner]];
+				Corners[Corner] = int64(Position.Y) * (GridSize + 1) + int64(Position.X);
+			}
+
+			const int32 First = Corners[0] < Corners[1] ? (Corners[0] < Corners[2] ? 0 : 2) : (Corners[1] < Corners[2] ? 1 : 2);
+			int64 Key = PolyGroups[TriIdx];
+			for (int32 Corner = 0; Corner < 3; Corner++)
+			{
+				Key = Key * NumGridVertices + Corners[(First + Corner) % 3];
+			}
+			Keys.Add(Key);
+		}
+		return Keys;
+	}
+}
+
+bool RealtimeMeshStreamOptimizationTests::RunTest(const FString& Parameters)
+{
+	using namespace RealtimeMeshStreamOptimizationTests;
+	constexpr int32 GridSize = 16;
+
+	FRealtimeMeshStreamSet Streams;
+	BuildQuadSoup(Streams, GridSize);
+
+	TArray<int64> SourceKeys = GetTriangleKeys(Streams, GridSize);
+	SourceKeys.Sort();
+	const TArray<uint16> SourcePolyGroups(Streams.FindChecked(FRealtimeMeshStreams::PolyGroups).GetArrayView<uint16>());
+	const float SourceACMR = RealtimeMeshAlgo::ComputeACMR(GetIndices(Streams));
+
+	// Soup vertices shared by neighbouring quads are identical in every stream
+	const int32 NumRemoved = RealtimeMeshAlgo::WeldVertices(Streams);
+	TestEqual(TEXT("WeldRemovedDuplicates"), NumRemoved, 4 * GridSize * GridSize - (GridSize + 1) * (GridSize + 1));
+	TestEqual(TEXT("WeldKeptPositionsAndTexCoordsAligned"), Streams.FindChecked(FRealtimeMeshStreams::TexCoords).Num(), (GridSize + 1) * (GridSize + 1));
+	TestEqual(TEXT("WeldIsIdempotent"), RealtimeMeshAlgo::WeldVertices(Streams), 0);
+
+	TestTrue(TEXT("OptimizeSucceeded"), RealtimeMeshAlgo::OptimizeStreamSet(Streams));
+
+	TArray<int64> OptimizedKeys = GetTriangleKeys(Streams, GridSize);
+	OptimizedKeys.Sort();
+	TestTrue(TEXT("SameTrianglesAndWinding"), OptimizedKeys == SourceKeys);
+	TestTrue(TEXT("PolyGroupsUnchanged"), TArray<uint16>(Streams.FindChecked(FRealtimeMeshStreams::PolyGroups).GetArrayView<uint16>()) == SourcePolyGroups);
+
+	const TArray<int32> Indices = GetIndices(Streams);
+	const float OptimizedACMR = RealtimeMeshAlgo::ComputeACMR(Indices);
+	TestTrue(TEXT("ACMRImproved"), OptimizedACMR < SourceACMR);
+	TestTrue(TEXT("ACMRBelowOneOnGrid"), OptimizedACMR < 1.0f);
+
+	// Vertices are numbered in order of first use
+	int32 NextVertex = 0;
+	bool bFirstUseOrder = true;
+	for (const int32 Index : Indices)
+	{
+		bFirstUseOrder &= Index <= NextVertex;
+		NextVertex = FMath::Max(NextVertex, Index + 1);
+	}
+	TestTrue(TEXT("VerticesInFirstUseOrder"), bFirstUseOrder);
+
+	// Mismatched vertex streams can't be remapped consistently, the stream set is left alone
+	FRealtimeMeshStreamSet MismatchedStreams;
+	BuildQuadSoup(MismatchedStreams, 2);
+	TRealtimeMeshStreamBuilder<FVector2f>(MismatchedStreams.FindChecked(FRealtimeMeshStreams::TexCoords)).SetNumUninitialized(3);
+	AddExpectedError(TEXT("Vertex streams differ in length"), EAutomationExpectedErrorFlags::Contains, 2);
+	TestEqual(TEXT("MismatchedStreamsNotWelded"), RealtimeMeshAlgo::WeldVertices(MismatchedStreams), 0);
+	TestFalse(TEXT("MismatchedStreamsNotReordered"), RealtimeMeshAlgo::OptimizeVertexOrder(MismatchedStreams));
+
+	TestEqual(TEXT("EmptyACMR"), RealtimeMeshAlgo::ComputeACMR(TConstArrayView<int32>()), 0.0f);
+
+	return true;
+}
+
+bool RealtimeMeshStreamOptimizationBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace RealtimeMeshStreamOptimizationTests;
+	constexpr int32 GridSize = 256;
+
+	FRealtimeMeshStreamSet Streams;
+	BuildQuadSoup(Streams, GridSize);
+	const int32 SourceVertices = Streams.FindChecked(FRealtimeMeshStreams::Position).Num();
+	const float SourceACMR = RealtimeMeshAlgo::ComputeACMR(GetIndices(Streams));
+
+	double StartTime = FPlatformTime::Seconds();
+	RealtimeMeshAlgo::WeldVertices(Streams);
+	const double WeldTime = FPlatformTime::Seconds() - StartTime;
+
+	StartTime = FPlatformTime::Seconds();
+	RealtimeMeshAlgo::OptimizeTriangleOrder(Streams);
+	const double TriangleOrderTime = FPlatformTime::Seconds() - StartTime;
+
+	StartTime = FPlatformTime::Seconds();
+	RealtimeMeshAlgo::OptimizeVertexOrder(Streams);
+	const double VertexOrderTime = FPlatformTime::Seconds() - StartTime;
+
+	const int32 NumTriangles = Streams.FindChecked(FRealtimeMeshStreams::Triangles).Num();
+	const float OptimizedACMR = RealtimeMeshAlgo::ComputeACMR(GetIndices(Streams));
+
+	AddInfo(FString::Printf(TEXT("%d triangles, vertices %d -> %d"), NumTriangles, SourceVertices, Streams.FindChecked(FRealtimeMeshStreams::Position).Num()));
+	AddInfo(FString::Printf(TEXT("Weld %.2fms, triangle order %.2fms, vertex order %.2fms"), WeldTime * 1000.0, TriangleOrderTime * 1000.0, VertexOrderTime * 1000.0));
+	AddInfo(FString::Printf(TEXT("ACMR %.3f -> %.3f, vertex shader invocations %d -> %d"), SourceACMR, OptimizedACMR,
+	                        FMath::RoundToInt(SourceACMR * NumTriangles), FMath::RoundToInt(OptimizedACMR * NumTriangles)));
+
+	TestTrue(TEXT("ACMRImproved"), OptimizedACMR < SourceACMR);
+	return true;
+}
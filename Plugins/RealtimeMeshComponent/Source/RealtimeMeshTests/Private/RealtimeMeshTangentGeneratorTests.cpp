@@ -0,0 +1,172 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#include "Mesh/RealtimeMeshTangentGenerator.h"
+#include "Mesh/RealtimeMeshAlgo.h"
+#include "Core/RealtimeMeshBuilder.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(RealtimeMeshTangentGeneratorTests, "RealtimeMeshComponent.RealtimeMeshTangentGenerator", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+using namespace RealtimeMesh;
+
+namespace RealtimeMeshTangentGeneratorTests
+{
+	static constexpr int32 GridSize = 8;
+
+	struct FTestMesh
+	{
+		TArray<FVector3f> Positions;
+		TArray<FVector2f> UVs;
+		TArray<int32> Indices;
+	};
+
+	// Grid of unit quads facing +Z with U along +X, or along -X when mirrored
+	void AddGrid(FTestMesh& Mesh, float OffsetX, bool bMirrorU, float DomeHeight)
+	{
+		const int32 FirstVertex = Mesh.Positions.Num();
+		for (int32 Y = 0; Y <= GridSize; Y++)
+		{
+			for (int32 X = 0; X <= GridSize; X++)
+			{
+				const float Distance = FVector2f(X - GridSize * 0.5f, Y - GridSize * 0.5f).Size() / GridSize;
+				Mesh.Positions.Add(FVector3f(OffsetX + X, Y, DomeHeight * (1.0f - Distance * Distance)));
+				Mesh.UVs.Add(FVector2f(bMirrorU ? GridSize - X : X, Y) / GridSize);
+			}
+		}
+
+		for (int32 Y = 0; Y < GridSize; Y++)
+		{
+			for (int32 X = 0; X < GridSize; X++)
+			{
+				const int32 V00 = FirstVertex + Y * (GridSize + 1) + X;
+				const int32 V10 = V00 + 1;
+				const int32 V01 = V00 + GridSize + 1;
+				const int32 V11 = V01 + 1;
+				Mesh.Indices.Append({ V00, V01, V10, V10, V01, V11 });
+			}
+		}
+	}
+}
+
+bool RealtimeMeshTangentGeneratorTests::RunTest(const FString& Parameters)
+{
+	using namespace RealtimeMeshTangentGeneratorTests;
+
+	// Flat grids, the right one with mirrored UVs and its own vertices along the seam like a mirrored UV island
+	FTestMesh Flat;
+	AddGrid(Flat, 0.0f, false, 0.0f);
+	AddGrid(Flat, GridSize, true, 0.0f);
+	const int32 NumGridVertices = (GridSize + 1) * (GridSize + 1);
+
+	TArray<int32> CornerOffsets;
+	TArray<int32> Corners;
+	TestTrue(TEXT("AdjacencyBuilt"), FRealtimeMeshTangentGenerator::BuildAdjacency(Flat.Indices, Flat.Positions.Num(), CornerOffsets, Corners));
+	TestEqual(TEXT("EveryCornerListed"), Corners.Num(), Flat.Indices.Num());
+
+	TArray<int32> InvalidOffsets;
+	TArray<int32> InvalidCorners;
+	TestFalse(TEXT("OutOfRangeIndexRejected"), FRealtimeMeshTangentGenerator::BuildAdjacency(TArray<int32>{ 0, 1, 3 }, 3, InvalidOffsets, InvalidCorners));
+
+	const FRealtimeMeshTangentGenerator FlatGenerator(Flat.Indices, CornerOffsets, Corners);
+	TArray<FVector3f> Normals;
+	Normals.SetNumZeroed(Flat.Positions.Num());
+	FlatGenerator.ComputeNormals(Flat.Positions, Normals);
+
+	TArray<FVector3f> Tangents;
+	Tangents.SetNumZeroed(Flat.Positions.Num());
+	TArray<float> Signs;
+	Signs.SetNumZeroed(Flat.Positions.Num());
+	FlatGenerator.ComputeTangents(Flat.Positions, Normals, Flat.UVs, Tangents, Signs);
+
+	bool bNormalsUp = true;
+	bool bTangentsFollowU = true;
+	bool bSignsUniform = true;
+	for (int32 VertexIdx = 0; VertexIdx < Flat.Positions.Num(); VertexIdx++)
+	{
+		const bool bMirrored = VertexIdx >= NumGridVertices;
+		bNormalsUp &= Normals[VertexIdx].Equals(FVector3f::UnitZ(), KINDA_SMALL_NUMBER);
+		bTangentsFollowU &= Tangents[VertexIdx].Equals(bMirrored ? -FVector3f::UnitX() : FVector3f::UnitX(), KINDA_SMALL_NUMBER);
+		bSignsUniform &= Signs[VertexIdx] == (bMirrored ? -Signs[0] : Signs[0]);
+	}
+	TestTrue(TEXT("FlatNormalsFaceUp"), bNormalsUp);
+	TestTrue(TEXT("TangentsFollowU"), bTangentsFollowU);
+	TestTrue(TEXT("MirroredUVsFlipTheBinormalSign"), bSignsUniform);
+
+	// On a curved surface tangents stay in the plane of the normal
+	FTestMesh Dome;
+	AddGrid(Dome, 0.0f, false, 4.0f);
+	FRealtimeMeshTangentGenerator::BuildAdjacency(Dome.Indices, Dome.Positions.Num(), CornerOffsets, Corners);
+	const FRealtimeMeshTangentGenerator DomeGenerator(Dome.Indices, CornerOffsets, Corners);
+	Normals.SetNumZeroed(Dome.Positions.Num());
+	Tangents.SetNumZeroed(Dome.Positions.Num());
+	DomeGenerator.ComputeNormals(Dome.Positions, Normals);
+	DomeGenerator.ComputeTangents(Dome.Positions, Normals, Dome.UVs, Tangents);
+
+	bool bOrthonormal = true;
+	for (int32 VertexIdx = 0; VertexIdx < Dome.Positions.Num(); VertexIdx++)
+	{
+		bOrthonormal &= FMath::IsNearlyZero(Normals[VertexIdx] | Tangents[VertexIdx], KINDA_SMALL_NUMBER) && Tangents[VertexIdx].IsNormalized();
+	}
+	TestTrue(TEXT("TangentsOrthonormalToNormals"), bOrthonormal);
+
+	// Moving one vertex and updating the vertices of its triangles matches a full recompute
+	const int32 MovedVertex = 4 * (GridSize + 1) + 4;
+	Dome.Positions[MovedVertex].Z += 1.5f;
+	TArray<int32> Affected;
+	for (int32 CornerIdx = CornerOffsets[MovedVertex]; CornerIdx < CornerOffsets[MovedVertex + 1]; CornerIdx++)
+	{
+		const int32 TriangleStart = Corners[CornerIdx] - Corners[CornerIdx] % 3;
+		for (int32 Corner = 0; Corner < 3; Corner++)
+		{
+			Affected.AddUnique(Dome.Indices[TriangleStart + Corner]);
+		}
+	}
+	DomeGenerator.ComputeNormals(Dome.Positions, Normals, Affected);
+	DomeGenerator.ComputeTangents(Dome.Positions, Normals, Dome.UVs, Tangents, TArrayView<float>(), Affected);
+
+	TArray<FVector3f> FullNormals;
+	TArray<FVector3f> FullTangents;
+	FullNormals.SetNumZeroed(Dome.Positions.Num());
+	FullTangents.SetNumZeroed(Dome.Positions.Num());
+	DomeGenerator.ComputeNormals(Dome.Positions, FullNormals);
+	DomeGenerator.ComputeTangents(Dome.Positions, FullNormals, Dome.UVs, FullTangents);
+	TestTrue(TEXT("PartialUpdateMatchesFull"), Normals == FullNormals && Tangents == FullTangents);
+
+	// The stream set path smooths across split vertices and writes packed tangents
+	FRealtimeMeshStreamSet Streams;
+	{
+		TRealtimeMeshStreamBuilder<FVector3f> Positions(Streams.AddStream<FVector3f>(FRealtimeMeshStreams::Position));
+		TRealtimeMeshStreamBuilder<FVector2f> TexCoords(Streams.AddStream<FVector2f>(FRealtimeMeshStreams::TexCoords));
+		TRealtimeMeshStreamBuilder<TIndex3<uint32>> Triangles(Streams.AddStream<TIndex3<uint32>>(FRealtimeMeshStreams::Triangles));
+		for (int32 VertexIdx = 0; VertexIdx < Flat.Positions.Num(); VertexIdx++)
+		{
+			Positions.Add(Flat.Positions[VertexIdx]);
+			TexCoords.Add(Flat.UVs[VertexIdx]);
+		}
+		for (int32 Index = 0; Index < Flat.Indices.Num(); Index += 3)
+		{
+			Triangles.Add(TIndex3<uint32>(Flat.Indices[Index], Flat.Indices[Index + 1], Flat.Indices[Index + 2]));
+		}
+	}
+	RealtimeMeshAlgo::GenerateTangents(Streams, true);
+
+	TRealtimeMeshStreamBuilder<const FRealtimeMeshTangentsNormalPrecision> StreamTangents(Streams.FindChecked(FRealtimeMeshStreams::Tangents));
+	TestEqual(TEXT("StreamTangentsPerVertex"), StreamTangents.Num(), Flat.Positions.Num());
+	const FRealtimeMeshTangentsNormalPrecision SeamLeft = StreamTangents[GridSize];
+	const FRealtimeMeshTangentsNormalPrecision SeamRight = StreamTangents[NumGridVertices];
+	TestTrue(TEXT("StreamNormalsFaceUp"), SeamLeft.GetNormal().Equals(FVector3f::UnitZ(), 0.01f) && SeamRight.GetNormal().Equals(FVector3f::UnitZ(), 0.01f));
+	TestTrue(TEXT("StreamSignsFlipAcrossMirrorSeam"), SeamLeft.IsBinormalFlipped() != SeamRight.IsBinormalFlipped());
+
+	// Split vertices a float rounding apart still count as one position, like seams written by a deforming mesh
+	const TArray<FVector3f> FoldPositions = { FVector3f(0, 0, 0), FVector3f(1, 0, 0), FVector3f(0, 1, 0), FVector3f(1, 1e-6f, 0), FVector3f(0, 1, 1e-6f), FVector3f(1, 1, 1) };
+	const TArray<FVector2f> FoldUVs = { FVector2f(0, 0), FVector2f(1, 0), FVector2f(0, 1), FVector2f(1, 0), FVector2f(0, 1), FVector2f(1, 1) };
+	const TArray<int32> FoldIndices = { 0, 2, 1, 3, 4, 5 };
+	TArray<FVector3f> FoldNormals;
+	TArray<FVector3f> FoldTangents;
+	TArray<float> FoldSigns;
+	RealtimeMeshAlgo::GenerateTangents(FoldIndices, FoldPositions, FoldUVs, FoldNormals, FoldTangents, FoldSigns, true);
+	TestTrue(TEXT("NearlyEqualPositionsShareNormals"), FoldNormals[1].Equals(FoldNormals[3], KINDA_SMALL_NUMBER) && FoldNormals[2].Equals(FoldNormals[4], KINDA_SMALL_NUMBER));
+	TestFalse(TEXT("FoldIsSmoothed"), FoldNormals[1].Equals(FoldNormals[0], KINDA_SMALL_NUMBER));
+
+	return true;
+}
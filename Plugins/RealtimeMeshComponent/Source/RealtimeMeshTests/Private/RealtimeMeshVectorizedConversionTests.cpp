@@ -0,0 +1,169 @@
+﻿// Copyright (c) 2015-2024 TriAxis Games, L.L.C. All Rights Reserved.
+
+#include "Core/RealtimeMeshBuilder.h"
+#include "Core/RealtimeMeshVectorizedConversion.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(RealtimeMeshVectorizedConversionTests, "RealtimeMeshComponent.RealtimeMeshVectorizedConversion", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(RealtimeMeshVectorizedConversionBenchmark, "RealtimeMeshComponent.RealtimeMeshVectorizedConversionBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+using namespace RealtimeMesh;
+
+namespace RealtimeMeshVectorizedConversionTests
+{
+	const ERealtimeMeshConversionPath AllPaths[] = { ERealtimeMeshConversionPath::Scalar, ERealtimeMeshConversionPath::Vector, ERealtimeMeshConversionPath::AVX2 };
+
+	// Unit range components like normals and UVs, with every eighth one out of range to hit the clamps
+	float RandomComponent(FRandomStream& Random)
+	{
+		return Random.RandRange(0, 7) == 0 ? Random.FRandRange(-4.0f, 4.0f) : Random.FRandRange(-1.0f, 1.0f);
+	}
+
+	template<typename Type>
+	TArray<Type> MakeRandomArray(int32 Num, int32 Seed)
+	{
+		FRandomStream Random(Seed);
+		TArray<Type> Result;
+		Result.SetNumUninitialized(Num);
+		float* Components = reinterpret_cast<float*>(Result.GetData());
+		for (int32 Index = 0; Index < Num * int32(sizeof(Type) / sizeof(float)); Index++)
+		{
+			Components[Index] = RandomComponent(Random);
+		}
+		return Result;
+	}
+
+	template<typename FromType, typename ToType>
+	TArray<ToType> ConvertScalar(const TArray<FromType>& Source)
+	{
+		TArray<ToType> Result;
+		Result.SetNumUninitialized(Source.Num());
+		for (int32 Index = 0; Index < Source.Num(); Index++)
+		{
+			Result[Index] = ToType(Source[Index]);
+		}
+		return Result;
+	}
+
+	template<typename FromType, typename ToType>
+	TArray<ToType> ConvertWithPath(const TArray<FromType>& Source, ERealtimeMeshConversionPath Path,
+	                               void (*Converter)(const FromType*, ToType*, uint32, ERealtimeMeshConversionPath))
+	{
+		TArray<ToType> Result;
+		Result.SetNumUninitialized(Source.Num());
+		Converter(Source.GetData(), Result.GetData(), Source.Num(), Path);
+		return Result;
+	}
+
+	template<typename Type>
+	bool BitwiseEqual(const TArray<Type>& A, const TArray<Type>& B)
+	{
+		return A.Num() == B.Num() && FMemory::Memcmp(A.GetData(), B.GetData(), A.Num() * sizeof(Type)) == 0;
+	}
+
+	template<typename FromType, typename ToType>
+	void MatchesScalarOnAllPaths(FAutomationTestBase& Test, const TCHAR* Name, void (*Converter)(const FromType*, ToType*, uint32, ERealtimeMeshConversionPath))
+	{
+		// Odd sizes leave a tail for the scalar remainder of every kernel
+		for (const int32 Num : { 0, 1, 3, 7, 17, 1003 })
+		{
+			const TArray<FromType> Source = MakeRandomArray<FromType>(Num, Num);
+			const TArray<ToType> Expected = ConvertScalar<FromType, ToType>(Source);
+			for (const ERealtimeMeshConversionPath Path : AllPaths)
+			{
+				Test.TestTrue(FString::Printf(TEXT("%s %s %d"), Name, FRealtimeMeshVectorizedConversion::GetPathName(Path), Num),
+				              BitwiseEqual(ConvertWithPath(Source, Path, Converter), Expected));
+			}
+		}
+	}
+
+	template<typename FromType, typename ToType>
+	void Benchmark(FAutomationTestBase& Test, const TCHAR* Name, void (*Converter)(const FromType*, ToType*, uint32, ERealtimeMeshConversionPath))
+	{
+		constexpr int32 NumElements = 1 << 20;
+		constexpr int32 NumIterations = 20;
+
+		const TArray<FromType> Source = MakeRandomArray<FromType>(NumElements, 1234);
+		TArray<ToType> Destination;
+		Destination.SetNumUninitialized(NumElements);
+
+		// The per element loop the contiguous converters ran before, kept as the baseline
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < NumIterations; Iteration++)
+		{
+			for (int32 Index = 0; Index < NumElements; Index++)
+			{
+				Destination[Index] = ToType(Source[Index]);
+			}
+		}
+		const double ScalarTime = (FPlatformTime::Seconds() - StartTime) / NumIterations;
+
+		FString Report = FString::Printf(TEXT("%s, %d elements: per element %.3fms"), Name, NumElements, ScalarTime * 1000.0);
+		for (const ERealtimeMeshConversionPath Path : AllPaths)
+		{
+			if (Path > FRealtimeMeshVectorizedConversion::GetSupportedPath())
+			{
+				continue;
+			}
+
+			StartTime = FPlatformTime::Seconds();
+			for (int32 Iteration = 0; Iteration < NumIterations; Iteration++)
+			{
+				Converter(Source.GetData(), Destination.GetData(), NumElements, Path);
+			}
+			const double PathTime = (FPlatformTime::Seconds() - StartTime) / NumIterations;
+			Report += FString::Printf(TEXT(", %s %.3fms (%.1fx)"), FRealtimeMeshVectorizedConversion::GetPathName(Path), PathTime * 1000.0, ScalarTime / FMath::Max(PathTime, UE_SMALL_NUMBER));
+		}
+		Test.AddInfo(Report);
+	}
+}
+
+bool RealtimeMeshVectorizedConversionTests::RunTest(const FString& Parameters)
+{
+	using namespace RealtimeMeshVectorizedConversionTests;
+
+	MatchesScalarOnAllPaths(*this, TEXT("FloatToHalf"), &FRealtimeMeshVectorizedConversion::ConvertFloatToHalf);
+	MatchesScalarOnAllPaths(*this, TEXT("Vector2fToHalf"), &FRealtimeMeshVectorizedConversion::ConvertVector2fToHalf);
+	MatchesScalarOnAllPaths(*this, TEXT("Vector3fToPackedNormal"), &FRealtimeMeshVectorizedConversion::ConvertVector3fToPackedNormal);
+	MatchesScalarOnAllPaths(*this, TEXT("Vector4fToPackedNormal"), &FRealtimeMeshVectorizedConversion::ConvertVector4fToPackedNormal);
+	MatchesScalarOnAllPaths(*this, TEXT("Vector4fToPackedRGBA16N"), &FRealtimeMeshVectorizedConversion::ConvertVector4fToPackedRGBA16N);
+
+	// Signed zeros, the largest half, subnormal and underflowing halves, and ties between two halves
+	const TArray<float> SpecialValues = { 0.0f, -0.0f, 65504.0f, -65504.0f, 1.0e-7f, -3.0e-6f, 6.1e-5f, -1.0e-20f, 0.5f, -2.0f, 1.0f / 3.0f, 2049.0f, 2051.0f, -4097.0f, 1.00048828125f, 2.98e-8f };
+	const TArray<FFloat16> ExpectedHalves = ConvertScalar<float, FFloat16>(SpecialValues);
+	for (const ERealtimeMeshConversionPath Path : AllPaths)
+	{
+		TestTrue(FString::Printf(TEXT("SpecialHalves %s"), FRealtimeMeshVectorizedConversion::GetPathName(Path)),
+		         BitwiseEqual(ConvertWithPath(SpecialValues, Path, &FRealtimeMeshVectorizedConversion::ConvertFloatToHalf), ExpectedHalves));
+	}
+
+	// Streams converting in place go through the registered contiguous converter
+	const TArray<TRealtimeMeshTangents<FVector4f>> Tangents = MakeRandomArray<TRealtimeMeshTangents<FVector4f>>(257, 42);
+	FRealtimeMeshStream TangentStream = FRealtimeMeshStream::Create<TRealtimeMeshTangents<FVector4f>>(FRealtimeMeshStreams::Tangents);
+	TangentStream.Append(Tangents);
+	TestTrue(TEXT("TangentStreamConverted"), TangentStream.ConvertTo<TRealtimeMeshTangents<FPackedNormal>>());
+
+	TArray<FPackedNormal> ExpectedPacked;
+	for (const TRealtimeMeshTangents<FVector4f>& Tangent : Tangents)
+	{
+		ExpectedPacked.Add(FPackedNormal(Tangent.Tangent));
+		ExpectedPacked.Add(FPackedNormal(Tangent.Normal));
+	}
+	TestTrue(TEXT("TangentStreamMatchesScalar"), TangentStream.GetStride() * TangentStream.Num() == ExpectedPacked.Num() * sizeof(FPackedNormal)
+		&& FMemory::Memcmp(TangentStream.GetData(), ExpectedPacked.GetData(), ExpectedPacked.Num() * sizeof(FPackedNormal)) == 0);
+
+	return true;
+}
+
+bool RealtimeMeshVectorizedConversionBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace RealtimeMeshVectorizedConversionTests;
+
+	AddInfo(FString::Printf(TEXT("Supported path: %s"), FRealtimeMeshVectorizedConversion::GetPathName(FRealtimeMeshVectorizedConversion::GetSupportedPath())));
+	Benchmark(*this, TEXT("float -> FFloat16"), &FRealtimeMeshVectorizedConversion::ConvertFloatToHalf);
+	Benchmark(*this, TEXT("FVector2f -> FVector2DHalf"), &FRealtimeMeshVectorizedConversion::ConvertVector2fToHalf);
+	Benchmark(*this, TEXT("FVector3f -> FPackedNormal"), &FRealtimeMeshVectorizedConversion::ConvertVector3fToPackedNormal);
+	Benchmark(*this, TEXT("FVector4f -> FPackedNormal"), &FRealtimeMeshVectorizedConversion::ConvertVector4fToPackedNormal);
+	Benchmark(*this, TEXT("FVector4f -> FPackedRGBA16N"), &FRealtimeMeshVectorizedConversion::ConvertVector4fToPackedRGBA16N);
+	return true;
+}
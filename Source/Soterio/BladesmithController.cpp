@@ -8,6 +8,9 @@
 #include "Serialization/JsonSerializer.h"
 #include "MeshDescription.h"
 #include "StaticMeshAttributes.h"
+#include "Async/Async.h"
+
+#include "../../Plugins/RealtimeMeshComponent/Source/RealtimeMeshComponent/Public/RealtimeMeshThreadingSubsystem.h"
 
 DEFINE_LOG_CATEGORY(LogBladesmithController);
 
@@ -150,27 +153,72 @@ void ABladesmithController::BeginPlay()
 	if (!Player)
 		return;
 	Bindings();
-	if (ProductQuery.Num() == 0)
-	{
-		ProductQuery.Add(new FProductProperties());
-	}
-	USoterioMeshLib::ExtractMeshData(BaseStaticMesh, *ProductQuery[0], true);
+	ProductStore = UProductStoreSubsystem::Get(this);
 	//USoterioMeshLib::CreateOreInstance(BaseStaticMesh, ProductComponent, *ProductQuery[0], ProductMaterial, true);
 	CreateOreInstance();
 	InitHammerList();
+
+	URealtimeMeshSimple* RealtimeMesh = Cast<URealtimeMeshSimple>(ProductComponent->GetRealtimeMesh());
+	if (bAsyncProductUpdates && RealtimeMesh && ProductQuery.Num() > 0)
+	{
+		ProductPipeline = MakeShared<FProductMeshPipeline>(ProductQuery[0], RealtimeMesh, FRealtimeMeshSectionGroupKey::Create(0, FName("TestTriangle")));
+		ProductPipeline->OnProductSwapped = [this](FProductProperties& Product, EProductDirtyFlags DirtyFlags)
+		{
+			OnProductSwapped(Product, DirtyFlags);
+		};
+	}
+
 	GetWorld()->GetTimerManager().SetTimer(
 		GameProgressTimeHandle,
 		this,
 		&ABladesmithController::TimePasses,
-		0.1f,
+		TimePassesInterval,
 		true
 	);
 }
 
+void ABladesmithController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Workers edit a copy of ProductQuery[0], let them finish before it goes away
+	if (ProductPipeline.IsValid())
+	{
+		ProductPipeline->Flush();
+		ProductPipeline.Reset();
+	}
+	if (DistanceFieldBuild.IsValid())
+	{
+		DistanceFieldBuild.Wait();
+		DistanceFieldBuild.Reset();
+	}
+	if (CardBuild.IsValid())
+	{
+		CardBuild.Wait();
+		CardBuild.Reset();
+	}
+	// The LOD build only holds a weak reference to the mesh and waits on the render thread, let it finish on its own
+	LODBuild.Reset();
+	if (ProductStore)
+	{
+		for (FProductProperties* Product : ProductQuery)
+		{
+			ProductStore->UnpinProduct(Product->ProductID);
+		}
+	}
+	ProductQuery.Empty();
+	Super::EndPlay(EndPlayReason);
+}
+
 void ABladesmithController::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	if (ProductPipeline.IsValid())
+	{
+		ProductPipeline->Tick();
+	}
+
+	UpdateProductSceneRepresentation();
+
 	if (CurrentMode == ES_GameMode::Anvil)
 	{
 		PerformRaycastFromAnvilCamera();
@@ -189,30 +237,31 @@ void ABladesmithController::Tick(float DeltaTime)
 
 void ABladesmithController::TestController(APlayerController* PC)
 {
+	// The bindings below all work on the product on the anvil
+	if (ProductQuery.IsEmpty())
+	{
+		return;
+	}
 	if (PC->WasInputKeyJustPressed(EKeys::P))
 	{
 		LogWarning("P pressed");
-		USoterioMeshLib::RotateMesh(ProductQuery[0], 90, 'Y');
-		UpdateProduct();
+		EditProduct([](FProductProperties& Product) { USoterioMeshLib::RotateMesh(&Product, 90, 'Y'); });
 	}
 
 	if (PC->WasInputKeyJustPressed(EKeys::O))
 	{
-		USoterioMeshLib::RotateMesh(ProductQuery[0], 90, 'Z');
+		EditProduct([](FProductProperties& Product) { USoterioMeshLib::RotateMesh(&Product, 90, 'Z'); });
 		LogWarning("O Pressed");
-		UpdateProduct();
 	}
 
 	if (PC->WasInputKeyJustPressed(EKeys::I))
 	{
-		USoterioMeshLib::RotateMesh(ProductQuery[0], 90, 'X');
+		EditProduct([](FProductProperties& Product) { USoterioMeshLib::RotateMesh(&Product, 90, 'X'); });
 		LogWarning("I Pressed");
-		UpdateProduct();
 	}
 	if (PC->WasInputKeyJustPressed(EKeys::RightMouseButton))
 	{
-		USoterioMeshLib::AlignCenter(ProductQuery[0], true);
-		UpdateProduct();
+		EditProduct([](FProductProperties& Product) { USoterioMeshLib::AlignCenter(&Product, true); });
 		LogWarning("Align");
 	}
 	if (PC->WasInputKeyJustPressed(EKeys::U))
@@ -223,9 +272,12 @@ void ABladesmithController::TestController(APlayerController* PC)
 
 	if (PC->WasInputKeyJustPressed(EKeys::Y))
 	{
-		USoterioMeshLib::CalculateSmoothNormals(ProductQuery[0], 10);
+		EditProduct([](FProductProperties& Product)
+		{
+			USoterioMeshLib::CalculateSmoothNormals(&Product, 10);
+			USoterioMeshLib::MarkAllDirty(Product, EProductDirtyFlags::Position);
+		}, 0, false);
 		LogWarning("Y Pressed");
-		UpdateProduct();
 	}
 
 	if (PC->WasInputKeyJustPressed(EKeys::SpaceBar))
@@ -237,8 +289,17 @@ void ABladesmithController::TestController(APlayerController* PC)
 	{
 		if (CurrentMode == ES_GameMode::Anvil)
 		{
-			USoterioMeshLib::ModifyMesh(*ProductQuery[0], *CurrentHammer, PerformRaycastFromAnvilCamera());
-			UpdateProduct(DefaultSmoothRate);
+			// Resolve the hit against the component here, the strike itself may run off the game thread
+			FHitResult Hit = PerformRaycastFromAnvilCamera();
+			if (Hit.bBlockingHit && Hit.Component.IsValid())
+			{
+				const FVector3f Local = FVector3f(Hit.Component->GetComponentTransform().InverseTransformPosition(Hit.Location));
+				const FVector3f ImpactNormal = FVector3f(Hit.ImpactNormal);
+				EditProduct([Hammer = *CurrentHammer, Local, ImpactNormal](FProductProperties& Product)
+				{
+					USoterioMeshLib::ModifyMesh(Product, Hammer, Local, ImpactNormal);
+				}, DefaultSmoothRate);
+			}
 		}
 		if (CurrentMode == ES_GameMode::Forge)
 		{
@@ -256,17 +317,30 @@ void ABladesmithController::TestController(APlayerController* PC)
 	{
 
 	}
-	if (PC->WasInputKeyJustPressed(EKeys::B))
+	if (PC->WasInputKeyJustPressed(EKeys::B) && ProductStore)
 	{
+		if (ProductPipeline.IsValid())
+		{
+			ProductPipeline->Flush();
+		}
 		FString SavePath = FPaths::ProjectSavedDir() + GameProgress.SaveName.ToString();
-		USoterioMeshLib::SaveMeshProperties(*ProductQuery[0], SavePath);
+		ProductStore->SaveAll();
+		ProductStore->GetProductIDs(GameProgress.GameProperties.Products);
 		SaveGameProgress();
 		UE_LOG(LogBladesmithController, Warning, TEXT("Saving game to %s"), *SavePath);
 	}
-	if (PC->WasInputKeyJustPressed(EKeys::V))
+	if (PC->WasInputKeyJustPressed(EKeys::V) && ProductStore)
 	{
+		if (ProductPipeline.IsValid())
+		{
+			ProductPipeline->Flush();
+		}
 		FString SavePath = FPaths::ProjectSavedDir() + GameProgress.SaveName.ToString();
-		USoterioMeshLib::LoadMeshProperties(*ProductQuery[0], SavePath);
+		if (ProductStore->ReloadProduct(ProductQuery[0]->ProductID))
+		{
+			MarkProductReshaped();
+			UpdateProduct();
+		}
 		LoadGameProgress(SavePath);
 		UE_LOG(LogBladesmithController, Warning, TEXT("Load from %s"), *SavePath);
 	}
@@ -461,15 +535,16 @@ void ABladesmithController::InitHammerList()
 
 void ABladesmithController::TimePasses()
 {
-	if (CurrentMode == ES_GameMode::Forge)
-	{
-		USoterioMeshLib::UpdateHeat(*ProductQuery[0], FurnaceHeat);
-	}
-	else
+	// Heat flows through the product every tick, it only loses heat to the air outside the forge.
+	// Thermal expansion is too small to rebuild the distance field, cards and LODs for, the next strike catches up on it
+	EditProduct([bInForge = CurrentMode == ES_GameMode::Forge, Heat = FurnaceHeat, Solver = HeatSolver, DeltaTime = TimePassesInterval](FProductProperties& Product)
 	{
-	USoterioMeshLib::DecreaseHeat(*ProductQuery[0]);
-	}
-	UpdateProduct(DefaultSmoothRate);
+		if (bInForge)
+		{
+			USoterioMeshLib::UpdateHeat(Product, Heat);
+		}
+		USoterioMeshLib::DiffuseHeat(Product, Solver, DeltaTime, !bInForge);
+	}, DefaultSmoothRate, false);
 
 	if (GameProgress.Date.TimeOfDay <= 300)
 	{
@@ -483,18 +558,22 @@ void ABladesmithController::TimePasses()
 
 void ABladesmithController::CreateOreInstance()
 {
-	FProductProperties* NewProduct = new FProductProperties();
-
-	if (BaseStaticMesh)
+	if (!BaseStaticMesh)
 	{
-		USoterioMeshLib::ExtractMeshData(BaseStaticMesh, *NewProduct, true);
-		ProductQuery.Add(NewProduct);
+		UE_LOG(LogBladesmithController, Error, TEXT("BaseStaticMesh is not set!"));
+		return;
 	}
-	else
+	if (!ProductStore)
 	{
-		UE_LOG(LogBladesmithController, Error, TEXT("BaseStaticMesh is not set!"));
+		UE_LOG(LogBladesmithController, Error, TEXT("ProductStore is not available!"));
 		return;
 	}
+
+	FProductProperties ExtractedProduct;
+	USoterioMeshLib::ExtractMeshData(BaseStaticMesh, ExtractedProduct, true);
+	FProductProperties* NewProduct = ProductStore->AddProduct(MoveTemp(ExtractedProduct));
+	ProductStore->PinProduct(NewProduct->ProductID);
+	ProductQuery.Add(NewProduct);
 	UE_LOG(LogBladesmithController, Log, TEXT("%s GUID Created"), *NewProduct->ProductID.ToString());
 
 	ProductComponent->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
@@ -505,48 +584,22 @@ void ABladesmithController::CreateOreInstance()
 	ProductComponent->SetCollisionResponseToAllChannels(ECR_Block);
 
 	URealtimeMeshSimple* RealtimeMesh = ProductComponent->InitializeRealtimeMesh<URealtimeMeshSimple>();
+	// The product is reshaped on every strike, trace it through a refit BVH instead of recooking its trimesh
+	RealtimeMesh->SetUseDeformableCollision(true);
+	// Timed updates and input events can both rebuild the product within a frame, only the last one needs uploading
+	RealtimeMesh->SetCoalesceProxyUpdates(true);
 
-	FRealtimeMeshStreamSet StreamSet;
-
-	TRealtimeMeshBuilderLocal<uint16, FPackedNormal, FVector2DHalf, 1> Builder(StreamSet);
-
-	Builder.EnableTangents();
-	Builder.EnableTexCoords();
-	Builder.EnableColors();
-	Builder.EnablePolyGroups();
+	// A new product gets a new volume layout
+	DistanceFieldGenerator.Reset();
+	bSceneRepresentationStale = true;
 
-
-	for (int i = 0; i + 2 < NewProduct->Triangles.Num(); i += 3)
-	{
-		int Index0 = NewProduct->Triangles[i];
-		int Index1 = NewProduct->Triangles[i + 1];
-		int Index2 = NewProduct->Triangles[i + 2];
-
-		int V0 = Builder.AddVertex(NewProduct->Vertices[Index0])
-			.SetNormal(NewProduct->Normals[Index0])
-			.SetTexCoord(NewProduct->UVs[Index0])
-			.SetTangent(NewProduct->Tangents[Index0])
-			.SetColor(USoterioMeshLib::GenerateVertexColor(NewProduct->VertexHeat[Index0]));
-
-		int V1 = Builder.AddVertex(NewProduct->Vertices[Index1])
-			.SetNormal(NewProduct->Normals[Index1])
-			.SetTexCoord(NewProduct->UVs[Index1])
-			.SetTangent(NewProduct->Tangents[Index1])
-			.SetColor(USoterioMeshLib::GenerateVertexColor(NewProduct->VertexHeat[Index1]));
-
-		int V2 = Builder.AddVertex(NewProduct->Vertices[Index2])
-			.SetNormal(NewProduct->Normals[Index2])
-			.SetTexCoord(NewProduct->UVs[Index2])
-			.SetTangent(NewProduct->Tangents[Index2])
-			.SetColor(USoterioMeshLib::GenerateVertexColor(NewProduct->VertexHeat[Index2]));
-
-		Builder.AddTriangle(V0, V1, V2, 0);
-	}
+	FRealtimeMeshStreamSet StreamSet;
+	USoterioMeshLib::BuildProductStreams(*NewProduct, StreamSet);
 
 	//RealtimeMesh->SetupMaterialSlot(0, "PrimaryMaterial");
 
-	USoterioMeshLib::GenerateSpline(*ProductQuery[0], *ProductComponent);
-	ProductQuery[0]->Spline->UpdateSpline();
+	USoterioMeshLib::GenerateSpline(*NewProduct, *ProductComponent);
+	NewProduct->Spline->UpdateSpline();
 
 	const FRealtimeMeshSectionGroupKey GroupKey = FRealtimeMeshSectionGroupKey::Create(0, FName("TestTriangle"));
 	const FRealtimeMeshSectionKey PolyGroup0SectionKey = FRealtimeMeshSectionKey::CreateForPolyGroup(GroupKey, 0);
@@ -554,6 +607,9 @@ void ABladesmithController::CreateOreInstance()
 	RealtimeMesh->CreateSectionGroup(GroupKey, StreamSet);
 	RealtimeMesh->UpdateSectionConfig(PolyGroup0SectionKey, FRealtimeMeshSectionConfig(0), true);
 
+	// The mesh now holds the extracted topology, later edits are written into it in place
+	USoterioMeshLib::BuildCornerLookup(*NewProduct);
+	USoterioMeshLib::ClearDirty(*NewProduct);
 }
 
 void ABladesmithController::HeatUpForge()
@@ -566,70 +622,172 @@ void ABladesmithController::SwitchDefaultMode()
 	SwitchGameMode(FHitResult());
 }
 
-void ABladesmithController::UpdateProduct(int CalculateNormalDepth)
+void ABladesmithController::EditProduct(FProductMeshPipeline::FProductJob&& Edit, int CalculateNormalsDepth, bool bReshapes)
 {
-	URealtimeMeshSimple* RealtimeMesh = Cast<URealtimeMeshSimple>(ProductComponent->GetRealtimeMesh());
-	if (!RealtimeMesh)
+	if (ProductQuery.IsEmpty())
 	{
-		UE_LOG(LogBladesmithController, Error, TEXT("RealtimeMesh is not valid!"));
 		return;
 	}
+	if (bReshapes)
+	{
+		MarkProductReshaped();
+	}
+	if (ProductStore)
+	{
+		ProductStore->MarkProductChanged(ProductQuery[0]->ProductID);
+	}
+	if (ProductPipeline.IsValid())
+	{
+		ProductPipeline->Enqueue(MoveTemp(Edit));
+		return;
+	}
+	Edit(*ProductQuery[0]);
+	UpdateProduct(CalculateNormalsDepth);
+}
 
-	FProductProperties EditableMeshData = *ProductQuery[0];
+void ABladesmithController::OnProductSwapped(FProductProperties& Product, EProductDirtyFlags DirtyFlags)
+{
+	if (EnumHasAnyFlags(DirtyFlags, EProductDirtyFlags::Position | EProductDirtyFlags::Topology))
+	{
+		USoterioMeshLib::GenerateSpline(Product, *ProductComponent);
+		Product.Spline->UpdateSpline();
+	}
+}
 
-	FRealtimeMeshStreamSet StreamSet;
-	TRealtimeMeshBuilderLocal<uint16, FPackedNormal, FVector2DHalf, 1> Builder(StreamSet);
+void ABladesmithController::MarkProductReshaped()
+{
+	bSceneRepresentationStale = true;
+	LastReshapeTime = GetWorld()->GetTimeSeconds();
+}
 
-	Builder.EnableTangents();
-	Builder.EnableTexCoords();
-	Builder.EnableColors();
-	Builder.EnablePolyGroups();
-	Builder.EnableColors();
-	ProductComponent->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
-	ProductComponent->SetCollisionObjectType(ECC_Camera);
-	ProductComponent->SetCollisionResponseToAllChannels(ECR_Block);
+void ABladesmithController::UpdateProductSceneRepresentation()
+{
+	URealtimeMeshSimple* RealtimeMesh = Cast<URealtimeMeshSimple>(ProductComponent->GetRealtimeMesh());
 
-	if (CalculateNormalDepth)
+	if (DistanceFieldBuild.IsValid() && DistanceFieldBuild.IsReady())
 	{
-		USoterioMeshLib::CalculateSmoothNormals(&EditableMeshData, CalculateNormalDepth);
+		TOptional<FRealtimeMeshDistanceField> DistanceField = DistanceFieldBuild.Consume();
+		if (DistanceField.IsSet() && RealtimeMesh)
+		{
+			RealtimeMesh->SetDistanceField(MoveTemp(DistanceField.GetValue()));
+		}
 	}
 
-	for (int i = 0; i + 2 < EditableMeshData.Triangles.Num(); i += 3)
+	if (CardBuild.IsValid() && CardBuild.IsReady())
 	{
-		int Index0 = EditableMeshData.Triangles[i];
-		int Index1 = EditableMeshData.Triangles[i + 1];
-		int Index2 = EditableMeshData.Triangles[i + 2];
+		TOptional<FRealtimeMeshCardRepresentation> Cards = CardBuild.Consume();
+		if (Cards.IsSet() && RealtimeMesh)
+		{
+			RealtimeMesh->SetCardRepresentation(MoveTemp(Cards.GetValue()));
+		}
+	}
 
-		int V0 = Builder.AddVertex(EditableMeshData.Vertices[Index0])
-			.SetNormal(EditableMeshData.Normals[Index0])
-			.SetTexCoord(EditableMeshData.UVs[Index0])
-			.SetTangent(EditableMeshData.Tangents[Index0])
-			.SetColor(USoterioMeshLib::GenerateVertexColor(EditableMeshData.VertexHeat[Index0]));
+	// The LODs are committed to the mesh by the build itself
+	if (LODBuild.IsValid() && LODBuild.IsReady())
+	{
+		LODBuild.Reset();
+	}
+
+	// Strikes that land while a build is running are picked up by the next one, a burst of strikes only rebuilds once it settled
+	if (DistanceFieldBuild.IsValid() || CardBuild.IsValid() || LODBuild.IsValid() || !bSceneRepresentationStale || ProductQuery.IsEmpty() ||
+		GetWorld()->GetTimeSeconds() - LastReshapeTime < SceneRepresentationSettleTime)
+	{
+		return;
+	}
+	bSceneRepresentationStale = false;
 
-		int V1 = Builder.AddVertex(EditableMeshData.Vertices[Index1])
-			.SetNormal(EditableMeshData.Normals[Index1])
-			.SetTexCoord(EditableMeshData.UVs[Index1])
-			.SetTangent(EditableMeshData.Tangents[Index1])
-			.SetColor(USoterioMeshLib::GenerateVertexColor(EditableMeshData.VertexHeat[Index1]));
+	// Later batches update the front product while the builds run, they work on copies of it
+	const FProductProperties& Product = *ProductQuery[0];
 
-		int V2 = Builder.AddVertex(EditableMeshData.Vertices[Index2])
-			.SetNormal(EditableMeshData.Normals[Index2])
-			.SetTexCoord(EditableMeshData.UVs[Index2])
-			.SetTangent(EditableMeshData.Tangents[Index2])
-			.SetColor(USoterioMeshLib::GenerateVertexColor(EditableMeshData.VertexHeat[Index2]));
+	if (bGenerateProductDistanceField)
+	{
+		if (!DistanceFieldGenerator.IsValid())
+		{
+			FRealtimeMeshDistanceFieldSettings Settings;
+			Settings.VoxelDensity = ProductDistanceFieldDensity;
+			// Room for the blade to be drawn out before the volume has to be laid out again
+			Settings.BoundsSlack = 0.25f;
+			DistanceFieldGenerator = MakeShared<FRealtimeMeshDistanceFieldGenerator>(Settings);
+		}
 
-		Builder.AddTriangle(V0, V1, V2, 0);  // Material index set to 0
+		DistanceFieldBuild = URealtimeMeshThreadingSubsystem::Get()->Launch(URealtimeMeshThreadingSubsystem::BackgroundPriority,
+			[Generator = DistanceFieldGenerator, Vertices = Product.Vertices, Triangles = Product.Triangles]() -> TOptional<FRealtimeMeshDistanceField>
+			{
+				FRealtimeMeshDistanceField DistanceField;
+				if (!Generator->Update(Vertices, Triangles, DistanceField))
+				{
+					return TOptional<FRealtimeMeshDistanceField>();
+				}
+				return TOptional<FRealtimeMeshDistanceField>(MoveTemp(DistanceField));
+			});
 	}
 
-	USoterioMeshLib::GenerateSpline(*ProductQuery[0], *ProductComponent);
-	ProductQuery[0]->Spline->UpdateSpline();
+	if (bGenerateProductCards)
+	{
+		CardBuild = FRealtimeMeshCardRepresentationGenerator().BuildAsync(CopyTemp(Product.Vertices), CopyTemp(Product.Triangles));
+	}
 
-	// Update the realtime mesh with the new builder data
+	if (bGenerateProductLODs && RealtimeMesh)
+	{
+		LODBuild = RealtimeMesh->GenerateLODs();
+	}
+}
+
+void ABladesmithController::UpdateProduct(int CalculateNormalDepth)
+{
+	// The synchronous path edits ProductQuery[0] directly, no batch may be working from it
+	if (ProductPipeline.IsValid())
+	{
+		ProductPipeline->Flush();
+	}
+
+	if (ProductQuery.IsEmpty())
+	{
+		return;
+	}
+
+	URealtimeMeshSimple* RealtimeMesh = Cast<URealtimeMeshSimple>(ProductComponent->GetRealtimeMesh());
+	if (!RealtimeMesh)
+	{
+		UE_LOG(LogBladesmithController, Error, TEXT("RealtimeMesh is not valid!"));
+		return;
+	}
+
+	FProductProperties& Product = *ProductQuery[0];
 	const FRealtimeMeshSectionGroupKey GroupKey = FRealtimeMeshSectionGroupKey::Create(0, FName("TestTriangle"));
 	const FRealtimeMeshSectionKey PolyGroup0SectionKey = FRealtimeMeshSectionKey::CreateForPolyGroup(GroupKey, 0);
 
+	const bool bGeometryChanged = EnumHasAnyFlags(Product.DirtyFlags, EProductDirtyFlags::Position | EProductDirtyFlags::Topology);
+	if (bGeometryChanged)
+	{
+		USoterioMeshLib::GenerateSpline(Product, *ProductComponent);
+		Product.Spline->UpdateSpline();
+	}
+
+	// Only the dirty vertices go to the GPU as long as the topology is unchanged
+	if (USoterioMeshLib::UpdateProductInPlace(RealtimeMesh, GroupKey, Product, CalculateNormalDepth).IsValid())
+	{
+		return;
+	}
+
+	ProductComponent->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	ProductComponent->SetCollisionObjectType(ECC_Camera);
+	ProductComponent->SetCollisionResponseToAllChannels(ECR_Block);
+
+	if (CalculateNormalDepth)
+	{
+		USoterioMeshLib::CalculateSmoothNormals(&Product, CalculateNormalDepth);
+	}
+
+	FRealtimeMeshStreamSet StreamSet;
+	USoterioMeshLib::BuildProductStreams(Product, StreamSet);
+
+	// Update the realtime mesh with the new builder data
 	RealtimeMesh->CreateSectionGroup(GroupKey, StreamSet);
 	RealtimeMesh->UpdateSectionConfig(PolyGroup0SectionKey, FRealtimeMeshSectionConfig(0), true);
+
+	USoterioMeshLib::BuildCornerLookup(Product);
+	USoterioMeshLib::ClearDirty(Product);
 }
 
 FHitResult ABladesmithController::PerformRaycastFromAnvilCamera()
@@ -657,6 +815,30 @@ FHitResult ABladesmithController::PerformRaycastFromAnvilCamera()
 		CollisionParams
 	);
 
+	// The product has no cooked collision, trace its deformable collision in component space and keep the closer hit
+	URealtimeMeshSimple* RealtimeMesh = Cast<URealtimeMeshSimple>(ProductComponent->GetRealtimeMesh());
+	if (RealtimeMesh && RealtimeMesh->IsUsingDeformableCollision())
+	{
+		const FTransform& ComponentTransform = ProductComponent->GetComponentTransform();
+		const FVector3f LocalStart = FVector3f(ComponentTransform.InverseTransformPosition(StartLocation));
+		const FVector3f LocalEnd = FVector3f(ComponentTransform.InverseTransformPosition(EndLocation));
+
+		FRealtimeMeshCollisionBVHHit ProductHit;
+		if (RealtimeMesh->LineTraceDeformableCollision(LocalStart, LocalEnd, ProductHit) && (!bHit || ProductHit.Time < HitResult.Time))
+		{
+			const FVector Location = ComponentTransform.TransformPosition(FVector(ProductHit.Location));
+			const FVector Normal = ComponentTransform.TransformVectorNoScale(FVector(ProductHit.Normal));
+			HitResult = FHitResult(this, ProductComponent, Location, Normal);
+			HitResult.bBlockingHit = true;
+			HitResult.Time = ProductHit.Time;
+			HitResult.Distance = FVector::Dist(StartLocation, Location);
+			HitResult.TraceStart = StartLocation;
+			HitResult.TraceEnd = EndLocation;
+			HitResult.FaceIndex = ProductHit.Triangle;
+			bHit = true;
+		}
+	}
+
 	FColor LineColor = bHit ? FColor::Green : FColor::Red;
 	float LineLifetime = 1.0f; 
 	DrawDebugPoint(
@@ -6,6 +6,8 @@
 
 #include "Camera/CameraComponent.h"
 #include "SoterioMeshLib.h"
+#include "ProductMeshPipeline.h"
+#include "ProductStore.h"
 #include "EngineUtils.h"
 #include "Logging/LogMacros.h"
 #include "GameFramework/Actor.h"
@@ -17,6 +19,8 @@
 #include "../../Plugins/RealtimeMeshComponent/Source/RealtimeMeshComponent/Public/RealtimeMeshComponent.h"
 #include "../../Plugins/RealtimeMeshComponent/Source/RealtimeMeshComponent/Public/RealtimeMeshSimple.h"
 #include "../../Plugins/RealtimeMeshComponent/Source/RealtimeMeshComponent/Public/RealtimeMeshCollisionLibrary.h"
+#include "../../Plugins/RealtimeMeshComponent/Source/RealtimeMeshComponent/Public/Mesh/RealtimeMeshDistanceFieldGenerator.h"
+#include "../../Plugins/RealtimeMeshComponent/Source/RealtimeMeshComponent/Public/Mesh/RealtimeMeshCardRepresentationGenerator.h"
 
 #include "GameTypes.h"
 #include "S_Material.h"
@@ -73,7 +77,25 @@ private:
 
 	UMaterialInstanceDynamic* DynamicMaterial;
 
+	// Owned and pinned by the product store while they are on the anvil
 	TArray<FProductProperties*> ProductQuery;
+
+	UPROPERTY()
+	TObjectPtr<UProductStoreSubsystem> ProductStore;
+
+	TSharedPtr<FProductMeshPipeline> ProductPipeline;
+
+	// Kept across rebuilds so a strike only recomputes the bricks around the triangles it moved
+	TSharedPtr<FRealtimeMeshDistanceFieldGenerator> DistanceFieldGenerator;
+	TFuture<TOptional<FRealtimeMeshDistanceField>> DistanceFieldBuild;
+	TFuture<TOptional<FRealtimeMeshCardRepresentation>> CardBuild;
+	TFuture<ERealtimeMeshProxyUpdateStatus> LODBuild;
+	// Distance field, Lumen cards and LODs no longer match the product shape
+	bool bSceneRepresentationStale = false;
+	// World time of the last edit that changed the product shape
+	double LastReshapeTime = 0.0;
+
+	const float TimePassesInterval = 0.1f;
 public:
 	ABladesmithController();
 	
@@ -108,6 +130,33 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Anvil")
 	int DefaultSmoothRate = 1;
 
+	// Run hammer strikes and heat ticks on the RealtimeMesh thread pool instead of in Tick
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Anvil")
+	bool bAsyncProductUpdates = true;
+
+	// Rebuild the product distance field on the RealtimeMesh thread pool after it changes shape, for Lumen and distance field shadows
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Anvil")
+	bool bGenerateProductDistanceField = true;
+
+	// Distance field voxels per cm, products are much smaller than the meshes the engine default is tuned for
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Anvil")
+	float ProductDistanceFieldDensity = 1.0f;
+
+	// Rebuild the product Lumen cards after it changes shape, without them the product gets no Lumen GI
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Anvil")
+	bool bGenerateProductCards = true;
+
+	// Rebuild the product LOD chain after it changes shape, so a finished product seen from across the forge draws fewer triangles
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Anvil")
+	bool bGenerateProductLODs = true;
+
+	// Seconds without a strike before the distance field, cards and LODs are rebuilt, so a burst of strikes rebuilds once
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Anvil")
+	float SceneRepresentationSettleTime = 0.5f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Forge")
+	FHeatSolverSettings HeatSolver;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	UDataTable* HammerData;
 
@@ -138,6 +187,7 @@ private:
 	void Bindings();
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	UPROPERTY(VisibleAnywhere)
 	TObjectPtr<URealtimeMeshComponent> ProductComponent;
@@ -175,6 +225,11 @@ public:
 	void SwitchDefaultMode();
 
 	void UpdateProduct(int CalculateNormalsDepth = 0);
+	// bReshapes is false for edits that don't change the shape enough to rebuild the scene representation for
+	void EditProduct(FProductMeshPipeline::FProductJob&& Edit, int CalculateNormalsDepth = 0, bool bReshapes = true);
+	void MarkProductReshaped();
+	void OnProductSwapped(FProductProperties& Product, EProductDirtyFlags DirtyFlags);
+	void UpdateProductSceneRepresentation();
 	FHitResult PerformRaycastFromAnvilCamera();
 
 	void SaveGameProgress();
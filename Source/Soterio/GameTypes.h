@@ -90,6 +90,165 @@ struct FQuestProperties
     int32 Count;
 };
 
+UENUM(BlueprintType)
+enum class EHeatSolverMode : uint8
+{
+    Explicit UMETA(DisplayName = "Explicit (forward Euler)"),
+    Implicit UMETA(DisplayName = "Implicit (backward Euler, Jacobi)")
+};
+
+// Heat conduction over the product surface, see USoterioMeshLib::DiffuseHeat
+USTRUCT(BlueprintType)
+struct FHeatSolverSettings
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat")
+    EHeatSolverMode Mode = EHeatSolverMode::Explicit;
+
+    // Minimum substeps per tick, explicit mode adds more when the step would be unstable
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat", meta = (ClampMin = "1"))
+    int32 Substeps = 2;
+
+    // Explicit substeps beyond this switch the tick to the implicit solver
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat", meta = (ClampMin = "1"))
+    int32 MaxSubsteps = 16;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat", meta = (ClampMin = "1"))
+    int32 JacobiIterations = 8;
+
+    // Thermal diffusivity in cm^2/s
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat", meta = (ClampMin = "0"))
+    float Diffusivity = 0.5f;
+
+    // Newton cooling rate towards AmbientHeat, 1/s
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat", meta = (ClampMin = "0"))
+    float CoolingRate = 0.006f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Heat")
+    float AmbientHeat = 20.f;
+};
+
+// Parts of a product's render mesh that are stale since the last upload
+enum class EProductDirtyFlags : uint8
+{
+    None     = 0,
+    Position = 1 << 0,  // Vertices moved, normals and tangents follow them
+    Heat     = 1 << 1,  // VertexHeat changed, only colors follow
+    Topology = 1 << 2   // Triangles or vertex count changed, needs a full rebuild
+};
+ENUM_CLASS_FLAGS(EProductDirtyFlags);
+
+// Uniform hash grid over a product's vertices, answers hammer radius queries without a full scan
+struct FProductSpatialGrid
+{
+    float CellSize = 0.f;
+    // Per-axis scale applied to every vertex since the grid was built, cells stay in build-time space
+    FVector3f Scale = FVector3f::OneVector;
+    TMap<FIntVector, TArray<int32>> Cells;
+    TArray<FIntVector> VertexCells;
+
+    bool IsValid(int32 NumVertices) const
+    {
+        return CellSize > 0.f && VertexCells.Num() == NumVertices;
+    }
+
+    void Invalidate()
+    {
+        CellSize = 0.f;
+    }
+
+    FIntVector GetCell(const FVector3f& Position) const
+    {
+        return FIntVector(
+            FMath::FloorToInt32(Position.X / (CellSize * Scale.X)),
+            FMath::FloorToInt32(Position.Y / (CellSize * Scale.Y)),
+            FMath::FloorToInt32(Position.Z / (CellSize * Scale.Z)));
+    }
+
+    // Follows a scale of the whole mesh without re-bucketing, queries map into build-time space instead
+    void ApplyScale(const FVector3f& InScale)
+    {
+        Scale *= InScale;
+    }
+
+    void Build(const TArray<FVector3f>& Vertices, float InCellSize)
+    {
+        CellSize = InCellSize;
+        Scale = FVector3f::OneVector;
+        Cells.Reset();
+        VertexCells.SetNumUninitialized(Vertices.Num());
+        for (int32 i = 0; i < Vertices.Num(); i++)
+        {
+            VertexCells[i] = GetCell(Vertices[i]);
+            Cells.FindOrAdd(VertexCells[i]).Add(i);
+        }
+    }
+
+    // Re-buckets a single vertex after it moved, cheap when it stays in its cell
+    void MoveVertex(int32 VertexIndex, const FVector3f& NewPosition)
+    {
+        if (CellSize <= 0.f)
+        {
+            return;
+        }
+        const FIntVector NewCell = GetCell(NewPosition);
+        if (NewCell == VertexCells[VertexIndex])
+        {
+            return;
+        }
+        if (TArray<int32>* OldBucket = Cells.Find(VertexCells[VertexIndex]))
+        {
+            OldBucket->RemoveSwap(VertexIndex, EAllowShrinking::No);
+            if (OldBucket->IsEmpty())
+            {
+                Cells.Remove(VertexCells[VertexIndex]);
+            }
+        }
+        Cells.FindOrAdd(NewCell).Add(VertexIndex);
+        VertexCells[VertexIndex] = NewCell;
+    }
+
+    // Appends every vertex whose position lies within Radius of Center
+    void QueryRadius(const TArray<FVector3f>& Vertices, const FVector3f& Center, float Radius, TArray<int32>& OutVertices) const
+    {
+        const float RadiusSquared = Radius * Radius;
+        const FIntVector MinCell = GetCell(Center - FVector3f(Radius));
+        const FIntVector MaxCell = GetCell(Center + FVector3f(Radius));
+        for (int32 z = MinCell.Z; z <= MaxCell.Z; z++)
+        {
+            for (int32 y = MinCell.Y; y <= MaxCell.Y; y++)
+            {
+                for (int32 x = MinCell.X; x <= MaxCell.X; x++)
+                {
+                    const TArray<int32>* Bucket = Cells.Find(FIntVector(x, y, z));
+                    if (!Bucket)
+                    {
+                        continue;
+                    }
+                    for (int32 VertexIndex : *Bucket)
+                    {
+                        if (FVector3f::DistSquared(Vertices[VertexIndex], Center) < RadiusSquared)
+                        {
+                            OutVertices.Add(VertexIndex);
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
+// Buffers USoterioMeshLib::DiffuseHeat reuses from tick to tick, they keep their size as long as the adjacency does
+struct FProductHeatScratch
+{
+    TArray<float> Weights;
+    TArray<float> RowSums;
+    TArray<float> BlockMaxRowSum;
+    TArray<float> Buffer;
+    TArray<float> Jacobi;
+};
+
 struct FEMMaterial
 {
     float YoungModulus; // (E)
@@ -192,6 +351,27 @@ struct FProductProperties
     UPROPERTY()
     TObjectPtr<USplineComponent> Spline;
 
+    // Incremental mesh update bookkeeping, see USoterioMeshLib::MarkVertexDirty
+    EProductDirtyFlags DirtyFlags = EProductDirtyFlags::Topology;
+    // Moved vertices only, heat is tracked for the whole mesh by its flag
+    TBitArray<> DirtyVertices;
+
+    // Vertex -> triangle corner lookup (CSR), rebuilt by USoterioMeshLib::BuildCornerLookup
+    TArray<int32> CornerOffsets;
+    TArray<int32> Corners;
+
+    // Per-face normal and per-corner angle cache, see USoterioMeshLib::UpdateDirtyNormals
+    TArray<FVector3f> FaceNormals;
+    TArray<float> CornerAngles;
+
+    // Vertex -> neighbour vertices (CSR), rebuilt by USoterioMeshLib::BuildVertexAdjacency
+    TArray<int32> NeighbourOffsets;
+    TArray<int32> Neighbours;
+    FProductHeatScratch HeatScratch;
+
+    // Vertex lookup for hammer strikes, see USoterioMeshLib::QueryVerticesInRadius
+    FProductSpatialGrid SpatialGrid;
+
     FProductProperties() {}
 
     FProductProperties(
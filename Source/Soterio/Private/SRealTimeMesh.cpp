@@ -15,19 +15,18 @@ void USRealTimeMesh::Initialize(AActor* actor, UStaticMesh* Base, UMaterialInter
 	ProductComponent->SetupAttachment(actor->GetRootComponent());
 	ProductComponent->SetVisibility(true);
 
-	TArray<FProductProperties*> ProductQuery;
-	FProductProperties* NewProduct = new FProductProperties();
+	// Only used to build the preview mesh, nothing keeps it afterwards
+	FProductProperties NewProduct;
 	if (Base)
 	{
-		USoterioMeshLib::ExtractMeshData(Base, *NewProduct, true);
-		ProductQuery.Add(NewProduct);
+		USoterioMeshLib::ExtractMeshData(Base, NewProduct, true);
 	}
 	else return;
 	
-	Triangles1 = NewProduct->Triangles;
-	Normals = NewProduct->Normals;
-	UVs = NewProduct->UVs;
-	Tangents = NewProduct->Tangents;
+	Triangles1 = NewProduct.Triangles;
+	Normals = NewProduct.Normals;
+	UVs = NewProduct.UVs;
+	Tangents = NewProduct.Tangents;
 
 	ProductComponent->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
 	ProductComponent->SetMaterial(0, ProductMaterial);
@@ -39,44 +38,11 @@ void USRealTimeMesh::Initialize(AActor* actor, UStaticMesh* Base, UMaterialInter
 	URealtimeMeshSimple* RealtimeMesh = ProductComponent->InitializeRealtimeMesh<URealtimeMeshSimple>();
 
 	FRealtimeMeshStreamSet StreamSet;
-
-	TRealtimeMeshBuilderLocal<uint16, FPackedNormal, FVector2DHalf, 1> Builder(StreamSet);
-
-	Builder.EnableTangents();
-	Builder.EnableTexCoords();
-	Builder.EnableColors();
-	Builder.EnablePolyGroups();
-
-	for (int i = 0; i + 2 < Triangles1.Num(); i += 3)
-	{
-		int Index0 = Triangles1[i];
-		int Index1 = Triangles1[i + 1];
-		int Index2 = Triangles1[i + 2];
-		
-		int V0 = Builder.AddVertex(NewProduct->Vertices[Index0])
-			.SetNormal(NewProduct->Normals[Index0])
-			.SetTexCoord(NewProduct->UVs[Index0])
-			.SetTangent(NewProduct->Tangents[Index0])
-			.SetColor(USoterioMeshLib::GenerateVertexColor(NewProduct->VertexHeat[Index0]));
-
-		int V1 = Builder.AddVertex(NewProduct->Vertices[Index1])
-			.SetNormal(NewProduct->Normals[Index1])
-			.SetTexCoord(NewProduct->UVs[Index1])
-			.SetTangent(NewProduct->Tangents[Index1])
-			.SetColor(USoterioMeshLib::GenerateVertexColor(NewProduct->VertexHeat[Index1]));
-
-		int V2 = Builder.AddVertex(NewProduct->Vertices[Index2])
-			.SetNormal(NewProduct->Normals[Index2])
-			.SetTexCoord(NewProduct->UVs[Index2])
-			.SetTangent(NewProduct->Tangents[Index2])
-			.SetColor(USoterioMeshLib::GenerateVertexColor(NewProduct->VertexHeat[Index2]));
-
-		Builder.AddTriangle(V0, V1, V2, 0);
-	}
+	USoterioMeshLib::BuildProductStreams(NewProduct, StreamSet);
 
 	//RealtimeMesh->SetupMaterialSlot(0, "PrimaryMaterial");
-	USoterioMeshLib::GenerateSpline(*ProductQuery[0], *ProductComponent);
-	ProductQuery[0]->Spline->UpdateSpline();
+	USoterioMeshLib::GenerateSpline(NewProduct, *ProductComponent);
+	NewProduct.Spline->UpdateSpline();
 
 	const FRealtimeMeshSectionGroupKey GroupKey = FRealtimeMeshSectionGroupKey::Create(0, FName("TestTriangle"));
 	const FRealtimeMeshSectionKey PolyGroup0SectionKey = FRealtimeMeshSectionKey::CreateForPolyGroup(GroupKey, 0);
@@ -0,0 +1,359 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProductFile.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace SoterioProductFile
+{
+	struct FHeader
+	{
+		uint32 FileMagic = Magic;
+		uint16 Version = CurrentVersion;
+		uint16 Flags = 0;
+		FGuid ProductID;
+		int32 NumVertices = 0;
+		int32 NumIndices = 0;
+		int32 NumSplinePoints = 0;
+		FVector3f BoundsMin = FVector3f::ZeroVector;
+		FVector3f BoundsMax = FVector3f::ZeroVector;
+		int32 UncompressedSize = 0;
+		int32 CompressedSize = 0;
+
+		friend FArchive& operator<<(FArchive& Ar, FHeader& Header)
+		{
+			Ar << Header.FileMagic << Header.Version << Header.Flags << Header.ProductID;
+			Ar << Header.NumVertices << Header.NumIndices << Header.NumSplinePoints;
+			Ar << Header.BoundsMin << Header.BoundsMax;
+			Ar << Header.UncompressedSize << Header.CompressedSize;
+			return Ar;
+		}
+	};
+
+	static const FName CompressionFormat = NAME_LZ4;
+
+	static uint16 Quantise(float Value, float Min, float Scale)
+	{
+		return (uint16)FMath::Clamp(FMath::RoundToInt32((Value - Min) * Scale), 0, (int32)MAX_uint16);
+	}
+
+	static float Dequantise(uint16 Value, float Min, float InvScale)
+	{
+		return Min + Value * InvScale;
+	}
+
+	static int16 ToSnorm16(float Value)
+	{
+		return (int16)FMath::Clamp(FMath::RoundToInt32(Value * MAX_int16), -MAX_int16, (int32)MAX_int16);
+	}
+
+	// Octahedral mapping, unit vector to two snorm16
+	static void EncodeOctahedral(const FVector3f& Vector, int16& OutX, int16& OutY)
+	{
+		const float L1 = FMath::Abs(Vector.X) + FMath::Abs(Vector.Y) + FMath::Abs(Vector.Z);
+		if (L1 <= UE_SMALL_NUMBER)
+		{
+			OutX = OutY = 0;
+			return;
+		}
+		float X = Vector.X / L1;
+		float Y = Vector.Y / L1;
+		if (Vector.Z < 0.f)
+		{
+			const float FoldedX = (1.f - FMath::Abs(Y)) * (X >= 0.f ? 1.f : -1.f);
+			const float FoldedY = (1.f - FMath::Abs(X)) * (Y >= 0.f ? 1.f : -1.f);
+			X = FoldedX;
+			Y = FoldedY;
+		}
+		OutX = ToSnorm16(X);
+		OutY = ToSnorm16(Y);
+	}
+
+	static FVector3f DecodeOctahedral(int16 InX, int16 InY)
+	{
+		float X = InX / (float)MAX_int16;
+		float Y = InY / (float)MAX_int16;
+		const float Z = 1.f - FMath::Abs(X) - FMath::Abs(Y);
+		if (Z < 0.f)
+		{
+			const float UnfoldedX = (1.f - FMath::Abs(Y)) * (X >= 0.f ? 1.f : -1.f);
+			const float UnfoldedY = (1.f - FMath::Abs(X)) * (Y >= 0.f ? 1.f : -1.f);
+			X = UnfoldedX;
+			Y = UnfoldedY;
+		}
+		return FVector3f(X, Y, Z).GetSafeNormal();
+	}
+
+	static void WriteOctahedral(FArchive& Ar, const TArray<FVector3f>& Vectors, int32 NumVertices)
+	{
+		for (int32 i = 0; i < NumVertices; i++)
+		{
+			int16 X, Y;
+			EncodeOctahedral(Vectors.IsValidIndex(i) ? Vectors[i] : FVector3f::ZeroVector, X, Y);
+			Ar << X << Y;
+		}
+	}
+
+	static void ReadOctahedral(FArchive& Ar, TArray<FVector3f>& Vectors, int32 NumVertices)
+	{
+		Vectors.SetNumUninitialized(NumVertices);
+		for (int32 i = 0; i < NumVertices; i++)
+		{
+			int16 X, Y;
+			Ar << X << Y;
+			Vectors[i] = DecodeOctahedral(X, Y);
+		}
+	}
+
+	// Payload layout: positions (per axis deltas), normals, tangents, uvs, heat, indices (deltas), spline points
+	static void WritePayload(FArchive& Ar, const FProductProperties& Product, const FHeader& Header)
+	{
+		const int32 NumVertices = Header.NumVertices;
+		const FVector3f Extent = Header.BoundsMax - Header.BoundsMin;
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			const float Scale = Extent[Axis] > UE_SMALL_NUMBER ? MAX_uint16 / Extent[Axis] : 0.f;
+			uint16 Previous = 0;
+			for (int32 i = 0; i < NumVertices; i++)
+			{
+				const uint16 Value = Quantise(Product.Vertices[i][Axis], Header.BoundsMin[Axis], Scale);
+				uint16 Delta = Value - Previous;
+				Ar << Delta;
+				Previous = Value;
+			}
+		}
+
+		WriteOctahedral(Ar, Product.Normals, NumVertices);
+		WriteOctahedral(Ar, Product.Tangents, NumVertices);
+
+		for (int32 i = 0; i < NumVertices; i++)
+		{
+			FVector2f UV = Product.UVs.IsValidIndex(i) ? Product.UVs[i] : FVector2f::ZeroVector;
+			Ar << UV;
+		}
+		for (int32 i = 0; i < NumVertices; i++)
+		{
+			float Heat = Product.VertexHeat.IsValidIndex(i) ? Product.VertexHeat[i] : 0.f;
+			Ar << Heat;
+		}
+
+		int32 Previous = 0;
+		for (int32 i = 0; i < Header.NumIndices; i++)
+		{
+			int32 Delta = Product.Triangles[i] - Previous;
+			Ar << Delta;
+			Previous = Product.Triangles[i];
+		}
+
+		for (int32 i = 0; i < Header.NumSplinePoints; i++)
+		{
+			FVector Point = Product.SplinePoints[i];
+			Ar << Point;
+		}
+	}
+
+	// False if an index points outside the vertex array, the mesh code indexes with them unchecked
+	static bool ReadPayload(FArchive& Ar, FProductProperties& Product, const FHeader& Header)
+	{
+		const int32 NumVertices = Header.NumVertices;
+		const FVector3f Extent = Header.BoundsMax - Header.BoundsMin;
+		Product.Vertices.SetNumUninitialized(NumVertices);
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			const float InvScale = Extent[Axis] / MAX_uint16;
+			uint16 Value = 0;
+			for (int32 i = 0; i < NumVertices; i++)
+			{
+				uint16 Delta;
+				Ar << Delta;
+				Value += Delta;
+				Product.Vertices[i][Axis] = Dequantise(Value, Header.BoundsMin[Axis], InvScale);
+			}
+		}
+
+		ReadOctahedral(Ar, Product.Normals, NumVertices);
+		ReadOctahedral(Ar, Product.Tangents, NumVertices);
+
+		Product.UVs.SetNumUninitialized(NumVertices);
+		for (int32 i = 0; i < NumVertices; i++)
+		{
+			Ar << Product.UVs[i];
+		}
+		Product.VertexHeat.SetNumUninitialized(NumVertices);
+		for (int32 i = 0; i < NumVertices; i++)
+		{
+			Ar << Product.VertexHeat[i];
+		}
+
+		Product.Triangles.SetNumUninitialized(Header.NumIndices);
+		int64 Index = 0;
+		for (int32 i = 0; i < Header.NumIndices; i++)
+		{
+			int32 Delta;
+			Ar << Delta;
+			Index += Delta;
+			if (Index < 0 || Index >= NumVertices)
+			{
+				return false;
+			}
+			Product.Triangles[i] = (int32)Index;
+		}
+
+		Product.SplinePoints.SetNumUninitialized(Header.NumSplinePoints);
+		for (int32 i = 0; i < Header.NumSplinePoints; i++)
+		{
+			Ar << Product.SplinePoints[i];
+		}
+		return true;
+	}
+
+	// Every field has a fixed size, so the counts give the exact payload size
+	static int64 PayloadSize(const FHeader& Header)
+	{
+		const int64 PerVertex = 3 * sizeof(uint16) + 4 * sizeof(int16) + sizeof(FVector2f) + sizeof(float);
+		return Header.NumVertices * PerVertex + Header.NumIndices * (int64)sizeof(int32) + Header.NumSplinePoints * (int64)sizeof(FVector);
+	}
+
+	// LZ4 can't expand a block by more than this, a larger claim is a corrupt header asking for a huge allocation
+	constexpr int64 MaxCompressionRatio = 255;
+
+	bool IsProductFile(TConstArrayView<uint8> Bytes)
+	{
+		return Bytes.Num() >= (int32)sizeof(uint32) && FMemory::Memcmp(Bytes.GetData(), &Magic, sizeof(uint32)) == 0;
+	}
+
+	bool Write(const FProductProperties& Product, TArray<uint8>& OutBytes)
+	{
+		FHeader Header;
+		Header.ProductID = Product.ProductID;
+		Header.NumVertices = Product.Vertices.Num();
+		Header.NumIndices = Product.Triangles.Num();
+		Header.NumSplinePoints = Product.SplinePoints.Num();
+
+		const FBox3f Bounds(Product.Vertices);
+		if (Bounds.IsValid)
+		{
+			Header.BoundsMin = Bounds.Min;
+			Header.BoundsMax = Bounds.Max;
+		}
+
+		TArray<uint8> Payload;
+		FMemoryWriter PayloadWriter(Payload);
+		WritePayload(PayloadWriter, Product, Header);
+		Header.UncompressedSize = Payload.Num();
+
+		int32 CompressedSize = FCompression::CompressMemoryBound(CompressionFormat, Payload.Num());
+		TArray<uint8> Compressed;
+		Compressed.SetNumUninitialized(CompressedSize);
+		if (!FCompression::CompressMemory(CompressionFormat, Compressed.GetData(), CompressedSize, Payload.GetData(), Payload.Num()))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Compressing product %s failed"), *Product.ProductID.ToString());
+			return false;
+		}
+		Header.CompressedSize = CompressedSize;
+
+		OutBytes.Reset();
+		FMemoryWriter Writer(OutBytes);
+		Writer << Header;
+		Writer.Serialize(Compressed.GetData(), CompressedSize);
+		return !Writer.IsError();
+	}
+
+	bool Read(FProductProperties& Product, TConstArrayView<uint8> Bytes)
+	{
+		if (!IsProductFile(Bytes))
+		{
+			return false;
+		}
+
+		FMemoryReaderView Reader(Bytes);
+		FHeader Header;
+		Reader << Header;
+
+		if (Reader.IsError() || Header.Version > CurrentVersion)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Unsupported product file version %d"), Header.Version);
+			return false;
+		}
+		if (Header.NumVertices < 0 || Header.NumIndices < 0 || Header.NumIndices % 3 != 0 || Header.NumSplinePoints < 0 ||
+			Header.CompressedSize < 0 || Header.CompressedSize > Bytes.Num() - Reader.Tell() ||
+			Header.UncompressedSize != PayloadSize(Header) || (int64)Header.UncompressedSize > (int64)Header.CompressedSize * MaxCompressionRatio)
+		{
+			UE_LOG(LogTemp, Error, TEXT("Product file header is corrupt"));
+			return false;
+		}
+
+		// LZ4 blocks only decompress whole, so the payload needs a buffer of its own. The compressed bytes are read
+		// straight from Bytes, which is the mapped file when loading from disk
+		TArray<uint8> Payload;
+		Payload.SetNumUninitialized(Header.UncompressedSize);
+		if (!FCompression::UncompressMemory(CompressionFormat, Payload.GetData(), Payload.Num(), Bytes.GetData() + Reader.Tell(), Header.CompressedSize))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Product file payload is corrupt"));
+			return false;
+		}
+
+		// Decoded aside so a corrupt file leaves the product as it was
+		FProductProperties Decoded;
+		FMemoryReader PayloadReader(Payload);
+		if (!ReadPayload(PayloadReader, Decoded, Header) || PayloadReader.IsError())
+		{
+			UE_LOG(LogTemp, Error, TEXT("Product file payload is corrupt"));
+			return false;
+		}
+
+		Product.ProductID = Header.ProductID;
+		Product.Vertices = MoveTemp(Decoded.Vertices);
+		Product.Triangles = MoveTemp(Decoded.Triangles);
+		Product.Normals = MoveTemp(Decoded.Normals);
+		Product.UVs = MoveTemp(Decoded.UVs);
+		Product.Tangents = MoveTemp(Decoded.Tangents);
+		Product.VertexHeat = MoveTemp(Decoded.VertexHeat);
+		Product.SplinePoints = MoveTemp(Decoded.SplinePoints);
+		return true;
+	}
+
+	bool Save(const FProductProperties& Product, const FString& FilePath)
+	{
+		TArray<uint8> Bytes;
+		return Write(Product, Bytes) && FFileHelper::SaveArrayToFile(Bytes, *FilePath);
+	}
+
+	// Old saves are the raw FProductProperties::Serialize stream without a header
+	static bool ReadLegacy(FProductProperties& Product, TConstArrayView<uint8> Bytes)
+	{
+		FMemoryReaderView Reader(Bytes, true);
+		Product.Serialize(Reader);
+		return !Reader.IsError();
+	}
+
+	static bool ReadAny(FProductProperties& Product, TConstArrayView<uint8> Bytes)
+	{
+		return IsProductFile(Bytes) ? Read(Product, Bytes) : ReadLegacy(Product, Bytes);
+	}
+
+	bool Load(FProductProperties& Product, const FString& FilePath)
+	{
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		TUniquePtr<IMappedFileHandle> MappedFile(PlatformFile.OpenMapped(*FilePath));
+		if (MappedFile.IsValid() && MappedFile->GetFileSize() > 0)
+		{
+			TUniquePtr<IMappedFileRegion> Region(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+			if (Region.IsValid())
+			{
+				return ReadAny(Product, TConstArrayView<uint8>(Region->GetMappedPtr(), (int32)Region->GetMappedSize()));
+			}
+		}
+
+		TArray<uint8> Bytes;
+		if (!FFileHelper::LoadFileToArray(Bytes, *FilePath))
+		{
+			return false;
+		}
+		return ReadAny(Product, Bytes);
+	}
+}
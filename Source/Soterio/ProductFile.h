@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameTypes.h"
+
+/*
+Binary product file
+	Header followed by an LZ4 compressed payload. Positions are quantised to 16 bits inside the
+	product bounds and delta coded per axis, normals and tangents are 16 bit octahedral pairs,
+	triangle indices are delta coded. Files without the header are read as the old raw archive.
+*/
+namespace SoterioProductFile
+{
+	constexpr uint32 Magic = 0x44525053; // "SPRD"
+	constexpr uint16 CurrentVersion = 1;
+
+	SOTERIO_API bool IsProductFile(TConstArrayView<uint8> Bytes);
+
+	SOTERIO_API bool Write(const FProductProperties& Product, TArray<uint8>& OutBytes);
+	SOTERIO_API bool Read(FProductProperties& Product, TConstArrayView<uint8> Bytes);
+
+	SOTERIO_API bool Save(const FProductProperties& Product, const FString& FilePath);
+	// Maps the file instead of reading it into memory when the platform allows it, only the decompressed payload is buffered
+	SOTERIO_API bool Load(FProductProperties& Product, const FString& FilePath);
+}
@@ -0,0 +1,186 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProductMeshPipeline.h"
+#include "SoterioMeshLib.h"
+#include "Async/Async.h"
+
+#include "../../Plugins/RealtimeMeshComponent/Source/RealtimeMeshComponent/Public/RealtimeMeshThreadingSubsystem.h"
+
+// Brings the front product up to date with what a batch can have changed on the back copy
+static void CopyBatchChanges(FProductProperties& To, const FProductProperties& From, EProductDirtyFlags DirtyFlags)
+{
+	if (EnumHasAnyFlags(DirtyFlags, EProductDirtyFlags::Topology))
+	{
+		To = From;
+		return;
+	}
+	if (EnumHasAnyFlags(DirtyFlags, EProductDirtyFlags::Position))
+	{
+		To.Vertices = From.Vertices;
+		To.Normals = From.Normals;
+		To.Tangents = From.Tangents;
+		To.FaceNormals = From.FaceNormals;
+		To.CornerAngles = From.CornerAngles;
+		To.SplinePoints = From.SplinePoints;
+		To.Length = From.Length;
+		To.MaxLength = From.MaxLength;
+		To.bIsMaxLength = From.bIsMaxLength;
+		// Strikes query the back copy's grid, the front one is only rebuilt if something queries it directly
+		To.SpatialGrid.Invalidate();
+	}
+	if (EnumHasAnyFlags(DirtyFlags, EProductDirtyFlags::Heat))
+	{
+		To.VertexHeat = From.VertexHeat;
+	}
+}
+
+FProductMeshPipeline::FProductMeshPipeline(FProductProperties* InFront, URealtimeMeshSimple* InRealtimeMesh, const FRealtimeMeshSectionGroupKey& InGroupKey)
+	: Front(InFront)
+	, RealtimeMesh(InRealtimeMesh)
+	, GroupKey(InGroupKey)
+{
+	check(Front);
+}
+
+TFuture<ERealtimeMeshProxyUpdateStatus> FProductMeshPipeline::Enqueue(FProductJob&& Job)
+{
+	check(IsInGameThread());
+
+	TSharedRef<TPromise<ERealtimeMeshProxyUpdateStatus>> Promise = MakeShared<TPromise<ERealtimeMeshProxyUpdateStatus>>();
+	TFuture<ERealtimeMeshProxyUpdateStatus> Future = Promise->GetFuture();
+
+	PendingJobs.Add(MoveTemp(Job));
+	PendingPromises.Add(Promise);
+	Kick();
+
+	return Future;
+}
+
+void FProductMeshPipeline::Tick()
+{
+	check(IsInGameThread());
+
+	if (InFlightBatch.IsValid() && InFlightBatch.IsReady())
+	{
+		FinishBatch();
+	}
+	Kick();
+}
+
+void FProductMeshPipeline::Flush()
+{
+	check(IsInGameThread());
+
+	while (IsBusy())
+	{
+		if (InFlightBatch.IsValid())
+		{
+			InFlightBatch.Wait();
+		}
+		Tick();
+	}
+	bBackStale = true;
+}
+
+void FProductMeshPipeline::Kick()
+{
+	if (InFlightBatch.IsValid() || PendingJobs.Num() == 0)
+	{
+		return;
+	}
+
+	InFlightPromises = MoveTemp(PendingPromises);
+	PendingPromises.Reset();
+
+	const bool bResync = bBackStale;
+	bBackStale = false;
+
+	// Front is only read on the game thread while the batch runs, so copying it from the worker is safe.
+	// The player is waiting on strikes, they go ahead of queued distance field and LOD builds
+	InFlightBatch = URealtimeMeshThreadingSubsystem::Get()->Launch(URealtimeMeshThreadingSubsystem::InteractivePriority,
+		[Self = AsShared(), Jobs = MoveTemp(PendingJobs), bResync]() mutable
+		{
+			FProductProperties& Back = Self->Back;
+			if (bResync)
+			{
+				Back = *Self->Front;
+			}
+			for (FProductJob& Job : Jobs)
+			{
+				Job(Back);
+			}
+
+			// Back stays dirty, FinishBatch uploads the dirty vertices and clears it
+			FBatchResult Result;
+			Result.DirtyFlags = Back.DirtyFlags;
+			if (Result.DirtyFlags == EProductDirtyFlags::Heat)
+			{
+				// Cooling ticks only recolor, the geometry streams and collision are left as they are
+				USoterioMeshLib::BuildProductColorStream(Back, Result.Colors);
+			}
+			else if (EnumHasAnyFlags(Result.DirtyFlags, EProductDirtyFlags::Position | EProductDirtyFlags::Topology))
+			{
+				USoterioMeshLib::UpdateDirtyNormals(Back);
+				if (EnumHasAnyFlags(Result.DirtyFlags, EProductDirtyFlags::Topology))
+				{
+					USoterioMeshLib::BuildProductStreams(Back, Result.Streams);
+				}
+			}
+			return Result;
+		});
+	PendingJobs.Reset();
+}
+
+void FProductMeshPipeline::FinishBatch()
+{
+	FBatchResult Result = InFlightBatch.Consume();
+	TArray<TSharedRef<TPromise<ERealtimeMeshProxyUpdateStatus>>> Promises = MoveTemp(InFlightPromises);
+
+	URealtimeMeshSimple* Mesh = RealtimeMesh.Get();
+	if (Mesh)
+	{
+		TFuture<ERealtimeMeshProxyUpdateStatus> Update;
+		if (Result.DirtyFlags == EProductDirtyFlags::Heat)
+		{
+			Update = USoterioMeshLib::UpdateProductColors(Mesh, GroupKey, Result.Colors);
+		}
+		else if (!EnumHasAnyFlags(Result.DirtyFlags, EProductDirtyFlags::Topology))
+		{
+			// Strikes and forge ticks only write the dirty vertex range, normals were already updated on the worker
+			Update = USoterioMeshLib::UpdateProductInPlace(Mesh, GroupKey, Back, 0);
+		}
+		if (!Update.IsValid())
+		{
+			// Topology changed, or the mesh doesn't hold this product's streams yet, upload all of them
+			if (Result.Streams.IsEmpty())
+			{
+				USoterioMeshLib::BuildProductStreams(Back, Result.Streams);
+			}
+			Update = Mesh->UpdateSectionGroup(GroupKey, MoveTemp(Result.Streams));
+		}
+
+		Update.Then([Promises = MoveTemp(Promises)](TFuture<ERealtimeMeshProxyUpdateStatus>&& Status)
+			{
+				const ERealtimeMeshProxyUpdateStatus FinalStatus = Status.Get();
+				for (const TSharedRef<TPromise<ERealtimeMeshProxyUpdateStatus>>& Promise : Promises)
+				{
+					Promise->SetValue(FinalStatus);
+				}
+			});
+	}
+	else
+	{
+		for (const TSharedRef<TPromise<ERealtimeMeshProxyUpdateStatus>>& Promise : Promises)
+		{
+			Promise->SetValue(ERealtimeMeshProxyUpdateStatus::NoProxy);
+		}
+	}
+
+	USoterioMeshLib::ClearDirty(Back);
+	CopyBatchChanges(*Front, Back, Result.DirtyFlags);
+
+	if (OnProductSwapped)
+	{
+		OnProductSwapped(*Front, Result.DirtyFlags);
+	}
+}
@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameTypes.h"
+
+#include "../../Plugins/RealtimeMeshComponent/Source/RealtimeMeshComponent/Public/RealtimeMeshSimple.h"
+
+/*
+Runs product edits and stream building on the RealtimeMesh thread pool.
+	The game thread keeps reading the front product while a back copy is edited. The back copy lives on between
+	batches, Tick only copies what a finished batch changed over to the front and writes the dirty vertex range
+	into the existing mesh streams. Jobs queued while a batch is running go into the next one.
+*/
+class SOTERIO_API FProductMeshPipeline : public TSharedFromThis<FProductMeshPipeline>
+{
+public:
+	using FProductJob = TFunction<void(FProductProperties&)>;
+
+	// Called on the game thread once a batch reached the front product, with the dirty flags the batch produced
+	TFunction<void(FProductProperties&, EProductDirtyFlags)> OnProductSwapped;
+
+	FProductMeshPipeline(FProductProperties* InFront, URealtimeMeshSimple* InRealtimeMesh, const FRealtimeMeshSectionGroupKey& InGroupKey);
+
+	// Game thread only. The future resolves once the upload containing this job finished
+	TFuture<ERealtimeMeshProxyUpdateStatus> Enqueue(FProductJob&& Job);
+
+	// Game thread, once per frame. Applies a finished batch and starts the next one
+	void Tick();
+
+	bool IsBusy() const { return InFlightBatch.IsValid() || PendingJobs.Num() > 0; }
+
+	// Blocks until every queued job is applied to the front product, needed before touching it directly.
+	// The back copy is refreshed from the front on the next batch, so direct edits are picked up
+	void Flush();
+
+private:
+	struct FBatchResult
+	{
+		// Only built for topology batches, the others are written into the mesh in place
+		FRealtimeMeshStreamSet Streams;
+		// Only built for heat only batches
+		FRealtimeMeshStream Colors;
+		EProductDirtyFlags DirtyFlags = EProductDirtyFlags::None;
+	};
+
+	void Kick();
+	void FinishBatch();
+
+	FProductProperties* Front;
+	FProductProperties Back;
+	// Back has to be copied from Front in full before the next batch
+	bool bBackStale = true;
+
+	TWeakObjectPtr<URealtimeMeshSimple> RealtimeMesh;
+	FRealtimeMeshSectionGroupKey GroupKey;
+
+	TArray<FProductJob> PendingJobs;
+	TArray<TSharedRef<TPromise<ERealtimeMeshProxyUpdateStatus>>> PendingPromises;
+
+	TFuture<FBatchResult> InFlightBatch;
+	TArray<TSharedRef<TPromise<ERealtimeMeshProxyUpdateStatus>>> InFlightPromises;
+};
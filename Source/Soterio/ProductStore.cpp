@@ -0,0 +1,389 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ProductStore.h"
+#include "SoterioMeshLib.h"
+#include "Engine/GameInstance.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace SoterioProductStore
+{
+	constexpr uint32 IndexMagic = 0x58444950; // "PIDX"
+	constexpr uint16 IndexVersion = 1;
+
+	// Heap memory behind a product's mesh arrays and caches
+	static int64 GetProductBytes(const FProductProperties& Product)
+	{
+		return Product.Vertices.GetAllocatedSize() + Product.Triangles.GetAllocatedSize() + Product.Normals.GetAllocatedSize() +
+			Product.UVs.GetAllocatedSize() + Product.Tangents.GetAllocatedSize() + Product.VertexHeat.GetAllocatedSize() +
+			Product.SplinePoints.GetAllocatedSize() + Product.DirtyVertices.GetAllocatedSize() +
+			Product.CornerOffsets.GetAllocatedSize() + Product.Corners.GetAllocatedSize() +
+			Product.FaceNormals.GetAllocatedSize() + Product.CornerAngles.GetAllocatedSize() +
+			Product.NeighbourOffsets.GetAllocatedSize() + Product.Neighbours.GetAllocatedSize() +
+			Product.SpatialGrid.Cells.GetAllocatedSize() + Product.SpatialGrid.VertexCells.GetAllocatedSize();
+	}
+}
+
+int32 UProductStoreSubsystem::FProductPool::Allocate()
+{
+	if (FreeSlots.IsEmpty())
+	{
+		const int32 FirstSlot = Chunks.Num() * ChunkSize;
+		Chunks.Add(MakeUnique<FProductProperties[]>(ChunkSize));
+		for (int32 Slot = FirstSlot + ChunkSize - 1; Slot >= FirstSlot; Slot--)
+		{
+			FreeSlots.Add(Slot);
+		}
+	}
+	return FreeSlots.Pop(EAllowShrinking::No);
+}
+
+void UProductStoreSubsystem::FProductPool::Free(int32 Slot)
+{
+	// Drops the mesh arrays, the slot itself is reused by the next product
+	(*this)[Slot] = FProductProperties();
+	FreeSlots.Add(Slot);
+}
+
+UProductStoreSubsystem* UProductStoreSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	const UGameInstance* GameInstance = World ? World->GetGameInstance() : nullptr;
+	return GameInstance ? GameInstance->GetSubsystem<UProductStoreSubsystem>() : nullptr;
+}
+
+void UProductStoreSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	ProductDir = FPaths::ProjectSavedDir() / TEXT("Products");
+	ReadIndex();
+}
+
+void UProductStoreSubsystem::Deinitialize()
+{
+	for (TPair<FGuid, FStoredProduct>& Pair : Products)
+	{
+		if (Pair.Value.Slot != INDEX_NONE)
+		{
+			Pool.Free(Pair.Value.Slot);
+		}
+	}
+	Products.Empty();
+	ResidentBytes = 0;
+	Super::Deinitialize();
+}
+
+FProductProperties* UProductStoreSubsystem::AddProduct(FProductProperties&& Product)
+{
+	if (!Product.ProductID.IsValid())
+	{
+		Product.ProductID = FGuid::NewGuid();
+	}
+	const FGuid ProductID = Product.ProductID;
+
+	FStoredProduct& Stored = Products.FindOrAdd(ProductID);
+	if (Stored.Slot == INDEX_NONE)
+	{
+		Stored.Slot = Pool.Allocate();
+	}
+	Stored.Index.ProductID = ProductID;
+	Stored.LastUsed = ++UseCounter;
+	Stored.bUnsaved = true;
+
+	FProductProperties& Slot = Pool[Stored.Slot];
+	Slot = MoveTemp(Product);
+
+	TrimToBudget(ProductID);
+	return &Slot;
+}
+
+FProductProperties* UProductStoreSubsystem::FindProduct(const FGuid& ProductID)
+{
+	FStoredProduct* Stored = Products.Find(ProductID);
+	if (!Stored)
+	{
+		return nullptr;
+	}
+	if (Stored->Slot == INDEX_NONE && !LoadIntoSlot(*Stored))
+	{
+		return nullptr;
+	}
+
+	Stored->LastUsed = ++UseCounter;
+
+	TrimToBudget(ProductID);
+	return &Pool[Stored->Slot];
+}
+
+void UProductStoreSubsystem::MarkProductChanged(const FGuid& ProductID)
+{
+	if (FStoredProduct* Stored = Products.Find(ProductID))
+	{
+		Stored->bUnsaved = true;
+	}
+}
+
+bool UProductStoreSubsystem::RemoveProduct(const FGuid& ProductID)
+{
+	FStoredProduct Stored;
+	if (!Products.RemoveAndCopyValue(ProductID, Stored))
+	{
+		return false;
+	}
+	ensureMsgf(Stored.PinCount == 0, TEXT("Removing pinned product %s"), *ProductID.ToString());
+
+	if (Stored.Slot != INDEX_NONE)
+	{
+		Pool.Free(Stored.Slot);
+	}
+	IFileManager::Get().Delete(*GetProductPath(ProductID), false, false, true);
+	bIndexDirty = true;
+	FlushIndex();
+	return true;
+}
+
+void UProductStoreSubsystem::PinProduct(const FGuid& ProductID)
+{
+	if (FStoredProduct* Stored = Products.Find(ProductID))
+	{
+		Stored->PinCount++;
+	}
+}
+
+void UProductStoreSubsystem::UnpinProduct(const FGuid& ProductID)
+{
+	if (FStoredProduct* Stored = Products.Find(ProductID))
+	{
+		check(Stored->PinCount > 0);
+		Stored->PinCount--;
+	}
+}
+
+bool UProductStoreSubsystem::SaveProduct(const FGuid& ProductID)
+{
+	const bool bSaved = WriteProduct(ProductID);
+	FlushIndex();
+	return bSaved;
+}
+
+bool UProductStoreSubsystem::WriteProduct(const FGuid& ProductID)
+{
+	FStoredProduct* Stored = Products.Find(ProductID);
+	if (!Stored || Stored->Slot == INDEX_NONE)
+	{
+		// Evicted products were written out when they left memory
+		return Stored != nullptr;
+	}
+
+	FProductProperties& Product = Pool[Stored->Slot];
+	if (!USoterioMeshLib::SaveMeshProperties(Product, GetProductPath(ProductID)))
+	{
+		return false;
+	}
+
+	Stored->Index.ProductName = Product.ProductName;
+	Stored->Index.Type = Product.Type;
+	Stored->Index.NumVertices = Product.Vertices.Num();
+	Stored->Index.NumTriangles = Product.Triangles.Num() / 3;
+	Stored->bUnsaved = false;
+	bIndexDirty = true;
+	return true;
+}
+
+void UProductStoreSubsystem::SaveAll()
+{
+	for (TPair<FGuid, FStoredProduct>& Pair : Products)
+	{
+		if (Pair.Value.bUnsaved)
+		{
+			WriteProduct(Pair.Key);
+		}
+	}
+	FlushIndex();
+}
+
+bool UProductStoreSubsystem::ReloadProduct(const FGuid& ProductID)
+{
+	FStoredProduct* Stored = Products.Find(ProductID);
+	if (!Stored)
+	{
+		return false;
+	}
+	if (Stored->Slot == INDEX_NONE)
+	{
+		return LoadIntoSlot(*Stored);
+	}
+
+	FProductProperties& Product = Pool[Stored->Slot];
+	if (!USoterioMeshLib::LoadMeshProperties(Product, GetProductPath(ProductID)))
+	{
+		return false;
+	}
+	Product.ProductName = Stored->Index.ProductName;
+	Product.Type = Stored->Index.Type;
+	Stored->bUnsaved = false;
+	return true;
+}
+
+void UProductStoreSubsystem::GetProductIDs(TArray<FGuid>& OutProductIDs) const
+{
+	Products.GenerateKeyArray(OutProductIDs);
+}
+
+const FProductIndexEntry* UProductStoreSubsystem::FindIndexEntry(const FGuid& ProductID) const
+{
+	const FStoredProduct* Stored = Products.Find(ProductID);
+	return Stored ? &Stored->Index : nullptr;
+}
+
+bool UProductStoreSubsystem::IsResident(const FGuid& ProductID) const
+{
+	const FStoredProduct* Stored = Products.Find(ProductID);
+	return Stored && Stored->Slot != INDEX_NONE;
+}
+
+void UProductStoreSubsystem::TrimToBudget(const FGuid& KeepProductID)
+{
+	// Products grow while they are worked on, so the resident size is measured rather than tracked
+	TArray<TPair<uint64, FGuid>, TInlineAllocator<32>> Candidates;
+	ResidentBytes = 0;
+	for (const TPair<FGuid, FStoredProduct>& Pair : Products)
+	{
+		if (Pair.Value.Slot == INDEX_NONE)
+		{
+			continue;
+		}
+		ResidentBytes += SoterioProductStore::GetProductBytes(Pool[Pair.Value.Slot]);
+		if (Pair.Value.PinCount == 0 && Pair.Key != KeepProductID)
+		{
+			Candidates.Emplace(Pair.Value.LastUsed, Pair.Key);
+		}
+	}
+
+	const int64 BudgetBytes = int64(MemoryBudgetMB) * 1024 * 1024;
+	if (ResidentBytes <= BudgetBytes)
+	{
+		return;
+	}
+
+	Candidates.Sort([](const TPair<uint64, FGuid>& A, const TPair<uint64, FGuid>& B) { return A.Key < B.Key; });
+	for (const TPair<uint64, FGuid>& Candidate : Candidates)
+	{
+		if (ResidentBytes <= BudgetBytes)
+		{
+			break;
+		}
+		FStoredProduct& Stored = Products[Candidate.Value];
+		const int64 ProductBytes = SoterioProductStore::GetProductBytes(Pool[Stored.Slot]);
+		if (Evict(Stored))
+		{
+			ResidentBytes -= ProductBytes;
+		}
+	}
+	FlushIndex();
+}
+
+FString UProductStoreSubsystem::GetProductPath(const FGuid& ProductID) const
+{
+	return ProductDir / ProductID.ToString() + TEXT(".product");
+}
+
+FString UProductStoreSubsystem::GetIndexPath() const
+{
+	return ProductDir / TEXT("Index.bin");
+}
+
+void UProductStoreSubsystem::ReadIndex()
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *GetIndexPath(), FILEREAD_Silent))
+	{
+		return;
+	}
+
+	FMemoryReader Reader(Bytes);
+	uint32 Magic = 0;
+	uint16 Version = 0;
+	TArray<FProductIndexEntry> Entries;
+	Reader << Magic << Version;
+	if (Magic != SoterioProductStore::IndexMagic || Version > SoterioProductStore::IndexVersion)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Product index %s is not readable"), *GetIndexPath());
+		return;
+	}
+	Reader << Entries;
+	if (Reader.IsError())
+	{
+		UE_LOG(LogTemp, Error, TEXT("Product index %s is corrupt"), *GetIndexPath());
+		return;
+	}
+
+	for (FProductIndexEntry& Entry : Entries)
+	{
+		FStoredProduct& Stored = Products.Add(Entry.ProductID);
+		Stored.Index = MoveTemp(Entry);
+	}
+}
+
+void UProductStoreSubsystem::FlushIndex()
+{
+	if (bIndexDirty)
+	{
+		WriteIndex();
+		bIndexDirty = false;
+	}
+}
+
+void UProductStoreSubsystem::WriteIndex() const
+{
+	TArray<FProductIndexEntry> Entries;
+	Entries.Reserve(Products.Num());
+	for (const TPair<FGuid, FStoredProduct>& Pair : Products)
+	{
+		Entries.Add(Pair.Value.Index);
+	}
+
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	uint32 Magic = SoterioProductStore::IndexMagic;
+	uint16 Version = SoterioProductStore::IndexVersion;
+	Writer << Magic << Version << Entries;
+
+	if (!FFileHelper::SaveArrayToFile(Bytes, *GetIndexPath()))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Unable to write product index %s"), *GetIndexPath());
+	}
+}
+
+bool UProductStoreSubsystem::LoadIntoSlot(FStoredProduct& Stored)
+{
+	const int32 Slot = Pool.Allocate();
+	FProductProperties& Product = Pool[Slot];
+	if (!USoterioMeshLib::LoadMeshProperties(Product, GetProductPath(Stored.Index.ProductID)))
+	{
+		Pool.Free(Slot);
+		return false;
+	}
+	Product.ProductName = Stored.Index.ProductName;
+	Product.Type = Stored.Index.Type;
+	Stored.Slot = Slot;
+	Stored.bUnsaved = false;
+	return true;
+}
+
+bool UProductStoreSubsystem::Evict(FStoredProduct& Stored)
+{
+	check(Stored.PinCount == 0 && Stored.Slot != INDEX_NONE);
+	if (Stored.bUnsaved && !WriteProduct(Stored.Index.ProductID))
+	{
+		// Keep it rather than lose the work, it gets another chance on the next trim
+		return false;
+	}
+	Pool.Free(Stored.Slot);
+	Stored.Slot = INDEX_NONE;
+	return true;
+}
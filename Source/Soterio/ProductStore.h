@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+
+#include "GameTypes.h"
+
+#include "ProductStore.generated.h"
+
+// What the inventory needs to know about a product without loading its mesh
+struct FProductIndexEntry
+{
+	FGuid ProductID;
+	FName ProductName;
+	ESwordType Type = ESwordType::None;
+	int32 NumVertices = 0;
+	int32 NumTriangles = 0;
+
+	friend FArchive& operator<<(FArchive& Ar, FProductIndexEntry& Entry)
+	{
+		Ar << Entry.ProductID << Entry.ProductName << Entry.Type << Entry.NumVertices << Entry.NumTriangles;
+		return Ar;
+	}
+};
+
+/*
+Owns every product of the game instance.
+	Products live in pooled slots whose addresses never move, mesh data is loaded from Saved/Products on
+	first use and dropped again for the least recently used products once the resident mesh data goes over
+	MemoryBudgetMB. Pinned products are never evicted, pin whatever is on the anvil or handed to a worker.
+	Pointers to unpinned products are only valid until the next FindProduct or AddProduct.
+*/
+UCLASS(Config = Game)
+class SOTERIO_API UProductStoreSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UProductStoreSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Takes ownership of the product, indexed by its ProductID
+	FProductProperties* AddProduct(FProductProperties&& Product);
+	// Loads the mesh data if it was evicted, nullptr for unknown ids
+	FProductProperties* FindProduct(const FGuid& ProductID);
+	// Products are only written back on save or eviction once they were marked changed
+	void MarkProductChanged(const FGuid& ProductID);
+	bool RemoveProduct(const FGuid& ProductID);
+
+	void PinProduct(const FGuid& ProductID);
+	void UnpinProduct(const FGuid& ProductID);
+
+	bool SaveProduct(const FGuid& ProductID);
+	void SaveAll();
+	// Re-reads a product from disk into its current slot, dropping unsaved changes
+	bool ReloadProduct(const FGuid& ProductID);
+
+	void GetProductIDs(TArray<FGuid>& OutProductIDs) const;
+	const FProductIndexEntry* FindIndexEntry(const FGuid& ProductID) const;
+	bool IsResident(const FGuid& ProductID) const;
+	int64 GetResidentBytes() const { return ResidentBytes; }
+
+	// Evicts least recently used, unpinned products until the resident mesh data fits the budget
+	void TrimToBudget(const FGuid& KeepProductID = FGuid());
+
+	UPROPERTY(Config, EditAnywhere, Category = "Products")
+	int32 MemoryBudgetMB = 256;
+
+private:
+	// Fixed size chunks so products never move when the pool grows
+	class FProductPool
+	{
+	public:
+		int32 Allocate();
+		void Free(int32 Slot);
+		FProductProperties& operator[](int32 Slot) { return Chunks[Slot / ChunkSize][Slot % ChunkSize]; }
+
+	private:
+		static constexpr int32 ChunkSize = 16;
+		TArray<TUniquePtr<FProductProperties[]>> Chunks;
+		TArray<int32> FreeSlots;
+	};
+
+	struct FStoredProduct
+	{
+		FProductIndexEntry Index;
+		int32 Slot = INDEX_NONE;
+		int32 PinCount = 0;
+		uint64 LastUsed = 0;
+		bool bUnsaved = false;
+	};
+
+	FString GetProductPath(const FGuid& ProductID) const;
+	FString GetIndexPath() const;
+	void ReadIndex();
+	void WriteIndex() const;
+	// Writes the index once for a batch of product writes
+	void FlushIndex();
+	// Writes the mesh data and updates its index entry, the index itself is written by FlushIndex
+	bool WriteProduct(const FGuid& ProductID);
+	bool LoadIntoSlot(FStoredProduct& Stored);
+	bool Evict(FStoredProduct& Stored);
+
+	FString ProductDir;
+	FProductPool Pool;
+	TMap<FGuid, FStoredProduct> Products;
+	uint64 UseCounter = 0;
+	int64 ResidentBytes = 0;
+	bool bIndexDirty = false;
+};
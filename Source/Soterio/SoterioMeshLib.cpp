@@ -5,13 +5,17 @@ Just remember:
 */
 
 #include "SoterioMeshLib.h"
-#include <Serialization/BufferArchive.h>
+#include "ProductFile.h"
 #include "Engine/StaticMesh.h"
 #include "MeshDescription.h"
 #include "StaticMeshAttributes.h"
 #include "AssetRegistry/AssetRegistryModule.h"
+#include "Async/ParallelFor.h"
+#include "Algo/Sort.h"
+#include "../../Plugins/RealtimeMeshComponent/Source/RealtimeMeshComponent/Public/Mesh/RealtimeMeshAlgo.h"
+#include "../../Plugins/RealtimeMeshComponent/Source/RealtimeMeshComponent/Public/Mesh/RealtimeMeshTangentGenerator.h"
 
-FORCEINLINE void USoterioMeshLib::CalculateNormals(FProductProperties* Product)
+void USoterioMeshLib::CalculateNormals(FProductProperties* Product)
 {
 	if (!Product)
 	{
@@ -63,31 +67,18 @@ void USoterioMeshLib::CalculateTangents(FProductProperties* Product)
 	if (!Product)
 	{
 		UE_LOG(LogTemp, Error, TEXT("Product is empty"));
+		return;
 	}
-	Product->Tangents.SetNumZeroed(Product->Vertices.Num());
 
-	for (int i = 0; i < Product->Triangles.Num(); i += 3)
+	if (Product->CornerOffsets.Num() != Product->Vertices.Num() + 1)
 	{
-		int32 Index0 = Product->Triangles[i];
-		int32 Index1 = Product->Triangles[i + 1];
-		int32 Index2 = Product->Triangles[i + 2];
-
-		FVector3f Vertex0 = Product->Vertices[Index0];
-		FVector3f Vertex1 = Product->Vertices[Index1];
-		FVector3f Vertex2 = Product->Vertices[Index2];
-
-		FVector3f Edge1 = Vertex1 - Vertex0;
-		FVector3f Edge2 = Vertex2 - Vertex0;
-
-		// Get the current face normal
-		FVector3f FaceNormal = Product->Normals[Index0];  // Assuming flat normals per triangle
-
-		// Calculate the tangent using the cross product with the face normal
-		FVector3f Tangent = FVector3f::CrossProduct(FaceNormal, Edge2).GetSafeNormal();
-		Product->Tangents[Index0] = Tangent;
-		Product->Tangents[Index1] = Tangent;
-		Product->Tangents[Index2] = Tangent;
+		BuildCornerLookup(*Product);
 	}
+	Product->Normals.SetNumZeroed(Product->Vertices.Num());
+	Product->Tangents.SetNumZeroed(Product->Vertices.Num());
+
+	FRealtimeMeshTangentGenerator(Product->Triangles, Product->CornerOffsets, Product->Corners)
+		.ComputeTangents(Product->Vertices, Product->Normals, Product->UVs, Product->Tangents);
 }
 
 void USoterioMeshLib::RotateMesh(FProductProperties* Product, float RotationDegree, char Axis)
@@ -154,6 +145,44 @@ void USoterioMeshLib::RotateMesh(FProductProperties* Product, float RotationDegr
 
 	USoterioMeshLib::CalculateSmoothNormals(Product, 5);
 	USoterioMeshLib::CalculateTangents(Product);
+	USoterioMeshLib::MarkAllDirty(*Product, EProductDirtyFlags::Position);
+}
+
+// Welds and reorders the extracted arrays for the GPU vertex cache. This has to happen here, after extraction product
+// and GPU vertices are kept 1:1 so in-place updates can address both with the same index
+static void OptimizeProductVertexOrder(FProductProperties& Product)
+{
+	const FRealtimeMeshStreamKey NormalsKey(ERealtimeMeshStreamType::Vertex, TEXT("ProductNormals"));
+	const FRealtimeMeshStreamKey TangentsKey(ERealtimeMeshStreamType::Vertex, TEXT("ProductTangents"));
+	const FRealtimeMeshStreamKey HeatKey(ERealtimeMeshStreamType::Vertex, TEXT("ProductHeat"));
+
+	FRealtimeMeshStreamSet Streams;
+	Streams.AddStream<FVector3f>(FRealtimeMeshStreams::Position).Append(Product.Vertices);
+	Streams.AddStream<FVector3f>(NormalsKey).Append(Product.Normals);
+	Streams.AddStream<FVector3f>(TangentsKey).Append(Product.Tangents);
+	Streams.AddStream<FVector2f>(FRealtimeMeshStreams::TexCoords).Append(Product.UVs);
+	Streams.AddStream<float>(HeatKey).Append(Product.VertexHeat);
+
+	FRealtimeMeshStream& Triangles = Streams.AddStream<TIndex3<int32>>(FRealtimeMeshStreams::Triangles);
+	Triangles.SetNumUninitialized(Product.Triangles.Num() / 3);
+	FMemory::Memcpy(Triangles.GetData(), Product.Triangles.GetData(), Triangles.Num() * Triangles.GetStride());
+
+	if (!RealtimeMeshAlgo::OptimizeStreamSet(Streams))
+	{
+		return;
+	}
+
+	Product.Vertices.Reset();
+	Product.Normals.Reset();
+	Product.Tangents.Reset();
+	Product.UVs.Reset();
+	Product.VertexHeat.Reset();
+	Streams.FindChecked(FRealtimeMeshStreams::Position).CopyTo(Product.Vertices);
+	Streams.FindChecked(NormalsKey).CopyTo(Product.Normals);
+	Streams.FindChecked(TangentsKey).CopyTo(Product.Tangents);
+	Streams.FindChecked(FRealtimeMeshStreams::TexCoords).CopyTo(Product.UVs);
+	Streams.FindChecked(HeatKey).CopyTo(Product.VertexHeat);
+	FMemory::Memcpy(Product.Triangles.GetData(), Triangles.GetData(), Triangles.Num() * Triangles.GetStride());
 }
 
 void USoterioMeshLib::ExtractMeshData(UStaticMesh* BaseMesh, FProductProperties& OutProductProperties, bool bConsoleDebug)
@@ -208,67 +237,102 @@ void USoterioMeshLib::ExtractMeshData(UStaticMesh* BaseMesh, FProductProperties&
 		OutProductProperties.Tangents.Add(Tangent);
 		OutProductProperties.UVs.Add(UV);
 	}
-	OutProductProperties.GenerateSplineData();
-}
 
-URealtimeMeshSimple* USoterioMeshLib::CreateOreInstance(UStaticMesh* BaseStaticMesh,
-	URealtimeMeshComponent* RealtimeMeshComponent, const FProductProperties& ProductProperties, UMaterialInterface* ProductMaterial, bool bConsoleDebug)
-{
-	if (!BaseStaticMesh || !RealtimeMeshComponent)
+	const int32 NumExtractedVertices = OutProductProperties.Vertices.Num();
+	OptimizeProductVertexOrder(OutProductProperties);
+	if (bConsoleDebug)
 	{
-		UE_LOG(LogTemp, Error, TEXT("BaseStaticMesh or RealtimeMeshComponent is not set!"));
-		return nullptr;
+		UE_LOG(LogTemp, Warning, TEXT("Optimized vertex order, welded %d duplicate vertices"), NumExtractedVertices - OutProductProperties.Vertices.Num());
 	}
 
-	URealtimeMeshSimple* RealtimeMesh = RealtimeMeshComponent->InitializeRealtimeMesh<URealtimeMeshSimple>();
-	if (!RealtimeMesh)
-	{
-		UE_LOG(LogTemp, Error, TEXT("Failed to initialize RealtimeMesh."));
-		return nullptr;
-	}
+	OutProductProperties.GenerateSplineData();
+	MarkAllDirty(OutProductProperties, EProductDirtyFlags::Topology);
+}
 
-	// Set up the stream set and builder
-	FRealtimeMeshStreamSet StreamSet;
-	TRealtimeMeshBuilderLocal<uint16, FPackedNormal, FVector2DHalf, 1> Builder(StreamSet);
+template<typename IndexType>
+static int32 FillProductStreams(const FProductProperties& Product, FRealtimeMeshStreamSet& StreamSet)
+{
+	TRealtimeMeshBuilderLocal<IndexType, FPackedNormal, FVector2DHalf, 1> Builder(StreamSet);
 
 	Builder.EnableTangents();
 	Builder.EnableTexCoords();
 	Builder.EnableColors();
 	Builder.EnablePolyGroups();
 
-	int debugIter = 0;
-	for (int i = 0; i + 2 < ProductProperties.Triangles.Num(); i += 3)
+	const int32 NumVertices = Product.Vertices.Num();
+	TArray<FColor> Colors;
+	Colors.SetNumUninitialized(NumVertices);
+	for (int32 i = 0; i < NumVertices; i++)
 	{
-		int Index0 = ProductProperties.Triangles[i];
-		int Index1 = ProductProperties.Triangles[i + 1];
-		int Index2 = ProductProperties.Triangles[i + 2];
+		Colors[i] = USoterioMeshLib::GenerateVertexColor(Product.VertexHeat[i]);
+	}
 
-		if (Index0 >= ProductProperties.Vertices.Num() ||
-			Index1 >= ProductProperties.Vertices.Num() ||
-			Index2 >= ProductProperties.Vertices.Num())
+	// One GPU vertex per product vertex, so GPU and product indices stay interchangeable
+	Builder.ReserveNumVertices(NumVertices);
+	Builder.AppendVertices(Product.Vertices, Product.Normals, Product.Tangents, Product.UVs, Colors);
+
+	const TConstArrayView<int32> Triangles = MakeArrayView(Product.Triangles.GetData(), Product.Triangles.Num() - Product.Triangles.Num() % 3);
+	TArray<int32> ValidTriangles;
+	bool bDroppedTriangles = false;
+	for (int32 i = 0; i < Triangles.Num(); i += 3)
+	{
+		int32 Index0 = Triangles[i];
+		int32 Index1 = Triangles[i + 1];
+		int32 Index2 = Triangles[i + 2];
+
+		if (Index0 >= NumVertices || Index1 >= NumVertices || Index2 >= NumVertices)
 		{
 			UE_LOG(LogTemp, Error, TEXT("Triangle index out of bounds! Indices: %d, %d, %d"), Index0, Index1, Index2);
+			// Only copy the index list when it has to drop triangles
+			if (!bDroppedTriangles)
+			{
+				ValidTriangles.Append(Triangles.GetData(), i);
+				bDroppedTriangles = true;
+			}
 			continue;
 		}
 
-		int V0 = Builder.AddVertex(ProductProperties.Vertices[Index0])
-			.SetNormal(ProductProperties.Normals[Index0])
-			.SetTexCoord(ProductProperties.UVs[Index0])
-			.SetTangent(ProductProperties.Tangents[Index0]);
+		if (bDroppedTriangles)
+		{
+			ValidTriangles.Append(&Triangles[i], 3);
+		}
+	}
 
-		int V1 = Builder.AddVertex(ProductProperties.Vertices[Index1])
-			.SetNormal(ProductProperties.Normals[Index1])
-			.SetTexCoord(ProductProperties.UVs[Index1])
-			.SetTangent(ProductProperties.Tangents[Index1]);
+	const TConstArrayView<int32> Indices = bDroppedTriangles ? TConstArrayView<int32>(ValidTriangles) : Triangles;
+	Builder.ReserveNumTriangles(Indices.Num() / 3);
+	Builder.AppendTriangles(Indices, 0);
+	return Indices.Num() / 3;
+}
 
-		int V2 = Builder.AddVertex(ProductProperties.Vertices[Index2])
-			.SetNormal(ProductProperties.Normals[Index2])
-			.SetTexCoord(ProductProperties.UVs[Index2])
-			.SetTangent(ProductProperties.Tangents[Index2]);
+int32 USoterioMeshLib::BuildProductStreams(const FProductProperties& Product, FRealtimeMeshStreamSet& StreamSet)
+{
+	// uint16 indices only address 65k vertices, bigger products need the wide index buffer
+	if (Product.Vertices.Num() > MAX_uint16)
+	{
+		return FillProductStreams<uint32>(Product, StreamSet);
+	}
+	return FillProductStreams<uint16>(Product, StreamSet);
+}
 
-		Builder.AddTriangle(V0, V1, V2, 0);
-		debugIter++;
+URealtimeMeshSimple* USoterioMeshLib::CreateOreInstance(UStaticMesh* BaseStaticMesh,
+	URealtimeMeshComponent* RealtimeMeshComponent, const FProductProperties& ProductProperties, UMaterialInterface* ProductMaterial, bool bConsoleDebug)
+{
+	if (!BaseStaticMesh || !RealtimeMeshComponent)
+	{
+		UE_LOG(LogTemp, Error, TEXT("BaseStaticMesh or RealtimeMeshComponent is not set!"));
+		return nullptr;
 	}
+
+	URealtimeMeshSimple* RealtimeMesh = RealtimeMeshComponent->InitializeRealtimeMesh<URealtimeMeshSimple>();
+	if (!RealtimeMesh)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to initialize RealtimeMesh."));
+		return nullptr;
+	}
+
+	// Set up the stream set and builder
+	FRealtimeMeshStreamSet StreamSet;
+	const int32 debugIter = USoterioMeshLib::BuildProductStreams(ProductProperties, StreamSet);
 	if (bConsoleDebug)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("Instanced Triangle count: %d"), debugIter);
@@ -289,11 +353,9 @@ URealtimeMeshSimple* USoterioMeshLib::CreateOreInstance(UStaticMesh* BaseStaticM
 	return RealtimeMesh;
 }
 
-inline static void FlatHammerShape(FProductProperties& ProductProperties, FHammerData& Hammer, FHitResult Hit, bool bDebug)
+inline static void FlatHammerShape(FProductProperties& ProductProperties, const FHammerData& Hammer, const FVector3f& Local, bool bDebug)
 {
-	FVector3f HitLocation = FVector3f(Hit.Location);
-
-	FVector3f Local = FVector3f(Hit.Component->GetComponentTransform().InverseTransformPosition(FVector(HitLocation)));
+	// The face presses the whole bar, every vertex moves so there is nothing for the spatial grid to narrow down
 	FVector3f ImpactNormal = FVector3f(0, 0, 1);
 	int i = 0;
 	float StressBound = ((ProductProperties.MaxLength - ProductProperties.Length) / ProductProperties.MaxLength);
@@ -310,33 +372,33 @@ inline static void FlatHammerShape(FProductProperties& ProductProperties, FHamme
 		}
 		i++;
 	}
+	USoterioMeshLib::MarkAllDirty(ProductProperties, EProductDirtyFlags::Position);
 }
 
-inline static void RoundHammerShape(FProductProperties& ProductProperties, FHammerData& Hammer, FHitResult Hit, bool bDebug)
+inline static void RoundHammerShape(FProductProperties& ProductProperties, const FHammerData& Hammer, const FVector3f& Local, const FVector3f& ImpactNormal, bool bDebug)
 {
-	FVector3f HitLocation = FVector3f(Hit.Location);
 	UE_LOG(LogTemp, Warning, TEXT("RoundHammer Called"));
-	FVector3f Local = FVector3f(Hit.Component->GetComponentTransform().InverseTransformPosition(FVector(HitLocation)));
-	FVector3f ImpactNormal = FVector3f(Hit.ImpactNormal);
 
 	const float InvMaxRadius = 1.0f / Hammer.MaxRadius;
-	const float MaxRadiusSquared = Hammer.MaxRadius * Hammer.MaxRadius;
+
+	TArray<int32> Candidates;
+	USoterioMeshLib::QueryVerticesInRadius(ProductProperties, Local, Hammer.MaxRadius, Candidates);
 
 	int AffectedVert = 0;
-	for (FVector3f& Vert : ProductProperties.Vertices)
+	for (int32 i : Candidates)
 	{
-		FVector3f Delta = Vert - Local;
-		float DistSquared = Delta.SizeSquared();
-		if (DistSquared < MaxRadiusSquared && Vert.Z > 0)
+		FVector3f& Vert = ProductProperties.Vertices[i];
+		if (Vert.Z > 0)
 		{
-			float falloff = 1.0f - FMath::Sqrt(DistSquared) * InvMaxRadius;
+			float falloff = 1.0f - FVector3f::Dist(Vert, Local) * InvMaxRadius;
 			FVector3f Deform = ImpactNormal * 0.1f * falloff * Vert.Z;
 			Vert -= Deform;
+			ProductProperties.SpatialGrid.MoveVertex(i, Vert);
+			USoterioMeshLib::MarkVertexDirty(ProductProperties, i, EProductDirtyFlags::Position);
 			AffectedVert++;
 		}
 	}
 
-
 	if (bDebug)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("Affected vertices: %d"), AffectedVert);
@@ -359,14 +421,20 @@ void USoterioMeshLib::ModifyMesh(FProductProperties& ProductProperties, FHammerD
 	//UE_LOG(LogTemp, Warning, TEXT("Impact Point in Local Coordinates: X: %f, Y: %f, Z: %f"),
 	//	Local.X, Local.Y, Local.Z);
 
+	ModifyMesh(ProductProperties, Hammer, Local, ImpactNormal, bDebug);
+}
+
+// Hit already in product space, touches no UObjects so it is safe off the game thread
+void USoterioMeshLib::ModifyMesh(FProductProperties& ProductProperties, const FHammerData& Hammer, const FVector3f& Local, const FVector3f& ImpactNormal, bool bDebug)
+{
 	ProductProperties.GenerateSplineData();
 	switch (Hammer.Face_0)
 	{
 	case ES_HAMMER_SHAPE::FLAT:
-		FlatHammerShape(ProductProperties, Hammer, Hit, bDebug);
+		FlatHammerShape(ProductProperties, Hammer, Local, bDebug);
 		break;
 	case ES_HAMMER_SHAPE::ROUND:
-		RoundHammerShape(ProductProperties, Hammer, Hit, bDebug);
+		RoundHammerShape(ProductProperties, Hammer, Local, ImpactNormal, bDebug);
 		break;
 	case ES_HAMMER_SHAPE::SHARP:
 		UE_LOG(LogTemp, Error, TEXT("Not Prepared!"));
@@ -406,36 +474,24 @@ float USoterioMeshLib::Expansion(float fallof, FHitResult Hit)
 
 bool USoterioMeshLib::SaveMeshProperties(FProductProperties& Product, const FString& FilePath)
 {
-	FBufferArchive Archive;
-	Product.Serialize(Archive);
-
-	if (FFileHelper::SaveArrayToFile(Archive, *FilePath))
+	if (!SoterioProductFile::Save(Product, FilePath))
 	{
-		Archive.FlushCache();
-		Archive.Empty();
-		return true;
+		UE_LOG(LogTemp, Error, TEXT("Unable to write Mesh Properties to %s"), *FilePath);
+		return false;
 	}
-
-	Archive.FlushCache();
-	Archive.Empty();
-	return false;
+	return true;
 }
 
 bool USoterioMeshLib::LoadMeshProperties(FProductProperties& Product, const FString& FilePath)
 {
-	TArray<uint8> BinaryArray;
-	if (!FFileHelper::LoadFileToArray(BinaryArray, *FilePath))
+	if (!SoterioProductFile::Load(Product, FilePath))
 	{
 		UE_LOG(LogTemp, Error, TEXT("Unable read Mesh Properties from %s"), *FilePath);
 		return false;
 	}
 
-	FMemoryReader Reader(BinaryArray, true);
-	Reader.Seek(0);
-	UE_LOG(LogTemp, Warning, TEXT("LOL"));
-
-	Product.Serialize(Reader);
-	return false;
+	MarkAllDirty(Product, EProductDirtyFlags::Topology);
+	return true;
 }
 
 void FlatForge()
@@ -443,66 +499,518 @@ void FlatForge()
 
 }
 
+// Angle-weighted normals need no extra passes, any Depth above zero is a single full recompute
 void USoterioMeshLib::CalculateSmoothNormals(FProductProperties* Product, int Depth)
 {
-	for (int i = 0; i < Depth; i++)
+	if (!Product || Depth <= 0)
 	{
-		USoterioMeshLib::CalculateNormals(Product);
+		return;
 	}
+	Product->FaceNormals.Reset();
+	UpdateDirtyNormals(*Product);
 }
 
-void USoterioMeshLib::UpdateHeat(FProductProperties& Product, float Heat)
+namespace SoterioNormals
 {
-	const float MaxHeat = 1440.0f;
-	float HeatFactor = 0.8f;
-	const float MaxDistance =19.5f;
+	constexpr int32 ParallelBatchSize = 1024;
+
+	static bool IsValidFace(const FProductProperties& Product, int32 Face)
+	{
+		const int32 NumVertices = Product.Vertices.Num();
+		return Product.Triangles[Face * 3] < NumVertices &&
+			Product.Triangles[Face * 3 + 1] < NumVertices &&
+			Product.Triangles[Face * 3 + 2] < NumVertices;
+	}
+
+	FORCEINLINE static float CornerAngle(const FVector3f& Corner, const FVector3f& A, const FVector3f& B)
+	{
+		const float CosAngle = FVector3f::DotProduct((A - Corner).GetSafeNormal(), (B - Corner).GetSafeNormal());
+		return FMath::Acos(FMath::Clamp(CosAngle, -1.f, 1.f));
+	}
 
-	for (int i = 0; i < Product.Vertices.Num(); i++)
+	static void ComputeFace(FProductProperties& Product, int32 Face)
 	{
-		if (Product.VertexHeat[i] <= 250)
+		// ComputeVertex weighs by the angles too, leaving them uninitialized would let NaNs through the zero normal
+		if (!IsValidFace(Product, Face))
 		{
-			HeatFactor = 1.2;
+			Product.FaceNormals[Face] = FVector3f::ZeroVector;
+			Product.CornerAngles[Face * 3] = 0.f;
+			Product.CornerAngles[Face * 3 + 1] = 0.f;
+			Product.CornerAngles[Face * 3 + 2] = 0.f;
+			return;
 		}
-		else if (Product.VertexHeat[i] <= 450)
+		const FVector3f& P0 = Product.Vertices[Product.Triangles[Face * 3]];
+		const FVector3f& P1 = Product.Vertices[Product.Triangles[Face * 3 + 1]];
+		const FVector3f& P2 = Product.Vertices[Product.Triangles[Face * 3 + 2]];
+
+		// Same winding as CalculateNormals
+		Product.FaceNormals[Face] = FVector3f::CrossProduct(P2 - P0, P1 - P0).GetSafeNormal();
+		Product.CornerAngles[Face * 3] = CornerAngle(P0, P1, P2);
+		Product.CornerAngles[Face * 3 + 1] = CornerAngle(P1, P2, P0);
+		Product.CornerAngles[Face * 3 + 2] = CornerAngle(P2, P0, P1);
+	}
+
+	static void ComputeVertex(FProductProperties& Product, int32 Vertex)
+	{
+		FVector3f Normal = FVector3f::ZeroVector;
+		for (int32 c = Product.CornerOffsets[Vertex]; c < Product.CornerOffsets[Vertex + 1]; c++)
+		{
+			const int32 Corner = Product.Corners[c];
+			Normal += Product.FaceNormals[Corner / 3] * Product.CornerAngles[Corner];
+		}
+		// Isolated vertices keep whatever normal they had
+		if (!Normal.IsNearlyZero())
 		{
-			HeatFactor = 0.75;
+			Product.Normals[Vertex] = Normal.GetUnsafeNormal();
 		}
-		else if (Product.VertexHeat[i] <= 650)
+	}
+
+	// Tangents depend on the same faces plus the new normals, so they go stale for exactly the vertices whose normals were recomputed
+	static void ComputeTangents(FProductProperties& Product, TConstArrayView<int32> Vertices)
+	{
+		Product.Tangents.SetNumZeroed(Product.Vertices.Num());
+		FRealtimeMeshTangentGenerator(Product.Triangles, Product.CornerOffsets, Product.Corners)
+			.ComputeTangents(Product.Vertices, Product.Normals, Product.UVs, Product.Tangents, TArrayView<float>(), Vertices);
+	}
+}
+
+void USoterioMeshLib::UpdateDirtyNormals(FProductProperties& Product)
+{
+	const int32 NumVertices = Product.Vertices.Num();
+	const int32 NumFaces = Product.Triangles.Num() / 3;
+
+	if (Product.CornerOffsets.Num() != NumVertices + 1)
+	{
+		BuildCornerLookup(Product);
+	}
+	Product.Normals.SetNumZeroed(NumVertices);
+
+	// Without a valid cache every face is stale, which is the same as every vertex being dirty
+	if (Product.FaceNormals.Num() != NumFaces || Product.DirtyVertices.Num() != NumVertices)
+	{
+		Product.FaceNormals.SetNumUninitialized(NumFaces);
+		Product.CornerAngles.SetNumUninitialized(NumFaces * 3);
+		Product.DirtyVertices.Init(true, NumVertices);
+
+		ParallelFor(TEXT("SoterioFaceNormals"), NumFaces, SoterioNormals::ParallelBatchSize, [&](int32 Face)
+		{
+			SoterioNormals::ComputeFace(Product, Face);
+		});
+		ParallelFor(TEXT("SoterioVertexNormals"), NumVertices, SoterioNormals::ParallelBatchSize, [&](int32 Vertex)
+		{
+			SoterioNormals::ComputeVertex(Product, Vertex);
+		});
+		SoterioNormals::ComputeTangents(Product, TConstArrayView<int32>());
+		return;
+	}
+
+	// Faces touching a moved vertex, then every vertex of those faces
+	TBitArray<> DirtyFaces(false, NumFaces);
+	TArray<int32> FaceList;
+	for (TConstSetBitIterator<> It(Product.DirtyVertices); It; ++It)
+	{
+		const int32 Vertex = It.GetIndex();
+		for (int32 c = Product.CornerOffsets[Vertex]; c < Product.CornerOffsets[Vertex + 1]; c++)
+		{
+			const int32 Face = Product.Corners[c] / 3;
+			if (!DirtyFaces[Face])
+			{
+				DirtyFaces[Face] = true;
+				FaceList.Add(Face);
+			}
+		}
+	}
+	for (int32 Face : FaceList)
+	{
+		Product.DirtyVertices[Product.Triangles[Face * 3]] = true;
+		Product.DirtyVertices[Product.Triangles[Face * 3 + 1]] = true;
+		Product.DirtyVertices[Product.Triangles[Face * 3 + 2]] = true;
+	}
+
+	TArray<int32> VertexList;
+	for (TConstSetBitIterator<> It(Product.DirtyVertices); It; ++It)
+	{
+		VertexList.Add(It.GetIndex());
+	}
+
+	ParallelFor(TEXT("SoterioFaceNormals"), FaceList.Num(), SoterioNormals::ParallelBatchSize, [&](int32 i)
+	{
+		SoterioNormals::ComputeFace(Product, FaceList[i]);
+	});
+	ParallelFor(TEXT("SoterioVertexNormals"), VertexList.Num(), SoterioNormals::ParallelBatchSize, [&](int32 i)
+	{
+		SoterioNormals::ComputeVertex(Product, VertexList[i]);
+	});
+	if (VertexList.Num() > 0)
+	{
+		SoterioNormals::ComputeTangents(Product, VertexList);
+	}
+}
+
+/*
+Heat kernel
+	Vertices are processed four at a time, positions are transposed into X/Y/Z registers
+	so the math runs in SoA form. Blocks of HeatBlockSize vertices are spread over ParallelFor.
+*/
+namespace SoterioHeat
+{
+	constexpr float MaxHeat = 1440.0f;
+	constexpr float MaxDistance = 19.5f;
+	constexpr int32 HeatBlockSize = 2048;
+
+	// Thermal expansion per heating tick, the same for every vertex
+	static const FVector3f ThermalScale(1.0003f, 0.9996f, 1.0003f);
+
+	// Heat factor applies when VertexHeat is above the threshold on the same row (factor for <= 250 is BaseHeatFactor)
+	constexpr float BaseHeatFactor = 1.2f;
+	constexpr float HeatThresholds[] = { 250.f, 450.f, 650.f, 700.f, 950.f };
+	constexpr float HeatFactors[] = { 0.75f, 0.60f, 1.4f, 0.6f, 1.0f };
+
+	template<typename BlockFunc>
+	static void ForEachBlock(int32 NumVertices, BlockFunc&& Func)
+	{
+		const int32 NumBlocks = FMath::DivideAndRoundUp(NumVertices, HeatBlockSize);
+		ParallelFor(NumBlocks, [&](int32 Block)
 		{
-			HeatFactor = 0.60;
+			const int32 Start = Block * HeatBlockSize;
+			Func(Start, FMath::Min(Start + HeatBlockSize, NumVertices));
+		}, NumBlocks < 2 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+	}
+
+	FORCEINLINE static void LoadPositions(const FVector3f* Vertices, VectorRegister4Float& X, VectorRegister4Float& Y, VectorRegister4Float& Z)
+	{
+		X = MakeVectorRegisterFloat(Vertices[0].X, Vertices[1].X, Vertices[2].X, Vertices[3].X);
+		Y = MakeVectorRegisterFloat(Vertices[0].Y, Vertices[1].Y, Vertices[2].Y, Vertices[3].Y);
+		Z = MakeVectorRegisterFloat(Vertices[0].Z, Vertices[1].Z, Vertices[2].Z, Vertices[3].Z);
+	}
+
+	FORCEINLINE static VectorRegister4Float VectorLength3(const VectorRegister4Float& X, const VectorRegister4Float& Y, const VectorRegister4Float& Z)
+	{
+		return VectorSqrt(VectorMultiplyAdd(X, X, VectorMultiplyAdd(Y, Y, VectorMultiply(Z, Z))));
+	}
+
+	FORCEINLINE static float ScalarHeatFactor(float Heat)
+	{
+		float Factor = BaseHeatFactor;
+		for (int32 k = 0; k < UE_ARRAY_COUNT(HeatThresholds); k++)
+		{
+			Factor = Heat > HeatThresholds[k] ? HeatFactors[k] : Factor;
 		}
-		else if (Product.VertexHeat[i] <= 700)
+		return Factor;
+	}
+
+	static void UpdateHeatBlock(float* RESTRICT Heat, FVector3f* RESTRICT Vertices, int32 Start, int32 End)
+	{
+		const VectorRegister4Float OriginY = VectorSetFloat1(-9.f);
+		const VectorRegister4Float MaxDistanceV = VectorSetFloat1(MaxDistance);
+		const VectorRegister4Float MaxHeatV = VectorSetFloat1(MaxHeat);
+
+		int32 i = Start;
+		for (; i + 4 <= End; i += 4)
 		{
-			HeatFactor = 1.4;
+			const VectorRegister4Float H = VectorLoad(Heat + i);
+
+			// Thresholds are ascending, so the last one passed picks the factor
+			VectorRegister4Float Factor = VectorSetFloat1(BaseHeatFactor);
+			for (int32 k = 0; k < UE_ARRAY_COUNT(HeatThresholds); k++)
+			{
+				Factor = VectorSelect(VectorCompareGT(H, VectorSetFloat1(HeatThresholds[k])), VectorSetFloat1(HeatFactors[k]), Factor);
+			}
+
+			VectorRegister4Float X, Y, Z;
+			LoadPositions(Vertices + i, X, Y, Z);
+			const VectorRegister4Float Distance = VectorMin(VectorLength3(X, VectorSubtract(Y, OriginY), Z), MaxDistanceV);
+
+			VectorStore(VectorMin(VectorMultiplyAdd(VectorSubtract(MaxDistanceV, Distance), Factor, H), MaxHeatV), Heat + i);
 		}
-		else if (Product.VertexHeat[i] <= 950)
+		for (; i < End; i++)
 		{
-			HeatFactor = 0.6;
+			const float Distance = FMath::Min(FVector3f::Dist(Vertices[i], FVector3f(0, -9, 0)), MaxDistance);
+			Heat[i] = FMath::Min(Heat[i] + (MaxDistance - Distance) * ScalarHeatFactor(Heat[i]), MaxHeat);
 		}
-		else {
-			HeatFactor = 1;
+
+		for (i = Start; i < End; i++)
+		{
+			Vertices[i] *= ThermalScale;
 		}
+	}
+
+	static void DecreaseHeatBlock(float* RESTRICT Heat, const FVector3f* RESTRICT Vertices, int32 Start, int32 End)
+	{
+		const VectorRegister4Float Rate = VectorSetFloat1(1.f / (5760.f * 6.f));
 
-		float Distance = FMath::Clamp(FVector3f::Dist(Product.Vertices[i], FVector3f(0, -9, 0)), 0, MaxDistance);
-		Product.VertexHeat[i] += (MaxDistance - Distance) * HeatFactor;
-		if (Product.VertexHeat[i] > MaxHeat)
+		int32 i = Start;
+		for (; i + 4 <= End; i += 4)
 		{
-			Product.VertexHeat[i] = MaxHeat;
+			const VectorRegister4Float H = VectorLoad(Heat + i);
+
+			VectorRegister4Float X, Y, Z;
+			LoadPositions(Vertices + i, X, Y, Z);
+			const VectorRegister4Float Loss = VectorMultiply(VectorMultiply(H, Rate), VectorLength3(X, Y, Z));
+
+			VectorStore(VectorMax(VectorSubtract(H, Loss), VectorZeroFloat()), Heat + i);
+		}
+		for (; i < End; i++)
+		{
+			Heat[i] = FMath::Max(Heat[i] - Heat[i] / 5760 * (Vertices[i].Length() / 6), 0.f);
 		}
-		Product.Vertices[i] *= FVector3f(1.0003, 0.9996, 1.0003);
 	}
 }
 
+void USoterioMeshLib::UpdateHeat(FProductProperties& Product, float Heat)
+{
+	if (Product.VertexHeat.Num() != Product.Vertices.Num())
+	{
+		UE_LOG(LogTemp, Error, TEXT("VertexHeat (%d) does not match vertex count (%d)"), Product.VertexHeat.Num(), Product.Vertices.Num());
+		return;
+	}
+
+	float* VertexHeat = Product.VertexHeat.GetData();
+	FVector3f* Vertices = Product.Vertices.GetData();
+	SoterioHeat::ForEachBlock(Product.Vertices.Num(), [&](int32 Start, int32 End)
+	{
+		SoterioHeat::UpdateHeatBlock(VertexHeat, Vertices, Start, End);
+	});
+	// Every vertex moved by the same scale, the grid follows it instead of being rebuilt on the next strike
+	Product.DirtyVertices.Init(true, Product.Vertices.Num());
+	Product.DirtyFlags |= EProductDirtyFlags::Heat | EProductDirtyFlags::Position;
+	Product.SpatialGrid.ApplyScale(SoterioHeat::ThermalScale);
+}
+
 void USoterioMeshLib::DecreaseHeat(FProductProperties& Product)
 {
-	for (int i = 0; i < Product.Vertices.Num(); i++)
+	if (Product.VertexHeat.Num() != Product.Vertices.Num())
+	{
+		UE_LOG(LogTemp, Error, TEXT("VertexHeat (%d) does not match vertex count (%d)"), Product.VertexHeat.Num(), Product.Vertices.Num());
+		return;
+	}
+
+	float* VertexHeat = Product.VertexHeat.GetData();
+	const FVector3f* Vertices = Product.Vertices.GetData();
+	SoterioHeat::ForEachBlock(Product.Vertices.Num(), [&](int32 Start, int32 End)
+	{
+		SoterioHeat::DecreaseHeatBlock(VertexHeat, Vertices, Start, End);
+	});
+	MarkAllDirty(Product, EProductDirtyFlags::Heat);
+}
+
+void USoterioMeshLib::BuildVertexAdjacency(FProductProperties& Product)
+{
+	const int32 NumVertices = Product.Vertices.Num();
+	const int32 NumCorners = (Product.Triangles.Num() / 3) * 3;
+
+	// Every triangle corner links to the two other corners, duplicates are dropped per row below
+	TArray<int32> Offsets;
+	Offsets.Init(0, NumVertices + 1);
+	for (int32 Corner = 0; Corner < NumCorners; Corner++)
+	{
+		if (Product.Triangles[Corner] < NumVertices)
+		{
+			Offsets[Product.Triangles[Corner] + 1] += 2;
+		}
+	}
+	for (int32 i = 0; i < NumVertices; i++)
+	{
+		Offsets[i + 1] += Offsets[i];
+	}
+
+	TArray<int32> Links;
+	Links.SetNumUninitialized(Offsets[NumVertices]);
+	TArray<int32> Cursor(Offsets.GetData(), NumVertices);
+	for (int32 Corner = 0; Corner < NumCorners; Corner++)
+	{
+		const int32 Vertex = Product.Triangles[Corner];
+		if (Vertex >= NumVertices)
+		{
+			continue;
+		}
+		const int32 FirstCorner = Corner - Corner % 3;
+		Links[Cursor[Vertex]++] = Product.Triangles[FirstCorner + (Corner + 1) % 3];
+		Links[Cursor[Vertex]++] = Product.Triangles[FirstCorner + (Corner + 2) % 3];
+	}
+
+	Product.NeighbourOffsets.SetNumUninitialized(NumVertices + 1);
+	Product.Neighbours.Reset(Links.Num());
+	Product.NeighbourOffsets[0] = 0;
+	for (int32 i = 0; i < NumVertices; i++)
+	{
+		TArrayView<int32> Row(Links.GetData() + Offsets[i], Offsets[i + 1] - Offsets[i]);
+		Algo::Sort(Row);
+		int32 Previous = INDEX_NONE;
+		for (int32 Neighbour : Row)
+		{
+			if (Neighbour != Previous && Neighbour != i && Neighbour < NumVertices)
+			{
+				Product.Neighbours.Add(Neighbour);
+			}
+			Previous = Neighbour;
+		}
+		Product.NeighbourOffsets[i + 1] = Product.Neighbours.Num();
+	}
+}
+
+namespace SoterioHeat
+{
+	// Explicit steps stay positive while Dt * Diffusivity * RowSum stays below this
+	constexpr float StableStepFactor = 0.9f;
+
+	/*
+	Surface Laplacian weights, W_ij = 4 / (N_i * |e_ij|^2), the umbrella operator scaled so
+	that Diffusivity is in mesh units. Edges are recomputed every call since hammering moves vertices.
+	*/
+	static float BuildLaplacianWeights(const FProductProperties& Product, FProductHeatScratch& Scratch)
+	{
+		const int32 NumVertices = Product.Vertices.Num();
+		TArray<float>& OutWeights = Scratch.Weights;
+		TArray<float>& OutRowSums = Scratch.RowSums;
+		TArray<float>& BlockMaxRowSum = Scratch.BlockMaxRowSum;
+		OutWeights.SetNumUninitialized(Product.Neighbours.Num(), EAllowShrinking::No);
+		OutRowSums.SetNumUninitialized(NumVertices, EAllowShrinking::No);
+		BlockMaxRowSum.Init(0.f, FMath::DivideAndRoundUp(NumVertices, HeatBlockSize));
+		ParallelFor(BlockMaxRowSum.Num(), [&](int32 Block)
+		{
+			const int32 Start = Block * HeatBlockSize;
+			const int32 End = FMath::Min(Start + HeatBlockSize, NumVertices);
+			for (int32 i = Start; i < End; i++)
+			{
+				const int32 RowStart = Product.NeighbourOffsets[i];
+				const int32 RowEnd = Product.NeighbourOffsets[i + 1];
+				const float Scale = RowEnd > RowStart ? 4.f / (RowEnd - RowStart) : 0.f;
+				float RowSum = 0.f;
+				for (int32 e = RowStart; e < RowEnd; e++)
+				{
+					const float LengthSquared = FMath::Max(FVector3f::DistSquared(Product.Vertices[i], Product.Vertices[Product.Neighbours[e]]), UE_KINDA_SMALL_NUMBER);
+					OutWeights[e] = Scale / LengthSquared;
+					RowSum += OutWeights[e];
+				}
+				OutRowSums[i] = RowSum;
+				BlockMaxRowSum[Block] = FMath::Max(BlockMaxRowSum[Block], RowSum);
+			}
+		});
+
+		float MaxRowSum = 0.f;
+		for (float BlockMax : BlockMaxRowSum)
+		{
+			MaxRowSum = FMath::Max(MaxRowSum, BlockMax);
+		}
+		return MaxRowSum;
+	}
+
+	// Out_i = sum_j W_ij * In_j, the sparse mat-vec both solvers are built on
+	FORCEINLINE static float NeighbourSum(const FProductProperties& Product, const TArray<float>& Weights, const float* In, int32 i)
+	{
+		float Sum = 0.f;
+		for (int32 e = Product.NeighbourOffsets[i]; e < Product.NeighbourOffsets[i + 1]; e++)
+		{
+			Sum += Weights[e] * In[Product.Neighbours[e]];
+		}
+		return Sum;
+	}
+
+	static void ExplicitStep(const FProductProperties& Product, const TArray<float>& Weights, const TArray<float>& RowSums,
+		const float* In, float* Out, float Alpha, float Cooling, float Ambient)
+	{
+		ForEachBlock(Product.Vertices.Num(), [&](int32 Start, int32 End)
+		{
+			for (int32 i = Start; i < End; i++)
+			{
+				const float Laplacian = NeighbourSum(Product, Weights, In, i) - RowSums[i] * In[i];
+				Out[i] = FMath::Clamp(In[i] + Alpha * Laplacian - Cooling * (In[i] - Ambient), 0.f, MaxHeat);
+			}
+		});
+	}
+
+	// (1 + Alpha * D + Cooling) T' - Alpha * W T' = T + Cooling * Ambient, relaxed with Jacobi sweeps
+	static void ImplicitStep(const FProductProperties& Product, const TArray<float>& Weights, const TArray<float>& RowSums,
+		const float* In, float* Out, float* Scratch, int32 Iterations, float Alpha, float Cooling, float Ambient)
+	{
+		const int32 NumVertices = Product.Vertices.Num();
+		FMemory::Memcpy(Out, In, NumVertices * sizeof(float));
+		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			ForEachBlock(NumVertices, [&](int32 Start, int32 End)
+			{
+				for (int32 i = Start; i < End; i++)
+				{
+					const float Rhs = In[i] + Cooling * Ambient + Alpha * NeighbourSum(Product, Weights, Out, i);
+					Scratch[i] = FMath::Clamp(Rhs / (1.f + Alpha * RowSums[i] + Cooling), 0.f, MaxHeat);
+				}
+			});
+			FMemory::Memcpy(Out, Scratch, NumVertices * sizeof(float));
+		}
+	}
+}
+
+void USoterioMeshLib::DiffuseHeat(FProductProperties& Product, const FHeatSolverSettings& Settings, float DeltaTime, bool bSurfaceCooling)
+{
+	const int32 NumVertices = Product.Vertices.Num();
+	if (NumVertices == 0 || DeltaTime <= 0.f)
+	{
+		return;
+	}
+	if (Product.VertexHeat.Num() != NumVertices)
 	{
-		Product.VertexHeat[i] -= (Product.VertexHeat[i] / 5760) * ((FVector3f::Dist(FVector3f(0, 0, 0), Product.Vertices[i])) / 6);
-		if (Product.VertexHeat[i] <= 0)
+		UE_LOG(LogTemp, Error, TEXT("VertexHeat (%d) does not match vertex count (%d)"), Product.VertexHeat.Num(), NumVertices);
+		return;
+	}
+	if (Product.NeighbourOffsets.Num() != NumVertices + 1)
+	{
+		BuildVertexAdjacency(Product);
+	}
+
+	// Solver buffers live on the product, after the first tick nothing here allocates
+	FProductHeatScratch& HeatScratch = Product.HeatScratch;
+	const float MaxRowSum = SoterioHeat::BuildLaplacianWeights(Product, HeatScratch);
+	const TArray<float>& Weights = HeatScratch.Weights;
+	const TArray<float>& RowSums = HeatScratch.RowSums;
+
+	int32 Substeps = FMath::Max(Settings.Substeps, 1);
+	bool bImplicit = Settings.Mode == EHeatSolverMode::Implicit;
+	if (!bImplicit)
+	{
+		const float StableDt = SoterioHeat::StableStepFactor / FMath::Max(Settings.Diffusivity * MaxRowSum + Settings.CoolingRate, UE_SMALL_NUMBER);
+		const int32 StableSubsteps = FMath::CeilToInt32(DeltaTime / StableDt);
+		if (StableSubsteps > Settings.MaxSubsteps)
 		{
-			Product.VertexHeat[i] = 0;
+			UE_LOG(LogTemp, Verbose, TEXT("Explicit heat step needs %d substeps, using the implicit solver"), StableSubsteps);
+			bImplicit = true;
+		}
+		else
+		{
+			Substeps = FMath::Max(Substeps, StableSubsteps);
 		}
 	}
+
+	const float StepDt = DeltaTime / Substeps;
+	const float Alpha = Settings.Diffusivity * StepDt;
+	const float Cooling = bSurfaceCooling ? Settings.CoolingRate * StepDt : 0.f;
+
+	HeatScratch.Buffer.SetNumUninitialized(NumVertices, EAllowShrinking::No);
+	if (bImplicit)
+	{
+		HeatScratch.Jacobi.SetNumUninitialized(NumVertices, EAllowShrinking::No);
+	}
+
+	float* Current = Product.VertexHeat.GetData();
+	float* Next = HeatScratch.Buffer.GetData();
+	for (int32 Step = 0; Step < Substeps; Step++)
+	{
+		if (bImplicit)
+		{
+			SoterioHeat::ImplicitStep(Product, Weights, RowSums, Current, Next, HeatScratch.Jacobi.GetData(), FMath::Max(Settings.JacobiIterations, 1), Alpha, Cooling, Settings.AmbientHeat);
+		}
+		else
+		{
+			SoterioHeat::ExplicitStep(Product, Weights, RowSums, Current, Next, Alpha, Cooling, Settings.AmbientHeat);
+		}
+		Swap(Current, Next);
+	}
+	if (Current != Product.VertexHeat.GetData())
+	{
+		FMemory::Memcpy(Product.VertexHeat.GetData(), Current, NumVertices * sizeof(float));
+	}
+
+	MarkAllDirty(Product, EProductDirtyFlags::Heat);
 }
 
 FColor USoterioMeshLib::GenerateVertexColor(float Heat)
@@ -581,6 +1089,7 @@ void USoterioMeshLib::AlignCenter(FProductProperties* Product, bool AlignHorizon
 			Product->Vertices[i].Z -= Center.Z;
 		}
 	}
+	MarkAllDirty(*Product, EProductDirtyFlags::Position);
 }
 
 void USoterioMeshLib::AlignRaw()
@@ -694,5 +1203,252 @@ void USoterioMeshLib::FixDegenerateTriangles(FProductProperties& ProductProperti
 		ProductProperties.Triangles.RemoveAt(Index, 3, false);
 		id = Index;
 	}
+	if (TrianglesToRemove.Num() > 0)
+	{
+		MarkAllDirty(ProductProperties, EProductDirtyFlags::Topology);
+	}
 	UE_LOG(LogTemp, Warning, TEXT("%d Triangles Affected"), id);
 }
+
+void USoterioMeshLib::MarkVertexDirty(FProductProperties& Product, int32 VertexIndex, EProductDirtyFlags Flags)
+{
+	// Heat always changes everywhere at once, it is only tracked by its flag so it doesn't widen geometry updates
+	if (EnumHasAnyFlags(Flags, EProductDirtyFlags::Position | EProductDirtyFlags::Topology))
+	{
+		if (Product.DirtyVertices.Num() != Product.Vertices.Num())
+		{
+			Product.DirtyVertices.Init(false, Product.Vertices.Num());
+		}
+		Product.DirtyVertices[VertexIndex] = true;
+	}
+	Product.DirtyFlags |= Flags;
+}
+
+void USoterioMeshLib::MarkAllDirty(FProductProperties& Product, EProductDirtyFlags Flags)
+{
+	if (EnumHasAnyFlags(Flags, EProductDirtyFlags::Position | EProductDirtyFlags::Topology))
+	{
+		Product.DirtyVertices.Init(true, Product.Vertices.Num());
+	}
+	Product.DirtyFlags |= Flags;
+
+	// Whole-mesh moves are cheaper to re-bucket lazily on the next query
+	if (EnumHasAnyFlags(Flags, EProductDirtyFlags::Position | EProductDirtyFlags::Topology))
+	{
+		Product.SpatialGrid.Invalidate();
+	}
+	if (EnumHasAnyFlags(Flags, EProductDirtyFlags::Topology))
+	{
+		Product.NeighbourOffsets.Reset();
+		Product.CornerOffsets.Reset();
+		Product.FaceNormals.Reset();
+	}
+}
+
+void USoterioMeshLib::ClearDirty(FProductProperties& Product)
+{
+	Product.DirtyVertices.Init(false, Product.Vertices.Num());
+	Product.DirtyFlags = EProductDirtyFlags::None;
+}
+
+void USoterioMeshLib::BuildCornerLookup(FProductProperties& Product)
+{
+	const int32 NumVertices = Product.Vertices.Num();
+	// Builders only consume whole triangles, trailing indices never reach the GPU
+	const int32 NumCorners = (Product.Triangles.Num() / 3) * 3;
+
+	auto IsValidTriangle = [&](int32 FirstCorner)
+	{
+		return Product.Triangles[FirstCorner] < NumVertices &&
+			Product.Triangles[FirstCorner + 1] < NumVertices &&
+			Product.Triangles[FirstCorner + 2] < NumVertices;
+	};
+
+	Product.CornerOffsets.Init(0, NumVertices + 1);
+	for (int32 Corner = 0; Corner < NumCorners; Corner++)
+	{
+		if (IsValidTriangle(Corner - Corner % 3))
+		{
+			Product.CornerOffsets[Product.Triangles[Corner] + 1]++;
+		}
+	}
+	for (int32 i = 0; i < NumVertices; i++)
+	{
+		Product.CornerOffsets[i + 1] += Product.CornerOffsets[i];
+	}
+
+	TArray<int32> Cursor(Product.CornerOffsets.GetData(), NumVertices);
+	Product.Corners.SetNumUninitialized(Product.CornerOffsets[NumVertices]);
+	for (int32 Corner = 0; Corner < NumCorners; Corner++)
+	{
+		if (IsValidTriangle(Corner - Corner % 3))
+		{
+			Product.Corners[Cursor[Product.Triangles[Corner]]++] = Corner;
+		}
+	}
+}
+
+TFuture<ERealtimeMeshProxyUpdateStatus> USoterioMeshLib::UpdateProductInPlace(URealtimeMeshSimple* RealtimeMesh, const FRealtimeMeshSectionGroupKey& GroupKey, FProductProperties& Product, int CalculateNormalDepth)
+{
+	if (!RealtimeMesh || EnumHasAnyFlags(Product.DirtyFlags, EProductDirtyFlags::Topology))
+	{
+		return TFuture<ERealtimeMeshProxyUpdateStatus>();
+	}
+
+	const bool bGeometryDirty = EnumHasAnyFlags(Product.DirtyFlags, EProductDirtyFlags::Position);
+	const bool bHeatDirty = EnumHasAnyFlags(Product.DirtyFlags, EProductDirtyFlags::Heat);
+	if (!bGeometryDirty && !bHeatDirty)
+	{
+		return MakeFulfilledPromise<ERealtimeMeshProxyUpdateStatus>(ERealtimeMeshProxyUpdateStatus::NoUpdate).GetFuture();
+	}
+
+	// Normals are recomputed through the corner lookup, recoloring doesn't need it
+	if (bGeometryDirty && Product.CornerOffsets.Num() != Product.Vertices.Num() + 1)
+	{
+		return TFuture<ERealtimeMeshProxyUpdateStatus>();
+	}
+
+	// Checked before editing, a commit that turns out to change nothing would still go out as an empty proxy update
+	bool bStreamsMatch = false;
+	int32 NumIndices = 0;
+	RealtimeMesh->ProcessMesh(GroupKey, [&](const FRealtimeMeshStreamSet& Streams)
+	{
+		const FRealtimeMeshStream* PositionStream = Streams.Find(FRealtimeMeshStreams::Position);
+		const FRealtimeMeshStream* TangentStream = Streams.Find(FRealtimeMeshStreams::Tangents);
+		const FRealtimeMeshStream* ColorStream = Streams.Find(FRealtimeMeshStreams::Color);
+		const FRealtimeMeshStream* TriangleStream = Streams.Find(FRealtimeMeshStreams::Triangles);
+		bStreamsMatch = PositionStream && TangentStream && ColorStream && TriangleStream &&
+			PositionStream->Num() == Product.Vertices.Num() && ColorStream->Num() == Product.Vertices.Num();
+		NumIndices = TriangleStream ? TriangleStream->Num() * TriangleStream->GetNumElements() : 0;
+	});
+	if (!bStreamsMatch)
+	{
+		return TFuture<ERealtimeMeshProxyUpdateStatus>();
+	}
+
+	// Also widens DirtyVertices to every vertex whose normal changed, heat ticks don't add to it
+	if (bGeometryDirty && CalculateNormalDepth)
+	{
+		UpdateDirtyNormals(Product);
+	}
+
+	TFuture<ERealtimeMeshProxyUpdateStatus> Update = RealtimeMesh->EditMeshInPlace(GroupKey, [&](FRealtimeMeshStreamSet& Streams)
+	{
+		TSet<FRealtimeMeshStreamKey> UpdatedStreams;
+
+		TRealtimeMeshStreamBuilder<FVector3f> Positions(Streams.FindChecked(FRealtimeMeshStreams::Position));
+		TRealtimeMeshStreamBuilder<TRealtimeMeshTangents<FVector4f>, TRealtimeMeshTangents<FPackedNormal>> Tangents(Streams.FindChecked(FRealtimeMeshStreams::Tangents));
+		TRealtimeMeshStreamBuilder<FColor> Colors(Streams.FindChecked(FRealtimeMeshStreams::Color));
+
+		// Streams are built from the shared vertex array, GPU vertex i is product vertex i.
+		// Only the span between the first and last moved vertex is re-uploaded, into the existing buffers
+		if (bGeometryDirty)
+		{
+			int32 FirstDirty = INDEX_NONE;
+			int32 LastDirty = INDEX_NONE;
+			for (TConstSetBitIterator<> It(Product.DirtyVertices); It; ++It)
+			{
+				const int32 VertexIndex = It.GetIndex();
+				FirstDirty = FirstDirty == INDEX_NONE ? VertexIndex : FirstDirty;
+				LastDirty = VertexIndex;
+				Positions.Set(VertexIndex, Product.Vertices[VertexIndex]);
+				Tangents.Set(VertexIndex, TRealtimeMeshTangents<FVector4f>(Product.Normals[VertexIndex], Product.Tangents[VertexIndex]));
+			}
+			if (LastDirty != INDEX_NONE)
+			{
+				Streams.MarkRangeDirty(FRealtimeMeshStreams::Position, FirstDirty, LastDirty - FirstDirty + 1);
+				Streams.MarkRangeDirty(FRealtimeMeshStreams::Tangents, FirstDirty, LastDirty - FirstDirty + 1);
+				UpdatedStreams.Add(FRealtimeMeshStreams::Position);
+				UpdatedStreams.Add(FRealtimeMeshStreams::Tangents);
+			}
+		}
+
+		// Heat is dirty everywhere or nowhere
+		if (bHeatDirty && Product.Vertices.Num() > 0)
+		{
+			for (int32 VertexIndex = 0; VertexIndex < Product.Vertices.Num(); VertexIndex++)
+			{
+				Colors.Set(VertexIndex, GenerateVertexColor(Product.VertexHeat[VertexIndex]));
+			}
+			Streams.MarkRangeDirty(FRealtimeMeshStreams::Color, 0, Product.Vertices.Num());
+			UpdatedStreams.Add(FRealtimeMeshStreams::Color);
+		}
+		return UpdatedStreams;
+	});
+
+	// Bounds follow the position stream on their own, and deformable collision refits from it. Only cooked complex
+	// collision needs the range re-submitted to be marked dirty
+	if (bGeometryDirty && !RealtimeMesh->IsUsingDeformableCollision())
+	{
+		RealtimeMesh->UpdateSectionRange(FRealtimeMeshSectionKey::CreateForPolyGroup(GroupKey, 0),
+			FRealtimeMeshStreamRange(0, Product.Vertices.Num(), 0, NumIndices));
+	}
+
+	ClearDirty(Product);
+	return Update;
+}
+
+void USoterioMeshLib::BuildProductColorStream(const FProductProperties& Product, FRealtimeMeshStream& OutColors)
+{
+	OutColors = FRealtimeMeshStream::Create<FColor>(FRealtimeMeshStreams::Color);
+	OutColors.SetNumUninitialized(Product.Vertices.Num());
+
+	TArrayView<FColor> Colors = OutColors.GetArrayView<FColor>();
+	for (int32 i = 0; i < Colors.Num(); i++)
+	{
+		Colors[i] = GenerateVertexColor(Product.VertexHeat[i]);
+	}
+}
+
+TFuture<ERealtimeMeshProxyUpdateStatus> USoterioMeshLib::UpdateProductColors(URealtimeMeshSimple* RealtimeMesh, const FRealtimeMeshSectionGroupKey& GroupKey, const FRealtimeMeshStream& Colors)
+{
+	if (!RealtimeMesh)
+	{
+		return TFuture<ERealtimeMeshProxyUpdateStatus>();
+	}
+
+	// Checked before editing, like UpdateProductInPlace, so a mismatch doesn't go out as an empty proxy update
+	bool bStreamsMatch = false;
+	RealtimeMesh->ProcessMesh(GroupKey, [&](const FRealtimeMeshStreamSet& Streams)
+	{
+		const FRealtimeMeshStream* ColorStream = Streams.Find(FRealtimeMeshStreams::Color);
+		bStreamsMatch = ColorStream && ColorStream->Num() == Colors.Num();
+	});
+	if (!bStreamsMatch)
+	{
+		return TFuture<ERealtimeMeshProxyUpdateStatus>();
+	}
+	if (Colors.Num() == 0)
+	{
+		return MakeFulfilledPromise<ERealtimeMeshProxyUpdateStatus>(ERealtimeMeshProxyUpdateStatus::NoUpdate).GetFuture();
+	}
+
+	return RealtimeMesh->EditMeshInPlace(GroupKey, [&](FRealtimeMeshStreamSet& Streams)
+	{
+		// Written into the existing stream so it stays linked to the position stream, and into the existing GPU buffer
+		FRealtimeMeshStream& ColorStream = Streams.FindChecked(FRealtimeMeshStreams::Color);
+		ColorStream.SetRange(0, Colors.GetLayout(), Colors.GetData(), Colors.Num());
+		Streams.MarkRangeDirty(FRealtimeMeshStreams::Color, 0, Colors.Num());
+
+		// Only the color buffer is re-uploaded, no section range or collision update follows
+		TSet<FRealtimeMeshStreamKey> UpdatedStreams;
+		UpdatedStreams.Add(FRealtimeMeshStreams::Color);
+		return UpdatedStreams;
+	});
+}
+
+void USoterioMeshLib::QueryVerticesInRadius(FProductProperties& Product, const FVector3f& Center, float Radius, TArray<int32>& OutVertices)
+{
+	if (Radius <= 0.f)
+	{
+		return;
+	}
+
+	// Cells about the size of the query keep the scan to a 3x3x3 block, thermal scaling stretches them over time
+	FProductSpatialGrid& Grid = Product.SpatialGrid;
+	if (!Grid.IsValid(Product.Vertices.Num()) || Grid.CellSize * Grid.Scale.GetMin() < Radius * 0.5f || Grid.CellSize * Grid.Scale.GetMax() > Radius * 2.f)
+	{
+		Grid.Build(Product.Vertices, Radius);
+	}
+	Grid.QueryRadius(Product.Vertices, Center, Radius, OutVertices);
+}
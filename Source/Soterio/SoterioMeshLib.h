@@ -38,6 +38,7 @@ public:
 		URealtimeMeshComponent* RealtimeMeshComponent, const FProductProperties& ProductProperties, UMaterialInterface* ProductMaterial, bool bConsoleDebug);
 
 	static void ModifyMesh(FProductProperties& ProductProperties, FHammerData& Hammer, FHitResult Hit, bool bDebug = false);
+	static void ModifyMesh(FProductProperties& ProductProperties, const FHammerData& Hammer, const FVector3f& Local, const FVector3f& ImpactNormal, bool bDebug = false);
 
 	static float Expansion(float fallof, FHitResult Hit);
 
@@ -45,8 +46,12 @@ public:
 	static bool LoadMeshProperties(FProductProperties& Product, const FString& FilePath);
 
 	static void CalculateSmoothNormals(FProductProperties* Product, int Depth);
+	// Recomputes normals and tangents of every vertex sharing a face with a dirty vertex
+	static void UpdateDirtyNormals(FProductProperties& Product);
 	static void UpdateHeat(FProductProperties& Product, float Heat);
 	static void DecreaseHeat(FProductProperties& Product);
+	static void BuildVertexAdjacency(FProductProperties& Product);
+	static void DiffuseHeat(FProductProperties& Product, const FHeatSolverSettings& Settings, float DeltaTime, bool bSurfaceCooling);
 	static FColor GenerateVertexColor(float Heat);
 	static UStaticMesh* ConvertToStaticMesh(UObject* Outer, const TArray<FVector3f>& Vertices, const TArray<int32>& Triangles, const TArray<FVector3f>& Normals, const TArray<FVector2f>& UVs);
 
@@ -60,4 +65,22 @@ public:
 	static void CheckMeshHealth(FProductProperties* Product);
 	static bool IsDegenerateTriangle(const FVector3f& P0, const FVector3f& P1, const FVector3f& P2, float Threshold);
 	static void FixDegenerateTriangles(FProductProperties& ProductProperties);
+
+	/*
+	Incremental mesh updates
+	*/
+	static void MarkVertexDirty(FProductProperties& Product, int32 VertexIndex, EProductDirtyFlags Flags);
+	static void MarkAllDirty(FProductProperties& Product, EProductDirtyFlags Flags);
+	static void ClearDirty(FProductProperties& Product);
+	static void BuildCornerLookup(FProductProperties& Product);
+	static int32 BuildProductStreams(const FProductProperties& Product, FRealtimeMeshStreamSet& StreamSet);
+	// Writes the dirty vertex range into the existing streams and GPU buffers. Invalid future if the topology changed or
+	// the group's streams don't match the product, the product is left dirty then
+	static TFuture<ERealtimeMeshProxyUpdateStatus> UpdateProductInPlace(URealtimeMeshSimple* RealtimeMesh, const FRealtimeMeshSectionGroupKey& GroupKey, FProductProperties& Product, int CalculateNormalDepth);
+	// Heat only path, the color stream is built and uploaded on its own so positions, indices and collision stay untouched
+	static void BuildProductColorStream(const FProductProperties& Product, FRealtimeMeshStream& OutColors);
+	// Invalid future if the group has no color stream matching the product's vertex count
+	static TFuture<ERealtimeMeshProxyUpdateStatus> UpdateProductColors(URealtimeMeshSimple* RealtimeMesh, const FRealtimeMeshSectionGroupKey& GroupKey, const FRealtimeMeshStream& Colors);
+
+	static void QueryVerticesInRadius(FProductProperties& Product, const FVector3f& Center, float Radius, TArray<int32>& OutVertices);
 };
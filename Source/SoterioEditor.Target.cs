@@ -11,5 +11,6 @@ public class SoterioEditorTarget : TargetRules
 		DefaultBuildSettings = BuildSettingsVersion.V5;
 		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_4;
 		ExtraModuleNames.Add("Soterio");
+		ExtraModuleNames.Add("SoterioTests");
 	}
 }
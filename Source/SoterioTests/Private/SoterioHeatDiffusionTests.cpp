@@ -0,0 +1,91 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "../../Soterio/SoterioMeshLib.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSoterioHeatDiffusionTest, "Soterio.MeshLib.HeatDiffusion", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+// Flat Size x Size vertex grid with 1cm spacing and a hot vertex in the middle
+static FProductProperties MakeDiffusionTestProduct(int32 Size)
+{
+	FProductProperties Product;
+	for (int32 y = 0; y < Size; y++)
+	{
+		for (int32 x = 0; x < Size; x++)
+		{
+			Product.Vertices.Add(FVector3f(x, y, 0));
+			Product.VertexHeat.Add(20.f);
+		}
+	}
+	for (int32 y = 0; y + 1 < Size; y++)
+	{
+		for (int32 x = 0; x + 1 < Size; x++)
+		{
+			const int32 i0 = y * Size + x;
+			Product.Triangles.Append({ i0, i0 + Size, i0 + 1, i0 + 1, i0 + Size, i0 + Size + 1 });
+		}
+	}
+	Product.VertexHeat[(Size / 2) * Size + Size / 2] = 1440.f;
+	return Product;
+}
+
+// Diffusion conserves heat weighted by vertex valence, the solver's lumped mass
+static double WeightedHeat(const FProductProperties& Product)
+{
+	double Sum = 0.0;
+	for (int32 i = 0; i < Product.Vertices.Num(); i++)
+	{
+		Sum += double(Product.NeighbourOffsets[i + 1] - Product.NeighbourOffsets[i]) * Product.VertexHeat[i];
+	}
+	return Sum;
+}
+
+bool FSoterioHeatDiffusionTest::RunTest(const FString& Parameters)
+{
+	FProductProperties Product = MakeDiffusionTestProduct(9);
+	USoterioMeshLib::BuildVertexAdjacency(Product);
+
+	TestEqual(TEXT("Corner vertex has two neighbours"), Product.NeighbourOffsets[1] - Product.NeighbourOffsets[0], 2);
+	TestEqual(TEXT("Interior vertex has six neighbours"), Product.NeighbourOffsets[41] - Product.NeighbourOffsets[40], 6);
+
+	FHeatSolverSettings Settings;
+	for (const EHeatSolverMode Mode : { EHeatSolverMode::Explicit, EHeatSolverMode::Implicit })
+	{
+		const TCHAR* ModeName = Mode == EHeatSolverMode::Explicit ? TEXT("Explicit") : TEXT("Implicit");
+		Settings.Mode = Mode;
+
+		FProductProperties Conducting = Product;
+		const double HeatBefore = WeightedHeat(Conducting);
+		for (int32 Tick = 0; Tick < 10; Tick++)
+		{
+			USoterioMeshLib::DiffuseHeat(Conducting, Settings, 0.1f, false);
+		}
+		TestTrue(FString::Printf(TEXT("%s conduction conserves heat"), ModeName), FMath::IsNearlyEqual(WeightedHeat(Conducting), HeatBefore, HeatBefore * 0.01));
+		TestTrue(FString::Printf(TEXT("%s conduction cools the hot spot"), ModeName), Conducting.VertexHeat[40] < 1440.f);
+		TestTrue(FString::Printf(TEXT("%s conduction warms its neighbours"), ModeName), Conducting.VertexHeat[41] > 20.f);
+
+		FProductProperties Cooling = Product;
+		for (float& Heat : Cooling.VertexHeat)
+		{
+			Heat = 1000.f;
+		}
+		USoterioMeshLib::DiffuseHeat(Cooling, Settings, 1.f, true);
+		TestTrue(FString::Printf(TEXT("%s cooling moves towards ambient"), ModeName), Cooling.VertexHeat[0] < 1000.f && Cooling.VertexHeat[0] > Settings.AmbientHeat);
+	}
+
+	// Roughly the 50k vertex budget TimePasses has to fit in, timings are reported rather than asserted
+	FProductProperties Large = MakeDiffusionTestProduct(224);
+	for (const EHeatSolverMode Mode : { EHeatSolverMode::Explicit, EHeatSolverMode::Implicit })
+	{
+		Settings.Mode = Mode;
+		const double Start = FPlatformTime::Seconds();
+		for (int32 Tick = 0; Tick < 10; Tick++)
+		{
+			USoterioMeshLib::DiffuseHeat(Large, Settings, 0.1f, true);
+		}
+		AddInfo(FString::Printf(TEXT("%s diffusion, %d vertices: %.3f ms per tick"),
+			Mode == EHeatSolverMode::Explicit ? TEXT("Explicit") : TEXT("Implicit"), Large.Vertices.Num(), (FPlatformTime::Seconds() - Start) * 100.0));
+	}
+
+	return true;
+}
@@ -0,0 +1,161 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "../../Soterio/SoterioMeshLib.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSoterioHeatKernelTest, "Soterio.MeshLib.HeatKernel", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+// The per-vertex loops UpdateHeat and DecreaseHeat used before the block kernel, kept as the reference
+static void ReferenceUpdateHeat(FProductProperties& Product)
+{
+	const float MaxHeat = 1440.0f;
+	float HeatFactor = 0.8f;
+	const float MaxDistance = 19.5f;
+
+	for (int i = 0; i < Product.Vertices.Num(); i++)
+	{
+		if (Product.VertexHeat[i] <= 250)
+		{
+			HeatFactor = 1.2;
+		}
+		else if (Product.VertexHeat[i] <= 450)
+		{
+			HeatFactor = 0.75;
+		}
+		else if (Product.VertexHeat[i] <= 650)
+		{
+			HeatFactor = 0.60;
+		}
+		else if (Product.VertexHeat[i] <= 700)
+		{
+			HeatFactor = 1.4;
+		}
+		else if (Product.VertexHeat[i] <= 950)
+		{
+			HeatFactor = 0.6;
+		}
+		else {
+			HeatFactor = 1;
+		}
+
+		float Distance = FMath::Clamp(FVector3f::Dist(Product.Vertices[i], FVector3f(0, -9, 0)), 0, MaxDistance);
+		Product.VertexHeat[i] += (MaxDistance - Distance) * HeatFactor;
+		if (Product.VertexHeat[i] > MaxHeat)
+		{
+			Product.VertexHeat[i] = MaxHeat;
+		}
+		Product.Vertices[i] *= FVector3f(1.0003, 0.9996, 1.0003);
+	}
+}
+
+static void ReferenceDecreaseHeat(FProductProperties& Product)
+{
+	for (int i = 0; i < Product.Vertices.Num(); i++)
+	{
+		Product.VertexHeat[i] -= (Product.VertexHeat[i] / 5760) * ((FVector3f::Dist(FVector3f(0, 0, 0), Product.Vertices[i])) / 6);
+		if (Product.VertexHeat[i] <= 0)
+		{
+			Product.VertexHeat[i] = 0;
+		}
+	}
+}
+
+// Ingot shaped point cloud, odd counts so the kernel's scalar tail is exercised too
+static FProductProperties MakeHeatTestProduct(int32 NumVertices)
+{
+	FRandomStream Random(1337);
+	FProductProperties Product;
+	Product.Vertices.SetNumUninitialized(NumVertices);
+	Product.VertexHeat.SetNumUninitialized(NumVertices);
+	for (int32 i = 0; i < NumVertices; i++)
+	{
+		Product.Vertices[i] = FVector3f(Random.FRandRange(-2.f, 2.f), Random.FRandRange(-30.f, 10.f), Random.FRandRange(-1.f, 1.f));
+		Product.VertexHeat[i] = Random.FRandRange(0.f, 1440.f);
+	}
+	return Product;
+}
+
+template<typename FuncType>
+static double TimeIterations(int32 Iterations, FuncType&& Func)
+{
+	const double Start = FPlatformTime::Seconds();
+	for (int32 i = 0; i < Iterations; i++)
+	{
+		Func();
+	}
+	return (FPlatformTime::Seconds() - Start) * 1000.0 / Iterations;
+}
+
+bool FSoterioHeatKernelTest::RunTest(const FString& Parameters)
+{
+	for (const int32 NumVertices : { 7, 4099, 250001 })
+	{
+		const FProductProperties Source = MakeHeatTestProduct(NumVertices);
+
+		FProductProperties Reference = Source;
+		FProductProperties Kernel = Source;
+		ReferenceUpdateHeat(Reference);
+		USoterioMeshLib::UpdateHeat(Kernel, 0);
+
+		bool bHeatMatches = true;
+		bool bVerticesMatch = true;
+		for (int32 i = 0; i < NumVertices; i++)
+		{
+			bHeatMatches &= FMath::IsNearlyEqual(Reference.VertexHeat[i], Kernel.VertexHeat[i], 1e-3f);
+			bVerticesMatch &= Reference.Vertices[i].Equals(Kernel.Vertices[i], 1e-5f);
+		}
+		TestTrue(FString::Printf(TEXT("UpdateHeat heat matches reference (%d vertices)"), NumVertices), bHeatMatches);
+		TestTrue(FString::Printf(TEXT("UpdateHeat positions match reference (%d vertices)"), NumVertices), bVerticesMatch);
+
+		ReferenceDecreaseHeat(Reference);
+		USoterioMeshLib::DecreaseHeat(Kernel);
+
+		bHeatMatches = true;
+		for (int32 i = 0; i < NumVertices; i++)
+		{
+			bHeatMatches &= FMath::IsNearlyEqual(Reference.VertexHeat[i], Kernel.VertexHeat[i], 1e-3f);
+		}
+		TestTrue(FString::Printf(TEXT("DecreaseHeat matches reference (%d vertices)"), NumVertices), bHeatMatches);
+	}
+
+	// Heating scales the vertices under a built grid, it has to keep answering like a full scan without a rebuild
+	{
+		FProductProperties Product = MakeHeatTestProduct(4099);
+		const FVector3f Center(0.f, -10.f, 0.f);
+		const float Radius = 3.f;
+		TArray<int32> Found;
+		USoterioMeshLib::QueryVerticesInRadius(Product, Center, Radius, Found);
+		for (int32 Tick = 0; Tick < 200; Tick++)
+		{
+			USoterioMeshLib::UpdateHeat(Product, 0);
+		}
+		TestEqual(TEXT("Grid survives heating"), Product.SpatialGrid.IsValid(Product.Vertices.Num()), true);
+
+		Found.Reset();
+		USoterioMeshLib::QueryVerticesInRadius(Product, Center, Radius, Found);
+		int32 Expected = 0;
+		for (const FVector3f& Vertex : Product.Vertices)
+		{
+			Expected += FVector3f::DistSquared(Vertex, Center) < Radius * Radius ? 1 : 0;
+		}
+		TestEqual(TEXT("Scaled grid query matches a full scan"), Found.Num(), Expected);
+	}
+
+	// Benchmark, numbers are reported rather than asserted since they depend on the machine
+	const int32 Iterations = 20;
+	for (const int32 NumVertices : { 4096, 65536, 262144 })
+	{
+		FProductProperties Reference = MakeHeatTestProduct(NumVertices);
+		FProductProperties Kernel = Reference;
+
+		const double ReferenceUpdateMs = TimeIterations(Iterations, [&]() { ReferenceUpdateHeat(Reference); });
+		const double KernelUpdateMs = TimeIterations(Iterations, [&]() { USoterioMeshLib::UpdateHeat(Kernel, 0); });
+		const double ReferenceDecreaseMs = TimeIterations(Iterations, [&]() { ReferenceDecreaseHeat(Reference); });
+		const double KernelDecreaseMs = TimeIterations(Iterations, [&]() { USoterioMeshLib::DecreaseHeat(Kernel); });
+
+		AddInfo(FString::Printf(TEXT("%d vertices: UpdateHeat %.3f ms -> %.3f ms, DecreaseHeat %.3f ms -> %.3f ms"),
+			NumVertices, ReferenceUpdateMs, KernelUpdateMs, ReferenceDecreaseMs, KernelDecreaseMs));
+	}
+
+	return true;
+}
@@ -0,0 +1,283 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "../../Soterio/SoterioMeshLib.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformMemory.h"
+#include "Engine/StaticMesh.h"
+#include "MeshDescription.h"
+#include "StaticMeshAttributes.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSoterioMeshLibBenchmark, "Soterio.MeshLib.Benchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+/*
+Times the forging hot paths on synthetic ingots and writes Saved/Benchmarks/SoterioMeshLib.json.
+	Memory is the change in the process' used physical memory over each timed call, read from the platform
+	stats so the allocator is left alone. It moves in pages and other engine threads add noise to it, it shows
+	ops that grow or retain memory rather than counting every allocation.
+*/
+namespace SoterioBenchmark
+{
+	struct FOpResult
+	{
+		FString Name;
+		int32 NumVertices = 0;
+		TArray<double> SamplesMs;
+		int64 MemoryDelta = 0;
+
+		double Percentile(double P) const
+		{
+			TArray<double> Sorted = SamplesMs;
+			Sorted.Sort();
+			return Sorted[FMath::Clamp(FMath::CeilToInt32(P * Sorted.Num()) - 1, 0, Sorted.Num() - 1)];
+		}
+	};
+
+	// Setup runs untimed before every iteration, Op is timed and its memory growth measured
+	template<typename SetupType, typename OpType>
+	static FOpResult Measure(const TCHAR* Name, int32 NumVertices, int32 Iterations, SetupType&& Setup, OpType&& Op)
+	{
+		FOpResult Result;
+		Result.Name = Name;
+		Result.NumVertices = NumVertices;
+		Result.SamplesMs.Reserve(Iterations);
+
+		for (int32 i = 0; i < Iterations; i++)
+		{
+			Setup();
+
+			const uint64 UsedBefore = FPlatformMemory::GetStats().UsedPhysical;
+			const double Start = FPlatformTime::Seconds();
+			Op();
+			const double End = FPlatformTime::Seconds();
+			const uint64 UsedAfter = FPlatformMemory::GetStats().UsedPhysical;
+
+			Result.SamplesMs.Add((End - Start) * 1000.0);
+			Result.MemoryDelta += int64(UsedAfter) - int64(UsedBefore);
+		}
+		Result.MemoryDelta /= Iterations;
+		return Result;
+	}
+
+	// One grid face of the ingot, wound so its normal is U x V
+	static void AddFace(FProductProperties& Product, const FVector3f& Origin, const FVector3f& U, const FVector3f& V, int32 NumU, int32 NumV)
+	{
+		const int32 First = Product.Vertices.Num();
+		for (int32 v = 0; v <= NumV; v++)
+		{
+			for (int32 u = 0; u <= NumU; u++)
+			{
+				Product.Vertices.Add(Origin + U * (u / float(NumU)) + V * (v / float(NumV)));
+				Product.UVs.Add(FVector2f(u / float(NumU), v / float(NumV)));
+				Product.VertexHeat.Add(20.f);
+			}
+		}
+		const int32 Stride = NumU + 1;
+		for (int32 v = 0; v < NumV; v++)
+		{
+			for (int32 u = 0; u < NumU; u++)
+			{
+				const int32 i0 = First + v * Stride + u;
+				Product.Triangles.Append({ i0, i0 + Stride, i0 + 1, i0 + 1, i0 + Stride, i0 + Stride + 1 });
+			}
+		}
+	}
+
+	// 4 x 40 x 2 cm bar like the base ingot, Density vertices per cm along every edge
+	static FProductProperties MakeIngot(int32 Density)
+	{
+		const FVector3f Size(4.f, 40.f, 2.f);
+		const FVector3f Min(-Size.X * 0.5f, -Size.Y * 0.5f, -Size.Z * 0.5f);
+		const FVector3f X(Size.X, 0, 0), Y(0, Size.Y, 0), Z(0, 0, Size.Z);
+		const int32 NX = FMath::Max(1, int32(Size.X * Density)), NY = FMath::Max(1, int32(Size.Y * Density)), NZ = FMath::Max(1, int32(Size.Z * Density));
+
+		FProductProperties Product;
+		Product.ProductID = FGuid::NewGuid();
+		AddFace(Product, Min + Z, X, Y, NX, NY);		// top
+		AddFace(Product, Min, Y, X, NY, NX);			// bottom
+		AddFace(Product, Min, Z, Y, NZ, NY);			// -X
+		AddFace(Product, Min + X, Y, Z, NY, NZ);		// +X
+		AddFace(Product, Min, X, Z, NX, NZ);			// -Y
+		AddFace(Product, Min + Y, Z, X, NZ, NX);		// +Y
+
+		USoterioMeshLib::CalculateNormals(&Product);
+		USoterioMeshLib::CalculateTangents(&Product);
+		Product.GenerateSplineData();
+		USoterioMeshLib::MarkAllDirty(Product, EProductDirtyFlags::Topology);
+		return Product;
+	}
+
+	// Runtime static mesh with CPU readable buffers so ExtractMeshData can be timed against it
+	static UStaticMesh* MakeIngotStaticMesh(const FProductProperties& Product)
+	{
+		FMeshDescription MeshDescription;
+		FStaticMeshAttributes Attributes(MeshDescription);
+		Attributes.Register();
+
+		MeshDescription.ReserveNewVertices(Product.Vertices.Num());
+		for (const FVector3f& Vertex : Product.Vertices)
+		{
+			Attributes.GetVertexPositions()[MeshDescription.CreateVertex()] = Vertex;
+		}
+
+		const FPolygonGroupID PolygonGroup = MeshDescription.CreatePolygonGroup();
+		MeshDescription.ReserveNewVertexInstances(Product.Triangles.Num());
+		MeshDescription.ReserveNewTriangles(Product.Triangles.Num() / 3);
+		for (int32 i = 0; i + 2 < Product.Triangles.Num(); i += 3)
+		{
+			TArray<FVertexInstanceID, TInlineAllocator<3>> Corners;
+			for (int32 j = 0; j < 3; j++)
+			{
+				const int32 Index = Product.Triangles[i + j];
+				const FVertexInstanceID Corner = MeshDescription.CreateVertexInstance(FVertexID(Index));
+				Attributes.GetVertexInstanceNormals()[Corner] = Product.Normals[Index];
+				Attributes.GetVertexInstanceTangents()[Corner] = Product.Tangents[Index];
+				Attributes.GetVertexInstanceUVs().Set(Corner, 0, Product.UVs[Index]);
+				Corners.Add(Corner);
+			}
+			MeshDescription.CreateTriangle(PolygonGroup, Corners);
+		}
+
+		UStaticMesh* StaticMesh = NewObject<UStaticMesh>(GetTransientPackage());
+		UStaticMesh::FBuildMeshDescriptionsParams Params;
+		Params.bFastBuild = true;
+		Params.bAllowCpuAccess = true;
+		StaticMesh->BuildFromMeshDescriptions({ &MeshDescription }, Params);
+		return StaticMesh;
+	}
+
+	static FHammerData MakeHammer(ES_HAMMER_SHAPE Shape)
+	{
+		FHammerData Hammer;
+		Hammer.Name = Shape == ES_HAMMER_SHAPE::FLAT ? FName("BenchFlat") : FName("BenchRound");
+		Hammer.MaxRadius = 1.5f;
+		Hammer.Weigth = 1.f;
+		Hammer.Size = 1.f;
+		Hammer.Face_0 = Shape;
+		Hammer.Face_1 = Shape;
+		Hammer.Mesh = nullptr;
+		return Hammer;
+	}
+
+	static TSharedRef<FJsonObject> ToJson(const FOpResult& Result)
+	{
+		TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+		Object->SetStringField(TEXT("op"), Result.Name);
+		Object->SetNumberField(TEXT("vertices"), Result.NumVertices);
+		Object->SetNumberField(TEXT("iterations"), Result.SamplesMs.Num());
+		Object->SetNumberField(TEXT("p50_ms"), Result.Percentile(0.5));
+		Object->SetNumberField(TEXT("p90_ms"), Result.Percentile(0.9));
+		Object->SetNumberField(TEXT("p99_ms"), Result.Percentile(0.99));
+		Object->SetNumberField(TEXT("max_ms"), Result.Percentile(1.0));
+		Object->SetNumberField(TEXT("memory_delta_bytes_per_op"), double(Result.MemoryDelta));
+		return Object;
+	}
+}
+
+bool FSoterioMeshLibBenchmark::RunTest(const FString& Parameters)
+{
+	using namespace SoterioBenchmark;
+
+	const int32 Iterations = 25;
+	TArray<FOpResult> Results;
+
+	for (const int32 Density : { 2, 4, 10 })
+	{
+		const FProductProperties Ingot = MakeIngot(Density);
+		const int32 NumVertices = Ingot.Vertices.Num();
+		FProductProperties Product;
+		auto Reset = [&]() { Product = Ingot; };
+		auto Keep = []() {};
+
+		UStaticMesh* StaticMesh = MakeIngotStaticMesh(Ingot);
+		Results.Add(Measure(TEXT("ExtractMeshData"), NumVertices, Iterations, Keep, [&]() { USoterioMeshLib::ExtractMeshData(StaticMesh, Product); }));
+		TestEqual(FString::Printf(TEXT("ExtractMeshData reads every triangle (%d vertices)"), NumVertices), Product.Triangles.Num(), Ingot.Triangles.Num());
+
+		// Strikes walk along the top face so each one lands on fresh metal
+		const FHammerData FlatHammer = MakeHammer(ES_HAMMER_SHAPE::FLAT);
+		const FHammerData RoundHammer = MakeHammer(ES_HAMMER_SHAPE::ROUND);
+		int32 Strike = 0;
+		auto NextStrike = [&Strike]() { return FVector3f(0.f, -18.f + (Strike++ % 36), 1.f); };
+
+		Reset();
+		Results.Add(Measure(TEXT("ModifyMesh.Flat"), NumVertices, Iterations, Keep, [&]() { USoterioMeshLib::ModifyMesh(Product, FlatHammer, NextStrike(), FVector3f(0, 0, 1)); }));
+		Reset();
+		Results.Add(Measure(TEXT("ModifyMesh.Round"), NumVertices, Iterations, Keep, [&]() { USoterioMeshLib::ModifyMesh(Product, RoundHammer, NextStrike(), FVector3f(0, 0, 1)); }));
+
+		Reset();
+		Results.Add(Measure(TEXT("UpdateHeat"), NumVertices, Iterations, Keep, [&]() { USoterioMeshLib::UpdateHeat(Product, 900.f); }));
+		Results.Add(Measure(TEXT("DecreaseHeat"), NumVertices, Iterations, Keep, [&]() { USoterioMeshLib::DecreaseHeat(Product); }));
+
+		Results.Add(Measure(TEXT("CalculateSmoothNormals"), NumVertices, Iterations, Reset, [&]() { USoterioMeshLib::CalculateSmoothNormals(&Product, 1); }));
+		Results.Add(Measure(TEXT("CalculateTangents"), NumVertices, Iterations, Reset, [&]() { USoterioMeshLib::CalculateTangents(&Product); }));
+
+		// What the pipeline pays per strike, normals and tangents refreshed only around the struck vertices
+		auto StrikeOnce = [&]()
+		{
+			Reset();
+			USoterioMeshLib::UpdateDirtyNormals(Product);
+			USoterioMeshLib::ClearDirty(Product);
+			USoterioMeshLib::ModifyMesh(Product, RoundHammer, NextStrike(), FVector3f(0, 0, 1));
+		};
+		Results.Add(Measure(TEXT("UpdateDirtyNormals.Strike"), NumVertices, Iterations, StrikeOnce, [&]() { USoterioMeshLib::UpdateDirtyNormals(Product); }));
+		Results.Add(Measure(TEXT("FixDegenerateTriangles"), NumVertices, Iterations, Reset, [&]() { USoterioMeshLib::FixDegenerateTriangles(Product); }));
+		TestEqual(FString::Printf(TEXT("A clean ingot has no degenerate triangles (%d vertices)"), NumVertices), Product.Triangles.Num(), Ingot.Triangles.Num());
+
+		// The full rebuild UpdateProduct falls back to when the topology changed
+		Results.Add(Measure(TEXT("UpdateProduct.Build"), NumVertices, Iterations, Reset, [&]()
+		{
+			FRealtimeMeshStreamSet StreamSet;
+			USoterioMeshLib::UpdateDirtyNormals(Product);
+			USoterioMeshLib::BuildProductStreams(Product, StreamSet);
+			USoterioMeshLib::BuildCornerLookup(Product);
+			USoterioMeshLib::ClearDirty(Product);
+		}));
+
+		// What a cooling tick uploads instead, just the color stream, written into a mesh holding the ingot.
+		// Timed up to the commit on the game thread, the GPU copy runs on the render thread
+		URealtimeMeshSimple* RealtimeMesh = NewObject<URealtimeMeshSimple>();
+		const FRealtimeMeshSectionGroupKey GroupKey = FRealtimeMeshSectionGroupKey::Create(0, FName("Benchmark"));
+		{
+			FRealtimeMeshStreamSet StreamSet;
+			USoterioMeshLib::BuildProductStreams(Product, StreamSet);
+			RealtimeMesh->CreateSectionGroup(GroupKey, StreamSet);
+		}
+		bool bColorsUploaded = true;
+		Results.Add(Measure(TEXT("UpdateProduct.Heat"), NumVertices, Iterations, Keep, [&]()
+		{
+			FRealtimeMeshStream Colors;
+			USoterioMeshLib::BuildProductColorStream(Product, Colors);
+			bColorsUploaded &= USoterioMeshLib::UpdateProductColors(RealtimeMesh, GroupKey, Colors).IsValid();
+		}));
+		TestTrue(FString::Printf(TEXT("Heat updates write the color stream in place (%d vertices)"), NumVertices), bColorsUploaded);
+		RealtimeMesh->MarkAsGarbage();
+
+		StaticMesh->MarkAsGarbage();
+	}
+
+	TArray<TSharedPtr<FJsonValue>> JsonResults;
+	for (const FOpResult& Result : Results)
+	{
+		AddInfo(FString::Printf(TEXT("%-24s %6d vertices: p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, %lld bytes memory delta"),
+			*Result.Name, Result.NumVertices, Result.Percentile(0.5), Result.Percentile(0.9), Result.Percentile(0.99), Result.MemoryDelta));
+		JsonResults.Add(MakeShared<FJsonValueObject>(ToJson(Result)));
+	}
+
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetStringField(TEXT("suite"), TEXT("Soterio.MeshLib"));
+	Report->SetStringField(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+	Report->SetStringField(TEXT("platform"), FPlatformProperties::IniPlatformName());
+	Report->SetArrayField(TEXT("results"), JsonResults);
+
+	FString Json;
+	FJsonSerializer::Serialize(Report, TJsonWriterFactory<>::Create(&Json));
+	const FString ReportPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / TEXT("SoterioMeshLib.json");
+	TestTrue(TEXT("Benchmark report written"), FFileHelper::SaveStringToFile(Json, *ReportPath));
+	AddInfo(FString::Printf(TEXT("Report: %s"), *ReportPath));
+
+	return true;
+}
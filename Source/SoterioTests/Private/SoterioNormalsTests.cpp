@@ -0,0 +1,71 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "../../Soterio/SoterioMeshLib.h"
+#include "Misc/AutomationTest.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSoterioNormalsTest, "Soterio.MeshLib.Normals", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+// Size x Size grid in the XY plane, wound so its normals face +Z
+static FProductProperties MakeNormalsTestProduct(int32 Size)
+{
+	FProductProperties Product;
+	for (int32 y = 0; y < Size; y++)
+	{
+		for (int32 x = 0; x < Size; x++)
+		{
+			Product.Vertices.Add(FVector3f(x, y, 0));
+		}
+	}
+	for (int32 y = 0; y + 1 < Size; y++)
+	{
+		for (int32 x = 0; x + 1 < Size; x++)
+		{
+			const int32 i0 = y * Size + x;
+			Product.Triangles.Append({ i0, i0 + Size, i0 + 1, i0 + 1, i0 + Size, i0 + Size + 1 });
+		}
+	}
+	return Product;
+}
+
+bool FSoterioNormalsTest::RunTest(const FString& Parameters)
+{
+	const int32 Size = 16;
+	FProductProperties Incremental = MakeNormalsTestProduct(Size);
+	USoterioMeshLib::CalculateSmoothNormals(&Incremental, 1);
+	USoterioMeshLib::ClearDirty(Incremental);
+
+	FProductProperties Reference = Incremental;
+	USoterioMeshLib::CalculateNormals(&Reference);
+	bool bFlatMatches = true;
+	for (int32 i = 0; i < Incremental.Normals.Num(); i++)
+	{
+		bFlatMatches &= Incremental.Normals[i].Equals(Reference.Normals[i], 1e-4f);
+	}
+	TestTrue(TEXT("Flat grid matches CalculateNormals"), bFlatMatches);
+
+	// Raise one interior vertex like a hammer strike would, a cooling tick in the same batch must not widen it
+	const int32 Struck = 8 * Size + 8;
+	Incremental.Vertices[Struck].Z += 0.5f;
+	USoterioMeshLib::MarkVertexDirty(Incremental, Struck, EProductDirtyFlags::Position);
+	Incremental.VertexHeat.Init(800.f, Incremental.Vertices.Num());
+	USoterioMeshLib::DecreaseHeat(Incremental);
+	TestTrue(TEXT("Cooling flags heat"), EnumHasAnyFlags(Incremental.DirtyFlags, EProductDirtyFlags::Heat));
+	TestEqual(TEXT("Cooling marks no vertex as moved"), Incremental.DirtyVertices.CountSetBits(), 1);
+	USoterioMeshLib::UpdateDirtyNormals(Incremental);
+
+	FProductProperties Full = Incremental;
+	USoterioMeshLib::CalculateSmoothNormals(&Full, 1);
+
+	bool bMatchesFull = true;
+	for (int32 i = 0; i < Incremental.Normals.Num(); i++)
+	{
+		bMatchesFull &= Incremental.Normals[i].Equals(Full.Normals[i], 1e-5f);
+	}
+	TestTrue(TEXT("Incremental update matches a full recompute"), bMatchesFull);
+	TestTrue(TEXT("Neighbour normal tilted towards the dent"), !Incremental.Normals[Struck + 1].Equals(Reference.Normals[Struck + 1], 1e-3f));
+
+	// The struck vertex and its one ring, nothing further away
+	TestEqual(TEXT("Only the one ring is marked dirty"), Incremental.DirtyVertices.CountSetBits(), 7);
+
+	return true;
+}
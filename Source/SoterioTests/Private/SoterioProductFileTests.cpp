@@ -0,0 +1,110 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "../../Soterio/SoterioMeshLib.h"
+#include "../../Soterio/ProductFile.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "Serialization/BufferArchive.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSoterioProductFileTest, "Soterio.MeshLib.ProductFile", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+// Ingot sized bar with a curved top so normals and tangents vary per vertex
+static FProductProperties MakeProductFileTestProduct(int32 Size)
+{
+	FProductProperties Product;
+	Product.ProductID = FGuid::NewGuid();
+	for (int32 y = 0; y < Size; y++)
+	{
+		for (int32 x = 0; x < Size; x++)
+		{
+			Product.Vertices.Add(FVector3f(x * 0.25f, y * 0.05f, FMath::Sin(x * 0.1f) * 2.f));
+			Product.UVs.Add(FVector2f(x / float(Size), y / float(Size)));
+			Product.VertexHeat.Add(20.f + x * 3.f);
+		}
+	}
+	for (int32 y = 0; y + 1 < Size; y++)
+	{
+		for (int32 x = 0; x + 1 < Size; x++)
+		{
+			const int32 i0 = y * Size + x;
+			Product.Triangles.Append({ i0, i0 + Size, i0 + 1, i0 + 1, i0 + Size, i0 + Size + 1 });
+		}
+	}
+	USoterioMeshLib::CalculateSmoothNormals(&Product, 1);
+	Product.Tangents.Init(FVector3f(1, 0, 0), Product.Vertices.Num());
+	Product.SplinePoints.Add(FVector(0, 0, 0));
+	Product.SplinePoints.Add(FVector(Size * 0.25, 0, 0));
+	return Product;
+}
+
+bool FSoterioProductFileTest::RunTest(const FString& Parameters)
+{
+	FProductProperties Product = MakeProductFileTestProduct(64);
+
+	TArray<uint8> Bytes;
+	TestTrue(TEXT("Product writes"), SoterioProductFile::Write(Product, Bytes));
+	TestTrue(TEXT("Written file has the header"), SoterioProductFile::IsProductFile(Bytes));
+
+	FBufferArchive Legacy;
+	Product.Serialize(Legacy);
+	AddInfo(FString::Printf(TEXT("%d vertices: %d bytes, old format %d bytes"), Product.Vertices.Num(), Bytes.Num(), Legacy.Num()));
+	TestTrue(TEXT("Binary format is smaller than the old archive"), Bytes.Num() < Legacy.Num());
+
+	FProductProperties Loaded;
+	TestTrue(TEXT("Product reads"), SoterioProductFile::Read(Loaded, Bytes));
+	TestEqual(TEXT("ProductID survives"), Loaded.ProductID, Product.ProductID);
+	TestEqual(TEXT("Triangles are lossless"), Loaded.Triangles, Product.Triangles);
+	TestEqual(TEXT("Heat is lossless"), Loaded.VertexHeat, Product.VertexHeat);
+	TestEqual(TEXT("Spline points are lossless"), Loaded.SplinePoints, Product.SplinePoints);
+
+	// 16 bits over a 16cm extent is well below a micron, octahedral normals are within a few thousandths
+	bool bPositionsMatch = Loaded.Vertices.Num() == Product.Vertices.Num();
+	bool bNormalsMatch = Loaded.Normals.Num() == Product.Normals.Num();
+	for (int32 i = 0; bPositionsMatch && bNormalsMatch && i < Product.Vertices.Num(); i++)
+	{
+		bPositionsMatch &= Loaded.Vertices[i].Equals(Product.Vertices[i], 1e-3f);
+		bNormalsMatch &= Loaded.Normals[i].Equals(Product.Normals[i], 1e-3f);
+	}
+	TestTrue(TEXT("Positions within quantisation error"), bPositionsMatch);
+	TestTrue(TEXT("Normals within quantisation error"), bNormalsMatch);
+
+	Bytes.SetNum(Bytes.Num() / 2);
+	FProductProperties Truncated;
+	TestFalse(TEXT("Truncated file is rejected"), SoterioProductFile::Read(Truncated, Bytes));
+
+	// Indices the mesh code would read out of bounds with, and a dangling partial triangle
+	FProductProperties BadIndices = Product;
+	BadIndices.Triangles[4] = BadIndices.Vertices.Num();
+	TestTrue(TEXT("Product with a bad index writes"), SoterioProductFile::Write(BadIndices, Bytes));
+	TestFalse(TEXT("Out of range index is rejected"), SoterioProductFile::Read(Loaded, Bytes));
+	TestEqual(TEXT("Rejected file leaves the product untouched"), Loaded.Triangles, Product.Triangles);
+
+	BadIndices = Product;
+	BadIndices.Triangles.Add(0);
+	TestTrue(TEXT("Product with a partial triangle writes"), SoterioProductFile::Write(BadIndices, Bytes));
+	TestFalse(TEXT("Partial triangle is rejected"), SoterioProductFile::Read(Loaded, Bytes));
+
+	// A header claiming a ~2 GB payload is rejected before anything is allocated for it
+	TestTrue(TEXT("Product rewrites"), SoterioProductFile::Write(Product, Bytes));
+	const int32 UncompressedSizeOffset = 60;
+	const int32 HugeSize = 0x7fff0000;
+	FMemory::Memcpy(Bytes.GetData() + UncompressedSizeOffset, &HugeSize, sizeof(HugeSize));
+	TestFalse(TEXT("Oversized payload is rejected"), SoterioProductFile::Read(Loaded, Bytes));
+
+	// Both formats load from disk, the old one through the legacy reader
+	const FString FilePath = FPaths::CreateTempFilename(*FPaths::ProjectIntermediateDir(), TEXT("ProductFile"));
+	FProductProperties FromDisk;
+	TestTrue(TEXT("Product saves"), USoterioMeshLib::SaveMeshProperties(Product, FilePath));
+	TestTrue(TEXT("Product loads"), USoterioMeshLib::LoadMeshProperties(FromDisk, FilePath));
+	TestEqual(TEXT("Loaded product has its triangles"), FromDisk.Triangles.Num(), Product.Triangles.Num());
+
+	FFileHelper::SaveArrayToFile(Legacy, *FilePath);
+	FProductProperties FromLegacy;
+	TestTrue(TEXT("Old saves still load"), USoterioMeshLib::LoadMeshProperties(FromLegacy, FilePath));
+	TestEqual(TEXT("Old save has its vertices"), FromLegacy.Vertices, Product.Vertices);
+	IFileManager::Get().Delete(*FilePath);
+
+	return true;
+}
@@ -0,0 +1,5 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "SoterioTests.h"
+
+IMPLEMENT_MODULE(FSoterioTestsModule, SoterioTests)
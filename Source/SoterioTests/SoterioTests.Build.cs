@@ -0,0 +1,23 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class SoterioTests : ModuleRules
+{
+	public SoterioTests(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+		bUseUnity = false;
+
+		PublicDependencyModuleNames.AddRange(new string[] {
+			"Core",
+			"CoreUObject",
+			"Engine",
+			"Soterio",
+			"RealtimeMeshComponent",
+			"Json",
+			"MeshDescription",
+			"StaticMeshDescription"
+		});
+	}
+}